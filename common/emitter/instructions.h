@@ -162,6 +162,9 @@ namespace x86Emitter
 	extern void xSTC();
 	extern void xCLC();
 
+	// Reads the time stamp counter into edx:eax
+	extern void xRDTSC();
+
 	// NOP 1-byte
 	extern void xNOP();
 
@@ -1144,6 +1144,8 @@ const xRegister32
 	__fi void xSTC() { xWrite8(0xF9); }
 	__fi void xCLC() { xWrite8(0xF8); }
 
+	__fi void xRDTSC() { xWrite16(0x310F); }
+
 	// NOP 1-byte
 	__fi void xNOP() { xWrite8(0x90); }
 
@@ -24,6 +24,7 @@
 #include "common/ProgressCallback.h"
 #include "common/SettingsWrapper.h"
 #include "common/StringUtil.h"
+#include "common/Timer.h"
 
 #include "pcsx2/PrecompiledHeader.h"
 
@@ -66,6 +67,7 @@ static MemorySettingsInterface s_settings_interface;
 
 static std::string s_output_prefix;
 static s32 s_loop_count = 1;
+static u32 s_start_frame = 0;
 static std::optional<bool> s_use_window;
 static bool s_no_console = false;
 
@@ -88,6 +90,12 @@ static u64 s_total_uploads = 0;
 static u64 s_total_readbacks = 0;
 static u32 s_total_frames = 0;
 static u32 s_total_drawn_frames = 0;
+static double s_playback_time = 0.0;
+static bool s_software_stats = false;
+
+// Time spent fast-forwarding to the start frame, which doesn't count as playback. Owned by the GS thread.
+static Common::Timer::Value s_fast_forward_start = 0;
+static Common::Timer::Value s_fast_forward_ticks = 0;
 
 bool GSRunner::InitializeConfig()
 {
@@ -240,6 +248,19 @@ void Host::ReleaseRenderWindow()
 
 void Host::BeginPresentFrame()
 {
+	// Frames before the start frame are neither dumped nor counted.
+	if (GSIsSkippingPresent())
+	{
+		if (s_fast_forward_start == 0)
+			s_fast_forward_start = Common::Timer::GetCurrentValue();
+		return;
+	}
+	else if (s_fast_forward_start != 0)
+	{
+		s_fast_forward_ticks += Common::Timer::GetCurrentValue() - s_fast_forward_start;
+		s_fast_forward_start = 0;
+	}
+
 	if (s_loop_number == 0 && !s_output_prefix.empty())
 	{
 		// when we wrap around, don't race other files
@@ -277,6 +298,15 @@ void Host::BeginPresentFrame()
 
 		s_total_frames++;
 
+		std::atomic_thread_fence(std::memory_order_release);
+	}
+	else
+	{
+		// The software renderer has no draw counters worth reporting, only the timing.
+		s_software_stats = true;
+		s_total_frames++;
+		s_total_drawn_frames++;
+
 		std::atomic_thread_fence(std::memory_order_release);
 	}
 }
@@ -444,7 +474,10 @@ static void PrintCommandLineHelp(const char* progname)
 	std::fprintf(stderr, "  -version: Displays version information and exits.\n");
 	std::fprintf(stderr, "  -dumpdir <dir>: Frame dump directory (will be dumped as filename_frameN.png).\n");
 	std::fprintf(stderr, "  -loop <count>: Loops dump playback N times. Defaults to 1. 0 will loop infinitely.\n");
+	std::fprintf(stderr, "  -frame <number>: Fast-forwards to frame N without presenting or dumping earlier frames.\n");
 	std::fprintf(stderr, "  -renderer <renderer>: Sets the graphics renderer. Defaults to Auto.\n");
+	std::fprintf(stderr, "  -swthreads <count>: Sets the number of software renderer threads.\n");
+	std::fprintf(stderr, "  -swraster <mode>: Sets how software renderer threads split draws, interleaved or tiled.\n");
 	std::fprintf(stderr, "  -window: Forces a window to be displayed.\n");
 	std::fprintf(stderr, "  -surfaceless: Disables showing a window.\n");
 	std::fprintf(stderr, "  -logfile <filename>: Writes emu log to filename.\n");
@@ -506,6 +539,12 @@ bool GSRunner::ParseCommandLineArgs(int argc, char* argv[], VMBootParameters& pa
 				Console.WriteLn("Looping dump playback %d times.", s_loop_count);
 				continue;
 			}
+			else if (CHECK_ARG_PARAM("-frame"))
+			{
+				s_start_frame = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
+				Console.WriteLn("Starting dump playback at frame %u.", s_start_frame);
+				continue;
+			}
 			else if (CHECK_ARG_PARAM("-renderer"))
 			{
 				const char* rname = argv[++i];
@@ -543,6 +582,37 @@ bool GSRunner::ParseCommandLineArgs(int argc, char* argv[], VMBootParameters& pa
 				s_settings_interface.SetIntValue("EmuCore/GS", "Renderer", static_cast<int>(type));
 				continue;
 			}
+			else if (CHECK_ARG_PARAM("-swthreads"))
+			{
+				const s32 threads = StringUtil::FromChars<s32>(argv[++i]).value_or(-1);
+				if (threads < 0)
+				{
+					Console.Error("Invalid software renderer thread count");
+					return false;
+				}
+
+				Console.WriteLn("Using %d software renderer threads.", threads);
+				s_settings_interface.SetIntValue("EmuCore/GS", "extrathreads", threads);
+				continue;
+			}
+			else if (CHECK_ARG_PARAM("-swraster"))
+			{
+				const char* mode = argv[++i];
+				GSSWRasterMode raster_mode;
+				if (StringUtil::Strcasecmp(mode, "interleaved") == 0)
+					raster_mode = GSSWRasterMode::Interleaved;
+				else if (StringUtil::Strcasecmp(mode, "tiled") == 0)
+					raster_mode = GSSWRasterMode::Tiled;
+				else
+				{
+					Console.Error("Unknown software raster mode '%s'", mode);
+					return false;
+				}
+
+				Console.WriteLn("Using %s software rasterization.", mode);
+				s_settings_interface.SetIntValue("EmuCore/GS", "SWRasterMode", static_cast<int>(raster_mode));
+				continue;
+			}
 			else if (CHECK_ARG_PARAM("-renderhacks"))
 			{
 				std::string str(argv[++i]);
@@ -661,6 +731,14 @@ bool GSRunner::ParseCommandLineArgs(int argc, char* argv[], VMBootParameters& pa
 void GSRunner::DumpStats()
 {
 	std::atomic_thread_fence(std::memory_order_acquire);
+	if (s_software_stats)
+	{
+		Console.WriteLn(fmt::format("======= SW STATISTICS FOR {} FRAMES ========", s_total_frames));
+		Console.WriteLn(fmt::format("@SWSTAT@ Playback Time: {:.2f} ms ({:.2f} FPS)", s_playback_time * 1000.0, s_total_frames / s_playback_time));
+		Console.WriteLn("============================================");
+		return;
+	}
+
 	Console.WriteLn(fmt::format("======= HW STATISTICS FOR {} ({}) FRAMES ========", s_total_frames, s_total_drawn_frames));
 	Console.WriteLn(fmt::format("@HWSTAT@ Draw Calls: {} (avg {})", s_total_draws, static_cast<u64>(std::ceil(s_total_draws / static_cast<double>(s_total_drawn_frames)))));
 	Console.WriteLn(fmt::format("@HWSTAT@ Render Passes: {} (avg {})", s_total_render_passes, static_cast<u64>(std::ceil(s_total_render_passes / static_cast<double>(s_total_drawn_frames)))));
@@ -668,6 +746,7 @@ void GSRunner::DumpStats()
 	Console.WriteLn(fmt::format("@HWSTAT@ Copies: {} (avg {})", s_total_copies, static_cast<u64>(std::ceil(s_total_copies / static_cast<double>(s_total_drawn_frames)))));
 	Console.WriteLn(fmt::format("@HWSTAT@ Uploads: {} (avg {})", s_total_uploads, static_cast<u64>(std::ceil(s_total_uploads / static_cast<double>(s_total_drawn_frames)))));
 	Console.WriteLn(fmt::format("@HWSTAT@ Readbacks: {} (avg {})", s_total_readbacks, static_cast<u64>(std::ceil(s_total_readbacks / static_cast<double>(s_total_drawn_frames)))));
+	Console.WriteLn(fmt::format("@HWSTAT@ Playback Time: {:.2f} ms ({:.2f} FPS)", s_playback_time * 1000.0, s_total_frames / s_playback_time));
 	Console.WriteLn("============================================");
 }
 
@@ -708,10 +787,14 @@ int main(int argc, char* argv[])
 	{
 		// run until end
 		GSDumpReplayer::SetLoopCount(s_loop_count);
+		GSDumpReplayer::SetStartFrame(s_start_frame);
 		VMManager::SetState(VMState::Running);
+		Common::Timer playback_timer;
 		while (VMManager::GetState() == VMState::Running)
 			VMManager::Execute();
+		s_playback_time = playback_timer.GetTimeSeconds();
 		VMManager::Shutdown(false);
+		s_playback_time -= Common::Timer::ConvertValueToSeconds(s_fast_forward_ticks);
 		GSRunner::DumpStats();
 	}
 
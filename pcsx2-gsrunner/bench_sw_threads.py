@@ -0,0 +1,121 @@
+import argparse
+import glob
+import hashlib
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+PLAYBACK_TIME_RE = re.compile(r"@SWSTAT@ Playback Time: ([0-9.]+) ms \(([0-9.]+) FPS\)")
+
+
+def run_benchmark(runner, gspath, threads, mode, loops):
+    with tempfile.TemporaryDirectory() as logdir:
+        logfile = os.path.join(logdir, "emulog.txt")
+        args = [runner, "-renderer", "sw", "-swthreads", str(threads), "-swraster", mode,
+                "-loop", str(loops), "-logfile", logfile, "-surfaceless", "--", gspath]
+
+        # disable output console entirely, the stats end up in the log file
+        environ = os.environ.copy()
+        environ["PCSX2_NOCONSOLE"] = "1"
+
+        subprocess.run(args, env=environ, stdin=subprocess.DEVNULL, stderr=subprocess.DEVNULL, stdout=subprocess.DEVNULL)
+        if not os.path.exists(logfile):
+            return None
+
+        with open(logfile, "r", errors="replace") as f:
+            match = PLAYBACK_TIME_RE.search(f.read())
+
+    if match is None:
+        return None
+
+    return float(match.group(1)), float(match.group(2))
+
+
+def dump_frames(runner, gspath, threads, mode, dumpdir):
+    args = [runner, "-renderer", "sw", "-swthreads", str(threads), "-swraster", mode,
+            "-dumpdir", dumpdir, "-surfaceless", "--", gspath]
+
+    environ = os.environ.copy()
+    environ["PCSX2_NOCONSOLE"] = "1"
+
+    subprocess.run(args, env=environ, stdin=subprocess.DEVNULL, stderr=subprocess.DEVNULL, stdout=subprocess.DEVNULL)
+
+    frames = {}
+    for path in glob.glob(os.path.join(dumpdir, "*_frame*.png")):
+        with open(path, "rb") as f:
+            frames[os.path.basename(path)] = hashlib.md5(f.read()).digest()
+
+    return frames
+
+
+def compare_modes(runner, gspath, threads, modes):
+    # Splitting draws differently must not change a single pixel, so every mode is checked against one thread.
+    print("Comparing frames of %s" % os.path.basename(gspath))
+
+    with tempfile.TemporaryDirectory() as dumpdir:
+        reference_dir = os.path.join(dumpdir, "reference")
+        os.mkdir(reference_dir)
+        reference = dump_frames(runner, gspath, 1, modes[0], reference_dir)
+        if not reference:
+            print("%-12s %8u %12s" % (modes[0], 1, "no frames"))
+            return False
+
+        matched = True
+        for mode in modes:
+            mode_dir = os.path.join(dumpdir, mode)
+            os.mkdir(mode_dir)
+            frames = dump_frames(runner, gspath, threads, mode, mode_dir)
+
+            diffs = sorted(name for name in reference.keys() if frames.get(name) != reference[name])
+            if diffs:
+                matched = False
+                print("%-12s %8u %5u/%u frames differ, first %s" % (mode, threads, len(diffs), len(reference), diffs[0]))
+            else:
+                print("%-12s %8u %12s" % (mode, threads, "match"))
+
+    return matched
+
+
+def run_benchmarks(runner, gspath, threads, modes, loops):
+    print("Benchmarking %s" % os.path.basename(gspath))
+    print("%-12s %8s %12s %10s %8s" % ("mode", "threads", "time (ms)", "fps", "speedup"))
+
+    for mode in modes:
+        baseline = None
+        for count in threads:
+            result = run_benchmark(runner, gspath, count, mode, loops)
+            if result is None:
+                print("%-12s %8u %12s" % (mode, count, "failed"))
+                continue
+
+            time_ms, fps = result
+            if baseline is None:
+                baseline = time_ms
+
+            print("%-12s %8u %12.2f %10.2f %7.2fx" % (mode, count, time_ms, fps, baseline / time_ms))
+
+    return True
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Measure software renderer scaling over thread counts on a GS dump")
+    parser.add_argument("-runner", action="store", required=True, help="Path to PCSX2 GS runner")
+    parser.add_argument("-gs", action="store", required=True, help="GS dump to play back")
+    parser.add_argument("-threads", action="store", default="1,2,4,8,16,32", help="Comma separated thread counts")
+    parser.add_argument("-modes", action="store", default="interleaved,tiled", help="Comma separated raster modes")
+    parser.add_argument("-loop", action="store", type=int, default=4, help="Times to play the dump per run")
+    parser.add_argument("-nocompare", action="store_true", help="Skip checking that every mode renders the same frames")
+
+    args = parser.parse_args()
+
+    threads = [int(x) for x in args.threads.split(",")]
+    modes = args.modes.split(",")
+    gspath = os.path.realpath(args.gs)
+    if not args.nocompare and not compare_modes(args.runner, gspath, max(threads), modes):
+        sys.exit(1)
+    if not run_benchmarks(args.runner, gspath, threads, modes, args.loop):
+        sys.exit(1)
+    else:
+        sys.exit(0)
@@ -447,6 +447,8 @@ void AudioSettingsWidget::onStretchSettingsClicked()
 		AudioStreamParameters::DEFAULT_STRETCH_USE_QUICKSEEK);
 	SettingWidgetBinder::BindWidgetToBoolSetting(sif, dlgui.useAAFilter, "SPU2/Output", "StretchUseAAFilter",
 		AudioStreamParameters::DEFAULT_STRETCH_USE_AA_FILTER);
+	SettingWidgetBinder::BindWidgetToBoolSetting(sif, dlgui.useSoundTouch, "SPU2/Output", "StretchUseSoundTouch",
+		AudioStreamParameters::DEFAULT_STRETCH_USE_SOUNDTOUCH);
 
 	connect(dlgui.buttonBox->button(QDialogButtonBox::Close), &QPushButton::clicked, &dlg, &QDialog::accept);
 	connect(dlgui.buttonBox->button(QDialogButtonBox::RestoreDefaults), &QPushButton::clicked, this, [this, &dlg]() {
@@ -470,6 +472,10 @@ void AudioSettingsWidget::onStretchSettingsClicked()
 			m_dialog->isPerGameSettings() ?
 				std::nullopt :
 				std::optional<bool>(AudioStreamParameters::DEFAULT_STRETCH_USE_AA_FILTER));
+		m_dialog->setBoolSettingValue("SPU2/Output", "StretchUseSoundTouch",
+			m_dialog->isPerGameSettings() ?
+				std::nullopt :
+				std::optional<bool>(AudioStreamParameters::DEFAULT_STRETCH_USE_SOUNDTOUCH));
 
 		dlg.done(0);
 
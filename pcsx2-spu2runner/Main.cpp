@@ -0,0 +1,608 @@
+// SPDX-FileCopyrightText: 2002-2024 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include "common/RedtapeWindows.h"
+#endif
+
+#include "fmt/core.h"
+
+#include "common/Console.h"
+#include "common/CrashHandler.h"
+#include "common/Error.h"
+#include "common/FileSystem.h"
+#include "common/ProgressCallback.h"
+#include "common/StringUtil.h"
+#include "common/Timer.h"
+#include "common/WAVWriter.h"
+
+#include "pcsx2/PrecompiledHeader.h"
+
+#include "pcsx2/Achievements.h"
+#include "pcsx2/GS.h"
+#include "pcsx2/GameList.h"
+#include "pcsx2/Host.h"
+#include "pcsx2/ImGui/FullscreenUI.h"
+#include "pcsx2/ImGui/ImGuiFullscreen.h"
+#include "pcsx2/ImGui/ImGuiManager.h"
+#include "pcsx2/Input/InputManager.h"
+#include "pcsx2/Memory.h"
+#include "pcsx2/SPU2/Trace.h"
+#include "pcsx2/SPU2/spu2.h"
+#include "pcsx2/VMManager.h"
+
+#include "svnrev.h"
+
+#define XXH_STATIC_LINKING_ONLY 1
+#define XXH_INLINE_ALL 1
+#include "xxhash.h"
+
+namespace SPU2Runner
+{
+	static bool ParseCommandLineArgs(int argc, char* argv[]);
+	static std::optional<std::vector<s16>> LoadGoldenWAV(const std::string& path, u32 sample_rate);
+	static bool CompareWithGolden(const std::vector<s16>& output, u32 sample_rate);
+} // namespace SPU2Runner
+
+static std::string s_trace_path;
+static std::string s_dump_wav_path;
+static std::string s_golden_wav_path;
+static s32 s_loop_count = 1;
+
+static void PrintCommandLineVersion()
+{
+	std::fprintf(stderr, "PCSX2 SPU2 Runner Version %s\n", GIT_REV);
+	std::fprintf(stderr, "https://pcsx2.net/\n");
+	std::fprintf(stderr, "\n");
+}
+
+static void PrintCommandLineHelp(const char* progname)
+{
+	PrintCommandLineVersion();
+	std::fprintf(stderr, "Usage: %s [parameters] [--] [filename]\n", progname);
+	std::fprintf(stderr, "\n");
+	std::fprintf(stderr, "  -help: Displays this information and exits.\n");
+	std::fprintf(stderr, "  -version: Displays version information and exits.\n");
+	std::fprintf(stderr, "  -loop <count>: Replays the trace N times for timing. Defaults to 1.\n");
+	std::fprintf(stderr, "  -dumpwav <filename>: Writes the output of the first replay to a WAV file.\n");
+	std::fprintf(stderr, "  -golden <filename>: Compares the output against a WAV file previously written\n"
+						 "    with -dumpwav, exits with a failure code if they differ.\n");
+	std::fprintf(stderr, "  --: Signals that no more arguments will follow and the remaining\n"
+						 "    parameters make up the filename. Use when the filename contains\n"
+						 "    spaces or starts with a dash.\n");
+	std::fprintf(stderr, "\n");
+}
+
+bool SPU2Runner::ParseCommandLineArgs(int argc, char* argv[])
+{
+	bool no_more_args = false;
+	for (int i = 1; i < argc; i++)
+	{
+		if (!no_more_args)
+		{
+#define CHECK_ARG(str) !std::strcmp(argv[i], str)
+#define CHECK_ARG_PARAM(str) (!std::strcmp(argv[i], str) && ((i + 1) < argc))
+
+			if (CHECK_ARG("-help"))
+			{
+				PrintCommandLineHelp(argv[0]);
+				return false;
+			}
+			else if (CHECK_ARG("-version"))
+			{
+				PrintCommandLineVersion();
+				return false;
+			}
+			else if (CHECK_ARG_PARAM("-loop"))
+			{
+				s_loop_count = StringUtil::FromChars<s32>(argv[++i]).value_or(0);
+				if (s_loop_count <= 0)
+				{
+					Console.Error("Invalid loop count.");
+					return false;
+				}
+
+				continue;
+			}
+			else if (CHECK_ARG_PARAM("-dumpwav"))
+			{
+				s_dump_wav_path = argv[++i];
+				continue;
+			}
+			else if (CHECK_ARG_PARAM("-golden"))
+			{
+				s_golden_wav_path = argv[++i];
+				continue;
+			}
+			else if (CHECK_ARG("--"))
+			{
+				no_more_args = true;
+				continue;
+			}
+			else if (argv[i][0] == '-')
+			{
+				Console.Error("Unknown parameter: '%s'", argv[i]);
+				return false;
+			}
+
+#undef CHECK_ARG
+#undef CHECK_ARG_PARAM
+		}
+
+		if (!s_trace_path.empty())
+			s_trace_path += ' ';
+		s_trace_path += argv[i];
+	}
+
+	if (s_trace_path.empty())
+	{
+		Console.Error("No trace file specified.");
+		return false;
+	}
+
+	return true;
+}
+
+std::optional<std::vector<s16>> SPU2Runner::LoadGoldenWAV(const std::string& path, u32 sample_rate)
+{
+	const std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(path.c_str());
+	if (!data.has_value() || data->size() < 12 || std::memcmp(data->data(), "RIFF", 4) != 0 ||
+		std::memcmp(data->data() + 8, "WAVE", 4) != 0)
+	{
+		Console.Error("Failed to read golden WAV '%s'.", path.c_str());
+		return std::nullopt;
+	}
+
+	// Walk the chunks, WAVWriter only writes "fmt " and "data" but other tools may add more.
+	bool format_ok = false;
+	size_t pos = 12;
+	while ((pos + 8) <= data->size())
+	{
+		u32 chunk_size;
+		std::memcpy(&chunk_size, data->data() + pos + 4, sizeof(chunk_size));
+		const u8* chunk = data->data() + pos + 8;
+		const size_t available = std::min<size_t>(chunk_size, data->size() - pos - 8);
+
+		if (std::memcmp(data->data() + pos, "fmt ", 4) == 0 && available >= 16)
+		{
+			u16 format, channels, bits;
+			u32 rate;
+			std::memcpy(&format, chunk, sizeof(format));
+			std::memcpy(&channels, chunk + 2, sizeof(channels));
+			std::memcpy(&rate, chunk + 4, sizeof(rate));
+			std::memcpy(&bits, chunk + 14, sizeof(bits));
+			if (format != 1 || channels != 2 || bits != 16 || rate != sample_rate)
+			{
+				Console.Error("Golden WAV must be 16-bit stereo PCM at %u Hz.", sample_rate);
+				return std::nullopt;
+			}
+
+			format_ok = true;
+		}
+		else if (std::memcmp(data->data() + pos, "data", 4) == 0 && format_ok)
+		{
+			std::vector<s16> samples(available / sizeof(s16));
+			std::memcpy(samples.data(), chunk, samples.size() * sizeof(s16));
+			return samples;
+		}
+
+		pos += 8 + chunk_size + (chunk_size & 1);
+	}
+
+	Console.Error("Golden WAV '%s' has no audio data.", path.c_str());
+	return std::nullopt;
+}
+
+bool SPU2Runner::CompareWithGolden(const std::vector<s16>& output, u32 sample_rate)
+{
+	const std::optional<std::vector<s16>> golden = LoadGoldenWAV(s_golden_wav_path, sample_rate);
+	if (!golden.has_value())
+		return false;
+
+	const u64 output_hash = XXH64(output.data(), output.size() * sizeof(s16), 0);
+	const u64 golden_hash = XXH64(golden->data(), golden->size() * sizeof(s16), 0);
+	if (output_hash == golden_hash && output.size() == golden->size())
+	{
+		Console.WriteLnFmt(Color_StrongGreen, "Output matches golden WAV ({:016x}).", golden_hash);
+		return true;
+	}
+
+	Console.ErrorFmt("Output does not match golden WAV: {:016x}, expected {:016x}.", output_hash, golden_hash);
+	if (output.size() != golden->size())
+		Console.ErrorFmt("  Output has {} frames, golden has {}.", output.size() / 2, golden->size() / 2);
+
+	const size_t count = std::min(output.size(), golden->size());
+	for (size_t i = 0; i < count; i++)
+	{
+		if (output[i] != (*golden)[i])
+		{
+			Console.ErrorFmt("  First difference at frame {} ({:.3f}s), {} channel: {}, expected {}.", i / 2,
+				static_cast<double>(i / 2) / sample_rate, (i & 1) ? "right" : "left", output[i], (*golden)[i]);
+			break;
+		}
+	}
+
+	return false;
+}
+
+#ifdef _WIN32
+// We can't handle unicode in filenames if we don't use wmain on Win32.
+#define main real_main
+#endif
+
+int main(int argc, char* argv[])
+{
+	CrashHandler::Install();
+	Log::SetConsoleOutputLevel(LOGLEVEL_INFO);
+
+	if (!SPU2Runner::ParseCommandLineArgs(argc, argv))
+		return EXIT_FAILURE;
+
+	if (!SysMemory::Allocate())
+	{
+		Console.Error("Failed to allocate memory.");
+		return EXIT_FAILURE;
+	}
+
+	Error error;
+	SPU2Trace::Player player;
+	if (!player.Open(s_trace_path, &error))
+	{
+		Console.ErrorFmt("Failed to open trace: {}", error.GetDescription());
+		SysMemory::Release();
+		return EXIT_FAILURE;
+	}
+
+	const u32 sample_rate = player.GetSampleRate();
+	Console.WriteLnFmt("Loaded {} events from '{}', {} Hz.", player.GetEventCount(), s_trace_path, sample_rate);
+
+	// Keep the output of every replay, each one must match the first, or something is nondeterministic.
+	std::vector<s16> first_output;
+	std::vector<s16> output;
+	SPU2::SetOutputCallback([&output](const s16* frames, u32 count) {
+		output.insert(output.end(), frames, frames + count * 2);
+	});
+
+	bool deterministic = true;
+	double total_time = 0.0;
+	for (s32 loop = 0; loop < s_loop_count; loop++)
+	{
+		output.clear();
+		player.Reset();
+
+		Common::Timer timer;
+		player.Run();
+		total_time += timer.GetTimeSeconds();
+
+		if (loop == 0)
+		{
+			first_output = std::move(output);
+			output = {};
+			output.reserve(first_output.size());
+		}
+		else if (output != first_output)
+		{
+			Console.ErrorFmt("Replay {} does not match the first replay.", loop + 1);
+			deterministic = false;
+		}
+	}
+
+	SPU2::SetOutputCallback(nullptr);
+
+	const u64 frames = (first_output.size() / 2) * static_cast<u64>(s_loop_count);
+	const double audio_time = static_cast<double>(frames) / sample_rate;
+	Console.WriteLnFmt("Replayed {} frames ({:.2f}s of audio) in {:.3f}s.", frames, audio_time, total_time);
+	if (total_time > 0.0)
+	{
+		Console.WriteLnFmt("{:.0f} samples/sec, {:.1f}x realtime.", static_cast<double>(frames) / total_time,
+			audio_time / total_time);
+	}
+	Console.WriteLnFmt("Output hash: {:016x}", XXH64(first_output.data(), first_output.size() * sizeof(s16), 0));
+
+	bool result = deterministic;
+	if (!s_dump_wav_path.empty())
+	{
+		Common::WAVWriter writer;
+		if (writer.Open(s_dump_wav_path.c_str(), sample_rate, 2))
+		{
+			writer.WriteFrames(first_output.data(), static_cast<u32>(first_output.size() / 2));
+			writer.Close();
+			Console.WriteLn("Wrote output to '%s'.", s_dump_wav_path.c_str());
+		}
+		else
+		{
+			Console.Error("Failed to open '%s' for writing.", s_dump_wav_path.c_str());
+			result = false;
+		}
+	}
+
+	if (!s_golden_wav_path.empty())
+		result = SPU2Runner::CompareWithGolden(first_output, sample_rate) && result;
+
+	SysMemory::Release();
+	return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+void Host::CommitBaseSettingChanges()
+{
+}
+
+void Host::LoadSettings(SettingsInterface& si, std::unique_lock<std::mutex>& lock)
+{
+}
+
+void Host::CheckForSettingsChanges(const Pcsx2Config& old_config)
+{
+}
+
+bool Host::RequestResetSettings(bool folders, bool core, bool controllers, bool hotkeys, bool ui)
+{
+	return false;
+}
+
+void Host::SetDefaultUISettings(SettingsInterface& si)
+{
+}
+
+std::unique_ptr<ProgressCallback> Host::CreateHostProgressCallback()
+{
+	return ProgressCallback::CreateNullProgressCallback();
+}
+
+void Host::ReportErrorAsync(const std::string_view title, const std::string_view message)
+{
+	if (!title.empty() && !message.empty())
+		ERROR_LOG("ReportErrorAsync: {}: {}", title, message);
+	else if (!message.empty())
+		ERROR_LOG("ReportErrorAsync: {}", message);
+}
+
+bool Host::ConfirmMessage(const std::string_view title, const std::string_view message)
+{
+	return true;
+}
+
+void Host::OpenURL(const std::string_view url)
+{
+}
+
+bool Host::CopyTextToClipboard(const std::string_view text)
+{
+	return false;
+}
+
+void Host::BeginTextInput()
+{
+}
+
+void Host::EndTextInput()
+{
+}
+
+std::optional<WindowInfo> Host::GetTopLevelWindowInfo()
+{
+	return std::nullopt;
+}
+
+void Host::OnInputDeviceConnected(const std::string_view identifier, const std::string_view device_name)
+{
+}
+
+void Host::OnInputDeviceDisconnected(const InputBindingKey key, const std::string_view identifier)
+{
+}
+
+void Host::SetMouseMode(bool relative_mode, bool hide_cursor)
+{
+}
+
+std::optional<WindowInfo> Host::AcquireRenderWindow(bool recreate_window)
+{
+	return std::nullopt;
+}
+
+void Host::ReleaseRenderWindow()
+{
+}
+
+void Host::BeginPresentFrame()
+{
+}
+
+void Host::RequestResizeHostDisplay(s32 width, s32 height)
+{
+}
+
+void Host::OnVMStarting()
+{
+}
+
+void Host::OnVMStarted()
+{
+}
+
+void Host::OnVMDestroyed()
+{
+}
+
+void Host::OnVMPaused()
+{
+}
+
+void Host::OnVMResumed()
+{
+}
+
+void Host::OnGameChanged(const std::string& title, const std::string& elf_override, const std::string& disc_path,
+	const std::string& disc_serial, u32 disc_crc, u32 current_crc)
+{
+}
+
+void Host::OnPerformanceMetricsUpdated()
+{
+}
+
+void Host::OnSaveStateLoading(const std::string_view filename)
+{
+}
+
+void Host::OnSaveStateLoaded(const std::string_view filename, bool was_successful)
+{
+}
+
+void Host::OnSaveStateSaved(const std::string_view filename)
+{
+}
+
+void Host::RunOnCPUThread(std::function<void()> function, bool block /* = false */)
+{
+}
+
+void Host::RefreshGameListAsync(bool invalidate_cache)
+{
+}
+
+void Host::CancelGameListRefresh()
+{
+}
+
+bool Host::IsFullscreen()
+{
+	return false;
+}
+
+void Host::SetFullscreen(bool enabled)
+{
+}
+
+void Host::OnCaptureStarted(const std::string& filename)
+{
+}
+
+void Host::OnCaptureStopped()
+{
+}
+
+void Host::RequestExitApplication(bool allow_confirm)
+{
+}
+
+void Host::RequestExitBigPicture()
+{
+}
+
+void Host::RequestVMShutdown(bool allow_confirm, bool allow_save_state, bool default_save_state)
+{
+}
+
+void Host::PumpMessagesOnCPUThread()
+{
+}
+
+s32 Host::Internal::GetTranslatedStringImpl(
+	const std::string_view context, const std::string_view msg, char* tbuf, size_t tbuf_space)
+{
+	if (msg.size() > tbuf_space)
+		return -1;
+	else if (msg.empty())
+		return 0;
+
+	std::memcpy(tbuf, msg.data(), msg.size());
+	return static_cast<s32>(msg.size());
+}
+
+std::string Host::TranslatePluralToString(const char* context, const char* msg, const char* disambiguation, int count)
+{
+	TinyString count_str = TinyString::from_format("{}", count);
+
+	std::string ret(msg);
+	for (;;)
+	{
+		std::string::size_type pos = ret.find("%n");
+		if (pos == std::string::npos)
+			break;
+
+		ret.replace(pos, pos + 2, count_str.view());
+	}
+
+	return ret;
+}
+
+void Host::OnAchievementsLoginRequested(Achievements::LoginRequestReason reason)
+{
+}
+
+void Host::OnAchievementsLoginSuccess(const char* username, u32 points, u32 sc_points, u32 unread_messages)
+{
+}
+
+void Host::OnAchievementsRefreshed()
+{
+}
+
+void Host::OnAchievementsHardcoreModeChanged(bool enabled)
+{
+}
+
+void Host::OnCoverDownloaderOpenRequested()
+{
+}
+
+void Host::OnCreateMemoryCardOpenRequested()
+{
+}
+
+bool Host::ShouldPreferHostFileSelector()
+{
+	return false;
+}
+
+void Host::OpenHostFileSelectorAsync(std::string_view title, bool select_directory, FileSelectorCallback callback,
+	FileSelectorFilters filters, std::string_view initial_directory)
+{
+	callback(std::string());
+}
+
+std::optional<u32> InputManager::ConvertHostKeyboardStringToCode(const std::string_view str)
+{
+	return std::nullopt;
+}
+
+std::optional<std::string> InputManager::ConvertHostKeyboardCodeToString(u32 code)
+{
+	return std::nullopt;
+}
+
+const char* InputManager::ConvertHostKeyboardCodeToIcon(u32 code)
+{
+	return nullptr;
+}
+
+BEGIN_HOTKEY_LIST(g_host_hotkeys)
+END_HOTKEY_LIST()
+
+#ifdef _WIN32
+
+int wmain(int argc, wchar_t** argv)
+{
+	std::vector<std::string> u8_args;
+	u8_args.reserve(static_cast<size_t>(argc));
+	for (int i = 0; i < argc; i++)
+		u8_args.push_back(StringUtil::WideStringToUTF8String(argv[i]));
+
+	std::vector<char*> u8_argptrs;
+	u8_argptrs.reserve(u8_args.size());
+	for (int i = 0; i < argc; i++)
+		u8_argptrs.push_back(u8_args[i].data());
+	u8_argptrs.push_back(nullptr);
+
+	return real_main(argc, u8_argptrs.data());
+}
+
+#endif // _WIN32
@@ -103,7 +103,6 @@ bool CsoFileReader::Precache2(ProgressCallback* progress, Error* error)
 		return false;
 	}
 
-	m_readBuffer.reset();
 	std::fclose(m_src);
 	m_src = nullptr;
 	return true;
@@ -146,14 +145,7 @@ bool CsoFileReader::InitializeBuffers(Error* error)
 	u32 numFrames = (u32)((m_totalSize + m_frameSize - 1) / m_frameSize);
 
 	// We might read a bit of alignment too, so be prepared.
-	if (m_frameSize + (1 << m_indexShift) < CSO_READ_BUFFER_SIZE)
-	{
-		m_readBuffer = std::make_unique<u8[]>(CSO_READ_BUFFER_SIZE);
-	}
-	else
-	{
-		m_readBuffer = std::make_unique<u8[]>(m_frameSize + (1 << m_indexShift));
-	}
+	m_readBufferSize = std::max<u32>(CSO_READ_BUFFER_SIZE, m_frameSize + (1 << m_indexShift));
 
 	const u32 indexSize = numFrames + 1;
 	m_index = std::make_unique<u32[]>(indexSize);
@@ -163,17 +155,56 @@ bool CsoFileReader::InitializeBuffers(Error* error)
 		return false;
 	}
 
-	// initialize zlib if not a ZSO
-	if (!m_uselz4)
+	// Make sure zlib works before the first frame is read, rather than failing every read.
+	DecompressContext* ctx = AcquireContext();
+	if (!ctx)
+	{
+		Error::SetString(error, "Unable to initialize zlib for CSO decompression.");
+		return false;
+	}
+	ReleaseContext(ctx);
+
+	return true;
+}
+
+CsoFileReader::DecompressContext* CsoFileReader::AcquireContext()
+{
 	{
-		if (inflateInit2(&m_z_stream, -15) != Z_OK)
+		std::lock_guard<std::mutex> lock(m_contextMutex);
+		if (!m_freeContexts.empty())
 		{
-			Error::SetString(error, "Unable to initialize zlib for CSO decompression.");
-			return false;
+			DecompressContext* ctx = m_freeContexts.back();
+			m_freeContexts.pop_back();
+			return ctx;
 		}
 	}
 
-	return true;
+	std::unique_ptr<DecompressContext> ctx = std::make_unique<DecompressContext>();
+	ctx->readBuffer = std::make_unique<u8[]>(m_readBufferSize);
+	// initialize zlib if not a ZSO
+	if (!m_uselz4 && inflateInit2(&ctx->zstream, -15) != Z_OK)
+		return nullptr;
+
+	std::lock_guard<std::mutex> lock(m_contextMutex);
+	return m_contexts.emplace_back(std::move(ctx)).get();
+}
+
+void CsoFileReader::ReleaseContext(DecompressContext* ctx)
+{
+	std::lock_guard<std::mutex> lock(m_contextMutex);
+	m_freeContexts.push_back(ctx);
+}
+
+void CsoFileReader::FreeContexts()
+{
+	std::lock_guard<std::mutex> lock(m_contextMutex);
+	if (!m_uselz4)
+	{
+		for (const std::unique_ptr<DecompressContext>& ctx : m_contexts)
+			inflateEnd(&ctx->zstream);
+	}
+	m_freeContexts.clear();
+	m_contexts.clear();
 }
 
 void CsoFileReader::Close2()
@@ -187,10 +218,8 @@ void CsoFileReader::Close2()
 	}
 	if (m_file_cache)
 		m_file_cache.reset();
-	if (!m_uselz4)
-		inflateEnd(&m_z_stream);
 
-	m_readBuffer.reset();
+	FreeContexts();
 	m_index.reset();
 }
 
@@ -244,6 +273,7 @@ int CsoFileReader::ReadChunk(void* dst, s64 chunkID)
 		}
 
 		// Just read directly, easy.
+		std::lock_guard<std::mutex> lock(m_srcMutex);
 		if (FileSystem::FSeek64(m_src, frameRawPos, SEEK_SET) != 0)
 		{
 			Console.Error("Unable to seek to uncompressed CSO data.");
@@ -253,6 +283,13 @@ int CsoFileReader::ReadChunk(void* dst, s64 chunkID)
 	}
 	else
 	{
+		DecompressContext* ctx = AcquireContext();
+		if (!ctx)
+		{
+			Console.Error("Unable to initialize zlib for CSO decompression.");
+			return 0;
+		}
+
 		// This might be less bytes than frameRawSize in case of padding on the last frame.
 		// This is because the index positions must be aligned.
 		u32 readRawBytes;
@@ -260,20 +297,26 @@ int CsoFileReader::ReadChunk(void* dst, s64 chunkID)
 		if (m_file_cache)
 		{
 			if (frameRawPos >= m_file_cache_size)
+			{
+				ReleaseContext(ctx);
 				return 0;
+			}
 
 			readRawBytes = static_cast<u32>(std::min<size_t>(m_file_cache_size - frameRawPos, frameRawSize));
 			readBuffer = &m_file_cache[frameRawPos];
 		}
 		else
 		{
+			// Only the read is serialized, decompression runs outside the lock.
+			std::lock_guard<std::mutex> lock(m_srcMutex);
 			if (FileSystem::FSeek64(m_src, frameRawPos, SEEK_SET) != 0)
 			{
 				Console.Error("Unable to seek to compressed CSO data.");
+				ReleaseContext(ctx);
 				return 0;
 			}
-			readBuffer = m_readBuffer.get();
-			readRawBytes = fread(m_readBuffer.get(), 1, frameRawSize, m_src);
+			readBuffer = ctx->readBuffer.get();
+			readRawBytes = fread(readBuffer, 1, std::min<u64>(frameRawSize, m_readBufferSize), m_src);
 		}
 
 		bool success = false;
@@ -290,20 +333,22 @@ int CsoFileReader::ReadChunk(void* dst, s64 chunkID)
 		}
 		else
 		{
-			m_z_stream.next_in = readBuffer;
-			m_z_stream.avail_in = readRawBytes;
-			m_z_stream.next_out = static_cast<Bytef*>(dst);
-			m_z_stream.avail_out = m_frameSize;
-
-			const int status = inflate(&m_z_stream, Z_FINISH);
-			success = (status == Z_STREAM_END && m_z_stream.total_out == m_frameSize);
+			z_stream& z = ctx->zstream;
+			z.next_in = readBuffer;
+			z.avail_in = readRawBytes;
+			z.next_out = static_cast<Bytef*>(dst);
+			z.avail_out = m_frameSize;
+
+			const int status = inflate(&z, Z_FINISH);
+			success = (status == Z_STREAM_END && z.total_out == m_frameSize);
 		}
 
 		if (!success)
 			Console.Error(fmt::format("Unable to decompress CSO frame using {}", (m_uselz4)? "lz4":"zlib"));
 		
 		if (!m_uselz4)
-			inflateReset(&m_z_stream);
+			inflateReset(&ctx->zstream);
+		ReleaseContext(ctx);
 
 		return success ? m_frameSize : 0;
 	}
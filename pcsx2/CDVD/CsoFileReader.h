@@ -4,6 +4,8 @@
 #pragma once
 
 #include "ThreadedFileReader.h"
+#include <mutex>
+#include <vector>
 #include <zlib.h>
 
 struct CsoHeader;
@@ -27,7 +29,21 @@ public:
 
 	u32 GetBlockCount() const override;
 
+protected:
+	bool CanReadChunksConcurrently() const override { return true; }
+
 private:
+	/// Per-thread state for decompressing frames, so several can be decompressed at once
+	struct DecompressContext
+	{
+		std::unique_ptr<u8[]> readBuffer;
+		z_stream zstream = {};
+	};
+
+	DecompressContext* AcquireContext();
+	void ReleaseContext(DecompressContext* ctx);
+	void FreeContexts();
+
 	static bool ValidateHeader(const CsoHeader& hdr, Error* error);
 	bool ReadFileHeader(Error* error);
 	bool InitializeBuffers(Error* error);
@@ -39,7 +55,7 @@ private:
 	u8 m_frameShift = 0;
 	u8 m_indexShift = 0;
 	bool m_uselz4 = false; // flag to enable LZ4 decompression (ZSO files)
-	std::unique_ptr<u8[]> m_readBuffer;
+	u32 m_readBufferSize = 0;
 
 	std::unique_ptr<u32[]> m_index;
 	u64 m_totalSize = 0;
@@ -47,5 +63,9 @@ private:
 	std::FILE* m_src = nullptr;
 	std::unique_ptr<u8[]> m_file_cache;
 	size_t m_file_cache_size = 0;
-	z_stream m_z_stream = {};
+	/// Serializes seeks and reads of m_src
+	std::mutex m_srcMutex;
+	std::mutex m_contextMutex;
+	std::vector<std::unique_ptr<DecompressContext>> m_contexts;
+	std::vector<DecompressContext*> m_freeContexts;
 };
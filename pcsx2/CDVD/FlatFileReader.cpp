@@ -8,12 +8,38 @@
 #include "common/FileSystem.h"
 #include "common/Error.h"
 
+#include "fmt/format.h"
+
 #include <cerrno>
 #include <cstring>
+#include <iterator>
+
+#ifdef _WIN32
+#include "common/RedtapeWindows.h"
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <sys/statfs.h>
+#include <sys/sysmacros.h>
+#else
+#include <sys/param.h>
+#include <sys/mount.h>
+#endif
+#endif
 
 static constexpr size_t CHUNK_SIZE = 128 * 1024;
 
-FlatFileReader::FlatFileReader() = default;
+// Sequential reads prefetch this far ahead of the read position, and top it up once half of it is used
+static constexpr u64 PREFETCH_WINDOW = 4 * 1024 * 1024;
+// Reads in a row which continue the previous one before the whole mapping is marked sequential
+static constexpr u32 SEQUENTIAL_THRESHOLD = 16;
+
+FlatFileReader::FlatFileReader(bool allow_mapping)
+	: m_allow_mapping(allow_mapping)
+{
+}
 
 FlatFileReader::~FlatFileReader()
 {
@@ -35,9 +61,170 @@ bool FlatFileReader::Open2(std::string filename, Error* error)
 	}
 
 	m_file_size = static_cast<u64>(filesize);
+
+	// Reading through the page cache saves a copy, and lets instances with the same image share its memory
+	if (m_allow_mapping && CanMapFile(m_file, m_filename) && !MapFile())
+		DevCon.Warning("FlatFileReader: Failed to map '%s', falling back to buffered reads.", m_filename.c_str());
+
+	return true;
+}
+
+bool FlatFileReader::CanMapFile(std::FILE* fp, const std::string& filename)
+{
+#ifdef _WIN32
+	wchar_t volume[MAX_PATH];
+	return GetVolumePathNameW(FileSystem::GetWin32Path(filename).c_str(), volume, std::size(volume)) &&
+		   GetDriveTypeW(volume) == DRIVE_FIXED;
+#elif defined(__linux__)
+	struct statfs sfs;
+	if (fstatfs(fileno(fp), &sfs) != 0)
+		return false;
+
+	switch (static_cast<u32>(sfs.f_type))
+	{
+		case 0x00006969: // NFS
+		case 0x0000517B: // SMB
+		case 0xFF534D42: // CIFS
+		case 0xFE534D42: // SMB2
+		case 0x01021997: // 9P, WSL's Windows drives
+		case 0x00C36400: // Ceph
+		case 0x65735546: // FUSE, which covers sshfs, rclone, ntfs-3g on USB drives..
+		case 0x00009660: // ISO 9660, a mounted disc
+		case 0x15013346: // UDF
+			return false;
+
+		default:
+			break;
+	}
+
+	// Block devices say if they're removable, partitions have it on their parent.
+	struct stat st;
+	if (fstat(fileno(fp), &st) != 0)
+		return false;
+	if (major(st.st_dev) == 0)
+		return true; // tmpfs, overlayfs, btrfs subvolumes..
+
+	for (const char* suffix : {"removable", "../removable"})
+	{
+		const std::string path = fmt::format("/sys/dev/block/{}:{}/{}", major(st.st_dev), minor(st.st_dev), suffix);
+		// sysfs files claim to be a page long, so read the flag directly.
+		const FileSystem::ManagedCFilePtr fp_removable = FileSystem::OpenManagedCFile(path.c_str(), "rb");
+		if (fp_removable)
+			return (std::fgetc(fp_removable.get()) != '1');
+	}
+
+	return true;
+#else
+	struct statfs sfs;
+	return (fstatfs(fileno(fp), &sfs) == 0 && (sfs.f_flags & MNT_LOCAL) != 0);
+#endif
+}
+
+bool FlatFileReader::MapFile()
+{
+#ifdef _WIN32
+	const HANDLE file = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(m_file)));
+	m_mapping_handle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!m_mapping_handle)
+		return false;
+
+	m_mapping = static_cast<u8*>(MapViewOfFile(m_mapping_handle, FILE_MAP_READ, 0, 0, 0));
+	if (!m_mapping)
+	{
+		CloseHandle(m_mapping_handle);
+		m_mapping_handle = nullptr;
+		return false;
+	}
+#else
+	void* ptr = mmap(nullptr, m_file_size, PROT_READ, MAP_SHARED, fileno(m_file), 0);
+	if (ptr == MAP_FAILED)
+		return false;
+
+	m_mapping = static_cast<u8*>(ptr);
+#endif
+
+	m_next_offset = 0;
+	m_prefetched_end = 0;
+	m_sequential_reads = 0;
+	m_sequential_hint = false;
 	return true;
 }
 
+void FlatFileReader::UnmapFile()
+{
+	if (!m_mapping)
+		return;
+
+#ifdef _WIN32
+	UnmapViewOfFile(m_mapping);
+	CloseHandle(m_mapping_handle);
+	m_mapping_handle = nullptr;
+#else
+	munmap(m_mapping, m_file_size);
+#endif
+	m_mapping = nullptr;
+}
+
+void FlatFileReader::AdviseRead(u64 offset, u32 size)
+{
+	const u64 end = offset + size;
+	const bool sequential = (offset == m_next_offset);
+	m_next_offset = end;
+
+	if (!sequential)
+	{
+		// Seeks get the OS' default readahead, which is small enough not to waste I/O on scattered reads
+		m_sequential_reads = 0;
+		m_prefetched_end = end;
+		if (m_sequential_hint)
+		{
+#ifndef _WIN32
+			posix_madvise(m_mapping, m_file_size, POSIX_MADV_NORMAL);
+#endif
+			m_sequential_hint = false;
+		}
+		return;
+	}
+
+	if (++m_sequential_reads == SEQUENTIAL_THRESHOLD && !m_sequential_hint)
+	{
+#ifndef _WIN32
+		posix_madvise(m_mapping, m_file_size, POSIX_MADV_SEQUENTIAL);
+#endif
+		m_sequential_hint = true;
+	}
+
+	// Streaming reads (FMVs, level loads) ask for the next window before they get to it
+	if (m_sequential_reads >= 2 && end + PREFETCH_WINDOW / 2 > m_prefetched_end && m_prefetched_end < m_file_size)
+	{
+		const u64 page_mask = ~static_cast<u64>(__pagesize - 1);
+		const u64 start = std::max(m_prefetched_end, end) & page_mask;
+		const u64 stop = std::min(end + PREFETCH_WINDOW, m_file_size);
+#ifdef _WIN32
+		WIN32_MEMORY_RANGE_ENTRY range = {m_mapping + start, static_cast<SIZE_T>(stop - start)};
+		PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+		posix_madvise(m_mapping + start, stop - start, POSIX_MADV_WILLNEED);
+#endif
+		m_prefetched_end = stop;
+	}
+}
+
+const u8* FlatFileReader::MapRange(u64 offset, u32 size)
+{
+	if (offset + size > m_file_size)
+		return nullptr;
+
+	if (m_file_cache)
+		return &m_file_cache[offset];
+
+	if (!m_mapping)
+		return nullptr;
+
+	AdviseRead(offset, size);
+	return m_mapping + offset;
+}
+
 bool FlatFileReader::Precache2(ProgressCallback* progress, Error* error)
 {
 	if (!m_file || !CheckAvailableMemoryForPrecaching(m_file_size, error))
@@ -52,6 +239,7 @@ bool FlatFileReader::Precache2(ProgressCallback* progress, Error* error)
 		return false;
 	}
 
+	UnmapFile();
 	std::fclose(m_file);
 	m_file = nullptr;
 	return true;
@@ -90,6 +278,16 @@ int FlatFileReader::ReadChunk(void* dst, s64 blockID)
 		return static_cast<int>(read_size);
 	}
 
+	if (m_mapping)
+	{
+		if (file_offset >= m_file_size)
+			return -1;
+
+		const u64 read_size = std::min<u64>(m_file_size - file_offset, CHUNK_SIZE);
+		std::memcpy(dst, m_mapping + file_offset, read_size);
+		return static_cast<int>(read_size);
+	}
+
 	if (FileSystem::FSeek64(m_file, file_offset, SEEK_SET) != 0)
 		return -1;
 
@@ -100,6 +298,8 @@ int FlatFileReader::ReadChunk(void* dst, s64 blockID)
 
 void FlatFileReader::Close2()
 {
+	UnmapFile();
+
 	if (!m_file)
 		return;
 
@@ -15,10 +15,33 @@ class FlatFileReader final : public ThreadedFileReader
 	std::unique_ptr<u8[]> m_file_cache;
 	u64 m_file_size = 0;
 
+	/// Read-only view of the whole file, reads are served from it in place when present
+	u8* m_mapping = nullptr;
+#ifdef _WIN32
+	void* m_mapping_handle = nullptr;
+#endif
+	/// Offset just past the last mapped read, to spot sequential access
+	u64 m_next_offset = 0;
+	/// End of the range we last asked the OS to prefetch
+	u64 m_prefetched_end = 0;
+	/// Number of mapped reads in a row which continued the previous one
+	u32 m_sequential_reads = 0;
+	bool m_sequential_hint = false;
+	bool m_allow_mapping;
+
+	bool MapFile();
+	void UnmapFile();
+	/// Give the OS hints about what to page in, based on the pattern of reads
+	void AdviseRead(u64 offset, u32 size);
+
 public:
-	FlatFileReader();
+	explicit FlatFileReader(bool allow_mapping = true);
 	~FlatFileReader() override;
 
+	/// A read from a mapping that fails takes the process down (SIGBUS, or an in-page exception on Windows)
+	/// instead of returning an error, so only files on local, non-removable disks are mapped.
+	static bool CanMapFile(std::FILE* fp, const std::string& filename);
+
 	bool Open2(std::string filename, Error* error) override;
 
 	bool Precache2(ProgressCallback* progress, Error* error) override;
@@ -29,4 +52,7 @@ public:
 	void Close2() override;
 
 	u32 GetBlockCount() const override;
+
+protected:
+	const u8* MapRange(u64 offset, u32 size) override;
 };
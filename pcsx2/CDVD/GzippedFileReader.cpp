@@ -189,15 +189,27 @@ bool GzippedFileReader::Open2(std::string filename, Error* error)
 		return false;
 	}
 
+	// The handle used for the index doubles as the first extraction context's
+	std::unique_ptr<ExtractContext> ctx = std::make_unique<ExtractContext>();
+	ctx->src = m_src;
+	m_freeContexts.push_back(ctx.get());
+	m_contexts.push_back(std::move(ctx));
 	return true;
 }
 
 void GzippedFileReader::Close2()
 {
-	if (m_z_state.isValid)
 	{
-		inflateEnd(&m_z_state.strm);
-		m_z_state = {};
+		std::lock_guard<std::mutex> lock(m_contextMutex);
+		for (const std::unique_ptr<ExtractContext>& ctx : m_contexts)
+		{
+			if (ctx->z_state.isValid)
+				inflateEnd(&ctx->z_state.strm);
+			if (ctx->src != m_src)
+				std::fclose(ctx->src);
+		}
+		m_freeContexts.clear();
+		m_contexts.clear();
 	}
 
 	if (m_src)
@@ -237,7 +249,51 @@ int GzippedFileReader::ReadChunk(void* dst, s64 chunkID)
 
 	const s64 file_offset = chunkID * m_index->span;
 	const u32 read_len = static_cast<u32>(std::min<s64>(m_index->uncompressed_size - file_offset, m_index->span));
-	return extract(m_src, m_index, file_offset, static_cast<unsigned char*>(dst), read_len, &m_z_state);
+
+	ExtractContext* ctx = AcquireContext(file_offset);
+	if (!ctx)
+		return -1;
+
+	const int ret = extract(ctx->src, m_index, file_offset, static_cast<unsigned char*>(dst), read_len, &ctx->z_state);
+	ReleaseContext(ctx);
+	return ret;
+}
+
+GzippedFileReader::ExtractContext* GzippedFileReader::AcquireContext(s64 offset)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_contextMutex);
+		if (!m_freeContexts.empty())
+		{
+			// Sequential reads can carry on from where the last span stopped, without going back to the index point
+			auto it = std::find_if(m_freeContexts.begin(), m_freeContexts.end(),
+				[offset](const ExtractContext* ctx) { return ctx->z_state.isValid && ctx->z_state.out_offset == offset; });
+			if (it == m_freeContexts.end())
+				it = m_freeContexts.end() - 1;
+
+			ExtractContext* ctx = *it;
+			m_freeContexts.erase(it);
+			return ctx;
+		}
+	}
+
+	// Every thread needs its own file position
+	std::unique_ptr<ExtractContext> ctx = std::make_unique<ExtractContext>();
+	Error error;
+	if (!(ctx->src = FileSystem::OpenCFile(m_filename.c_str(), "rb", &error)))
+	{
+		Console.Error(fmt::format("Failed to reopen gzip file for parallel reads: {}", error.GetDescription()));
+		return nullptr;
+	}
+
+	std::lock_guard<std::mutex> lock(m_contextMutex);
+	return m_contexts.emplace_back(std::move(ctx)).get();
+}
+
+void GzippedFileReader::ReleaseContext(ExtractContext* ctx)
+{
+	std::lock_guard<std::mutex> lock(m_contextMutex);
+	m_freeContexts.push_back(ctx);
 }
 
 u32 GzippedFileReader::GetBlockCount() const
@@ -6,6 +6,10 @@
 #include "CDVD/ThreadedFileReader.h"
 #include "zlib_indexed.h"
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
 class GzippedFileReader final : public ThreadedFileReader
 {
 	DeclareNoncopyableObject(GzippedFileReader);
@@ -23,7 +27,17 @@ public:
 
 	u32 GetBlockCount() const override;
 
+protected:
+	bool CanReadChunksConcurrently() const override { return true; }
+
 private:
+	/// A file handle and inflate state for one thread, so spans can be extracted in parallel
+	struct ExtractContext
+	{
+		std::FILE* src = nullptr;
+		zstate z_state = {};
+	};
+
 	static constexpr int GZFILE_SPAN_DEFAULT = (1048576 * 4); /* distance between direct access points when creating a new index */
 	static constexpr int GZFILE_READ_CHUNK_SIZE = (256 * 1024); /* zlib extraction chunks size (at 0-based boundaries) */
 	static constexpr int GZFILE_CACHE_SIZE_MB = 200; /* cache size for extracted data. must be at least GZFILE_READ_CHUNK_SIZE (in MB)*/
@@ -31,9 +45,15 @@ private:
 	// Verifies that we have an index, or try to create one
 	bool LoadOrCreateIndex(Error* error);
 
+	/// Get a free context, preferably one whose inflate state already stops at `offset`
+	ExtractContext* AcquireContext(s64 offset);
+	void ReleaseContext(ExtractContext* ctx);
+
 	Access* m_index = nullptr; // Quick access index
 
 	std::FILE* m_src = nullptr;
 
-	zstate m_z_state = {};
+	std::mutex m_contextMutex;
+	std::vector<std::unique_ptr<ExtractContext>> m_contexts;
+	std::vector<ExtractContext*> m_freeContexts;
 };
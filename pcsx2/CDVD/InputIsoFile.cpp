@@ -64,6 +64,12 @@ int InputIsoFile::ReadSync(u8* dst, uint lsn)
 		return -1;
 	}
 
+	if (const u8* block = m_reader->GetMappedBlock(lsn))
+	{
+		std::memcpy(dst + m_blockofs, block, m_blocksize);
+		return static_cast<int>(m_blocksize);
+	}
+
 	return m_reader->ReadSync(dst + m_blockofs, lsn, 1);
 }
 
@@ -85,6 +91,10 @@ void InputIsoFile::BeginRead2(uint lsn)
 
 	m_read_lsn = lsn;
 
+	// Mapped sectors are copied straight to the destination in FinishRead3, no need to read ahead of time
+	if ((m_mapped_block = m_reader->GetMappedBlock(m_read_lsn)))
+		return;
+
 	m_reader->BeginRead(m_readbuffer, m_read_lsn, 1);
 	m_read_inprogress = true;
 }
@@ -152,7 +162,7 @@ int InputIsoFile::FinishRead3(u8* dst, uint mode)
 
 	length = end - _offset;
 
-	std::memcpy(dst + diff, m_readbuffer + ndiff, length);
+	std::memcpy(dst + diff, (m_mapped_block ? m_mapped_block : m_readbuffer) + ndiff, length);
 
 	if (m_type == ISOTYPE_CD && diff >= 12)
 	{
@@ -186,6 +196,7 @@ void InputIsoFile::_init()
 	m_read_inprogress = false;
 	m_current_lsn = -1;
 	m_read_lsn = -1;
+	m_mapped_block = nullptr;
 	m_reader.reset();
 }
 
@@ -223,6 +234,9 @@ bool InputIsoFile::Open(std::string srcfile, Error* error)
 
 bool InputIsoFile::Precache(ProgressCallback* progress, Error* error)
 {
+	// Precaching replaces the file mapping, so don't keep pointers into it
+	m_read_lsn = -1;
+	m_mapped_block = nullptr;
 	return m_reader->Precache(progress, error);
 }
 
@@ -49,6 +49,8 @@ protected:
 	bool m_read_inprogress;
 	uint m_read_lsn;
 	u8 m_readbuffer[CD_FRAMESIZE_RAW];
+	// Data of m_read_lsn in the reader's file mapping, used instead of m_readbuffer when set
+	const u8* m_mapped_block;
 
 public:
 	InputIsoFile();
@@ -2,8 +2,10 @@
 // SPDX-License-Identifier: GPL-3.0+
 
 #include "ThreadedFileReader.h"
+#include "Config.h"
 #include "Host.h"
 
+#include "common/Console.h"
 #include "common/Error.h"
 #include "common/HostSys.h"
 #include "common/Path.h"
@@ -11,14 +13,25 @@
 #include "common/SmallString.h"
 #include "common/Threading.h"
 
+#include <algorithm>
 #include <cstring>
 
 // Make sure buffer size is bigger than the cutoff where PCSX2 emulates a seek
 // If buffers are smaller than that, we can't keep up with linear reads
 static constexpr u32 MINIMUM_SIZE = 128 * 1024;
 
+// Reads starting this close to the end of a stream continue it, so small skips don't start a new one
+static constexpr u64 STREAM_WINDOW = MINIMUM_SIZE;
+
+// Streams which haven't been read from in this many reads no longer get readahead
+static constexpr u64 STREAM_TIMEOUT = 64;
+
+static constexpr u32 MAX_BUFFERS = 64;
+static constexpr u32 MAX_WORKERS = 4;
+
 ThreadedFileReader::ThreadedFileReader()
 {
+	ResizeBuffers();
 	m_readThread = std::thread([](ThreadedFileReader* r){ r->Loop(); }, this);
 }
 
@@ -28,9 +41,116 @@ ThreadedFileReader::~ThreadedFileReader()
 	(void)std::lock_guard<std::mutex>{m_mtx};
 	m_condition.notify_one();
 	m_readThread.join();
-	for (auto& buffer : m_buffer)
-		if (buffer.ptr)
-			free(buffer.ptr);
+	StopWorkers();
+	for (u32 i = 0; i < m_bufferCount; i++)
+		if (m_buffers[i].ptr)
+			free(m_buffers[i].ptr);
+}
+
+void ThreadedFileReader::ResizeBuffers()
+{
+	const u32 count = static_cast<u32>(std::clamp(EmuConfig.CdvdCacheBuffers, 2, static_cast<int>(MAX_BUFFERS)));
+	if (count == m_bufferCount)
+		return;
+
+	for (u32 i = 0; i < m_bufferCount; i++)
+		if (m_buffers[i].ptr)
+			free(m_buffers[i].ptr);
+
+	m_buffers = std::make_unique<Buffer[]>(count);
+	m_bufferCount = count;
+}
+
+ThreadedFileReader::CacheStats ThreadedFileReader::GetCacheStats() const
+{
+	return {m_stats.hits.load(std::memory_order_relaxed), m_stats.misses.load(std::memory_order_relaxed),
+		m_stats.chunksReadAhead.load(std::memory_order_relaxed), m_stats.parallelFills.load(std::memory_order_relaxed)};
+}
+
+void ThreadedFileReader::StartWorkers()
+{
+	if (!m_workers.empty() || !CanReadChunksConcurrently())
+		return;
+
+	// The read thread works on jobs too, so one less worker than the threads we want
+	const u32 threads = std::clamp(std::thread::hardware_concurrency() / 2, 2u, MAX_WORKERS);
+	m_workQuit = false;
+	for (u32 i = 0; i < threads - 1; i++)
+		m_workers.emplace_back([](ThreadedFileReader* r) { r->WorkerLoop(); }, this);
+}
+
+void ThreadedFileReader::StopWorkers()
+{
+	if (m_workers.empty())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_workMtx);
+		m_workQuit = true;
+	}
+	m_workCondition.notify_all();
+	for (std::thread& worker : m_workers)
+		worker.join();
+	m_workers.clear();
+}
+
+void ThreadedFileReader::WorkerLoop()
+{
+	Threading::SetNameOfCurrentThread("ISO Decompress Worker");
+
+	u64 generation = 0;
+	std::unique_lock<std::mutex> lock(m_workMtx);
+	while (true)
+	{
+		while (m_jobGeneration == generation && !m_workQuit)
+			m_workCondition.wait(lock);
+
+		if (m_workQuit)
+			return;
+
+		generation = m_jobGeneration;
+		RunPendingChunkJobs(lock, generation);
+	}
+}
+
+void ThreadedFileReader::RunPendingChunkJobs(std::unique_lock<std::mutex>& lock, u64 generation)
+{
+	// Jobs are claimed under the lock, so a late worker can't pick up one from a batch that's already done
+	while (m_jobGeneration == generation && m_nextJob < m_jobCount)
+	{
+		ChunkJob& job = m_jobs[m_nextJob++];
+		if (m_jobsReadahead && m_requestPtr.load(std::memory_order_acquire))
+		{
+			// Don't hold up a new request behind the rest of the readahead
+			job.result = 0;
+		}
+		else
+		{
+			lock.unlock();
+			job.result = ReadChunk(job.dst, job.chunkID);
+			lock.lock();
+		}
+		if (--m_jobsRemaining == 0)
+			m_workDoneCondition.notify_one();
+	}
+}
+
+void ThreadedFileReader::RunChunkJobs(ChunkJob* jobs, u32 count, bool readahead)
+{
+	std::unique_lock<std::mutex> lock(m_workMtx);
+	m_jobs = jobs;
+	m_jobsReadahead = readahead;
+	m_jobCount = count;
+	m_nextJob = 0;
+	m_jobsRemaining = count;
+	m_jobGeneration++;
+	m_workCondition.notify_all();
+
+	RunPendingChunkJobs(lock, m_jobGeneration);
+	while (m_jobsRemaining > 0)
+		m_workDoneCondition.wait(lock);
+	m_jobs = nullptr;
+	m_jobCount = 0;
 }
 
 size_t ThreadedFileReader::CopyBlocks(void* dst, const void* src, size_t size) const
@@ -98,34 +218,24 @@ void ThreadedFileReader::Loop()
 
 		if (ok)
 		{
-			// Readahead
-			Chunk chunk = ChunkForOffset(requestOffset + requestSize);
-			if (chunk.chunkID >= 0)
+			// Readahead for every recently read stream, most recent (this request's) first, splitting the buffers between them
+			lock.lock();
+			std::array<Stream, MAX_STREAMS> streams = m_streams;
+			const u64 streamClock = m_streamClock;
+			lock.unlock();
+
+			std::sort(streams.begin(), streams.end(), [](const Stream& a, const Stream& b) { return a.lastUse > b.lastUse; });
+			const u32 active = static_cast<u32>(std::count_if(streams.begin(), streams.end(),
+				[streamClock](const Stream& stream) { return stream.lastUse && streamClock - stream.lastUse < STREAM_TIMEOUT; }));
+			if (active == 0)
+			{
+				ReadAhead(requestOffset + requestSize, 2);
+			}
+			else
 			{
-				int buffersFilled = 0;
-				Buffer* buf = GetBlockPtr(chunk);
-				// Cancel readahead if a new request comes in
-				while (buf && !m_requestPtr.load(std::memory_order_acquire))
-				{
-					u32 bufsize = buf->size.load(std::memory_order_relaxed);
-					chunk = ChunkForOffset(buf->offset + bufsize);
-					if (chunk.chunkID < 0)
-						break;
-					if (buf->offset + bufsize != chunk.offset || chunk.length + bufsize > buf->cap)
-					{
-						buffersFilled++;
-						if (buffersFilled >= 2)
-							break;
-						buf = GetBlockPtr(chunk);
-					}
-					else
-					{
-						int amt = ReadChunk(static_cast<char*>(buf->ptr) + bufsize, chunk.chunkID);
-						if (amt <= 0)
-							break;
-						buf->size.store(bufsize + amt, std::memory_order_release);
-					}
-				}
+				const u32 depth = std::max(1u, (m_bufferCount - 1) / active);
+				for (u32 i = 0; i < active && !m_requestPtr.load(std::memory_order_acquire); i++)
+					ReadAhead(streams[i].next, depth);
 			}
 		}
 
@@ -141,42 +251,201 @@ void ThreadedFileReader::Loop()
 	}
 }
 
-ThreadedFileReader::Buffer* ThreadedFileReader::GetBlockPtr(const Chunk& block)
+ThreadedFileReader::Buffer* ThreadedFileReader::FindBuffer(const Chunk& block)
+{
+	for (u32 i = 0; i < m_bufferCount; i++)
+	{
+		u32 size = m_buffers[i].size.load(std::memory_order_relaxed);
+		u64 offset = m_buffers[i].offset;
+		if (size && offset <= block.offset && offset + size > block.offset)
+			return &m_buffers[i];
+	}
+	return nullptr;
+}
+
+ThreadedFileReader::Buffer* ThreadedFileReader::AllocateBuffer(const Chunk& block)
+{
+	Buffer* buf = &m_buffers[0];
+	for (u32 i = 1; i < m_bufferCount; i++)
+	{
+		if (m_buffers[i].lastUse.load(std::memory_order_relaxed) < buf->lastUse.load(std::memory_order_relaxed))
+			buf = &m_buffers[i];
+	}
+
+	// This can be called from both the read thread threads in ReadSync
+	// Calls from ReadSync are done with the lock already held to keep the read thread out
+	// Therefore we should only lock on the read thread
+	std::unique_lock<std::mutex> lock(m_mtx, std::defer_lock);
+	if (std::this_thread::get_id() == m_readThread.get_id())
+		lock.lock();
+	u32 size = std::max(block.length, MINIMUM_SIZE);
+	if (buf->cap < size)
+	{
+		buf->ptr = realloc(buf->ptr, size);
+		buf->cap = size;
+	}
+	buf->size.store(0, std::memory_order_relaxed);
+	buf->offset = block.offset;
+	buf->lastUse.store(++m_useClock, std::memory_order_relaxed);
+	return buf;
+}
+
+bool ThreadedFileReader::FillBuffer(Buffer& buf)
+{
+	u32 bufsize = buf.size.load(std::memory_order_relaxed);
+
+	// Cancel readahead if a new request comes in
+	while (!m_requestPtr.load(std::memory_order_acquire))
+	{
+		Chunk chunk = ChunkForOffset(buf.offset + bufsize);
+		if (chunk.chunkID < 0 || buf.offset + bufsize != chunk.offset || chunk.length + bufsize > buf.cap)
+			return true;
+
+		int amt = ReadChunk(static_cast<char*>(buf.ptr) + bufsize, chunk.chunkID);
+		if (amt <= 0)
+			return false;
+		bufsize += amt;
+		buf.size.store(bufsize, std::memory_order_release);
+		m_stats.chunksReadAhead.fetch_add(1, std::memory_order_relaxed);
+	}
+	return false;
+}
+
+void ThreadedFileReader::ReadAhead(u64 offset, u32 depth)
+{
+	if (!m_workers.empty())
+	{
+		ReadAheadParallel(offset, depth);
+		return;
+	}
+
+	for (u32 filled = 0; filled < depth && !m_requestPtr.load(std::memory_order_acquire); filled++)
+	{
+		Chunk chunk = ChunkForOffset(offset);
+		if (chunk.chunkID < 0)
+			return;
+
+		Buffer* buf = FindBuffer(chunk);
+		if (!buf)
+			buf = AllocateBuffer(chunk);
+		if (!FillBuffer(*buf))
+			return;
+
+		u32 bufsize = buf->size.load(std::memory_order_relaxed);
+		if (!bufsize)
+			return;
+		offset = buf->offset + bufsize;
+	}
+}
+
+void ThreadedFileReader::ReadAheadParallel(u64 offset, u32 depth)
 {
-	for (int i = 0; i < static_cast<int>(std::size(m_buffer)); i++)
+	struct PlannedBuffer
+	{
+		Buffer* buf;
+		u32 firstJob;
+		u32 jobCount;
+	};
+	PlannedBuffer planned[MAX_BUFFERS];
+	u32 plannedCount = 0;
+
+	// Plan the blocks of every buffer first, so they all decompress at once
+	m_jobBatch.clear();
+	for (u32 filled = 0; filled < depth && !m_requestPtr.load(std::memory_order_acquire); filled++)
 	{
-		u32 size = m_buffer[i].size.load(std::memory_order_relaxed);
-		u64 offset = m_buffer[i].offset;
-		if (size && offset <= block.offset && offset + size >= block.offset + block.length)
+		Chunk chunk = ChunkForOffset(offset);
+		if (chunk.chunkID < 0)
+			break;
+
+		Buffer* buf = FindBuffer(chunk);
+		if (!buf)
+			buf = AllocateBuffer(chunk);
+		else // Keep buffers planned in this batch from being replaced by the ones after them
+			buf->lastUse.store(++m_useClock, std::memory_order_relaxed);
+
+		const u32 first = static_cast<u32>(m_jobBatch.size());
+		u32 end = buf->size.load(std::memory_order_relaxed);
+		for (chunk = ChunkForOffset(buf->offset + end);
+			 chunk.chunkID >= 0 && chunk.offset == buf->offset + end && end + chunk.length <= buf->cap;
+			 chunk = ChunkForOffset(buf->offset + end))
 		{
-			m_nextBuffer = (i + 1) % std::size(m_buffer);
-			return m_buffer + i;
+			m_jobBatch.push_back({static_cast<char*>(buf->ptr) + end, chunk.chunkID, static_cast<int>(chunk.length)});
+			end += chunk.length;
 		}
+
+		if (m_jobBatch.size() > first)
+			planned[plannedCount++] = {buf, first, static_cast<u32>(m_jobBatch.size()) - first};
+		if (end == 0)
+			break;
+		offset = buf->offset + end;
 	}
 
-	Buffer& buf = m_buffer[m_nextBuffer];
+	if (m_jobBatch.empty() || m_requestPtr.load(std::memory_order_acquire))
+		return;
+
+	// Jobs get the expected length in `result`, and replace it with the amount read
+	std::vector<int> lengths(m_jobBatch.size());
+	for (size_t i = 0; i < m_jobBatch.size(); i++)
+		lengths[i] = m_jobBatch[i].result;
+
+	RunChunkJobs(m_jobBatch.data(), static_cast<u32>(m_jobBatch.size()), true);
+	m_stats.parallelFills.fetch_add(plannedCount, std::memory_order_relaxed);
+
+	// Only the part of each buffer up to its first short read is usable
+	for (u32 i = 0; i < plannedCount; i++)
 	{
-		// This can be called from both the read thread threads in ReadSync
-		// Calls from ReadSync are done with the lock already held to keep the read thread out
-		// Therefore we should only lock on the read thread
-		std::unique_lock<std::mutex> lock(m_mtx, std::defer_lock);
-		if (std::this_thread::get_id() == m_readThread.get_id())
-			lock.lock();
-		u32 size = std::max(block.length, MINIMUM_SIZE);
-		if (buf.cap < size)
+		Buffer& buf = *planned[i].buf;
+		u32 bufsize = buf.size.load(std::memory_order_relaxed);
+		for (u32 j = planned[i].firstJob; j < planned[i].firstJob + planned[i].jobCount; j++)
 		{
-			buf.ptr = realloc(buf.ptr, size);
-			buf.cap = size;
+			const ChunkJob& job = m_jobBatch[j];
+			if (job.result <= 0)
+				break;
+			bufsize += job.result;
+			m_stats.chunksReadAhead.fetch_add(1, std::memory_order_relaxed);
+			if (job.result != lengths[j])
+				break;
 		}
-		buf.size.store(0, std::memory_order_relaxed);
+		buf.size.store(bufsize, std::memory_order_release);
+	}
+}
+
+void ThreadedFileReader::TrackStream(u64 begin, u64 end, const std::lock_guard<std::mutex>&)
+{
+	m_streamClock++;
+
+	Stream* oldest = &m_streams[0];
+	for (Stream& stream : m_streams)
+	{
+		if (stream.lastUse && begin + STREAM_WINDOW >= stream.next && begin <= stream.next + STREAM_WINDOW)
+		{
+			stream.next = end;
+			stream.lastUse = m_streamClock;
+			return;
+		}
+		if (stream.lastUse < oldest->lastUse)
+			oldest = &stream;
+	}
+
+	oldest->next = end;
+	oldest->lastUse = m_streamClock;
+}
+
+ThreadedFileReader::Buffer* ThreadedFileReader::GetBlockPtr(const Chunk& block)
+{
+	Buffer* buf = FindBuffer(block);
+	if (buf && buf->offset + buf->size.load(std::memory_order_relaxed) >= block.offset + block.length)
+	{
+		buf->lastUse.store(++m_useClock, std::memory_order_relaxed);
+		return buf;
 	}
-	int size = ReadChunk(buf.ptr, block.chunkID);
+
+	buf = AllocateBuffer(block);
+	int size = ReadChunk(buf->ptr, block.chunkID);
 	if (size > 0)
 	{
-		buf.offset = block.offset;
-		buf.size.store(size, std::memory_order_release);
-		m_nextBuffer = (m_nextBuffer + 1) % std::size(m_buffer);
-		return &buf;
+		buf->size.store(size, std::memory_order_release);
+		return buf;
 	}
 	return nullptr;
 }
@@ -206,6 +475,32 @@ bool ThreadedFileReader::Decompress(void* target, u64 begin, u32 size)
 			remaining -= len;
 			off += len;
 		}
+		else if (!m_workers.empty())
+		{
+			// Split whole blocks going straight to the destination across the worker pool
+			m_jobBatch.clear();
+			u32 len = 0;
+			for (; chunk.chunkID >= 0 && chunk.offset == off + len && chunk.length <= remaining - len; chunk = ChunkForOffset(off + len))
+			{
+				m_jobBatch.push_back({write + len, chunk.chunkID, 0});
+				len += chunk.length;
+			}
+
+			if (m_jobBatch.size() > 1)
+				RunChunkJobs(m_jobBatch.data(), static_cast<u32>(m_jobBatch.size()), false);
+			else
+				m_jobBatch[0].result = ReadChunk(write, m_jobBatch[0].chunkID);
+
+			for (const ChunkJob& job : m_jobBatch)
+			{
+				const u32 amt = ChunkForOffset(off).length;
+				if (job.result < static_cast<int>(amt))
+					return false;
+				write += amt;
+				remaining -= amt;
+				off += amt;
+			}
+		}
 		else
 		{
 			int amt = ReadChunk(write, chunk.chunkID);
@@ -222,18 +517,19 @@ bool ThreadedFileReader::Decompress(void* target, u64 begin, u32 size)
 
 bool ThreadedFileReader::TryCachedRead(void*& buffer, u64& offset, u32& size, const std::lock_guard<std::mutex>&)
 {
-	// Run through twice so that if m_buffer[1] contains the first half and m_buffer[0] contains the second half it still works
+	// Keep going while we make progress, so it still works when the buffers holding the request are out of order
 	m_amtRead = 0;
 	u64 end = 0;
-	bool allDone = false;
-	for (int i = 0; i < static_cast<int>(std::size(m_buffer) * 2); i++)
+	for (bool progress = true; progress && size > 0;)
 	{
-		Buffer& buf = m_buffer[i % std::size(m_buffer)];
-		u32 bufsize = buf.size.load(std::memory_order_acquire);
-		if (!bufsize)
-			continue;
-		if (buf.offset <= offset && buf.offset + bufsize > offset)
+		progress = false;
+		for (u32 i = 0; i < m_bufferCount && size > 0; i++)
 		{
+			Buffer& buf = m_buffers[i];
+			u32 bufsize = buf.size.load(std::memory_order_acquire);
+			if (!bufsize || buf.offset > offset || buf.offset + bufsize <= offset)
+				continue;
+
 			u32 off = offset - buf.offset;
 			u32 cpysize = std::min(size, bufsize - off);
 			size_t read = CopyBlocks(buffer, static_cast<char*>(buf.ptr) + off, cpysize);
@@ -241,14 +537,27 @@ bool ThreadedFileReader::TryCachedRead(void*& buffer, u64& offset, u32& size, co
 			size -= cpysize;
 			offset += cpysize;
 			buffer = static_cast<char*>(buffer) + read;
+			buf.lastUse.store(++m_useClock, std::memory_order_relaxed);
 			if (size == 0)
 				end = buf.offset + bufsize;
+			progress = true;
 		}
-		// Do buffers contain the current and next block?
-		if (end > 0 && buf.offset == end)
-			allDone = true;
 	}
-	return allDone;
+
+	if (size > 0)
+	{
+		m_stats.misses.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	m_stats.hits.fetch_add(1, std::memory_order_relaxed);
+
+	// Do buffers contain the current and next block?
+	for (u32 i = 0; i < m_bufferCount; i++)
+	{
+		if (m_buffers[i].size.load(std::memory_order_relaxed) && m_buffers[i].offset == end)
+			return true;
+	}
+	return false;
 }
 
 bool ThreadedFileReader::Precache(ProgressCallback* progress, Error* error)
@@ -284,7 +593,16 @@ bool ThreadedFileReader::CheckAvailableMemoryForPrecaching(u64 required_size, Er
 bool ThreadedFileReader::Open(std::string filename, Error* error)
 {
 	CancelAndWaitUntilStopped();
-	return Open2(std::move(filename), error);
+	ResizeBuffers();
+	m_stats.hits.store(0, std::memory_order_relaxed);
+	m_stats.misses.store(0, std::memory_order_relaxed);
+	m_stats.chunksReadAhead.store(0, std::memory_order_relaxed);
+	m_stats.parallelFills.store(0, std::memory_order_relaxed);
+	if (!Open2(std::move(filename), error))
+		return false;
+
+	StartWorkers();
+	return true;
 }
 
 int ThreadedFileReader::ReadSync(void* pBuffer, u32 sector, u32 count)
@@ -294,6 +612,7 @@ int ThreadedFileReader::ReadSync(void* pBuffer, u32 sector, u32 count)
 	u32 size = count * blocksize;
 	{
 		std::lock_guard<std::mutex> l(m_mtx);
+		TrackStream(offset, offset + size, l);
 		if (TryCachedRead(pBuffer, offset, size, l))
 			return m_amtRead;
 
@@ -348,6 +667,7 @@ void ThreadedFileReader::BeginRead(void* pBuffer, u32 sector, u32 count)
 	u32 size = count * blocksize;
 	{
 		std::lock_guard<std::mutex> l(m_mtx);
+		TrackStream(offset, offset + size, l);
 		if (TryCachedRead(pBuffer, offset, size, l))
 			return;
 		if (size == 0)
@@ -391,11 +711,36 @@ void ThreadedFileReader::CancelRead(void)
 void ThreadedFileReader::Close(void)
 {
 	CancelAndWaitUntilStopped();
-	for (auto& buf : m_buffer)
-		buf.size.store(0, std::memory_order_relaxed);
+	StopWorkers();
+
+	const CacheStats stats = GetCacheStats();
+	if (stats.hits || stats.misses)
+	{
+		DevCon.WriteLn("ThreadedFileReader: %.*s: %llu hits, %llu misses (%.1f%% hit rate), %llu blocks read ahead, %llu parallel fills",
+			static_cast<int>(Path::GetFileName(m_filename).size()), Path::GetFileName(m_filename).data(),
+			static_cast<unsigned long long>(stats.hits), static_cast<unsigned long long>(stats.misses),
+			static_cast<double>(stats.hits) * 100.0 / static_cast<double>(stats.hits + stats.misses),
+			static_cast<unsigned long long>(stats.chunksReadAhead), static_cast<unsigned long long>(stats.parallelFills));
+	}
+
+	{
+		std::lock_guard<std::mutex> l(m_mtx);
+		for (u32 i = 0; i < m_bufferCount; i++)
+		{
+			m_buffers[i].size.store(0, std::memory_order_relaxed);
+			m_buffers[i].lastUse.store(0, std::memory_order_relaxed);
+		}
+		m_streams = {};
+	}
 	Close2();
 }
 
+const u8* ThreadedFileReader::GetMappedBlock(u32 sector)
+{
+	// With an internal block size, the external block is the start of the internal one, as in CopyBlocks
+	return MapRange(static_cast<u64>(sector) * InternalBlockSize() + m_dataoffset, m_blocksize);
+}
+
 void ThreadedFileReader::SetBlockSize(u32 bytes)
 {
 	m_blocksize = bytes;
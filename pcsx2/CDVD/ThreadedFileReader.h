@@ -5,10 +5,13 @@
 
 #include "common/Pcsx2Defs.h"
 
+#include <array>
 #include <thread>
+#include <memory>
 #include <mutex>
 #include <atomic>
 #include <condition_variable>
+#include <vector>
 
 class Error;
 class ProgressCallback;
@@ -49,6 +52,11 @@ protected:
 	virtual void Close2() = 0;
 	/// Checks system memory, to ensure that precaching would not exceed a reasonable amount.
 	bool CheckAvailableMemoryForPrecaching(u64 required_size, Error* error);
+	/// Return true if ReadChunk can be called from several threads at once, which lets
+	/// chunks of a read-ahead buffer be decompressed in parallel on a worker pool
+	virtual bool CanReadChunksConcurrently() const { return false; }
+	/// Return a pointer to `size` bytes of the file at `offset` if they can be read in place, or nullptr
+	virtual const u8* MapRange(u64 offset, u32 size) { return nullptr; }
 
 	ThreadedFileReader();
 
@@ -71,10 +79,56 @@ private:
 		u64 offset = 0;
 		std::atomic<u32> size{0};
 		u32 cap = 0;
+		/// Value of m_useClock when the buffer was last filled or read from
+		std::atomic<u64> lastUse{0};
 	};
-	/// 2 buffers for readahead (current block, next block)
-	Buffer m_buffer[2];
-	u32 m_nextBuffer = 0;
+	/// Buffers for readahead, the least recently used one gets replaced (at least 2: current block, next block)
+	std::unique_ptr<Buffer[]> m_buffers;
+	u32 m_bufferCount = 0;
+	std::atomic<u64> m_useClock{0};
+
+	/// A sequential run of reads, which gets its own readahead
+	struct Stream
+	{
+		/// Offset just past the last read of the stream
+		u64 next = 0;
+		/// Value of m_streamClock when the stream was last read from, 0 if unused
+		u64 lastUse = 0;
+	};
+	static constexpr u32 MAX_STREAMS = 4;
+	/// View while holding `m_mtx`
+	std::array<Stream, MAX_STREAMS> m_streams = {};
+	u64 m_streamClock = 0;
+
+	struct Stats
+	{
+		std::atomic<u64> hits{0};
+		std::atomic<u64> misses{0};
+		std::atomic<u64> chunksReadAhead{0};
+		std::atomic<u64> parallelFills{0};
+	};
+	Stats m_stats;
+
+	/// Worker pool for CanReadChunksConcurrently() readers, the read thread takes part as well
+	struct ChunkJob
+	{
+		void* dst;
+		s64 chunkID;
+		int result;
+	};
+	std::vector<std::thread> m_workers;
+	/// Jobs of the batch being planned by the read thread
+	std::vector<ChunkJob> m_jobBatch;
+	std::mutex m_workMtx;
+	std::condition_variable m_workCondition;
+	std::condition_variable m_workDoneCondition;
+	ChunkJob* m_jobs = nullptr;
+	u32 m_jobCount = 0;
+	u32 m_nextJob = 0;
+	u32 m_jobsRemaining = 0;
+	u64 m_jobGeneration = 0;
+	bool m_jobsReadahead = false;
+	bool m_workQuit = false;
 
 	std::thread m_readThread;
 	std::mutex m_mtx;
@@ -95,7 +149,33 @@ private:
 	/// Main loop of read thread
 	void Loop();
 
-	/// Load the given block into one of the `m_buffer` buffers if necessary and return a pointer to its contents if successful
+	/// Allocate the readahead buffers, with the count from the settings
+	void ResizeBuffers();
+	/// Find the buffer holding the start of the given block, if any
+	Buffer* FindBuffer(const Chunk& block);
+	/// Replace the least recently used buffer with an empty one starting at the given block
+	Buffer* AllocateBuffer(const Chunk& block);
+	/// Append the blocks following the end of `buf` until it's full
+	/// Returns false if reading failed or a request came in
+	bool FillBuffer(Buffer& buf);
+	/// Fill up to `depth` buffers starting from the given offset
+	void ReadAhead(u64 offset, u32 depth);
+	/// ReadAhead, decompressing the blocks of all buffers on the worker pool
+	void ReadAheadParallel(u64 offset, u32 depth);
+	/// Record a read of [begin, end) against the stream it continues, or start a new one
+	void TrackStream(u64 begin, u64 end, const std::lock_guard<std::mutex>&);
+
+	/// Start the worker pool if the reader supports it
+	void StartWorkers();
+	void StopWorkers();
+	void WorkerLoop();
+	/// Run all jobs on the worker pool, returns once they're done. Readahead batches stop starting jobs once a new
+	/// request comes in, leaving a result of 0 in the ones skipped.
+	void RunChunkJobs(ChunkJob* jobs, u32 count, bool readahead);
+	/// Take and run jobs of batch `generation` until none are left, `lock` holds `m_workMtx`
+	void RunPendingChunkJobs(std::unique_lock<std::mutex>& lock, u64 generation);
+
+	/// Load the given block into one of the `m_buffers` buffers if necessary and return a pointer to its contents if successful
 	Buffer* GetBlockPtr(const Chunk& block);
 	/// Decompress from offset to size into
 	bool Decompress(void* ptr, u64 offset, u32 size);
@@ -109,8 +189,21 @@ private:
 public:
 	virtual ~ThreadedFileReader();
 
+	struct CacheStats
+	{
+		/// Reads served entirely from the readahead buffers
+		u64 hits;
+		/// Reads which had to wait for decompression
+		u64 misses;
+		/// Blocks read into the buffers ahead of being requested
+		u64 chunksReadAhead;
+		/// Buffers filled on the worker pool
+		u64 parallelFills;
+	};
+
 	const std::string& GetFilename() const { return m_filename; }
 	u32 GetBlockSize() const { return m_blocksize; }
+	CacheStats GetCacheStats() const;
 
 	virtual u32 GetBlockCount() const = 0;
 
@@ -118,6 +211,9 @@ public:
 	bool Open(std::string filename, Error* error);
 	bool Precache(ProgressCallback* progress, Error* error);
 	int ReadSync(void* pBuffer, u32 sector, u32 count);
+	/// Get the data of a sector without copying it, for readers that support it
+	/// The pointer stays valid until the reader is closed
+	const u8* GetMappedBlock(u32 sector);
 	void BeginRead(void* pBuffer, u32 sector, u32 count);
 	int FinishRead();
 	void CancelRead();
@@ -30,8 +30,13 @@ void WriteCP0Status(u32 value)
 void WriteCP0Config(u32 value)
 {
 	// Protect the read-only ICacheSize (IC) and DataCacheSize (DC) bits
+	const u32 old_config = cpuRegs.CP0.n.Config;
 	cpuRegs.CP0.n.Config = value & ~0xFC0;
 	cpuRegs.CP0.n.Config |= 0x440;
+
+	// Only the data cache enable bit changes which pages are cached.
+	if ((old_config ^ cpuRegs.CP0.n.Config) & (1 << 16))
+		vtlb_UpdateCachedPages();
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -337,6 +342,10 @@ void UnmapTLB(const tlbs& t, int i)
 	{
 		if (cachedTlbs.PFN0s[i] == t.PFN0() && cachedTlbs.PFN1s[i] == t.PFN1() && cachedTlbs.PageMasks[i] == ConvertPageMask(t.PageMask.UL))
 		{
+			const bool enabled0 = cachedTlbs.CacheEnabled0[i] != 0;
+			const bool enabled1 = cachedTlbs.CacheEnabled1[i] != 0;
+			const u32 page_mask = cachedTlbs.PageMasks[i];
+
 			for (size_t j = i; j < cachedTlbs.count - 1; j++)
 			{
 				cachedTlbs.CacheEnabled0[j] = cachedTlbs.CacheEnabled0[j + 1];
@@ -346,6 +355,11 @@ void UnmapTLB(const tlbs& t, int i)
 				cachedTlbs.PageMasks[j] = cachedTlbs.PageMasks[j + 1];
 			}
 			cachedTlbs.count--;
+
+			if (enabled0)
+				vtlb_UpdateCachedPages(t.PFN0(), page_mask);
+			if (enabled1)
+				vtlb_UpdateCachedPages(t.PFN1(), page_mask);
 			break;
 		}
 	}
@@ -384,6 +398,11 @@ void WriteTLB(int i)
 		cachedTlbs.PageMasks[idx] = ConvertPageMask(tlb[i].PageMask.UL);
 
 		cachedTlbs.count++;
+
+		if (cachedTlbs.CacheEnabled0[idx])
+			vtlb_UpdateCachedPages(cachedTlbs.PFN0s[idx], cachedTlbs.PageMasks[idx]);
+		if (cachedTlbs.CacheEnabled1[idx])
+			vtlb_UpdateCachedPages(cachedTlbs.PFN1s[idx], cachedTlbs.PageMasks[idx]);
 	}
 
 	MapTLB(tlb[i], i);
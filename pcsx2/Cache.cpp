@@ -35,10 +35,10 @@ namespace
 
 		enum Flags : decltype(rawValue)
 		{
-			DIRTY_FLAG = 0x40,
-			VALID_FLAG = 0x20,
+			DIRTY_FLAG = CACHE_TAG_DIRTY,
+			VALID_FLAG = CACHE_TAG_VALID,
 			LRF_FLAG = 0x10,
-			LOCK_FLAG = 0x8,
+			LOCK_FLAG = CACHE_TAG_LOCK,
 			ALL_FLAGS = 0xFFF
 		};
 
@@ -137,11 +137,12 @@ namespace
 	struct CacheSet
 	{
 		CacheTag tags[2];
-		CacheData data[2];
 	};
 
+	// Data and tags live in separate arrays so recompiled code can index both with shifts.
 	struct Cache
 	{
+		CacheData data[64][2];
 		CacheSet sets[64];
 
 		int setIdxFor(u32 vaddr) const
@@ -151,13 +152,27 @@ namespace
 
 		CacheLine lineAt(int idx, int way)
 		{
-			return {sets[idx].tags[way], sets[idx].data[way], idx};
+			return {sets[idx].tags[way], data[idx][way], idx};
 		}
 	};
 
+	static_assert(sizeof(CacheTag) == CACHE_TAG_SIZE && offsetof(CacheTag, rawValue) == 0);
+	static_assert(sizeof(CacheSet) == CACHE_TAG_SIZE * 2);
+	static_assert(sizeof(CacheData) == CACHE_LINE_SIZE && sizeof(Cache::data[0]) == CACHE_LINE_SIZE * 2);
+
 	static Cache cache = {};
 } // namespace
 
+void* GetCacheTagsPtr()
+{
+	return cache.sets;
+}
+
+void* GetCacheDataPtr()
+{
+	return cache.data;
+}
+
 void resetCache()
 {
 	std::memset(&cache, 0, sizeof(cache));
@@ -339,6 +354,57 @@ RETURNS_R128 readCache128(u32 mem, bool validPFN)
 	return value;
 }
 
+u8 recReadCache8(u32 mem)
+{
+	return readCache<u8>(mem, true);
+}
+
+u16 recReadCache16(u32 mem)
+{
+	return readCache<u16>(mem, true);
+}
+
+u32 recReadCache32(u32 mem)
+{
+	return readCache<u32>(mem, true);
+}
+
+u64 recReadCache64(u32 mem)
+{
+	return readCache<u64>(mem, true);
+}
+
+RETURNS_R128 recReadCache128(u32 mem)
+{
+	return readCache128(mem, true);
+}
+
+void recWriteCache8(u32 mem, u8 value)
+{
+	writeCache<u8>(mem, value, true);
+}
+
+void recWriteCache16(u32 mem, u16 value)
+{
+	writeCache<u16>(mem, value, true);
+}
+
+void recWriteCache32(u32 mem, u32 value)
+{
+	writeCache<u32>(mem, value, true);
+}
+
+void recWriteCache64(u32 mem, u64 value)
+{
+	writeCache<u64>(mem, value, true);
+}
+
+void TAKES_R128 recWriteCache128(u32 mem, r128 value)
+{
+	alignas(16) const u128 r = r128_to_u128(value);
+	writeCache128(mem, &r, true);
+}
+
 template <typename Op>
 void doCacheHitOp(u32 addr, const char* name, Op op)
 {
@@ -7,6 +7,19 @@
 
 #include "common/SingleRegisterTypes.h"
 
+// Layout of the data cache, which the recompiler looks lines up in without calling out.
+// Set s, way w has its tag at GetCacheTagsPtr() + (s * 2 + w) * CACHE_TAG_SIZE and its line
+// at GetCacheDataPtr() + (s * 2 + w) * CACHE_LINE_SIZE. A tag starts with the host address
+// of the cached line's page, with the flags below in its low 12 bits.
+static constexpr u32 CACHE_TAG_SIZE = 16;
+static constexpr u32 CACHE_LINE_SIZE = 64;
+static constexpr u32 CACHE_TAG_DIRTY = 0x40;
+static constexpr u32 CACHE_TAG_VALID = 0x20;
+static constexpr u32 CACHE_TAG_LOCK = 0x8;
+
+void* GetCacheTagsPtr();
+void* GetCacheDataPtr();
+
 void resetCache();
 // Dumps all dirty cache entries to memory
 // This is necessary to fix a bug when enabled the recompiler while the cache was enabled.
@@ -21,3 +34,15 @@ u16 readCache16(u32 mem, bool validPFN = true);
 u32 readCache32(u32 mem, bool validPFN = true);
 u64 readCache64(u32 mem, bool validPFN = true);
 RETURNS_R128 readCache128(u32 mem, bool validPFN = true);
+
+// Entry points for recompiled code, for accesses which missed or hit a locked way.
+u8 recReadCache8(u32 mem);
+u16 recReadCache16(u32 mem);
+u32 recReadCache32(u32 mem);
+u64 recReadCache64(u32 mem);
+RETURNS_R128 recReadCache128(u32 mem);
+void recWriteCache8(u32 mem, u8 value);
+void recWriteCache16(u32 mem, u16 value);
+void recWriteCache32(u32 mem, u32 value);
+void recWriteCache64(u32 mem, u64 value);
+void TAKES_R128 recWriteCache128(u32 mem, r128 value);
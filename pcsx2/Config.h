@@ -327,6 +327,12 @@ enum class TriFiltering : s8
 	Forced,
 };
 
+enum class GSSWRasterMode : u8
+{
+	Interleaved, // Each thread draws every primitive, on its own set of scanlines
+	Tiled, // Primitives are binned into screen tiles, which threads take (and steal) whole
+};
+
 enum class AccBlendLevel : u8
 {
 	Minimum,
@@ -616,6 +622,18 @@ struct Pcsx2Config
 			EnableFastmem : 1;
 		bool
 			PauseOnTLBMiss : 1;
+		bool
+			EnableEEBlockReuse : 1;
+		bool
+			EnableVU1AsyncCompile : 1;
+		bool
+			EnableEEBlockProfiler : 1;
+		bool
+			EnableEESuperblocks : 1;
+		bool
+			EnableIOPBlockLinking : 1;
+		bool
+			EnableIOPLinkStats : 1;
 		BITFIELD_END
 
 		RecompilerOptions();
@@ -721,6 +739,7 @@ struct Pcsx2Config
 					OsdShowHardwareInfo : 1,
 					HWSpinGPUForReadbacks : 1,
 					HWSpinCPUForReadbacks : 1,
+					HWSpeculativeReadbacks : 1,
 					GPUPaletteConversion : 1,
 					AutoFlushSW : 1,
 					PreloadFrameWithGSData : 1,
@@ -817,8 +836,11 @@ struct Pcsx2Config
 		u8 ShadeBoost_Saturation = 50;
 		u8 PNGCompressionLevel = 1;
 
+		u16 HashCacheBudget = 0; // MB of VRAM the hash cache is trimmed to, zero for no limit
+
 		u16 SWExtraThreads = 2;
 		u16 SWExtraThreadsHeight = 4;
+		GSSWRasterMode SWRasterMode = GSSWRasterMode::Interleaved;
 
 		int SaveN = 0;
 		int SaveL = 5000;
@@ -906,6 +928,10 @@ struct Pcsx2Config
 		u32 FastForwardVolume = 100;
 		bool OutputMuted = false;
 
+		/// Passes mixed output to the audio stream (format conversion, expansion, time stretching) on a
+		/// separate thread. Voice mixing and reverb stay on the emulation thread.
+		bool StreamWriteThread = false;
+
 		AudioBackend Backend = DEFAULT_BACKEND;
 		SPU2SyncMode SyncMode = DEFAULT_SYNC_MODE;
 		AudioStreamParameters StreamParameters;
@@ -1042,7 +1068,8 @@ struct Pcsx2Config
 			WaitLoop : 1, // enables constant loop detection and fast-forwarding
 			vuFlagHack : 1, // microVU specific flag hack
 			vuThread : 1, // Enable Threaded VU1
-			vu1Instant : 1; // Enable Instant VU1 (Without MTVU only)
+			vu1Instant : 1, // Enable Instant VU1 (Without MTVU only)
+			ipuThread : 1; // IPU macroblock IDCT/colour conversion on a separate thread
 		BITFIELD_END
 
 		s8 EECycleRate; // EE cycle rate selector (1.0, 1.5, 2.0)
@@ -1310,6 +1337,7 @@ struct Pcsx2Config
 	// slots (3 each)
 	McdOptions Mcd[8];
 	std::string GzipIsoIndexTemplate; // for quick-access index with gzipped ISO
+	int CdvdCacheBuffers; // readahead buffers kept by compressed image readers
 
 	int PINESlot;
 
@@ -1402,7 +1430,7 @@ namespace EmuFolders
 #define CHECK_EEREC (EmuConfig.Cpu.Recompiler.EnableEE)
 #define CHECK_CACHE (EmuConfig.Cpu.Recompiler.EnableEECache)
 #define CHECK_IOPREC (EmuConfig.Cpu.Recompiler.EnableIOP)
-#define CHECK_FASTMEM (EmuConfig.Cpu.Recompiler.EnableEE && EmuConfig.Cpu.Recompiler.EnableFastmem)
+#define CHECK_FASTMEM (EmuConfig.Cpu.Recompiler.EnableEE && EmuConfig.Cpu.Recompiler.EnableFastmem && !EmuConfig.Cpu.Recompiler.EnableEECache)
 #define CHECK_EXTRAMEM (memGetExtraMemMode())
 
 //------------ SPECIAL GAME FIXES!!! ---------------
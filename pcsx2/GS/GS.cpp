@@ -17,6 +17,7 @@
 #include "Input/InputManager.h"
 #include "MTGS.h"
 #include "pcsx2/GS.h"
+#include "GS/Renderers/Common/GSFunctionMap.h"
 #include "GS/Renderers/Null/GSRendererNull.h"
 #include "GS/Renderers/HW/GSRendererHW.h"
 #include "GS/Renderers/HW/GSTextureReplacements.h"
@@ -47,6 +48,7 @@
 #include "common/Path.h"
 #include "common/SmallString.h"
 #include "common/StringUtil.h"
+#include "common/Timer.h"
 
 #include "IconsFontAwesome5.h"
 
@@ -57,6 +59,7 @@
 Pcsx2Config::GSOptions GSConfig;
 
 static GSRendererType GSCurrentRenderer;
+static bool s_skip_present = false;
 
 GSRendererType GSGetCurrentRenderer()
 {
@@ -467,6 +470,16 @@ int GSfreeze(FreezeAction mode, freezeData* data)
 	}
 }
 
+void GSSetSkipPresent(bool skip)
+{
+	s_skip_present = skip;
+}
+
+bool GSIsSkippingPresent()
+{
+	return s_skip_present;
+}
+
 void GSQueueSnapshot(const std::string& path, u32 gsdump_frames)
 {
 	if (g_gs_renderer)
@@ -514,6 +527,9 @@ void GSGameChanged()
 	if (GSIsHardwareRenderer())
 		GSTextureReplacements::GameChanged();
 
+	if (g_gs_renderer)
+		g_gs_renderer->GameChanged();
+
 	if (!VMManager::HasValidVM() && GSCapture::IsCapturing())
 		GSCapture::EndCapture();
 }
@@ -673,9 +689,14 @@ void GSgetStats(SmallStringBase& info)
 			prefix = '\0';
 		}
 
-		info.format("{} SW | {} SP | {} P | {} D | {:.2f} S | {:.2f} U | {:.2f} {}pps",
+		// Waits on earlier draws a dependent one had, sync points count every time the workers were drained.
+		const double waits = pm.Get(GSPerfMon::SyncTarget) + pm.Get(GSPerfMon::SyncSource) +
+							 pm.Get(GSPerfMon::SyncTransfer) + pm.Get(GSPerfMon::SyncReadback);
+
+		info.format("{} SW | {} SP | {} W | {} P | {} D | {:.2f} S | {:.2f} U | {:.2f} {}pps",
 			api_name,
 			(int)pm.Get(GSPerfMon::SyncPoint),
+			(int)std::ceil(waits),
 			(int)pm.Get(GSPerfMon::Prim),
 			(int)pm.Get(GSPerfMon::Draw),
 			pm.Get(GSPerfMon::Swizzle) / 1024,
@@ -688,7 +709,7 @@ void GSgetStats(SmallStringBase& info)
 	}
 	else
 	{
-		info.format("{} HW | {} P | {} D | {} DC | {} B | {} RP | {} RB | {} TC | {} TU",
+		info.format("{} HW | {} P | {} D | {} DC | {} B | {} RP | {} RB | {} TC | {} TU | {:.2f} TH | {} HS | {:.2f} RS | {:.2f} RH",
 			api_name,
 			(int)pm.Get(GSPerfMon::Prim),
 			(int)pm.Get(GSPerfMon::Draw),
@@ -697,12 +718,29 @@ void GSgetStats(SmallStringBase& info)
 			(int)std::ceil(pm.Get(GSPerfMon::RenderPasses)),
 			(int)std::ceil(pm.Get(GSPerfMon::Readbacks)),
 			(int)std::ceil(pm.Get(GSPerfMon::TextureCopies)),
-			(int)std::ceil(pm.Get(GSPerfMon::TextureUploads)));
+			(int)std::ceil(pm.Get(GSPerfMon::TextureUploads)),
+			pm.Get(GSPerfMon::TextureHashBytes) / 1024,
+			(int)std::ceil(pm.Get(GSPerfMon::TextureHashSkips)),
+			pm.Get(GSPerfMon::ReadbackStall),
+			pm.Get(GSPerfMon::ReadbackHidden));
 	}
 }
 
 void GSgetMemoryStats(SmallStringBase& info)
 {
+	if (GSCurrentRenderer == GSRendererType::SW)
+	{
+		// Functions compiled ahead of time which draws went on to use, and the JIT time that took out of the frames.
+		const GSCodeCacheStats& jit = g_gs_code_cache_stats;
+		fmt::format_to(std::back_inserter(info), "JIT: {}/{} pre | {:.1f} ms saved | {} in-frame | {:.1f} ms",
+			jit.pregenerated_used.load(std::memory_order_relaxed),
+			jit.pregenerated.load(std::memory_order_relaxed),
+			Common::Timer::ConvertValueToMilliseconds(jit.pregenerated_used_time.load(std::memory_order_relaxed)),
+			jit.generated.load(std::memory_order_relaxed),
+			Common::Timer::ConvertValueToMilliseconds(jit.generated_time.load(std::memory_order_relaxed)));
+		return;
+	}
+
 	if (!g_texture_cache)
 		return;
 
@@ -714,12 +752,15 @@ void GSgetMemoryStats(SmallStringBase& info)
 
 	if (GSConfig.TexturePreloading == TexturePreloadingLevel::Full)
 	{
-		fmt::format_to(std::back_inserter(info), "VRAM: {} MB | T: {} MB | S: {} MB | H: {} MB | P: {} MB",
+		// Hash cache evictions by age and by size/budget, and how many of the evicted textures had to be made again.
+		const GSTextureCache::HashCacheStats& hc = g_texture_cache->GetHashCacheStats();
+		fmt::format_to(std::back_inserter(info), "VRAM: {} MB | T: {} MB | S: {} MB | H: {} MB | P: {} MB | HE: {}/{} | HR: {}",
 			(int)std::ceil(total / 1048576.0f),
 			(int)std::ceil(targets / 1048576.0f),
 			(int)std::ceil(sources / 1048576.0f),
 			(int)std::ceil(hashcache / 1048576.0f),
-			(int)std::ceil(pool / 1048576.0f));
+			(int)std::ceil(pool / 1048576.0f),
+			hc.evicted_by_age, hc.evicted_by_size, hc.recreated);
 	}
 	else
 	{
@@ -769,7 +810,8 @@ void GSUpdateConfig(const Pcsx2Config::GSOptions& new_config)
 
 	// Options which aren't using the global struct yet, so we need to recreate all GS objects.
 	if (GSConfig.SWExtraThreads != old_config.SWExtraThreads ||
-		GSConfig.SWExtraThreadsHeight != old_config.SWExtraThreadsHeight)
+		GSConfig.SWExtraThreadsHeight != old_config.SWExtraThreadsHeight ||
+		GSConfig.SWRasterMode != old_config.SWRasterMode)
 	{
 		if (!GSreopen(false, true, GSConfig.Renderer, &old_config))
 			pxFailRel("Failed to do quick GS reopen");
@@ -87,6 +87,10 @@ void GSResizeDisplayWindow(int width, int height, float scale);
 void GSUpdateDisplayWindow();
 void GSSetVSyncMode(GSVSyncMode mode, bool allow_present_throttle);
 
+/// Skips presenting frames while set, e.g. when fast-forwarding a GS dump to a frame. GS thread only.
+void GSSetSkipPresent(bool skip);
+bool GSIsSkippingPresent();
+
 GSRendererType GSGetCurrentRenderer();
 bool GSIsHardwareRenderer();
 std::string GetDefaultAdapter();
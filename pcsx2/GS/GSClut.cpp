@@ -6,6 +6,7 @@
 #include "GS/GSLocalMemory.h"
 #include "GS/GSGL.h"
 #include "GS/GSUtil.h"
+#include "GS/GSXXH.h"
 #include "GS/Renderers/Common/GSDevice.h"
 #include "GS/Renderers/Common/GSRenderer.h"
 #include "common/AlignedMalloc.h"
@@ -23,6 +24,8 @@ GSClut::GSClut(GSLocalMemory* mem)
 	m_write.dirty = 1;
 	m_read.dirty = true;
 
+	MULTI_ISA_SELECT(GSClutPopulateKernels)(m_kernels);
+
 	for (int i = 0; i < 16; i++)
 	{
 		for (int j = 0; j < 64; j++)
@@ -219,28 +222,34 @@ void GSClut::Write(const GIFRegTEX0& TEX0, const GIFRegTEXCLUT& TEXCLUT)
 {
 	m_write.TEX0 = TEX0;
 	m_write.TEXCLUT = TEXCLUT;
-	m_read.dirty = true;
 	m_write.dirty = 0;
 
 	(this->*m_wc[TEX0.CSM][TEX0.CPSM][TEX0.PSM])(TEX0, TEXCLUT);
+
+	// Most games reload the same palette before every draw, only rebuild the expanded copy if it actually changed.
+	// Palettes read back from render targets don't have their data in local memory, so those always need the reload.
+	const u64 hash = GSXXH3_64bits(m_clut, CLUT_DATA_SIZE);
+	if (hash != m_write.hash || GSConfig.UserHacks_GPUTargetCLUTMode != GSGPUTargetCLUTMode::Disabled)
+		m_read.dirty = true;
+	m_write.hash = hash;
 }
 
 void GSClut::WriteCLUT32_I8_CSM1(const GIFRegTEX0& TEX0, const GIFRegTEXCLUT& TEXCLUT)
 {
 	ALIGN_STACK(32);
-	WriteCLUT_T32_I8_CSM1((u32*)m_mem->BlockPtr32(0, 0, TEX0.CBP, 1), m_clut, (TEX0.CSA & 15));
+	m_kernels.WriteCLUT_T32_I8_CSM1((u32*)m_mem->BlockPtr32(0, 0, TEX0.CBP, 1), m_clut, (TEX0.CSA & 15));
 }
 
 void GSClut::WriteCLUT32_I4_CSM1(const GIFRegTEX0& TEX0, const GIFRegTEXCLUT& TEXCLUT)
 {
 	ALIGN_STACK(32);
 
-	WriteCLUT_T32_I4_CSM1((u32*)m_mem->BlockPtr32(0, 0, TEX0.CBP, 1), m_clut + ((TEX0.CSA & 15) << 4));
+	m_kernels.WriteCLUT_T32_I4_CSM1((u32*)m_mem->BlockPtr32(0, 0, TEX0.CBP, 1), m_clut + ((TEX0.CSA & 15) << 4));
 }
 
 void GSClut::WriteCLUT16_I8_CSM1(const GIFRegTEX0& TEX0, const GIFRegTEXCLUT& TEXCLUT)
 {
-	WriteCLUT_T16_I8_CSM1((u16*)m_mem->BlockPtr16(0, 0, TEX0.CBP, 1), m_clut + (TEX0.CSA << 4));
+	m_kernels.WriteCLUT_T16_I8_CSM1((u16*)m_mem->BlockPtr16(0, 0, TEX0.CBP, 1), m_clut + (TEX0.CSA << 4));
 }
 
 void GSClut::WriteCLUT16_I4_CSM1(const GIFRegTEX0& TEX0, const GIFRegTEXCLUT& TEXCLUT)
@@ -250,7 +259,7 @@ void GSClut::WriteCLUT16_I4_CSM1(const GIFRegTEX0& TEX0, const GIFRegTEXCLUT& TE
 
 void GSClut::WriteCLUT16S_I8_CSM1(const GIFRegTEX0& TEX0, const GIFRegTEXCLUT& TEXCLUT)
 {
-	WriteCLUT_T16_I8_CSM1((u16*)m_mem->BlockPtr16S(0, 0, TEX0.CBP, 1), m_clut + (TEX0.CSA << 4));
+	m_kernels.WriteCLUT_T16_I8_CSM1((u16*)m_mem->BlockPtr16S(0, 0, TEX0.CBP, 1), m_clut + (TEX0.CSA << 4));
 }
 
 void GSClut::WriteCLUT16S_I4_CSM1(const GIFRegTEX0& TEX0, const GIFRegTEXCLUT& TEXCLUT)
@@ -377,15 +386,15 @@ void GSClut::Read32(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA)
 			{
 				case PSMT8:
 				case PSMT8H:
-					ReadCLUT_T32_I8(clut, m_buff32, (TEX0.CSA & 15) << 4);
+					m_kernels.ReadCLUT_T32_I8(clut, m_buff32, (TEX0.CSA & 15) << 4);
 					break;
 				case PSMT4:
 				case PSMT4HL:
 				case PSMT4HH:
 					clut += (TEX0.CSA & 15) << 4;
 					// TODO: merge these functions
-					ReadCLUT_T32_I4(clut, m_buff32);
-					ExpandCLUT64_T32_I8(m_buff32, (u64*)m_buff64); // sw renderer does not need m_buff64 anymore
+					m_kernels.ReadCLUT_T32_I4(clut, m_buff32);
+					m_kernels.ExpandCLUT64_T32_I8(m_buff32, (u64*)m_buff64); // sw renderer does not need m_buff64 anymore
 					break;
 			}
 		}
@@ -396,15 +405,15 @@ void GSClut::Read32(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA)
 				case PSMT8:
 				case PSMT8H:
 					clut += TEX0.CSA << 4;
-					Expand16(clut, m_buff32, 256, TEXA);
+					m_kernels.Expand16(clut, m_buff32, 256, TEXA);
 					break;
 				case PSMT4:
 				case PSMT4HL:
 				case PSMT4HH:
 					clut += TEX0.CSA << 4;
 					// TODO: merge these functions
-					Expand16(clut, m_buff32, 16, TEXA);
-					ExpandCLUT64_T32_I8(m_buff32, (u64*)m_buff64); // sw renderer does not need m_buff64 anymore
+					m_kernels.Expand16(clut, m_buff32, 16, TEXA);
+					m_kernels.ExpandCLUT64_T32_I8(m_buff32, (u64*)m_buff64); // sw renderer does not need m_buff64 anymore
 					break;
 			}
 		}
@@ -527,85 +536,6 @@ void GSClut::GetAlphaMinMax32(int& amin_out, int& amax_out)
 
 //
 
-void GSClut::WriteCLUT_T32_I8_CSM1(const u32* RESTRICT src, u16* RESTRICT clut, u16 offset)
-{
-	// This is required when CSA is offset from the base of the CLUT so we point to the right data
-	for (int i = offset; i < 16; i ++)
-	{
-		const int off = i << 4; // WriteCLUT_T32_I4_CSM1 loads 16 at a time
-		// Source column
-		const int s = clutTableT32I8[off & 0x70] | (off & 0x80);
-
-		WriteCLUT_T32_I4_CSM1(&src[s], &clut[off]);
-	}
-}
-
-__forceinline void GSClut::WriteCLUT_T32_I4_CSM1(const u32* RESTRICT src, u16* RESTRICT clut)
-{
-	// 1 block
-
-#if _M_SSE >= 0x501
-
-	GSVector8i* s = (GSVector8i*)src;
-	GSVector8i* d = (GSVector8i*)clut;
-
-	GSVector8i v0 = s[0].acbd();
-	GSVector8i v1 = s[1].acbd();
-
-	GSVector8i::sw16(v0, v1);
-	GSVector8i::sw16(v0, v1);
-	GSVector8i::sw16(v0, v1);
-
-	d[0] = v0;
-	d[16] = v1;
-
-#else
-
-	GSVector4i* s = (GSVector4i*)src;
-	GSVector4i* d = (GSVector4i*)clut;
-
-	GSVector4i v0 = s[0];
-	GSVector4i v1 = s[1];
-	GSVector4i v2 = s[2];
-	GSVector4i v3 = s[3];
-
-	GSVector4i::sw16(v0, v1, v2, v3);
-	GSVector4i::sw32(v0, v1, v2, v3);
-	GSVector4i::sw16(v0, v2, v1, v3);
-
-	d[0] = v0;
-	d[1] = v2;
-	d[32] = v1;
-	d[33] = v3;
-
-#endif
-}
-
-void GSClut::WriteCLUT_T16_I8_CSM1(const u16* RESTRICT src, u16* RESTRICT clut)
-{
-	// 2 blocks
-
-	GSVector4i* s = (GSVector4i*)src;
-	GSVector4i* d = (GSVector4i*)clut;
-
-	for (int i = 0; i < 32; i += 4)
-	{
-		GSVector4i v0 = s[i + 0];
-		GSVector4i v1 = s[i + 1];
-		GSVector4i v2 = s[i + 2];
-		GSVector4i v3 = s[i + 3];
-
-		GSVector4i::sw16(v0, v1, v2, v3);
-		GSVector4i::sw32(v0, v1, v2, v3);
-		GSVector4i::sw16(v0, v2, v1, v3);
-
-		d[i + 0] = v0;
-		d[i + 1] = v2;
-		d[i + 2] = v1;
-		d[i + 3] = v3;
-	}
-}
-
 __forceinline void GSClut::WriteCLUT_T16_I4_CSM1(const u16* RESTRICT src, u16* RESTRICT clut)
 {
 	// 1 block (half)
@@ -616,250 +546,6 @@ __forceinline void GSClut::WriteCLUT_T16_I4_CSM1(const u16* RESTRICT src, u16* R
 	}
 }
 
-void GSClut::ReadCLUT_T32_I8(const u16* RESTRICT clut, u32* RESTRICT dst, int offset)
-{
-	// Okay this deserves a small explanation
-	// T32 I8 can address up to 256 colors however the offset can be "more than zero" when reading
-	// Previously I assumed that it would wrap around the end of the buffer to the beginning
-	// but it turns out this is incorrect, the address doesn't mirror, it clamps to to the last offset,
-	// probably though some sort of addressing mechanism then picks the color from the lower 0xF of the requested CLUT entry.
-	// if we don't do this, the dirt on GTA SA goes transparent and actually cleans the car driving through dirt.
-	for (int i = 0; i < 256; i += 16)
-	{
-		// Min value + offet or Last CSA * 16 (240)
-		ReadCLUT_T32_I4(&clut[std::min((i + offset), 240)], &dst[i]);
-	}
-}
-
-__forceinline void GSClut::ReadCLUT_T32_I4(const u16* RESTRICT clut, u32* RESTRICT dst)
-{
-	GSVector4i* s = (GSVector4i*)clut;
-	GSVector4i* d = (GSVector4i*)dst;
-
-	GSVector4i v0 = s[0];
-	GSVector4i v1 = s[1];
-	GSVector4i v2 = s[32];
-	GSVector4i v3 = s[33];
-
-	GSVector4i::sw16(v0, v2, v1, v3);
-
-	d[0] = v0;
-	d[1] = v1;
-	d[2] = v2;
-	d[3] = v3;
-}
-
-#if 0
-__forceinline void GSClut::ReadCLUT_T32_I4(const u16* RESTRICT clut, u32* RESTRICT dst32, u64* RESTRICT dst64)
-{
-	GSVector4i* s = (GSVector4i*)clut;
-	GSVector4i* d32 = (GSVector4i*)dst32;
-	GSVector4i* d64 = (GSVector4i*)dst64;
-
-	GSVector4i s0 = s[0];
-	GSVector4i s1 = s[1];
-	GSVector4i s2 = s[32];
-	GSVector4i s3 = s[33];
-
-	GSVector4i::sw16(s0, s2, s1, s3);
-
-	d32[0] = s0;
-	d32[1] = s1;
-	d32[2] = s2;
-	d32[3] = s3;
-
-	ExpandCLUT64_T32(s0, s0, s1, s2, s3, &d64[0]);
-	ExpandCLUT64_T32(s1, s0, s1, s2, s3, &d64[32]);
-	ExpandCLUT64_T32(s2, s0, s1, s2, s3, &d64[64]);
-	ExpandCLUT64_T32(s3, s0, s1, s2, s3, &d64[96]);
-}
-#endif
-
-#if 0
-void GSClut::ReadCLUT_T16_I8(const u16* RESTRICT clut, u32* RESTRICT dst)
-{
-	for(int i = 0; i < 256; i += 16)
-	{
-		ReadCLUT_T16_I4(&clut[i], &dst[i]);
-	}
-}
-#endif
-
-#if 0
-__forceinline void GSClut::ReadCLUT_T16_I4(const u16* RESTRICT clut, u32* RESTRICT dst)
-{
-	GSVector4i* s = (GSVector4i*)clut;
-	GSVector4i* d = (GSVector4i*)dst;
-
-	GSVector4i v0 = s[0];
-	GSVector4i v1 = s[1];
-
-	d[0] = v0.upl16();
-	d[1] = v0.uph16();
-	d[2] = v1.upl16();
-	d[3] = v1.uph16();
-}
-#endif
-
-#if 0
-__forceinline void GSClut::ReadCLUT_T16_I4(const u16* RESTRICT clut, u32* RESTRICT dst32, u64* RESTRICT dst64)
-{
-	GSVector4i* s = (GSVector4i*)clut;
-	GSVector4i* d32 = (GSVector4i*)dst32;
-	GSVector4i* d64 = (GSVector4i*)dst64;
-
-	GSVector4i v0 = s[0];
-	GSVector4i v1 = s[1];
-
-	GSVector4i s0 = v0.upl16();
-	GSVector4i s1 = v0.uph16();
-	GSVector4i s2 = v1.upl16();
-	GSVector4i s3 = v1.uph16();
-
-	d32[0] = s0;
-	d32[1] = s1;
-	d32[2] = s2;
-	d32[3] = s3;
-
-	ExpandCLUT64_T16(s0, s0, s1, s2, s3, &d64[0]);
-	ExpandCLUT64_T16(s1, s0, s1, s2, s3, &d64[32]);
-	ExpandCLUT64_T16(s2, s0, s1, s2, s3, &d64[64]);
-	ExpandCLUT64_T16(s3, s0, s1, s2, s3, &d64[96]);
-}
-#endif
-
-void GSClut::ExpandCLUT64_T32_I8(const u32* RESTRICT src, u64* RESTRICT dst)
-{
-	GSVector4i* s = (GSVector4i*)src;
-	GSVector4i* d = (GSVector4i*)dst;
-
-	const GSVector4i s0 = s[0];
-	const GSVector4i s1 = s[1];
-	const GSVector4i s2 = s[2];
-	const GSVector4i s3 = s[3];
-
-	ExpandCLUT64_T32(s0, s0, s1, s2, s3, &d[0]);
-	ExpandCLUT64_T32(s1, s0, s1, s2, s3, &d[32]);
-	ExpandCLUT64_T32(s2, s0, s1, s2, s3, &d[64]);
-	ExpandCLUT64_T32(s3, s0, s1, s2, s3, &d[96]);
-}
-
-__forceinline void GSClut::ExpandCLUT64_T32(const GSVector4i& hi, const GSVector4i& lo0, const GSVector4i& lo1, const GSVector4i& lo2, const GSVector4i& lo3, GSVector4i* dst)
-{
-	ExpandCLUT64_T32(hi.xxxx(), lo0, &dst[0]);
-	ExpandCLUT64_T32(hi.xxxx(), lo1, &dst[2]);
-	ExpandCLUT64_T32(hi.xxxx(), lo2, &dst[4]);
-	ExpandCLUT64_T32(hi.xxxx(), lo3, &dst[6]);
-	ExpandCLUT64_T32(hi.yyyy(), lo0, &dst[8]);
-	ExpandCLUT64_T32(hi.yyyy(), lo1, &dst[10]);
-	ExpandCLUT64_T32(hi.yyyy(), lo2, &dst[12]);
-	ExpandCLUT64_T32(hi.yyyy(), lo3, &dst[14]);
-	ExpandCLUT64_T32(hi.zzzz(), lo0, &dst[16]);
-	ExpandCLUT64_T32(hi.zzzz(), lo1, &dst[18]);
-	ExpandCLUT64_T32(hi.zzzz(), lo2, &dst[20]);
-	ExpandCLUT64_T32(hi.zzzz(), lo3, &dst[22]);
-	ExpandCLUT64_T32(hi.wwww(), lo0, &dst[24]);
-	ExpandCLUT64_T32(hi.wwww(), lo1, &dst[26]);
-	ExpandCLUT64_T32(hi.wwww(), lo2, &dst[28]);
-	ExpandCLUT64_T32(hi.wwww(), lo3, &dst[30]);
-}
-
-__forceinline void GSClut::ExpandCLUT64_T32(const GSVector4i& hi, const GSVector4i& lo, GSVector4i* dst)
-{
-	dst[0] = lo.upl32(hi);
-	dst[1] = lo.uph32(hi);
-}
-
-#if 0
-void GSClut::ExpandCLUT64_T16_I8(const u32* RESTRICT src, u64* RESTRICT dst)
-{
-	GSVector4i* s = (GSVector4i*)src;
-	GSVector4i* d = (GSVector4i*)dst;
-
-	GSVector4i s0 = s[0];
-	GSVector4i s1 = s[1];
-	GSVector4i s2 = s[2];
-	GSVector4i s3 = s[3];
-
-	ExpandCLUT64_T16(s0, s0, s1, s2, s3, &d[0]);
-	ExpandCLUT64_T16(s1, s0, s1, s2, s3, &d[32]);
-	ExpandCLUT64_T16(s2, s0, s1, s2, s3, &d[64]);
-	ExpandCLUT64_T16(s3, s0, s1, s2, s3, &d[96]);
-}
-#endif
-
-__forceinline void GSClut::ExpandCLUT64_T16(const GSVector4i& hi, const GSVector4i& lo0, const GSVector4i& lo1, const GSVector4i& lo2, const GSVector4i& lo3, GSVector4i* dst)
-{
-	ExpandCLUT64_T16(hi.xxxx(), lo0, &dst[0]);
-	ExpandCLUT64_T16(hi.xxxx(), lo1, &dst[2]);
-	ExpandCLUT64_T16(hi.xxxx(), lo2, &dst[4]);
-	ExpandCLUT64_T16(hi.xxxx(), lo3, &dst[6]);
-	ExpandCLUT64_T16(hi.yyyy(), lo0, &dst[8]);
-	ExpandCLUT64_T16(hi.yyyy(), lo1, &dst[10]);
-	ExpandCLUT64_T16(hi.yyyy(), lo2, &dst[12]);
-	ExpandCLUT64_T16(hi.yyyy(), lo3, &dst[14]);
-	ExpandCLUT64_T16(hi.zzzz(), lo0, &dst[16]);
-	ExpandCLUT64_T16(hi.zzzz(), lo1, &dst[18]);
-	ExpandCLUT64_T16(hi.zzzz(), lo2, &dst[20]);
-	ExpandCLUT64_T16(hi.zzzz(), lo3, &dst[22]);
-	ExpandCLUT64_T16(hi.wwww(), lo0, &dst[24]);
-	ExpandCLUT64_T16(hi.wwww(), lo1, &dst[26]);
-	ExpandCLUT64_T16(hi.wwww(), lo2, &dst[28]);
-	ExpandCLUT64_T16(hi.wwww(), lo3, &dst[30]);
-}
-
-__forceinline void GSClut::ExpandCLUT64_T16(const GSVector4i& hi, const GSVector4i& lo, GSVector4i* dst)
-{
-	dst[0] = lo.upl16(hi);
-	dst[1] = lo.uph16(hi);
-}
-
-// TODO
-
-constinit const GSVector4i GSClut::m_bm = GSVector4i::cxpr(0x00007c00);
-constinit const GSVector4i GSClut::m_gm = GSVector4i::cxpr(0x000003e0);
-constinit const GSVector4i GSClut::m_rm = GSVector4i::cxpr(0x0000001f);
-
-void GSClut::Expand16(const u16* RESTRICT src, u32* RESTRICT dst, int w, const GIFRegTEXA& TEXA)
-{
-	pxAssert((w & 7) == 0);
-
-	const GSVector4i rm = m_rm;
-	const GSVector4i gm = m_gm;
-	const GSVector4i bm = m_bm;
-
-	const GSVector4i TA0(TEXA.TA0 << 24);
-	const GSVector4i TA1(TEXA.TA1 << 24);
-
-	GSVector4i c, cl, ch;
-
-	const GSVector4i* s = (const GSVector4i*)src;
-	GSVector4i* d = (GSVector4i*)dst;
-
-	if (!TEXA.AEM)
-	{
-		for (int i = 0, j = w >> 3; i < j; i++)
-		{
-			c = s[i];
-			cl = c.upl16(c);
-			ch = c.uph16(c);
-			d[i * 2 + 0] = ((cl & rm) << 3) | ((cl & gm) << 6) | ((cl & bm) << 9) | TA0.blend8(TA1, cl.sra16<15>());
-			d[i * 2 + 1] = ((ch & rm) << 3) | ((ch & gm) << 6) | ((ch & bm) << 9) | TA0.blend8(TA1, ch.sra16<15>());
-		}
-	}
-	else
-	{
-		for (int i = 0, j = w >> 3; i < j; i++)
-		{
-			c = s[i];
-			cl = c.upl16(c);
-			ch = c.uph16(c);
-			d[i * 2 + 0] = ((cl & rm) << 3) | ((cl & gm) << 6) | ((cl & bm) << 9) | TA0.blend8(TA1, cl.sra16<15>()).andnot(cl == GSVector4i::zero());
-			d[i * 2 + 1] = ((ch & rm) << 3) | ((ch & gm) << 6) | ((ch & bm) << 9) | TA0.blend8(TA1, ch.sra16<15>()).andnot(ch == GSVector4i::zero());
-		}
-	}
-}
-
 bool GSClut::WriteState::IsDirty(const GIFRegTEX0& TEX0, const GIFRegTEXCLUT& TEXCLUT)
 {
 	constexpr u64 mask = 0x1FFFFFE000000000ull; // CSA CSM CPSM CBP
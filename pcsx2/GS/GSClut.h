@@ -7,19 +7,34 @@
 #include "GSVector.h"
 #include "GSTables.h"
 #include "GSAlignedClass.h"
+#include "MultiISA.h"
 
 class GSLocalMemory;
 class GSTexture;
 
+/// Palette conversion kernels, compiled for each vector ISA and picked at startup
+struct GSClutKernels
+{
+	void (*WriteCLUT_T32_I8_CSM1)(const u32* RESTRICT src, u16* RESTRICT clut, u16 offset);
+	void (*WriteCLUT_T32_I4_CSM1)(const u32* RESTRICT src, u16* RESTRICT clut);
+	void (*WriteCLUT_T16_I8_CSM1)(const u16* RESTRICT src, u16* RESTRICT clut);
+	void (*ReadCLUT_T32_I8)(const u16* RESTRICT clut, u32* RESTRICT dst, int offset);
+	void (*ReadCLUT_T32_I4)(const u16* RESTRICT clut, u32* RESTRICT dst);
+	void (*ExpandCLUT64_T32_I8)(const u32* RESTRICT src, u64* RESTRICT dst);
+	void (*Expand16)(const u16* RESTRICT src, u32* RESTRICT dst, int w, const GIFRegTEXA& TEXA);
+};
+
+MULTI_ISA_DEF(void GSClutPopulateKernels(GSClutKernels& kernels);)
+
 class alignas(32) GSClut final : public GSAlignedClass<32>
 {
 	static constexpr u32 CLUT_ALLOC_SIZE = 4096 * 2;
 
-	static const GSVector4i m_bm;
-	static const GSVector4i m_gm;
-	static const GSVector4i m_rm;
+	/// Palette storage in front of m_buff32, including the mirrored area
+	static constexpr u32 CLUT_DATA_SIZE = 2048;
 
 	GSLocalMemory* m_mem;
+	GSClutKernels m_kernels;
 
 	u32 m_CBP[2] = {};
 	u16* m_clut = nullptr;
@@ -32,6 +47,7 @@ class alignas(32) GSClut final : public GSAlignedClass<32>
 		GIFRegTEXCLUT TEXCLUT;
 		u8 dirty;
 		u64 next_tex0;
+		u64 hash;
 		bool IsDirty(const GIFRegTEX0& TEX0, const GIFRegTEXCLUT& TEXCLUT);
 	} m_write = {};
 
@@ -70,27 +86,7 @@ class alignas(32) GSClut final : public GSAlignedClass<32>
 
 	void WriteCLUT_NULL(const GIFRegTEX0& TEX0, const GIFRegTEXCLUT& TEXCLUT);
 
-	static void WriteCLUT_T32_I8_CSM1(const u32* RESTRICT src, u16* RESTRICT clut, u16 offset);
-	static void WriteCLUT_T32_I4_CSM1(const u32* RESTRICT src, u16* RESTRICT clut);
-	static void WriteCLUT_T16_I8_CSM1(const u16* RESTRICT src, u16* RESTRICT clut);
 	static void WriteCLUT_T16_I4_CSM1(const u16* RESTRICT src, u16* RESTRICT clut);
-	static void ReadCLUT_T32_I8(const u16* RESTRICT clut, u32* RESTRICT dst, int offset);
-	static void ReadCLUT_T32_I4(const u16* RESTRICT clut, u32* RESTRICT dst);
-	//static void ReadCLUT_T32_I4(const u16* RESTRICT clut, u32* RESTRICT dst32, u64* RESTRICT dst64);
-	//static void ReadCLUT_T16_I8(const u16* RESTRICT clut, u32* RESTRICT dst);
-	//static void ReadCLUT_T16_I4(const u16* RESTRICT clut, u32* RESTRICT dst);
-	//static void ReadCLUT_T16_I4(const u16* RESTRICT clut, u32* RESTRICT dst32, u64* RESTRICT dst64);
-public:
-	static void ExpandCLUT64_T32_I8(const u32* RESTRICT src, u64* RESTRICT dst);
-
-private:
-	static void ExpandCLUT64_T32(const GSVector4i& hi, const GSVector4i& lo0, const GSVector4i& lo1, const GSVector4i& lo2, const GSVector4i& lo3, GSVector4i* dst);
-	static void ExpandCLUT64_T32(const GSVector4i& hi, const GSVector4i& lo, GSVector4i* dst);
-	//static void ExpandCLUT64_T16_I8(const u32* RESTRICT src, u64* RESTRICT dst);
-	static void ExpandCLUT64_T16(const GSVector4i& hi, const GSVector4i& lo0, const GSVector4i& lo1, const GSVector4i& lo2, const GSVector4i& lo3, GSVector4i* dst);
-	static void ExpandCLUT64_T16(const GSVector4i& hi, const GSVector4i& lo, GSVector4i* dst);
-
-	static void Expand16(const u16* RESTRICT src, u32* RESTRICT dst, int w, const GIFRegTEXA& TEXA);
 
 public:
 	GSClut(GSLocalMemory* mem);
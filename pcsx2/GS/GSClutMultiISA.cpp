@@ -0,0 +1,330 @@
+// SPDX-FileCopyrightText: 2002-2024 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#include "GS/GSClut.h"
+
+MULTI_ISA_UNSHARED_IMPL;
+
+#if _M_SSE >= 0x501
+static constexpr GSVector8i s_bm = GSVector8i::cxpr(0x00007c00);
+static constexpr GSVector8i s_gm = GSVector8i::cxpr(0x000003e0);
+static constexpr GSVector8i s_rm = GSVector8i::cxpr(0x0000001f);
+#else
+static constexpr GSVector4i s_bm = GSVector4i::cxpr(0x00007c00);
+static constexpr GSVector4i s_gm = GSVector4i::cxpr(0x000003e0);
+static constexpr GSVector4i s_rm = GSVector4i::cxpr(0x0000001f);
+#endif
+
+static __forceinline void WriteCLUT_T32_I4_CSM1(const u32* RESTRICT src, u16* RESTRICT clut)
+{
+	// 1 block
+
+#if _M_SSE >= 0x501
+
+	GSVector8i* s = (GSVector8i*)src;
+	GSVector8i* d = (GSVector8i*)clut;
+
+	GSVector8i v0 = s[0].acbd();
+	GSVector8i v1 = s[1].acbd();
+
+	GSVector8i::sw16(v0, v1);
+	GSVector8i::sw16(v0, v1);
+	GSVector8i::sw16(v0, v1);
+
+	d[0] = v0;
+	d[16] = v1;
+
+#else
+
+	GSVector4i* s = (GSVector4i*)src;
+	GSVector4i* d = (GSVector4i*)clut;
+
+	GSVector4i v0 = s[0];
+	GSVector4i v1 = s[1];
+	GSVector4i v2 = s[2];
+	GSVector4i v3 = s[3];
+
+	GSVector4i::sw16(v0, v1, v2, v3);
+	GSVector4i::sw32(v0, v1, v2, v3);
+	GSVector4i::sw16(v0, v2, v1, v3);
+
+	d[0] = v0;
+	d[1] = v2;
+	d[32] = v1;
+	d[33] = v3;
+
+#endif
+}
+
+static void WriteCLUT_T32_I8_CSM1(const u32* RESTRICT src, u16* RESTRICT clut, u16 offset)
+{
+	// This is required when CSA is offset from the base of the CLUT so we point to the right data
+	for (int i = offset; i < 16; i ++)
+	{
+		const int off = i << 4; // WriteCLUT_T32_I4_CSM1 loads 16 at a time
+		// Source column
+		const int s = clutTableT32I8[off & 0x70] | (off & 0x80);
+
+		WriteCLUT_T32_I4_CSM1(&src[s], &clut[off]);
+	}
+}
+
+static void WriteCLUT_T16_I8_CSM1(const u16* RESTRICT src, u16* RESTRICT clut)
+{
+	// 2 blocks
+
+#if _M_SSE >= 0x501
+
+	// Each 16 byte column gets its even and odd pairs split into dwords, then those get transposed across columns.
+	// Same result as the unpack chain below, with half the shuffles.
+
+	const GSVector8i split = GSVector8i::broadcast128(GSVector4i::cxpr8(0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15));
+	const GSVector8i order = GSVector8i::cxpr(0, 4, 1, 5, 2, 6, 3, 7);
+
+	GSVector8i* s = (GSVector8i*)src;
+	GSVector8i* d = (GSVector8i*)clut;
+
+	for (int i = 0; i < 16; i += 2)
+	{
+		const GSVector8i v0 = s[i + 0].shuffle8(split);
+		const GSVector8i v1 = s[i + 1].shuffle8(split);
+
+		d[i + 0] = v0.upl32(v1).permute32(order);
+		d[i + 1] = v0.uph32(v1).permute32(order);
+	}
+
+#else
+
+	GSVector4i* s = (GSVector4i*)src;
+	GSVector4i* d = (GSVector4i*)clut;
+
+	for (int i = 0; i < 32; i += 4)
+	{
+		GSVector4i v0 = s[i + 0];
+		GSVector4i v1 = s[i + 1];
+		GSVector4i v2 = s[i + 2];
+		GSVector4i v3 = s[i + 3];
+
+		GSVector4i::sw16(v0, v1, v2, v3);
+		GSVector4i::sw32(v0, v1, v2, v3);
+		GSVector4i::sw16(v0, v2, v1, v3);
+
+		d[i + 0] = v0;
+		d[i + 1] = v2;
+		d[i + 2] = v1;
+		d[i + 3] = v3;
+	}
+
+#endif
+}
+
+static __forceinline void ReadCLUT_T32_I4(const u16* RESTRICT clut, u32* RESTRICT dst)
+{
+#if _M_SSE >= 0x501
+
+	GSVector8i* s = (GSVector8i*)clut;
+	GSVector8i* d = (GSVector8i*)dst;
+
+	// Put the 64-bit halves of each 128-bit lane next to each other, so the in-lane unpacks come out in order
+	const GSVector8i lo = s[0].acbd();
+	const GSVector8i hi = s[16].acbd();
+
+	d[0] = lo.upl16(hi);
+	d[1] = lo.uph16(hi);
+
+#else
+
+	GSVector4i* s = (GSVector4i*)clut;
+	GSVector4i* d = (GSVector4i*)dst;
+
+	GSVector4i v0 = s[0];
+	GSVector4i v1 = s[1];
+	GSVector4i v2 = s[32];
+	GSVector4i v3 = s[33];
+
+	GSVector4i::sw16(v0, v2, v1, v3);
+
+	d[0] = v0;
+	d[1] = v1;
+	d[2] = v2;
+	d[3] = v3;
+
+#endif
+}
+
+static void ReadCLUT_T32_I8(const u16* RESTRICT clut, u32* RESTRICT dst, int offset)
+{
+	// Okay this deserves a small explanation
+	// T32 I8 can address up to 256 colors however the offset can be "more than zero" when reading
+	// Previously I assumed that it would wrap around the end of the buffer to the beginning
+	// but it turns out this is incorrect, the address doesn't mirror, it clamps to to the last offset,
+	// probably though some sort of addressing mechanism then picks the color from the lower 0xF of the requested CLUT entry.
+	// if we don't do this, the dirt on GTA SA goes transparent and actually cleans the car driving through dirt.
+	for (int i = 0; i < 256; i += 16)
+	{
+		// Min value + offet or Last CSA * 16 (240)
+		ReadCLUT_T32_I4(&clut[std::min((i + offset), 240)], &dst[i]);
+	}
+}
+
+#if _M_SSE < 0x501
+
+static __forceinline void ExpandCLUT64_T32(const GSVector4i& hi, const GSVector4i& lo, GSVector4i* dst)
+{
+	dst[0] = lo.upl32(hi);
+	dst[1] = lo.uph32(hi);
+}
+
+static __forceinline void ExpandCLUT64_T32(const GSVector4i& hi, const GSVector4i& lo0, const GSVector4i& lo1, const GSVector4i& lo2, const GSVector4i& lo3, GSVector4i* dst)
+{
+	ExpandCLUT64_T32(hi.xxxx(), lo0, &dst[0]);
+	ExpandCLUT64_T32(hi.xxxx(), lo1, &dst[2]);
+	ExpandCLUT64_T32(hi.xxxx(), lo2, &dst[4]);
+	ExpandCLUT64_T32(hi.xxxx(), lo3, &dst[6]);
+	ExpandCLUT64_T32(hi.yyyy(), lo0, &dst[8]);
+	ExpandCLUT64_T32(hi.yyyy(), lo1, &dst[10]);
+	ExpandCLUT64_T32(hi.yyyy(), lo2, &dst[12]);
+	ExpandCLUT64_T32(hi.yyyy(), lo3, &dst[14]);
+	ExpandCLUT64_T32(hi.zzzz(), lo0, &dst[16]);
+	ExpandCLUT64_T32(hi.zzzz(), lo1, &dst[18]);
+	ExpandCLUT64_T32(hi.zzzz(), lo2, &dst[20]);
+	ExpandCLUT64_T32(hi.zzzz(), lo3, &dst[22]);
+	ExpandCLUT64_T32(hi.wwww(), lo0, &dst[24]);
+	ExpandCLUT64_T32(hi.wwww(), lo1, &dst[26]);
+	ExpandCLUT64_T32(hi.wwww(), lo2, &dst[28]);
+	ExpandCLUT64_T32(hi.wwww(), lo3, &dst[30]);
+}
+
+#endif
+
+static void ExpandCLUT64_T32_I8(const u32* RESTRICT src, u64* RESTRICT dst)
+{
+#if _M_SSE >= 0x501
+
+	GSVector8i* s = (GSVector8i*)src;
+	GSVector8i* d = (GSVector8i*)dst;
+
+	const GSVector8i lo0 = s[0].acbd();
+	const GSVector8i lo1 = s[1].acbd();
+
+	for (int i = 0; i < 16; i++, d += 4)
+	{
+		const GSVector8i hi = GSVector8i::broadcast32(&src[i]);
+
+		d[0] = lo0.upl32(hi);
+		d[1] = lo0.uph32(hi);
+		d[2] = lo1.upl32(hi);
+		d[3] = lo1.uph32(hi);
+	}
+
+#else
+
+	GSVector4i* s = (GSVector4i*)src;
+	GSVector4i* d = (GSVector4i*)dst;
+
+	const GSVector4i s0 = s[0];
+	const GSVector4i s1 = s[1];
+	const GSVector4i s2 = s[2];
+	const GSVector4i s3 = s[3];
+
+	ExpandCLUT64_T32(s0, s0, s1, s2, s3, &d[0]);
+	ExpandCLUT64_T32(s1, s0, s1, s2, s3, &d[32]);
+	ExpandCLUT64_T32(s2, s0, s1, s2, s3, &d[64]);
+	ExpandCLUT64_T32(s3, s0, s1, s2, s3, &d[96]);
+
+#endif
+}
+
+static void Expand16(const u16* RESTRICT src, u32* RESTRICT dst, int w, const GIFRegTEXA& TEXA)
+{
+#if _M_SSE >= 0x501
+
+	pxAssert((w & 15) == 0);
+
+	const GSVector8i rm = s_rm;
+	const GSVector8i gm = s_gm;
+	const GSVector8i bm = s_bm;
+
+	const GSVector8i TA0(TEXA.TA0 << 24);
+	const GSVector8i TA1(TEXA.TA1 << 24);
+
+	GSVector8i c, cl, ch;
+
+	const GSVector8i* s = (const GSVector8i*)src;
+	GSVector8i* d = (GSVector8i*)dst;
+
+	if (!TEXA.AEM)
+	{
+		for (int i = 0, j = w >> 4; i < j; i++)
+		{
+			c = s[i].acbd();
+			cl = c.upl16(c);
+			ch = c.uph16(c);
+			d[i * 2 + 0] = ((cl & rm) << 3) | ((cl & gm) << 6) | ((cl & bm) << 9) | TA0.blend8(TA1, cl.sra16<15>());
+			d[i * 2 + 1] = ((ch & rm) << 3) | ((ch & gm) << 6) | ((ch & bm) << 9) | TA0.blend8(TA1, ch.sra16<15>());
+		}
+	}
+	else
+	{
+		for (int i = 0, j = w >> 4; i < j; i++)
+		{
+			c = s[i].acbd();
+			cl = c.upl16(c);
+			ch = c.uph16(c);
+			d[i * 2 + 0] = ((cl & rm) << 3) | ((cl & gm) << 6) | ((cl & bm) << 9) | TA0.blend8(TA1, cl.sra16<15>()).andnot(cl == GSVector8i::zero());
+			d[i * 2 + 1] = ((ch & rm) << 3) | ((ch & gm) << 6) | ((ch & bm) << 9) | TA0.blend8(TA1, ch.sra16<15>()).andnot(ch == GSVector8i::zero());
+		}
+	}
+
+#else
+
+	pxAssert((w & 7) == 0);
+
+	const GSVector4i rm = s_rm;
+	const GSVector4i gm = s_gm;
+	const GSVector4i bm = s_bm;
+
+	const GSVector4i TA0(TEXA.TA0 << 24);
+	const GSVector4i TA1(TEXA.TA1 << 24);
+
+	GSVector4i c, cl, ch;
+
+	const GSVector4i* s = (const GSVector4i*)src;
+	GSVector4i* d = (GSVector4i*)dst;
+
+	if (!TEXA.AEM)
+	{
+		for (int i = 0, j = w >> 3; i < j; i++)
+		{
+			c = s[i];
+			cl = c.upl16(c);
+			ch = c.uph16(c);
+			d[i * 2 + 0] = ((cl & rm) << 3) | ((cl & gm) << 6) | ((cl & bm) << 9) | TA0.blend8(TA1, cl.sra16<15>());
+			d[i * 2 + 1] = ((ch & rm) << 3) | ((ch & gm) << 6) | ((ch & bm) << 9) | TA0.blend8(TA1, ch.sra16<15>());
+		}
+	}
+	else
+	{
+		for (int i = 0, j = w >> 3; i < j; i++)
+		{
+			c = s[i];
+			cl = c.upl16(c);
+			ch = c.uph16(c);
+			d[i * 2 + 0] = ((cl & rm) << 3) | ((cl & gm) << 6) | ((cl & bm) << 9) | TA0.blend8(TA1, cl.sra16<15>()).andnot(cl == GSVector4i::zero());
+			d[i * 2 + 1] = ((ch & rm) << 3) | ((ch & gm) << 6) | ((ch & bm) << 9) | TA0.blend8(TA1, ch.sra16<15>()).andnot(ch == GSVector4i::zero());
+		}
+	}
+
+#endif
+}
+
+void CURRENT_ISA::GSClutPopulateKernels(GSClutKernels& kernels)
+{
+	kernels.WriteCLUT_T32_I8_CSM1 = WriteCLUT_T32_I8_CSM1;
+	kernels.WriteCLUT_T32_I4_CSM1 = WriteCLUT_T32_I4_CSM1;
+	kernels.WriteCLUT_T16_I8_CSM1 = WriteCLUT_T16_I8_CSM1;
+	kernels.ReadCLUT_T32_I8 = ReadCLUT_T32_I8;
+	kernels.ReadCLUT_T32_I4 = ReadCLUT_T32_I4;
+	kernels.ExpandCLUT64_T32_I8 = ExpandCLUT64_T32_I8;
+	kernels.Expand16 = Expand16;
+}
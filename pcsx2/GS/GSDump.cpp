@@ -77,6 +77,7 @@ void GSDumpBase::Transfer(int index, const u8* mem, size_t size)
 	AppendRawData(static_cast<u8>(index));
 	AppendRawData(&size, 4);
 	AppendRawData(mem, size);
+	PacketWritten(false);
 }
 
 void GSDumpBase::ReadFIFO(u32 size)
@@ -86,6 +87,7 @@ void GSDumpBase::ReadFIFO(u32 size)
 
 	AppendRawData(2);
 	AppendRawData(&size, 4);
+	PacketWritten(false);
 }
 
 bool GSDumpBase::VSync(int field, bool last, const GSPrivRegSet* regs)
@@ -96,9 +98,11 @@ bool GSDumpBase::VSync(int field, bool last, const GSPrivRegSet* regs)
 
 	AppendRawData(3);
 	AppendRawData(regs, sizeof(*regs));
+	PacketWritten(false);
 
 	AppendRawData(1);
 	AppendRawData(static_cast<u8>(field));
+	PacketWritten(true);
 
 	if (last)
 		m_extra_frames--;
@@ -313,15 +317,33 @@ namespace
 {
 	class GSDumpZst final : public GSDumpBase
 	{
-		ZSTD_CStream* m_strm;
+		// Chunks are cut at the first vsync after this much data, or at any packet past the maximum.
+		static constexpr size_t CHUNK_SIZE = 2 * _1mb;
+		static constexpr size_t MAX_CHUNK_SIZE = 8 * _1mb;
+
+		struct Chunk
+		{
+			u32 compressed_size;
+			u32 uncompressed_size;
+			u32 num_packets;
+		};
+
+		ZSTD_CCtx* m_cctx;
 
 		std::vector<u8> m_in_buff;
 		std::vector<u8> m_out_buff;
 
-		void MayFlush();
-		void Compress(ZSTD_EndDirective action);
+		std::vector<Chunk> m_chunks;
+		std::vector<u32> m_vsync_packets;
+		u32 m_chunk_packets = 0;
+		u32 m_total_packets = 0;
+		u64 m_file_offset = 0;
+
+		void Compress();
+		void WritePacketIndex();
 		void AppendRawData(const void* data, size_t size);
 		void AppendRawData(u8 c);
+		void PacketWritten(bool vsync);
 
 	public:
 		GSDumpZst(const std::string& fn, const std::string& serial, u32 crc,
@@ -335,23 +357,24 @@ namespace
 		const freezeData& fd, const GSPrivRegSet* regs)
 		: GSDumpBase(fn + ".gs.zst")
 	{
-		m_strm = ZSTD_createCStream();
+		m_cctx = ZSTD_createCCtx();
 
 		// Compression level 6 provides a good balance between speed and ratio.
-		ZSTD_CCtx_setParameter(m_strm, ZSTD_c_compressionLevel, 6);
+		ZSTD_CCtx_setParameter(m_cctx, ZSTD_c_compressionLevel, 6);
 
-		m_in_buff.reserve(_1mb);
-		m_out_buff.resize(_1mb);
+		m_in_buff.reserve(CHUNK_SIZE);
 
+		// Header gets its own chunk, so the packets can be decompressed without it.
 		AddHeader(serial, crc, screenshot_width, screenshot_height, screenshot_pixels, fd, regs);
+		Compress();
 	}
 
 	GSDumpZst::~GSDumpZst()
 	{
-		// Finish the stream
-		Compress(ZSTD_e_end);
+		Compress();
+		WritePacketIndex();
 
-		ZSTD_freeCStream(m_strm);
+		ZSTD_freeCCtx(m_cctx);
 	}
 
 	void GSDumpZst::AppendRawData(const void* data, size_t size)
@@ -359,61 +382,116 @@ namespace
 		size_t old_size = m_in_buff.size();
 		m_in_buff.resize(old_size + size);
 		memcpy(&m_in_buff[old_size], data, size);
-		MayFlush();
 	}
 
 	void GSDumpZst::AppendRawData(u8 c)
 	{
 		m_in_buff.push_back(c);
-		MayFlush();
 	}
 
-	void GSDumpZst::MayFlush()
+	void GSDumpZst::PacketWritten(bool vsync)
 	{
-		if (m_in_buff.size() >= _1mb)
-			Compress(ZSTD_e_continue);
+		if (vsync)
+			m_vsync_packets.push_back(m_total_packets);
+
+		m_chunk_packets++;
+		m_total_packets++;
+
+		if ((vsync && m_in_buff.size() >= CHUNK_SIZE) || m_in_buff.size() >= MAX_CHUNK_SIZE)
+			Compress();
 	}
 
-	void GSDumpZst::Compress(ZSTD_EndDirective action)
+	void GSDumpZst::Compress()
 	{
 		if (m_in_buff.empty())
 			return;
 
-		ZSTD_inBuffer inbuf = {m_in_buff.data(), m_in_buff.size(), 0};
-
-		for (;;)
+		m_out_buff.resize(ZSTD_compressBound(m_in_buff.size()));
+		const size_t compressed_size = ZSTD_compress2(m_cctx, m_out_buff.data(), m_out_buff.size(), m_in_buff.data(), m_in_buff.size());
+		if (ZSTD_isError(compressed_size))
 		{
-			ZSTD_outBuffer outbuf = {m_out_buff.data(), m_out_buff.size(), 0};
-
-			const size_t remaining = ZSTD_compressStream2(m_strm, &outbuf, &inbuf, action);
-			if (ZSTD_isError(remaining))
-			{
-				Console.ErrorFmt("GSDumpZstd: Error {}", ZSTD_getErrorName(remaining));
-				return;
-			}
-
-			if (outbuf.pos > 0)
-			{
-				Write(m_out_buff.data(), outbuf.pos);
-				outbuf.pos = 0;
-			}
-
-			if (action == ZSTD_e_end)
-			{
-				// break when compression output has finished
-				if (remaining == 0)
-					break;
-			}
-			else
-			{
-				// break when all input data is consumed
-				if (inbuf.pos == inbuf.size)
-					break;
-			}
+			Console.ErrorFmt("GSDumpZstd: Error {}", ZSTD_getErrorName(compressed_size));
+			return;
 		}
 
+		Write(m_out_buff.data(), compressed_size);
+		m_chunks.push_back({static_cast<u32>(compressed_size), static_cast<u32>(m_in_buff.size()), m_chunk_packets});
+		m_file_offset += compressed_size;
+		m_chunk_packets = 0;
+
 		m_in_buff.clear();
 	}
+
+	void GSDumpZst::WritePacketIndex()
+	{
+		std::vector<u8> content;
+		const auto append = [&content](const void* data, size_t size) {
+			const size_t pos = content.size();
+			content.resize(pos + size);
+			std::memcpy(&content[pos], data, size);
+		};
+		const auto append_u32 = [&append](u32 value) { append(&value, sizeof(value)); };
+
+		// Wrapped in a dummy transfer, which replaying skips over.
+		const u8 packet_header[2] = {0, static_cast<u8>(GSDumpTypes::GSTransferPath::Dummy)};
+		append(packet_header, sizeof(packet_header));
+		append_u32(0);
+
+		append_u32(GS_DUMP_PACKET_INDEX_VERSION);
+		append_u32(static_cast<u32>(m_chunks.size()));
+		for (const Chunk& chunk : m_chunks)
+		{
+			append_u32(chunk.compressed_size);
+			append_u32(chunk.uncompressed_size);
+			append_u32(chunk.num_packets);
+		}
+		append_u32(static_cast<u32>(m_vsync_packets.size()));
+		append(m_vsync_packets.data(), m_vsync_packets.size() * sizeof(u32));
+
+		// Written as a frame of raw blocks by hand, so the footer is readable at the end of the file.
+		// Everything but the footer goes in the leading blocks, the footer is the last block.
+		static constexpr size_t FRAME_HEADER_SIZE = 4 + 1 + 8;
+		static constexpr size_t BLOCK_HEADER_SIZE = 3;
+		const u32 transfer_size = static_cast<u32>(content.size() - sizeof(packet_header) - sizeof(u32) + sizeof(GSDumpPacketIndexFooter));
+		std::memcpy(&content[sizeof(packet_header)], &transfer_size, sizeof(transfer_size));
+
+		const size_t leading_blocks = (content.size() + ZSTD_BLOCKSIZE_MAX - 1) / ZSTD_BLOCKSIZE_MAX;
+		const size_t content_size = content.size() + sizeof(GSDumpPacketIndexFooter);
+		const size_t frame_size = FRAME_HEADER_SIZE + (leading_blocks + 1) * BLOCK_HEADER_SIZE + content_size;
+
+		GSDumpPacketIndexFooter footer;
+		footer.index_offset = m_file_offset;
+		footer.index_size = static_cast<u32>(frame_size);
+		footer.magic = GS_DUMP_PACKET_INDEX_MAGIC;
+
+		std::vector<u8> frame;
+		frame.reserve(frame_size);
+		const auto write_frame = [&frame](const void* data, size_t size) {
+			const u8* bytes = static_cast<const u8*>(data);
+			frame.insert(frame.end(), bytes, bytes + size);
+		};
+		const auto write_block = [&write_frame](const void* data, size_t size, bool last) {
+			// Raw block: last flag, type 0, 21-bit size.
+			const u32 header = (last ? 1u : 0u) | (static_cast<u32>(size) << 3);
+			const u8 header_bytes[BLOCK_HEADER_SIZE] = {static_cast<u8>(header), static_cast<u8>(header >> 8), static_cast<u8>(header >> 16)};
+			write_frame(header_bytes, sizeof(header_bytes));
+			write_frame(data, size);
+		};
+
+		// Single segment with an 8 byte content size, no checksum or dictionary.
+		const u32 magic = ZSTD_MAGICNUMBER;
+		const u8 descriptor = 0xE0;
+		const u64 frame_content_size = content_size;
+		write_frame(&magic, sizeof(magic));
+		write_frame(&descriptor, sizeof(descriptor));
+		write_frame(&frame_content_size, sizeof(frame_content_size));
+		for (size_t pos = 0; pos < content.size(); pos += ZSTD_BLOCKSIZE_MAX)
+			write_block(&content[pos], std::min<size_t>(content.size() - pos, ZSTD_BLOCKSIZE_MAX), false);
+		write_block(&footer, sizeof(footer), true);
+		pxAssert(frame.size() == frame_size);
+
+		Write(frame.data(), frame.size());
+	}
 } // namespace
 
 std::unique_ptr<GSDumpBase> GSDumpBase::CreateZstDump(
@@ -24,6 +24,14 @@ ReadFIFO2 data (id == 2)
 Regs data (id == 3)
 - [PMODE/0x2000]
 
+Zstandard dumps are compressed in independent frames, which always end on a packet boundary. The header and
+state are in the first frame. The last frame holds a transfer on the dummy path, which older versions skip
+when replaying, containing the packet index:
+- [version/4] [chunk count/4] [[compressed size/4] [uncompressed size/4] [packet count/4]] ..
+- [vsync count/4] [packet number of each vsync/4] ..
+- [GSDumpPacketIndexFooter]
+The index frame is stored uncompressed, with the footer in its own block, so the footer is the end of the file.
+
 */
 
 #pragma pack(push, 4)
@@ -39,8 +47,18 @@ struct GSDumpHeader
 	u32 screenshot_offset;
 	u32 screenshot_size;
 };
+
+struct GSDumpPacketIndexFooter
+{
+	u64 index_offset; ///< File offset of the zstd frame holding the packet index.
+	u32 index_size;
+	u32 magic;
+};
 #pragma pack(pop)
 
+static constexpr u32 GS_DUMP_PACKET_INDEX_MAGIC = 0x58444950; // PIDX
+static constexpr u32 GS_DUMP_PACKET_INDEX_VERSION = 1;
+
 class GSDumpBase
 {
 	FILE* m_gs;
@@ -57,6 +75,9 @@ protected:
 	virtual void AppendRawData(const void* data, size_t size) = 0;
 	virtual void AppendRawData(u8 c) = 0;
 
+	/// Called after each complete packet, so formats which are split into chunks can split on packet boundaries.
+	virtual void PacketWritten(bool vsync) {}
+
 public:
 	GSDumpBase(std::string fn);
 	virtual ~GSDumpBase();
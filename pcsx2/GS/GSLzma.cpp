@@ -8,6 +8,7 @@
 #include "common/BitUtils.h"
 #include "common/Error.h"
 #include "common/HeapArray.h"
+#include "common/Threading.h"
 
 #include "GS/GSDump.h"
 #include "GS/GSLzma.h"
@@ -19,7 +20,10 @@
 #include <XzCrc64.h>
 #include <zstd.h>
 
+#include <algorithm>
+#include <condition_variable>
 #include <mutex>
+#include <thread>
 
 using namespace GSDumpTypes;
 
@@ -126,6 +130,11 @@ bool GSDumpFile::ReadFile(Error* error)
 		return false;
 	}
 
+	return ReadPackets(error);
+}
+
+bool GSDumpFile::ReadPackets(Error* error)
+{
 	// read all the packet data in
 	// TODO: make this suck less by getting the full/extracted size and preallocating
 	for (;;)
@@ -149,8 +158,29 @@ bool GSDumpFile::ReadFile(Error* error)
 		}
 	}
 
-	u8* data = m_packet_data.data();
-	size_t remaining = m_packet_data.size();
+	if (!ParsePackets(m_packet_data.data(), m_packet_data.size(), &m_dump_packets, error))
+		return false;
+
+	for (size_t i = 0; i < m_dump_packets.size(); i++)
+	{
+		if (m_dump_packets[i].id == GSType::VSync)
+			m_vsync_packets.push_back(static_cast<u32>(i));
+	}
+
+	m_ready_packets_start = 0;
+	m_ready_packets_count = m_dump_packets.size();
+	return true;
+}
+
+void GSDumpFile::WaitForPacket(size_t index)
+{
+	// Everything is read up front.
+	pxFailRel("Packet out of range");
+}
+
+bool GSDumpFile::ParsePackets(u8* data, size_t size, GSDataArray* packets, Error* error)
+{
+	size_t remaining = size;
 
 #define GET_BYTE(dst) \
 	do \
@@ -220,7 +250,7 @@ bool GSDumpFile::ReadFile(Error* error)
 			remaining -= packet.length;
 		}
 
-		m_dump_packets.push_back(std::move(packet));
+		packets->push_back(std::move(packet));
 	}
 
 #undef GET_WORD
@@ -577,6 +607,334 @@ namespace
 
 	/******************************************************************/
 
+	class GSDumpSeekableZst final : public GSDumpFile
+	{
+	public:
+		GSDumpSeekableZst();
+		~GSDumpSeekableZst() override;
+
+		/// Returns true if the file ends with a packet index footer.
+		static bool HasPacketIndex(std::FILE* fp);
+
+	protected:
+		bool Open(FileSystem::ManagedCFilePtr fp, Error* error) override;
+		bool IsEof() override;
+		size_t Read(void* ptr, size_t size) override;
+		bool ReadPackets(Error* error) override;
+		void WaitForPacket(size_t index) override;
+
+	private:
+		static constexpr u32 NO_CHUNK = 0xFFFFFFFFu;
+
+		struct Chunk
+		{
+			u64 file_offset;
+			u32 compressed_size;
+			u32 uncompressed_size;
+			u32 first_packet;
+			u32 num_packets;
+			DynamicHeapArray<u8, 64> data;
+			bool ready; // protected by m_mutex
+		};
+
+		bool ReadPacketIndex(const GSDumpPacketIndexFooter& footer, u64 file_size, Error* error);
+		bool DecompressChunk(ZSTD_DCtx* dctx, u32 index, DynamicHeapArray<u8, 64>* buffer, Error* error);
+		void LoadChunk(ZSTD_DCtx* dctx, u32 index, DynamicHeapArray<u8, 64>* buffer, GSDataArray* packets);
+		void DecompressThread();
+
+		// First chunk is the header, which is decompressed when opening.
+		std::vector<Chunk> m_chunks;
+		size_t m_header_pos = 0;
+
+		std::thread m_thread;
+		std::mutex m_mutex;
+		std::condition_variable m_work_cv;
+		std::condition_variable m_ready_cv;
+		u32 m_next_chunk = 1;
+		u32 m_requested_chunk = NO_CHUNK;
+		bool m_shutdown = false;
+	};
+
+	GSDumpSeekableZst::GSDumpSeekableZst() = default;
+
+	GSDumpSeekableZst::~GSDumpSeekableZst()
+	{
+		if (m_thread.joinable())
+		{
+			{
+				std::unique_lock lock(m_mutex);
+				m_shutdown = true;
+				m_work_cv.notify_one();
+			}
+			m_thread.join();
+		}
+	}
+
+	bool GSDumpSeekableZst::HasPacketIndex(std::FILE* fp)
+	{
+		GSDumpPacketIndexFooter footer;
+		const bool result = (FileSystem::FSeek64(fp, -static_cast<s64>(sizeof(footer)), SEEK_END) == 0 &&
+							 std::fread(&footer, sizeof(footer), 1, fp) == 1 && footer.magic == GS_DUMP_PACKET_INDEX_MAGIC);
+		FileSystem::FSeek64(fp, 0, SEEK_SET);
+		return result;
+	}
+
+	bool GSDumpSeekableZst::Open(FileSystem::ManagedCFilePtr fp, Error* error)
+	{
+		m_fp = std::move(fp);
+
+		const s64 file_size = FileSystem::FSize64(m_fp.get());
+		GSDumpPacketIndexFooter footer;
+		if (file_size < static_cast<s64>(sizeof(footer)) ||
+			FileSystem::FSeek64(m_fp.get(), file_size - static_cast<s64>(sizeof(footer)), SEEK_SET) != 0 ||
+			std::fread(&footer, sizeof(footer), 1, m_fp.get()) != 1)
+		{
+			Error::SetString(error, "Failed to read packet index footer");
+			return false;
+		}
+
+		if (!ReadPacketIndex(footer, static_cast<u64>(file_size), error))
+			return false;
+
+		ZSTD_DCtx* dctx = ZSTD_createDCtx();
+		DynamicHeapArray<u8, 64> buffer;
+		const bool result = DecompressChunk(dctx, 0, &buffer, error);
+		ZSTD_freeDCtx(dctx);
+		if (!result)
+			return false;
+
+		DevCon.WriteLnFmt("Seekable zstd dump has {} packets across {} chunks", m_dump_packets.size(), m_chunks.size() - 1);
+		return true;
+	}
+
+	bool GSDumpSeekableZst::ReadPacketIndex(const GSDumpPacketIndexFooter& footer, u64 file_size, Error* error)
+	{
+		if (footer.index_offset >= file_size || footer.index_size > (file_size - footer.index_offset))
+		{
+			Error::SetString(error, "Packet index is out of range");
+			return false;
+		}
+
+		DynamicHeapArray<u8, 64> frame(footer.index_size);
+		if (FileSystem::FSeek64(m_fp.get(), static_cast<s64>(footer.index_offset), SEEK_SET) != 0 ||
+			std::fread(frame.data(), frame.size(), 1, m_fp.get()) != 1)
+		{
+			Error::SetString(error, "Failed to read packet index");
+			return false;
+		}
+
+		const unsigned long long content_size = ZSTD_getFrameContentSize(frame.data(), frame.size());
+		if (content_size == ZSTD_CONTENTSIZE_UNKNOWN || content_size == ZSTD_CONTENTSIZE_ERROR || content_size > frame.size())
+		{
+			Error::SetString(error, "Packet index frame is corrupted");
+			return false;
+		}
+
+		DynamicHeapArray<u8, 64> content(static_cast<size_t>(content_size));
+		const size_t decompressed = ZSTD_decompress(content.data(), content.size(), frame.data(), frame.size());
+		if (ZSTD_isError(decompressed) || decompressed != content.size())
+		{
+			Error::SetString(error, "Failed to decompress packet index");
+			return false;
+		}
+
+		// Skip over the dummy transfer header, and leave the footer off the end.
+		const u8* data = content.data() + sizeof(u8) * 2 + sizeof(u32);
+		size_t remaining = content.size() - std::min(content.size(), sizeof(u8) * 2 + sizeof(u32) + sizeof(footer));
+		const auto get_u32 = [&data, &remaining](u32* value) {
+			if (remaining < sizeof(u32))
+				return false;
+			std::memcpy(value, data, sizeof(u32));
+			data += sizeof(u32);
+			remaining -= sizeof(u32);
+			return true;
+		};
+
+		u32 version, num_chunks;
+		if (!get_u32(&version) || version != GS_DUMP_PACKET_INDEX_VERSION || !get_u32(&num_chunks) || num_chunks == 0 ||
+			num_chunks > (remaining / (sizeof(u32) * 3)))
+		{
+			Error::SetString(error, "Unsupported packet index");
+			return false;
+		}
+
+		m_chunks = std::vector<Chunk>(num_chunks);
+		u64 file_offset = 0;
+		u32 total_packets = 0;
+		for (Chunk& chunk : m_chunks)
+		{
+			get_u32(&chunk.compressed_size);
+			get_u32(&chunk.uncompressed_size);
+			get_u32(&chunk.num_packets);
+			chunk.file_offset = file_offset;
+			chunk.first_packet = total_packets;
+			chunk.ready = false;
+			file_offset += chunk.compressed_size;
+			total_packets += chunk.num_packets;
+		}
+
+		u32 num_vsyncs;
+		if (file_offset != footer.index_offset || m_chunks[0].num_packets != 0 || !get_u32(&num_vsyncs) ||
+			num_vsyncs != (remaining / sizeof(u32)))
+		{
+			Error::SetString(error, "Packet index is corrupted");
+			return false;
+		}
+
+		m_vsync_packets.resize(num_vsyncs);
+		for (u32& packet : m_vsync_packets)
+		{
+			get_u32(&packet);
+			if (packet >= total_packets)
+			{
+				Error::SetString(error, "Packet index is corrupted");
+				return false;
+			}
+		}
+
+		m_dump_packets.resize(total_packets);
+		return true;
+	}
+
+	bool GSDumpSeekableZst::DecompressChunk(ZSTD_DCtx* dctx, u32 index, DynamicHeapArray<u8, 64>* buffer, Error* error)
+	{
+		Chunk& chunk = m_chunks[index];
+		if (buffer->size() < chunk.compressed_size)
+			buffer->resize(Common::AlignUpPow2(chunk.compressed_size, _128kb));
+
+		if (FileSystem::FSeek64(m_fp.get(), static_cast<s64>(chunk.file_offset), SEEK_SET) != 0 ||
+			std::fread(buffer->data(), chunk.compressed_size, 1, m_fp.get()) != 1)
+		{
+			Error::SetStringFmt(error, "Failed to read {} bytes from offset {}", chunk.compressed_size, chunk.file_offset);
+			return false;
+		}
+
+		chunk.data.resize(chunk.uncompressed_size);
+		const size_t decompressed = ZSTD_decompressDCtx(dctx, chunk.data.data(), chunk.data.size(), buffer->data(), chunk.compressed_size);
+		if (ZSTD_isError(decompressed) || decompressed != chunk.uncompressed_size) [[unlikely]]
+		{
+			Error::SetStringFmt(error, "Failed to decompress chunk {}: {}", index,
+				ZSTD_isError(decompressed) ? ZSTD_getErrorName(decompressed) : "size mismatch");
+			return false;
+		}
+
+		return true;
+	}
+
+	void GSDumpSeekableZst::LoadChunk(ZSTD_DCtx* dctx, u32 index, DynamicHeapArray<u8, 64>* buffer, GSDataArray* packets)
+	{
+		Chunk& chunk = m_chunks[index];
+		GSData* out = &m_dump_packets[chunk.first_packet];
+
+		Error error;
+		packets->clear();
+		if (DecompressChunk(dctx, index, buffer, &error) && ParsePackets(chunk.data.data(), chunk.data.size(), packets, &error))
+		{
+			if (packets->size() == chunk.num_packets)
+			{
+				std::copy(packets->begin(), packets->end(), out);
+				return;
+			}
+
+			Error::SetStringFmt(&error, "Index expects {} packets, chunk has {}", chunk.num_packets, packets->size());
+		}
+
+		// Replaying can't stop partway, so turn the chunk into no-ops rather than leaving holes.
+		Console.ErrorFmt("(GSDump) Dropping {} packets in chunk {}: {}", chunk.num_packets, index, error.GetDescription());
+		for (u32 i = 0; i < chunk.num_packets; i++)
+			out[i] = {GSType::Transfer, nullptr, 0, GSTransferPath::Dummy};
+	}
+
+	bool GSDumpSeekableZst::IsEof()
+	{
+		return (m_header_pos == m_chunks[0].data.size());
+	}
+
+	size_t GSDumpSeekableZst::Read(void* ptr, size_t size)
+	{
+		// Only the header is read this way, packets are decompressed directly.
+		const size_t read = std::min(size, m_chunks[0].data.size() - m_header_pos);
+		std::memcpy(ptr, &m_chunks[0].data[m_header_pos], read);
+		m_header_pos += read;
+		return read;
+	}
+
+	bool GSDumpSeekableZst::ReadPackets(Error* error)
+	{
+		if (!IsEof())
+			Console.Warning("(GSDump) Ignoring extra data in header");
+
+		m_thread = std::thread(&GSDumpSeekableZst::DecompressThread, this);
+		return true;
+	}
+
+	void GSDumpSeekableZst::WaitForPacket(size_t index)
+	{
+		const auto it = std::upper_bound(m_chunks.begin() + 1, m_chunks.end(), index,
+			[](size_t index, const Chunk& chunk) { return (index < chunk.first_packet); });
+		pxAssert(it != m_chunks.begin() + 1);
+		Chunk& chunk = *(it - 1);
+
+		std::unique_lock lock(m_mutex);
+		if (!chunk.ready)
+		{
+			// Move the decompression thread to this chunk, seeking or replay caught up with it.
+			m_requested_chunk = static_cast<u32>(std::distance(m_chunks.begin(), it - 1));
+			m_work_cv.notify_one();
+			m_ready_cv.wait(lock, [&chunk]() { return chunk.ready; });
+		}
+
+		m_ready_packets_start = chunk.first_packet;
+		m_ready_packets_count = chunk.num_packets;
+	}
+
+	void GSDumpSeekableZst::DecompressThread()
+	{
+		Threading::SetNameOfCurrentThread("GS Dump Decompression");
+
+		ZSTD_DCtx* dctx = ZSTD_createDCtx();
+		DynamicHeapArray<u8, 64> buffer;
+		GSDataArray packets;
+
+		const u32 num_chunks = static_cast<u32>(m_chunks.size());
+		std::unique_lock lock(m_mutex);
+		while (!m_shutdown)
+		{
+			// Requested chunks first, then carry on in order from the last one, wrapping around for any skipped.
+			u32 index = m_requested_chunk;
+			m_requested_chunk = NO_CHUNK;
+			if (index == NO_CHUNK || m_chunks[index].ready)
+			{
+				index = NO_CHUNK;
+				for (u32 i = 0; i < num_chunks - 1; i++)
+				{
+					const u32 next = 1 + ((m_next_chunk - 1 + i) % (num_chunks - 1));
+					if (!m_chunks[next].ready)
+					{
+						index = next;
+						break;
+					}
+				}
+
+				// Everything is loaded.
+				if (index == NO_CHUNK)
+					break;
+			}
+
+			lock.unlock();
+			LoadChunk(dctx, index, &buffer, &packets);
+			lock.lock();
+
+			m_chunks[index].ready = true;
+			m_next_chunk = (index + 1 < num_chunks) ? (index + 1) : 1;
+			m_ready_cv.notify_all();
+		}
+
+		ZSTD_freeDCtx(dctx);
+	}
+
+	/******************************************************************/
+
 	class GSDumpRaw final : public GSDumpFile
 	{
 	public:
@@ -626,6 +984,8 @@ std::unique_ptr<GSDumpFile> GSDumpFile::OpenGSDump(const char* filename, Error*
 	std::unique_ptr<GSDumpFile> file;
 	if (StringUtil::EndsWithNoCase(filename, ".xz"))
 		file = std::make_unique<GSDumpLzma>();
+	else if (StringUtil::EndsWithNoCase(filename, ".zst") && GSDumpSeekableZst::HasPacketIndex(fp.get()))
+		file = std::make_unique<GSDumpSeekableZst>();
 	else if (StringUtil::EndsWithNoCase(filename, ".zst"))
 		file = std::make_unique<GSDumpDecompressZst>();
 	else
@@ -300,7 +300,21 @@ public:
 
 	__fi const ByteArray& GetRegsData() const { return m_regs_data; }
 	__fi const ByteArray& GetStateData() const { return m_state_data; }
-	__fi const GSDataArray& GetPackets() const { return m_dump_packets; }
+
+	__fi size_t GetPacketCount() const { return m_dump_packets.size(); }
+	__fi u32 GetFrameCount() const { return static_cast<u32>(m_vsync_packets.size()); }
+
+	/// Returns the index of the first packet after the specified number of vsyncs.
+	__fi size_t GetFrameStartPacket(u32 frame) const { return (frame == 0) ? 0 : (m_vsync_packets[frame - 1] + 1); }
+
+	/// Returns the specified packet, waiting for it to be decompressed if the dump is still being read.
+	__fi const GSData& GetPacket(size_t index)
+	{
+		if ((index - m_ready_packets_start) >= m_ready_packets_count) [[unlikely]]
+			WaitForPacket(index);
+
+		return m_dump_packets[index];
+	}
 
 	bool ReadFile(Error* error);
 
@@ -311,9 +325,23 @@ protected:
 	virtual bool IsEof() = 0;
 	virtual size_t Read(void* ptr, size_t size) = 0;
 
+	/// Reads everything after the header. By default the whole stream is decompressed and parsed up front.
+	virtual bool ReadPackets(Error* error);
+
+	/// Makes sure the packet is loaded, and sets the range of packets which can be returned without checking again.
+	virtual void WaitForPacket(size_t index);
+
+	/// Appends the packets in data to the array. The packets point into data, so it must outlive them.
+	static bool ParsePackets(u8* data, size_t size, GSDataArray* packets, Error* error);
+
 protected:
 	FileSystem::ManagedCFilePtr m_fp;
 
+	GSDataArray m_dump_packets;
+	std::vector<u32> m_vsync_packets;
+	size_t m_ready_packets_start = 0;
+	size_t m_ready_packets_count = 0;
+
 private:
 	std::string m_serial;
 	u32 m_crc = 0;
@@ -321,8 +349,6 @@ private:
 	std::vector<u8> m_regs_data;
 	std::vector<u8> m_state_data;
 	std::vector<u8> m_packet_data;
-
-	GSDataArray m_dump_packets;
 };
 
 // Initializes CRC tables used by LZMA SDK.
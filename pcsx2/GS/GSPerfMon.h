@@ -22,6 +22,23 @@ public:
 		SyncPoint,
 		Barriers,
 		RenderPasses,
+
+		// Software renderer waits for in-flight draws, by reason.
+		SyncFrame, // everything, for presenting or resetting
+		SyncDump, // everything, for dumping draws
+		SyncTarget, // draw target overlaps earlier draws
+		SyncSource, // draw samples pages which earlier draws write
+		SyncTransfer, // host to local transfer over pages in use
+		SyncReadback, // local to host transfer from pages being drawn to
+
+		// Hardware texture cache hashing of local memory.
+		TextureHashBytes, // bytes read to hash textures
+		TextureHashSkips, // hashes reused because none of the texture's pages were written
+
+		// Hardware target readbacks, in milliseconds.
+		ReadbackStall, // waiting for the GPU copy to complete
+		ReadbackHidden, // between issuing a speculative copy and the game reading it
+
 		CounterLast,
 
 		// Reused counters for HW.
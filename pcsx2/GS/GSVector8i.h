@@ -752,6 +752,11 @@ public:
 		return GSVector8i(_mm256_mullo_epi16(m, v.m));
 	}
 
+	__forceinline GSVector8i mul32l(const GSVector8i& v) const
+	{
+		return GSVector8i(_mm256_mullo_epi32(m, v.m));
+	}
+
 	__forceinline GSVector8i mul16hrs(const GSVector8i& v) const
 	{
 		return GSVector8i(_mm256_mulhrs_epi16(m, v.m));
@@ -58,6 +58,14 @@ static ProcessorFeatures getProcessorFeatures()
 		features.hasFMA = over[0] == 'Y' || over[0] == 'y' || over[0] == '1';
 		fprintf(stderr, "Processor FMA override: %s\n", features.hasFMA ? "Supported" : "Unsupported");
 	}
+	// cpuinfo only reports AVX-512 when the OS saves the opmask state
+	features.hasAVX512 = features.vectorISA == ProcessorFeatures::VectorISA::AVX2 && cpuinfo_has_x86_avx512f() &&
+	                     cpuinfo_has_x86_avx512bw() && cpuinfo_has_x86_avx512dq() && cpuinfo_has_x86_avx512vl();
+	if (const char* over = getenv("OVERRIDE_AVX512"))
+	{
+		features.hasAVX512 = features.hasAVX512 && (over[0] == 'Y' || over[0] == 'y' || over[0] == '1');
+		fprintf(stderr, "Processor AVX-512 override: %s\n", features.hasAVX512 ? "Supported" : "Unsupported");
+	}
 	features.hasSlowGather = false;
 	if (const char* over = getenv("OVERRIDE_SLOW_GATHER")) // Easy override for comparing on vs off
 	{
@@ -48,6 +48,7 @@ struct ProcessorFeatures
 	enum class VectorISA { SSE4, AVX, AVX2 };
 	VectorISA vectorISA;
 	bool hasFMA;
+	bool hasAVX512; ///< F/BW/DQ/VL, only used by the JIT on xmm/ymm registers
 	bool hasSlowGather;
 #endif
 };
@@ -9,6 +9,18 @@ namespace GSCodeReserve
 	static u8* s_memory_base;
 	static u8* s_memory_end;
 	static u8* s_memory_ptr;
+	static std::mutex s_lock;
+}
+
+GSCodeCacheStats g_gs_code_cache_stats;
+
+void GSCodeCacheStats::Reset()
+{
+	pregenerated.store(0, std::memory_order_relaxed);
+	pregenerated_used.store(0, std::memory_order_relaxed);
+	pregenerated_used_time.store(0, std::memory_order_relaxed);
+	generated.store(0, std::memory_order_relaxed);
+	generated_time.store(0, std::memory_order_relaxed);
 }
 
 void GSCodeReserve::ResetMemory()
@@ -18,11 +30,21 @@ void GSCodeReserve::ResetMemory()
 	s_memory_ptr = s_memory_base;
 }
 
+size_t GSCodeReserve::GetMemorySize()
+{
+	return s_memory_end - s_memory_base;
+}
+
 size_t GSCodeReserve::GetMemoryUsed()
 {
 	return s_memory_ptr - s_memory_base;
 }
 
+std::mutex& GSCodeReserve::GetLock()
+{
+	return s_lock;
+}
+
 u8* GSCodeReserve::ReserveMemory(size_t size)
 {
 	pxAssert((s_memory_ptr + size) <= s_memory_end);
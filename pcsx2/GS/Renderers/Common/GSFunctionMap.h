@@ -7,8 +7,12 @@
 #include "GS/Renderers/SW/GSScanlineEnvironment.h"
 
 #include "common/HostSys.h"
+#include "common/Timer.h"
 
+#include <atomic>
 #include <cinttypes>
+#include <mutex>
+#include <unordered_set>
 
 template <class KEY, class VALUE>
 class GSFunctionMap
@@ -27,6 +31,15 @@ protected:
 
 	virtual VALUE GetDefaultFunction(KEY key) = 0;
 
+	void ClearActive()
+	{
+		for (auto& i : m_map_active)
+			delete i.second;
+
+		m_map_active.clear();
+		m_active = NULL;
+	}
+
 public:
 	GSFunctionMap()
 		: m_active(NULL)
@@ -141,20 +154,76 @@ namespace GSCodeReserve
 {
 	void ResetMemory();
 
+	size_t GetMemorySize();
 	size_t GetMemoryUsed();
 
+	/// Held while generating code, so functions can be compiled ahead of time on another thread.
+	std::mutex& GetLock();
+
 	u8* ReserveMemory(size_t size);
 	void CommitMemory(size_t size);
 }
 
+// --------------------------------------------------------------------------------------
+//  GSCodeCacheStats
+// --------------------------------------------------------------------------------------
+// Where the GS software JIT spent its time, for the stats overlay.
+//
+struct GSCodeCacheStats
+{
+	std::atomic<u32> pregenerated{0}; ///< Functions compiled ahead of time from the recorded selectors
+	std::atomic<u32> pregenerated_used{0}; ///< Of those, how many a draw has asked for so far
+	std::atomic<u64> pregenerated_used_time{0}; ///< Compile time of the used ones, which the draws didn't have to wait for
+	std::atomic<u32> generated{0}; ///< Functions compiled on demand by a draw
+	std::atomic<u64> generated_time{0};
+
+	void Reset();
+};
+
+extern GSCodeCacheStats g_gs_code_cache_stats;
+
 template <class CG, class KEY, class VALUE>
 class GSCodeGeneratorFunctionMap : public GSFunctionMap<KEY, VALUE>
 {
+	struct Function
+	{
+		VALUE f;
+		Common::Timer::Value time; ///< How long it took to compile
+		bool pregenerated; ///< Compiled ahead of time and not asked for yet
+	};
+
 	std::string m_name;
-	std::unordered_map<u64, VALUE> m_cgmap;
+	std::unordered_map<u64, Function> m_cgmap;
+	std::unordered_set<KEY> m_used; ///< Keys asked for since the last TakeUsedKeys(), kept across cache resets
 
 	enum { MAX_SIZE = 8192 };
 
+	Function Generate(KEY key)
+	{
+		const Common::Timer::Value start = Common::Timer::GetCurrentValue();
+
+		HostSys::BeginCodeWrite();
+
+		u8* code_ptr = GSCodeReserve::ReserveMemory(MAX_SIZE);
+		CG cg(key, code_ptr, MAX_SIZE);
+		cg.Generate();
+		pxAssert(cg.GetSize() < MAX_SIZE);
+
+#if 0
+		fprintf(stderr, "%s Location:%p Size:%zu Key:%llx\n", m_name.c_str(), code_ptr, cg.getSize(), (u64)key);
+		GSScanlineSelector sel(key);
+		sel.Print();
+#endif
+
+		const u32 size = static_cast<u32>(cg.GetSize());
+		GSCodeReserve::CommitMemory(size);
+
+		HostSys::EndCodeWrite();
+		HostSys::FlushInstructionCache(code_ptr, static_cast<u32>(size));
+
+		return {(VALUE)cg.GetCode(), Common::Timer::GetCurrentValue() - start, false};
+	}
+
 public:
 	GSCodeGeneratorFunctionMap(std::string name)
 		: m_name(name)
@@ -165,45 +234,82 @@ public:
 
 	void Clear()
 	{
+		std::lock_guard<std::mutex> lock(GSCodeReserve::GetLock());
+
 		m_cgmap.clear();
+		this->ClearActive();
 	}
 
 	VALUE GetDefaultFunction(KEY key)
 	{
-		VALUE ret = nullptr;
+		std::lock_guard<std::mutex> lock(GSCodeReserve::GetLock());
+
+		m_used.insert(key);
 
 		auto i = m_cgmap.find(key);
 
 		if (i != m_cgmap.end())
 		{
-			ret = i->second;
+			if (i->second.pregenerated)
+			{
+				i->second.pregenerated = false;
+				g_gs_code_cache_stats.pregenerated_used.fetch_add(1, std::memory_order_relaxed);
+				g_gs_code_cache_stats.pregenerated_used_time.fetch_add(i->second.time, std::memory_order_relaxed);
+			}
+
+			return i->second.f;
 		}
-		else
-		{
-			HostSys::BeginCodeWrite();
 
-			u8* code_ptr = GSCodeReserve::ReserveMemory(MAX_SIZE);
-			CG cg(key, code_ptr, MAX_SIZE);
-			cg.Generate();
-			pxAssert(cg.GetSize() < MAX_SIZE);
+		const Function f = Generate(key);
 
-#if 0
-			fprintf(stderr, "%s Location:%p Size:%zu Key:%llx\n", m_name.c_str(), code_ptr, cg.getSize(), (u64)key);
-			GSScanlineSelector sel(key);
-			sel.Print();
-#endif
+		m_cgmap[key] = f;
+
+		g_gs_code_cache_stats.generated.fetch_add(1, std::memory_order_relaxed);
+		g_gs_code_cache_stats.generated_time.fetch_add(f.time, std::memory_order_relaxed);
+
+		return f.f;
+	}
+
+	/// Compiles the function for a key before anything asks for it. Leaves half of the code space for
+	/// the functions compiled on demand, returning false once that's reached.
+	bool Pregenerate(KEY key)
+	{
+		std::lock_guard<std::mutex> lock(GSCodeReserve::GetLock());
 
-			const u32 size = static_cast<u32>(cg.GetSize());
-			GSCodeReserve::CommitMemory(size);
+		if (m_cgmap.find(key) != m_cgmap.end())
+			return true;
 
-			HostSys::EndCodeWrite();
-			HostSys::FlushInstructionCache(code_ptr, static_cast<u32>(size));
+		if (GSCodeReserve::GetMemoryUsed() + MAX_SIZE > GSCodeReserve::GetMemorySize() / 2)
+			return false;
 
-			ret = (VALUE)cg.GetCode();
+		Function f = Generate(key);
+		f.pregenerated = true;
 
-			m_cgmap[key] = ret;
-		}
+		m_cgmap[key] = f;
+
+		g_gs_code_cache_stats.pregenerated.fetch_add(1, std::memory_order_relaxed);
+
+		return true;
+	}
+
+	/// Returns the keys asked for since the last call.
+	std::vector<KEY> TakeUsedKeys()
+	{
+		std::lock_guard<std::mutex> lock(GSCodeReserve::GetLock());
+
+		std::vector<KEY> keys(m_used.begin(), m_used.end());
+		m_used.clear();
+		return keys;
+	}
+
+	/// Forgets the keys asked for so far. Also drops the active functions, since keys already active would otherwise
+	/// never be asked for again. The caller must make sure no draw is using them.
+	void ResetUsedKeys()
+	{
+		this->ClearActive();
+
+		std::lock_guard<std::mutex> lock(GSCodeReserve::GetLock());
 
-		return ret;
+		m_used.clear();
 	}
 };
@@ -45,6 +45,9 @@ public:
 
 	virtual void UpdateRenderFixes();
 
+	/// Called when the disc serial changes, for caches kept per game.
+	virtual void GameChanged() {}
+
 	virtual void VSync(u32 field, bool registers_written, bool idle_frame);
 	virtual bool CanUpscale() { return false; }
 	virtual float GetUpscaleMultiplier() { return 1.0f; }
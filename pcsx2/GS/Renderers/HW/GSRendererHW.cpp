@@ -7077,6 +7077,8 @@ void GSRendererHW::ClearGSLocalMemory(const GSOffset& off, const GSVector4i& r,
 	GL_INS("ClearGSLocalMemory(): %08X %d,%d => %d,%d @ BP %x BW %u %s", vert_color, r.x, r.y, r.z, r.w, off.bp(),
 		off.bw(), psm_str(off.psm()));
 
+	g_texture_cache->MarkPagesWritten(off, r);
+
 	const u32 psm = (off.psm() == PSMCT32 && m_cached_ctx.FRAME.FBMSK == 0xFF000000u) ? PSMCT24 : off.psm();
 	const int format = GSLocalMemory::m_psm[psm].fmt;
 
@@ -7543,6 +7545,12 @@ GSHWDrawConfig& GSRendererHW::BeginHLEHardwareDraw(
 {
 	ResetStates();
 
+	// HLE draws don't go through UpdateDrawn(), speculative readbacks of the targets are stale after them.
+	if (rt)
+		g_texture_cache->TargetTextureChanged(rt);
+	if (ds)
+		g_texture_cache->TargetTextureChanged(ds);
+
 	// Bit gross, but really no other way to ensure there's nothing of the last draw left over.
 	GSHWDrawConfig& config = m_conf;
 	std::memset(&config.cb_vs, 0, sizeof(config.cb_vs));
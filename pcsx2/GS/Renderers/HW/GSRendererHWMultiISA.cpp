@@ -544,6 +544,12 @@ bool GSRendererHWFunctions::SwPrimRender(GSRendererHW& hw, bool invalidate_tc, b
 
 	static_cast<GSSingleRasterizer*>(hw.m_sw_rasterizer.get())->Draw(data);
 
+	// Hashes of textures in the written pages are stale even when the caller skips invalidating the cache.
+	if (fwrite)
+		g_texture_cache->MarkPagesWritten(context->offset.fb, bbox);
+	if (zwrite)
+		g_texture_cache->MarkPagesWritten(context->offset.zb, bbox);
+
 	if (invalidate_tc)
 		g_texture_cache->InvalidateVideoMem(context->offset.fb, bbox);
 
@@ -14,6 +14,7 @@
 #include "common/BitUtils.h"
 #include "common/HashCombine.h"
 #include "common/SmallString.h"
+#include "common/Timer.h"
 
 #include "fmt/format.h"
 
@@ -29,8 +30,19 @@ std::unique_ptr<GSTextureCache> g_texture_cache;
 
 static u8* s_unswizzle_buffer;
 
-/// List of candidates for purging when the hash cache gets too large.
-static std::vector<std::pair<GSTextureCache::HashCacheMap::iterator, s32>> s_hash_cache_purge_list;
+/// Hash cache entries which no source is using, most recently released first.
+/// Lives outside the texture cache because sources release their entries while it is being destroyed.
+static FastList<GSTextureCache::HashCacheEntry*> s_hash_cache_lru;
+
+/// Incremented once per frame, entries are aged against it.
+static u32 s_hash_cache_frame = 0;
+
+/// Eviction cost given to replacement textures, in microseconds like measured ones. Replacements come back through
+/// the loader thread, and the original texture shows until they do.
+static constexpr u32 REPLACEMENT_TEXTURE_LOAD_COST = 10000;
+
+/// Source of Target::m_content_version, shared so that versions never repeat across targets.
+static u64 s_target_content_version = 0;
 
 #ifdef PCSX2_DEVBUILD
 // We can only set one texture name per command buffer, which would break our fancy texture cache RT/DS/texture naming.
@@ -61,7 +73,6 @@ GSTextureCache::~GSTextureCache()
 {
 	RemoveAll(true, true, true);
 
-	s_hash_cache_purge_list = {};
 	_aligned_free(s_unswizzle_buffer);
 }
 
@@ -96,6 +107,9 @@ void GSTextureCache::RemoveAll(bool sources, bool targets, bool hash_cache)
 		m_target_heights.clear();
 		m_surface_offset_cache.clear();
 		m_target_memory_usage = 0;
+
+		for (SpeculativeReadback& srb : m_speculative_readbacks)
+			srb.target = nullptr;
 	}
 
 	if (hash_cache)
@@ -106,6 +120,10 @@ void GSTextureCache::RemoveAll(bool sources, bool targets, bool hash_cache)
 		m_hash_cache.clear();
 		m_hash_cache_memory_usage = 0;
 		m_hash_cache_replacement_memory_usage = 0;
+		m_hash_cache_stats = {};
+		m_hash_cache_evicted_keys.clear();
+		m_texture_hash_memo.clear();
+		s_hash_cache_lru.clear();
 	}
 }
 
@@ -2331,6 +2349,7 @@ GSTextureCache::Target* GSTextureCache::LookupTarget(GIFRegTEX0 TEX0, const GSVe
 	{
 		dst->m_used |= used;
 		dst->readbacks_since_draw = 0;
+		dst->ContentChanged();
 
 		pxAssert(dst && dst->m_texture && dst->m_scale == scale);
 	}
@@ -2783,6 +2802,7 @@ void GSTextureCache::Target::ScaleRTAlpha()
 		}
 
 		m_rt_alpha_scale = true;
+		ContentChanged();
 	}
 }
 
@@ -2809,6 +2829,7 @@ void GSTextureCache::Target::UnscaleRTAlpha()
 		}
 
 		m_rt_alpha_scale = false;
+		ContentChanged();
 	}
 }
 
@@ -3156,6 +3177,8 @@ void GSTextureCache::InvalidateVideoMem(const GSOffset& off, const GSVector4i& r
 	const u32 bw = off.bw();
 	const u32 psm = off.psm();
 
+	MarkPagesWritten(off, rect);
+
 	if (!target)
 	{
 		// Remove Source that have same BP as the render target (color&dss)
@@ -4112,6 +4135,7 @@ void GSTextureCache::CopyPages(Target* src, u32 sbw, u32 src_offset, Target* dst
 
 	// No need to sort here, it's all from the same texture.
 	g_gs_device->DrawMultiStretchRects(rects, num_pages, dst->m_texture, shader);
+	dst->ContentChanged();
 }
 
 GSTextureCache::Target* GSTextureCache::GetExactTarget(u32 BP, u32 BW, int type, u32 end_bp)
@@ -4323,9 +4347,7 @@ void GSTextureCache::ReplaceSourceTexture(Source* s, GSTexture* new_texture, flo
 
 	if (s->m_from_hash_cache)
 	{
-		pxAssert(s->m_from_hash_cache->refcount > 0);
-		if ((--s->m_from_hash_cache->refcount) == 0)
-			s->m_from_hash_cache->age = 0;
+		ReleaseHashCacheEntry(s->m_from_hash_cache);
 	}
 	else if (!s->m_shared_texture)
 	{
@@ -4340,7 +4362,7 @@ void GSTextureCache::ReplaceSourceTexture(Source* s, GSTexture* new_texture, flo
 	s->m_scale = new_scale;
 
 	if (s->m_from_hash_cache)
-		s->m_from_hash_cache->refcount++;
+		AcquireHashCacheEntry(s->m_from_hash_cache);
 	else if (!s->m_shared_texture)
 		m_source_memory_usage += s->m_texture->GetMemUsage();
 }
@@ -4361,6 +4383,7 @@ void GSTextureCache::IncAge()
 	}
 
 	AgeHashCache();
+	IssueSpeculativeReadbacks();
 
 	// As of 04/15/2024 this is s et to 60 (just 1 second of targets), which should be fine now as it doesn't destroy targets which haven't been covered.
 	// 
@@ -5291,7 +5314,8 @@ GSTextureCache::HashCacheEntry* GSTextureCache::LookupHashCache(const GIFRegTEX0
 
 	// need the hash either for replacing, dumping or caching.
 	// if dumping/replacing is on, we compute the clut hash regardless, since replacements aren't indexed
-	HashCacheKey key{HashCacheKey::Create(TEX0, TEXA, (dump || replace || !paltex) ? clut : nullptr, lod, region)};
+	HashCacheKey key{HashCacheKey::Create(TEX0, TEXA, (dump || replace || !paltex) ? clut : nullptr,
+		LookupTextureHash(TEX0, TEXA, lod, region), region)};
 
 	// handle dumping first, this is mostly isolated.
 	if (dump)
@@ -5327,7 +5351,7 @@ GSTextureCache::HashCacheEntry* GSTextureCache::LookupHashCache(const GIFRegTEX0
 		GL_CACHE("HC Hit: %" PRIx64 " %" PRIx64 " R-%ux%u", key.TEX0Hash, key.CLUTHash, key.region_width, key.region_height);
 		HashCacheEntry* entry = &it->second;
 		paltex &= (entry->texture->GetFormat() == GSTexture::Format::UNorm8);
-		entry->refcount++;
+		AcquireHashCacheEntry(entry);
 		return entry;
 	}
 
@@ -5345,9 +5369,10 @@ GSTextureCache::HashCacheEntry* GSTextureCache::LookupHashCache(const GIFRegTEX0
 		{
 			// found a replacement texture! insert it into the hash cache, and clear paltex (since it's not indexed)
 			paltex = false;
-			const HashCacheEntry entry{replacement_tex, 1u, 0u, alpha_minmax, true, true};
+			HashCacheEntry entry{replacement_tex, 1u, 0u, alpha_minmax, true, true};
+			entry.load_cost = REPLACEMENT_TEXTURE_LOAD_COST;
 			m_hash_cache_replacement_memory_usage += entry.texture->GetMemUsage();
-			return &m_hash_cache.emplace(key, entry).first->second;
+			return InsertIntoHashCache(key, entry);
 		}
 		else if (
 			replacement_texture_pending ||
@@ -5389,6 +5414,7 @@ GSTextureCache::HashCacheEntry* GSTextureCache::LookupHashCache(const GIFRegTEX0
 	const int tw = region.HasX() ? region.GetWidth() : (1 << TEX0.TW);
 	const int th = region.HasY() ? region.GetHeight() : (1 << TEX0.TH);
 	const int tlevels = lod ? (GSConfig.HWMipmap ? std::min(lod->y - lod->x + 1, GSDevice::GetMipmapLevelsForSize(tw, th)) : -1) : 1;
+	Common::Timer load_timer;
 	GSTexture* tex = g_gs_device->CreateTexture(tw, th, tlevels, paltex ? GSTexture::Format::UNorm8 : GSTexture::Format::Color);
 	if (!tex)
 	{
@@ -5428,9 +5454,41 @@ GSTextureCache::HashCacheEntry* GSTextureCache::LookupHashCache(const GIFRegTEX0
 		key.RemoveCLUTHash();
 
 	// insert into the cache cache, and we're done
-	const HashCacheEntry entry{tex, 1u, 0u, alpha_minmax, compute_alpha_minmax, false};
+	HashCacheEntry entry{tex, 1u, 0u, alpha_minmax, compute_alpha_minmax, false};
+	entry.load_cost = static_cast<u32>(std::min(load_timer.GetTimeNanoseconds() / 1000.0, 1e9));
 	m_hash_cache_memory_usage += tex->GetMemUsage();
-	return &m_hash_cache.emplace(key, entry).first->second;
+	return InsertIntoHashCache(key, entry);
+}
+
+GSTextureCache::HashCacheEntry* GSTextureCache::InsertIntoHashCache(const HashCacheKey& key, const HashCacheEntry& entry)
+{
+	if (!m_hash_cache_evicted_keys.empty() && m_hash_cache_evicted_keys.erase(HashCacheKeyHash()(key)) > 0)
+		m_hash_cache_stats.recreated++;
+
+	const auto it = m_hash_cache.emplace(key, entry).first;
+	it->second.key = &it->first;
+	return &it->second;
+}
+
+void GSTextureCache::AcquireHashCacheEntry(HashCacheEntry* entry)
+{
+	if (entry->lru_index != 0)
+	{
+		s_hash_cache_lru.EraseIndex(entry->lru_index);
+		entry->lru_index = 0;
+	}
+
+	entry->refcount++;
+}
+
+void GSTextureCache::ReleaseHashCacheEntry(HashCacheEntry* entry)
+{
+	pxAssert(entry->refcount > 0);
+	if ((--entry->refcount) > 0)
+		return;
+
+	entry->last_used = s_hash_cache_frame;
+	entry->lru_index = s_hash_cache_lru.InsertFront(entry);
 }
 
 void GSTextureCache::RemoveFromHashCache(HashCacheMap::iterator it)
@@ -5441,10 +5499,31 @@ void GSTextureCache::RemoveFromHashCache(HashCacheMap::iterator it)
 		m_hash_cache_replacement_memory_usage -= mem_usage;
 	else
 		m_hash_cache_memory_usage -= mem_usage;
+	if (e.lru_index != 0)
+		s_hash_cache_lru.EraseIndex(e.lru_index);
 	g_gs_device->Recycle(e.texture);
 	m_hash_cache.erase(it);
 }
 
+void GSTextureCache::EvictFromHashCache(HashCacheEntry* entry, bool by_age)
+{
+	pxAssert(entry->refcount == 0);
+
+	if (by_age)
+		m_hash_cache_stats.evicted_by_age++;
+	else
+		m_hash_cache_stats.evicted_by_size++;
+	m_hash_cache_stats.evicted_bytes += entry->texture->GetMemUsage();
+
+	// Remember what went, so we can tell when the budget is too tight and textures keep coming back.
+	constexpr size_t MAX_EVICTED_KEYS = 4096;
+	if (m_hash_cache_evicted_keys.size() >= MAX_EVICTED_KEYS)
+		m_hash_cache_evicted_keys.clear();
+	m_hash_cache_evicted_keys.insert(HashCacheKeyHash()(*entry->key));
+
+	RemoveFromHashCache(m_hash_cache.find(*entry->key));
+}
+
 void GSTextureCache::AgeHashCache()
 {
 	// Where did this number come from?
@@ -5454,47 +5533,69 @@ void GSTextureCache::AgeHashCache()
 	constexpr u32 MAX_HASH_CACHE_SIZE = 800;
 	constexpr u32 MAX_HASH_CACHE_AGE = 30;
 
-	bool might_need_cache_purge = (m_hash_cache.size() > MAX_HASH_CACHE_SIZE);
-	if (might_need_cache_purge)
-		s_hash_cache_purge_list.clear();
+	// How many of the least recently used entries are weighed against each other when over the limits.
+	constexpr u32 EVICTION_CANDIDATES = 16;
 
-	for (auto it = m_hash_cache.begin(); it != m_hash_cache.end();)
-	{
-		HashCacheEntry& e = it->second;
-		if (e.refcount > 0)
-		{
-			++it;
-			continue;
-		}
+	s_hash_cache_frame++;
 
-		if (++e.age > MAX_HASH_CACHE_AGE)
-		{
-			RemoveFromHashCache(it++);
-			continue;
-		}
+	// Unreferenced entries are in release order, so the expired ones are all at the back.
+	while (!s_hash_cache_lru.empty() && (s_hash_cache_frame - s_hash_cache_lru.back()->last_used) > MAX_HASH_CACHE_AGE)
+		EvictFromHashCache(s_hash_cache_lru.back(), true);
 
-		// We might free up enough just with "normal" removals above.
-		if (might_need_cache_purge)
+	const u64 budget = static_cast<u64>(GSConfig.HashCacheBudget) * _1mb;
+	while (!s_hash_cache_lru.empty() &&
+		   (m_hash_cache.size() > MAX_HASH_CACHE_SIZE || (budget > 0 && GetTotalHashCacheMemoryUsage() > budget)))
+	{
+		// Out of the oldest few, drop whichever frees the most memory for the least cost of bringing it back,
+		// scaled by how long it has been unused. Replacements are costed high, since they come back from disk.
+		HashCacheEntry* victim = nullptr;
+		float victim_score = 0.0f;
+		u32 candidates = 0;
+		for (auto it = s_hash_cache_lru.rbegin(); it != s_hash_cache_lru.rend() && candidates < EVICTION_CANDIDATES;
+			 ++it, candidates++)
 		{
-			might_need_cache_purge = (m_hash_cache.size() > MAX_HASH_CACHE_SIZE);
-			if (might_need_cache_purge)
-				s_hash_cache_purge_list.emplace_back(it, static_cast<s32>(e.age));
+			HashCacheEntry* e = *it;
+			const float score = static_cast<float>(s_hash_cache_frame - e->last_used + 1) *
+								static_cast<float>(e->texture->GetMemUsage()) / static_cast<float>(e->load_cost + 1);
+			if (!victim || score > victim_score)
+			{
+				victim = e;
+				victim_score = score;
+			}
 		}
 
-		++it;
+		EvictFromHashCache(victim, false);
 	}
 
-	// Pushing to a list, sorting, and removing ends up faster than re-iterating the map.
-	if (might_need_cache_purge)
-	{
-		std::sort(s_hash_cache_purge_list.begin(), s_hash_cache_purge_list.end(),
-			[](const auto& lhs, const auto& rhs) { return lhs.second > rhs.second; });
+	// Memoized hashes are tiny, but textures which stream through (FMVs) would grow it without bound.
+	constexpr u32 MAX_TEXTURE_HASH_MEMO_SIZE = MAX_HASH_CACHE_SIZE * 4;
+	if (m_texture_hash_memo.size() > MAX_TEXTURE_HASH_MEMO_SIZE)
+		m_texture_hash_memo.clear();
+}
+
+GSTextureCache::HashType GSTextureCache::LookupTextureHash(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, const GSVector2i* lod, SourceRegion region)
+{
+	// Mipmap addresses come from MIPTBP, and they'd all have to be part of the key. Uncommon enough not to bother.
+	if (lod)
+		return HashTexture(TEX0, TEXA, lod, region);
+
+	const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[TEX0.PSM];
+	TextureHashMemoKey key;
+	key.TEX0.U64 = TEX0.U64 & 0x00000003FFFFFFFFULL; // TBP0, TBW, PSM, TW, TH
+	key.TEXA.U64 = (psm.pal == 0 && psm.fmt > 0) ? (TEXA.U64 & 0x000000FF000080FFULL) : 0;
+	key.region = region;
 
-		const u32 entries_to_purge = std::min(static_cast<u32>(m_hash_cache.size() - MAX_HASH_CACHE_SIZE),
-			static_cast<u32>(s_hash_cache_purge_list.size()));
-		for (u32 i = 0; i < entries_to_purge; i++)
-			RemoveFromHashCache(s_hash_cache_purge_list[i].first);
+	const u64 generation = GetPageGeneration(TEX0, region);
+	const auto it = m_texture_hash_memo.find(key);
+	if (it != m_texture_hash_memo.end() && it->second.generation == generation)
+	{
+		g_perfmon.Put(GSPerfMon::TextureHashSkips, 1);
+		return it->second.hash;
 	}
+
+	const HashType hash = HashTexture(TEX0, TEXA, region);
+	m_texture_hash_memo[key] = {hash, generation};
+	return hash;
 }
 
 GSTextureCache::Target* GSTextureCache::Target::Create(GIFRegTEX0 TEX0, int w, int h, float scale, int type, bool clear)
@@ -5594,19 +5695,10 @@ std::shared_ptr<GSTextureCache::Palette> GSTextureCache::LookupPaletteObject(con
 	return m_palette_map.LookupPalette(clut, pal, need_gs_texture);
 }
 
-void GSTextureCache::Read(Target* t, const GSVector4i& r)
+bool GSTextureCache::GetTargetReadbackFormat(const Target* t, GSTexture::Format* fmt, ShaderConvert* ps_shader)
 {
-	if ((!t->m_dirty.empty() && !t->m_dirty.GetTotalRect(t->m_TEX0, t->m_unscaled_size).rintersect(r).rempty())
-		|| r.width() == 0 || r.height() == 0)
-		return;
-
-	const GIFRegTEX0& TEX0 = t->m_TEX0;
 	const bool is_depth = (t->m_type == DepthStencil);
-
-	GSTexture::Format fmt;
-	ShaderConvert ps_shader;
-	std::unique_ptr<GSDownloadTexture>* dltex;
-	switch (TEX0.PSM)
+	switch (t->m_TEX0.PSM)
 	{
 		case PSMCT32:
 		case PSMCT24:
@@ -5616,71 +5708,65 @@ void GSTextureCache::Read(Target* t, const GSVector4i& r)
 			// better than writing back FP values to local memory.
 			if (is_depth)
 			{
-				fmt = GSTexture::Format::UInt32;
-				ps_shader = ShaderConvert::FLOAT32_TO_32_BITS;
-				dltex = &m_uint32_download_texture;
+				*fmt = GSTexture::Format::UInt32;
+				*ps_shader = ShaderConvert::FLOAT32_TO_32_BITS;
 			}
 			else
 			{
-				fmt = GSTexture::Format::Color;
+				*fmt = GSTexture::Format::Color;
 				if (t->m_rt_alpha_scale)
-					ps_shader = ShaderConvert::RTA_DECORRECTION;
+					*ps_shader = ShaderConvert::RTA_DECORRECTION;
 				else
-					ps_shader = ShaderConvert::COPY;
-
-				dltex = &m_color_download_texture;
+					*ps_shader = ShaderConvert::COPY;
 			}
 		}
-		break;
+		return true;
 
 		case PSMCT16:
 		case PSMCT16S:
 		{
-			fmt = GSTexture::Format::UInt16;
-			ps_shader = is_depth ? ShaderConvert::FLOAT32_TO_16_BITS : ShaderConvert::RGBA8_TO_16_BITS;
-			dltex = &m_uint16_download_texture;
+			*fmt = GSTexture::Format::UInt16;
+			*ps_shader = is_depth ? ShaderConvert::FLOAT32_TO_16_BITS : ShaderConvert::RGBA8_TO_16_BITS;
 		}
-		break;
+		return true;
 
 		case PSMZ32:
 		case PSMZ24:
 		{
-			fmt = GSTexture::Format::UInt32;
-			ps_shader = ShaderConvert::FLOAT32_TO_32_BITS;
-			dltex = &m_uint32_download_texture;
+			*fmt = GSTexture::Format::UInt32;
+			*ps_shader = ShaderConvert::FLOAT32_TO_32_BITS;
 		}
-		break;
+		return true;
 
 		case PSMZ16:
 		case PSMZ16S:
 		{
-			fmt = GSTexture::Format::UInt16;
-			ps_shader = ShaderConvert::FLOAT32_TO_16_BITS;
-			dltex = &m_uint16_download_texture;
+			*fmt = GSTexture::Format::UInt16;
+			*ps_shader = ShaderConvert::FLOAT32_TO_16_BITS;
 		}
-		break;
+		return true;
 
 		default:
-			return;
+			return false;
 	}
+}
 
+u32 GSTextureCache::GetTargetReadbackWriteMask(const Target* t)
+{
 	// Don't overwrite bits which aren't used in the target's format.
 	// Stops Burnout 3's sky from breaking when flushing targets to local memory.
-	const u32 write_mask = (t->m_valid_rgb ? 0x00FFFFFFu : 0) | (t->m_valid_alpha_low ? 0x0F000000u : 0) | (t->m_valid_alpha_high ? 0xF0000000u : 0);
-	if (write_mask == 0)
-	{
-		DbgCon.Warning("Not reading back target %x PSM %s due to no write mask", TEX0.TBP0, psm_str(TEX0.PSM));
-		return;
-	}
-
-	GL_PERF("TC: Read Back Target: (0x%x)[fmt: 0x%x]. Size %dx%d", TEX0.TBP0, TEX0.PSM, r.width(), r.height());
+	return (t->m_valid_rgb ? 0x00FFFFFFu : 0) | (t->m_valid_alpha_low ? 0x0F000000u : 0) | (t->m_valid_alpha_high ? 0xF0000000u : 0);
+}
 
+bool GSTextureCache::CopyTargetForReadback(Target* t, const GSVector4i& r, GSTexture::Format fmt, ShaderConvert ps_shader,
+	std::unique_ptr<GSDownloadTexture>* dltex)
+{
 	const GSVector4 src(GSVector4(r) * GSVector4(t->m_scale) / GSVector4(t->m_texture->GetSize()).xyxy());
 	const GSVector4i drc(0, 0, r.width(), r.height());
 	const bool direct_read = t->m_type == RenderTarget && t->m_scale == 1.0f && ps_shader == ShaderConvert::COPY;
 
 	if (!PrepareDownloadTexture(drc.z, drc.w, fmt, dltex))
-		return;
+		return false;
 
 	if (direct_read)
 	{
@@ -5699,18 +5785,19 @@ void GSTextureCache::Read(Target* t, const GSVector4i& r)
 		else
 		{
 			Console.Error("Failed to allocate temporary %dx%d target for read.", drc.z, drc.w);
-			return;
+			return false;
 		}
 	}
 
-	dltex->get()->Flush();
-	if (!dltex->get()->Map(drc))
-		return;
+	return true;
+}
 
+void GSTextureCache::WriteTargetReadback(const Target* t, const GSVector4i& r, const u8* bits, u32 pitch, u32 write_mask)
+{
 	// Why does WritePixelNN() not take a const pointer?
+	const GIFRegTEX0& TEX0 = t->m_TEX0;
 	const GSOffset off = g_gs_renderer->m_mem.GetOffset(TEX0.TBP0, TEX0.TBW, TEX0.PSM);
-	u8* bits = const_cast<u8*>(dltex->get()->GetMapPointer());
-	const u32 pitch = dltex->get()->GetMapPitch();
+	u8* wbits = const_cast<u8*>(bits);
 
 	switch (TEX0.PSM)
 	{
@@ -5718,13 +5805,13 @@ void GSTextureCache::Read(Target* t, const GSVector4i& r)
 		case PSMZ32:
 		case PSMCT24:
 		case PSMZ24:
-			g_gs_renderer->m_mem.WritePixel32(bits, pitch, off, r, write_mask);
+			g_gs_renderer->m_mem.WritePixel32(wbits, pitch, off, r, write_mask);
 			break;
 		case PSMCT16:
 		case PSMCT16S:
 		case PSMZ16:
 		case PSMZ16S:
-			g_gs_renderer->m_mem.WritePixel16(bits, pitch, off, r);
+			g_gs_renderer->m_mem.WritePixel16(wbits, pitch, off, r);
 			break;
 
 		default:
@@ -5732,9 +5819,148 @@ void GSTextureCache::Read(Target* t, const GSVector4i& r)
 			break;
 	}
 
+	MarkPagesWritten(off, r);
+}
+
+std::unique_ptr<GSDownloadTexture>* GSTextureCache::GetReadbackDownloadTexture(GSTexture::Format fmt)
+{
+	switch (fmt)
+	{
+		case GSTexture::Format::UInt16:
+			return &m_uint16_download_texture;
+		case GSTexture::Format::UInt32:
+			return &m_uint32_download_texture;
+		default:
+			return &m_color_download_texture;
+	}
+}
+
+void GSTextureCache::Read(Target* t, const GSVector4i& r)
+{
+	if ((!t->m_dirty.empty() && !t->m_dirty.GetTotalRect(t->m_TEX0, t->m_unscaled_size).rintersect(r).rempty())
+		|| r.width() == 0 || r.height() == 0)
+		return;
+
+	const GIFRegTEX0& TEX0 = t->m_TEX0;
+
+	GSTexture::Format fmt;
+	ShaderConvert ps_shader;
+	if (!GetTargetReadbackFormat(t, &fmt, &ps_shader))
+		return;
+
+	const u32 write_mask = GetTargetReadbackWriteMask(t);
+	if (write_mask == 0)
+	{
+		DbgCon.Warning("Not reading back target %x PSM %s due to no write mask", TEX0.TBP0, psm_str(TEX0.PSM));
+		return;
+	}
+
+	GL_PERF("TC: Read Back Target: (0x%x)[fmt: 0x%x]. Size %dx%d", TEX0.TBP0, TEX0.PSM, r.width(), r.height());
+
+	// Makes the target a candidate for reading back ahead of time at the end of the frame.
+	t->m_last_readback_frame = g_perfmon.GetFrame();
+
+	if (ReadSpeculativeReadback(t, r, fmt, write_mask))
+		return;
+
+	std::unique_ptr<GSDownloadTexture>* dltex = GetReadbackDownloadTexture(fmt);
+	const GSVector4i drc(0, 0, r.width(), r.height());
+	if (!CopyTargetForReadback(t, r, fmt, ps_shader, dltex))
+		return;
+
+	Common::Timer stall_timer;
+	dltex->get()->Flush();
+	g_perfmon.Put(GSPerfMon::ReadbackStall, stall_timer.GetTimeMilliseconds());
+
+	if (!dltex->get()->Map(drc))
+		return;
+
+	WriteTargetReadback(t, r, dltex->get()->GetMapPointer(), dltex->get()->GetMapPitch(), write_mask);
 	dltex->get()->Unmap();
 }
 
+bool GSTextureCache::ReadSpeculativeReadback(const Target* t, const GSVector4i& r, GSTexture::Format fmt, u32 write_mask)
+{
+	for (SpeculativeReadback& srb : m_speculative_readbacks)
+	{
+		// Versions are never reused, even by other targets, so a match means nothing has touched it since the copy.
+		if (srb.target != t || srb.content_version != t->m_content_version || srb.format != fmt ||
+			!srb.rect.rintersect(r).eq(r))
+		{
+			continue;
+		}
+
+		// Should have completed alongside the rest of the last frame, anything left is what the readback still stalls.
+		const GSVector4i drc(0, 0, srb.rect.width(), srb.rect.height());
+		Common::Timer stall_timer;
+		srb.dltex->Flush();
+		g_perfmon.Put(GSPerfMon::ReadbackStall, stall_timer.GetTimeMilliseconds());
+		if (!srb.dltex->Map(drc))
+			return false;
+
+		if (!srb.consumed)
+		{
+			srb.consumed = true;
+			g_perfmon.Put(GSPerfMon::ReadbackHidden,
+				Common::Timer::ConvertValueToMilliseconds(stall_timer.GetStartValue() - srb.issue_time));
+		}
+
+		const u32 pitch = srb.dltex->GetMapPitch();
+		const u8* bits = srb.dltex->GetMapPointer() + (static_cast<u32>(r.y - srb.rect.y) * pitch) +
+						 (static_cast<u32>(r.x - srb.rect.x) * GSTexture::GetCompressedBytesPerBlock(fmt));
+		WriteTargetReadback(t, r, bits, pitch, write_mask);
+		srb.dltex->Unmap();
+		return true;
+	}
+
+	return false;
+}
+
+void GSTextureCache::IssueSpeculativeReadbacks()
+{
+	// Anything not consumed by now was a misprediction, or the target changed before the game read it.
+	for (SpeculativeReadback& srb : m_speculative_readbacks)
+		srb.target = nullptr;
+
+	if (!GSConfig.HWSpeculativeReadbacks || GSConfig.HWDownloadMode != GSHardwareDownloadMode::Enabled)
+		return;
+
+	// Targets the game read back during the frame which was ending, and has drawn to since, will probably be read
+	// back again before being drawn to. Queue the copy now so the GPU does it along with the rest of the frame.
+	const u64 frame = g_perfmon.GetFrame();
+	u32 issued = 0;
+	for (int type = 0; type < 2 && issued < NUM_SPECULATIVE_READBACKS; type++)
+	{
+		for (Target* t : m_dst[type])
+		{
+			if (t->m_last_readback_frame + 1 < frame || t->m_drawn_since_read.rempty())
+				continue;
+
+			const GSVector4i r = t->m_drawn_since_read;
+			if (!t->m_dirty.empty() && !t->m_dirty.GetTotalRect(t->m_TEX0, t->m_unscaled_size).rintersect(r).rempty())
+				continue;
+
+			GSTexture::Format fmt;
+			ShaderConvert ps_shader;
+			if (!GetTargetReadbackFormat(t, &fmt, &ps_shader) || GetTargetReadbackWriteMask(t) == 0)
+				continue;
+
+			SpeculativeReadback& srb = m_speculative_readbacks[issued];
+			if (!CopyTargetForReadback(t, r, fmt, ps_shader, &srb.dltex))
+				continue;
+
+			srb.target = t;
+			srb.content_version = t->m_content_version;
+			srb.rect = r;
+			srb.format = fmt;
+			srb.issue_time = Common::Timer::GetCurrentValue();
+			srb.consumed = false;
+			if (++issued == NUM_SPECULATIVE_READBACKS)
+				break;
+		}
+	}
+}
+
 void GSTextureCache::Read(Source* t, const GSVector4i& r)
 {
 	if (r.rempty())
@@ -5754,6 +5980,7 @@ void GSTextureCache::Read(Source* t, const GSVector4i& r)
 		g_gs_renderer->m_mem.WritePixel32(
 			const_cast<u8*>(m_color_download_texture->GetMapPointer()), m_color_download_texture->GetMapPitch(), off, r);
 		m_color_download_texture->Unmap();
+		MarkPagesWritten(off, r);
 	}
 }
 
@@ -6072,14 +6299,24 @@ void GSTextureCache::Source::Flush(u32 count, int layer, const GSOffset& off)
 
 void GSTextureCache::Source::PreloadLevel(int level)
 {
-	// m_TEX0 is adjusted for mips (messy, should be changed).
-	const HashType hash = HashTexture(m_TEX0, m_TEXA, m_region);
-
 	// Layer is complete again, regardless of whether the hash matches or not (and we reupload).
 	const u8 layer_bit = static_cast<u8>(1) << level;
 	m_complete_layers |= layer_bit;
 
+	// Writes to any page of the source invalidate every layer, skip the ones which weren't touched.
+	// m_TEX0 is adjusted for mips (messy, should be changed).
+	const u64 generation = g_texture_cache->GetPageGeneration(m_TEX0, m_region);
+	if ((m_valid_hashes & layer_bit) && m_layer_generation[level] == generation && m_layer_hash_TEX0[level] == m_TEX0)
+	{
+		g_perfmon.Put(GSPerfMon::TextureHashSkips, 1);
+		return;
+	}
+
+	m_layer_hash_TEX0[level] = m_TEX0;
+	m_layer_generation[level] = generation;
+
 	// Check whether the hash matches. Black textures will be 0, so check the valid bit.
+	const HashType hash = HashTexture(m_TEX0, m_TEXA, m_region);
 	if ((m_valid_hashes & layer_bit) && m_layer_hash[level] == hash)
 		return;
 
@@ -6120,6 +6357,7 @@ GSTextureCache::Target::Target(GIFRegTEX0 TEX0, int type, const GSVector2i& unsc
 	m_unscaled_size = unscaled_size;
 	m_scale = scale;
 	m_texture = texture;
+	ContentChanged();
 	m_downscaled = scale == 1.0f && g_gs_renderer->GetUpscaleMultiplier() > 1.0f;
 
 	if ((m_TEX0.PSM & 0xf) == PSMCT24)
@@ -6191,6 +6429,8 @@ void GSTextureCache::Target::Update(bool cannot_scale)
 		return;
 	}
 
+	ContentChanged();
+
 	const GSVector4i t_offset(total_rect.xyxy());
 	const GSVector4i t_size(total_rect - t_offset);
 	const GSVector4 t_sizef(t_size.zwzw());
@@ -6421,8 +6661,30 @@ void GSTextureCache::Target::ResizeDrawn(const GSVector4i& rect)
 }
 
 
+void GSTextureCache::Target::ContentChanged()
+{
+	m_content_version = ++s_target_content_version;
+}
+
+void GSTextureCache::TargetTextureChanged(const GSTexture* tex)
+{
+	for (auto& list : m_dst)
+	{
+		for (Target* t : list)
+		{
+			if (t->m_texture == tex)
+			{
+				t->ContentChanged();
+				return;
+			}
+		}
+	}
+}
+
 void GSTextureCache::Target::UpdateDrawn(const GSVector4i& rect, bool can_update_size)
 {
+	ContentChanged();
+
 	if (m_drawn_since_read.rempty())
 	{
 		m_drawn_since_read = rect.rintersect(m_valid);
@@ -6524,6 +6786,7 @@ bool GSTextureCache::Target::ResizeTexture(int new_unscaled_width, int new_unsca
 
 	m_texture = tex;
 	m_unscaled_size = new_unscaled_size;
+	ContentChanged();
 
 	UpdateTextureDebugName();
 
@@ -6569,11 +6832,7 @@ void GSTextureCache::SourceMap::RemoveAll()
 	for (auto s : m_surfaces)
 	{
 		if (s->m_from_hash_cache)
-		{
-			pxAssert(s->m_from_hash_cache->refcount > 0);
-			if ((--s->m_from_hash_cache->refcount) == 0)
-				s->m_from_hash_cache->age = 0;
-		}
+			ReleaseHashCacheEntry(s->m_from_hash_cache);
 
 		delete s;
 	}
@@ -6599,11 +6858,7 @@ void GSTextureCache::SourceMap::RemoveAt(Source* s)
 	});
 
 	if (s->m_from_hash_cache)
-	{
-		pxAssert(s->m_from_hash_cache->refcount > 0);
-		if ((--s->m_from_hash_cache->refcount) == 0)
-			s->m_from_hash_cache->age = 0;
-	}
+		ReleaseHashCacheEntry(s->m_from_hash_cache);
 
 	delete s;
 }
@@ -6841,13 +7096,19 @@ void GSTextureCache::InjectHashCacheTexture(const HashCacheKey& key, GSTexture*
 	{
 		// We must've got evicted before we finished loading. No matter, add it in there anyway;
 		// if it's not used again, it'll get tossed out later.
-		const HashCacheEntry entry{tex, 1u, 0u, alpha_minmax, true, true};
-		m_hash_cache.emplace(key, entry);
+		HashCacheEntry entry{tex, 1u, 0u, alpha_minmax, true, true};
+		entry.load_cost = REPLACEMENT_TEXTURE_LOAD_COST;
+		ReleaseHashCacheEntry(InsertIntoHashCache(key, entry));
 		return;
 	}
 
 	// Reset age so we don't get thrown out too early.
-	it->second.age = 0;
+	if (it->second.refcount == 0)
+	{
+		AcquireHashCacheEntry(&it->second);
+		ReleaseHashCacheEntry(&it->second);
+	}
+	it->second.load_cost = REPLACEMENT_TEXTURE_LOAD_COST;
 	it->second.alpha_minmax = alpha_minmax;
 	it->second.valid_alpha_minmax = true;
 
@@ -7257,6 +7518,8 @@ static void HashTextureLevel(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, GST
 			for (int y = 0; y < th; y++, ptr += pitch)
 				BlockHashAccumulate(hash_st, ptr, row_size);
 		}
+
+		g_perfmon.Put(GSPerfMon::TextureHashBytes, row_size * static_cast<u32>(th));
 	}
 	else
 	{
@@ -7265,13 +7528,17 @@ static void HashTextureLevel(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, GST
 		const int bottom = block_rect.bottom >> off.blockShiftY();
 		const int xAdd = (1 << off.blockShiftX()) * (psm.bpp / 8);
 
+		u32 blocks = 0;
 		for (; bn.blkY() < bottom; bn.nextBlockY())
 		{
 			for (int x = 0; bn.blkX() < right; bn.nextBlockX(), x += xAdd)
 			{
 				BlockHashAccumulate(hash_st, mem.BlockPtr(bn.value()));
+				blocks++;
 			}
 		}
+
+		g_perfmon.Put(GSPerfMon::TextureHashBytes, blocks * BLOCK_SIZE);
 	}
 }
 
@@ -7283,6 +7550,53 @@ GSTextureCache::HashType GSTextureCache::HashTexture(const GIFRegTEX0& TEX0, con
 	return FinishBlockHash(hash_st);
 }
 
+GSTextureCache::HashType GSTextureCache::HashTexture(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, const GSVector2i* lod, SourceRegion region)
+{
+	BlockHashState hash_st;
+	BlockHashReset(hash_st);
+
+	// base level is always hashed
+	HashTextureLevel(TEX0, TEXA, region, hash_st, s_unswizzle_buffer);
+
+	if (lod)
+	{
+		// hash and combine full mipmaps when enabled
+		const int basemip = lod->x;
+		const int nmips = lod->y - lod->x + 1;
+		for (int i = 1; i < nmips; i++)
+		{
+			const GIFRegTEX0 MIP_TEX0{g_gs_renderer->GetTex0Layer(basemip + i)};
+			HashTextureLevel(MIP_TEX0, TEXA, region.AdjustForMipmap(i), hash_st, s_unswizzle_buffer);
+		}
+	}
+
+	return FinishBlockHash(hash_st);
+}
+
+void GSTextureCache::MarkPagesWritten(const GSOffset& off, const GSVector4i& r)
+{
+	if (r.rempty())
+		return;
+
+	const u64 generation = ++m_page_generation_counter;
+	off.loopPages(r, [this, generation](u32 page) { m_page_generation[page] = generation; });
+}
+
+u64 GSTextureCache::GetPageGeneration(const GIFRegTEX0& TEX0, SourceRegion region) const
+{
+	// Same blocks as HashTextureLevel() and PreloadTexture() read.
+	const GSVector2i& bs = GSLocalMemory::m_psm[TEX0.PSM].bs;
+	const int tw = region.HasX() ? region.GetWidth() : (1 << TEX0.TW);
+	const int th = region.HasY() ? region.GetHeight() : (1 << TEX0.TH);
+	const GSVector4i block_rect(region.GetRect(tw, th).ralign<Align_Outside>(bs));
+
+	u64 generation = 0;
+	g_gs_renderer->m_mem.GetOffset(TEX0.TBP0, TEX0.TBW, TEX0.PSM).loopPages(block_rect, [this, &generation](u32 page) {
+		generation = std::max(generation, m_page_generation[page]);
+	});
+	return generation;
+}
+
 void GSTextureCache::PreloadTexture(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, SourceRegion region, GSLocalMemory& mem,
 	bool paltex, GSTexture* tex, u32 level, std::pair<u8, u8>* alpha_minmax)
 {
@@ -7344,7 +7658,7 @@ GSTextureCache::HashCacheKey::HashCacheKey()
 	TEXA.U64 = 0;
 }
 
-GSTextureCache::HashCacheKey GSTextureCache::HashCacheKey::Create(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, const u32* clut, const GSVector2i* lod, SourceRegion region)
+GSTextureCache::HashCacheKey GSTextureCache::HashCacheKey::Create(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, const u32* clut, HashType tex_hash, SourceRegion region)
 {
 	const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[TEX0.PSM];
 
@@ -7354,27 +7668,7 @@ GSTextureCache::HashCacheKey GSTextureCache::HashCacheKey::Create(const GIFRegTE
 	ret.CLUTHash = clut ? GSTextureCache::PaletteKeyHash{}({clut, psm.pal}) : 0;
 	ret.region_width = static_cast<u16>(region.GetWidth());
 	ret.region_height = static_cast<u16>(region.GetHeight());
-
-	BlockHashState hash_st;
-	BlockHashReset(hash_st);
-
-	// base level is always hashed
-	HashTextureLevel(TEX0, TEXA, region, hash_st, s_unswizzle_buffer);
-
-	if (lod)
-	{
-		// hash and combine full mipmaps when enabled
-		const int basemip = lod->x;
-		const int nmips = lod->y - lod->x + 1;
-		for (int i = 1; i < nmips; i++)
-		{
-			const GIFRegTEX0 MIP_TEX0{g_gs_renderer->GetTex0Layer(basemip + i)};
-			HashTextureLevel(MIP_TEX0, TEXA, region.AdjustForMipmap(i), hash_st, s_unswizzle_buffer);
-		}
-	}
-
-	ret.TEX0Hash = FinishBlockHash(hash_st);
-
+	ret.TEX0Hash = tex_hash;
 	return ret;
 }
 
@@ -7397,3 +7691,10 @@ u64 GSTextureCache::HashCacheKeyHash::operator()(const HashCacheKey& key) const
 		static_cast<u64>(key.region_width) | (static_cast<u64>(key.region_height) << 16));
 	return h;
 }
+
+u64 GSTextureCache::TextureHashMemoKeyHash::operator()(const TextureHashMemoKey& key) const
+{
+	std::size_t h = 0;
+	HashCombine(h, key.TEX0.U64, key.TEXA.U64, key.region.bits);
+	return h;
+}
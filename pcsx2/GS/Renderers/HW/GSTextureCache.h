@@ -7,6 +7,8 @@
 #include "GS/Renderers/Common/GSFastList.h"
 #include "GS/Renderers/Common/GSDirtyRect.h"
 
+#include "common/Timer.h"
+
 #include <unordered_set>
 #include <utility>
 #include <limits>
@@ -94,7 +96,7 @@ public:
 
 		HashCacheKey();
 
-		static HashCacheKey Create(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, const u32* clut, const GSVector2i* lod, SourceRegion region);
+		static HashCacheKey Create(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, const u32* clut, HashType tex_hash, SourceRegion region);
 
 		HashCacheKey WithRemovedCLUTHash() const;
 		void RemoveCLUTHash();
@@ -114,14 +116,49 @@ public:
 	{
 		GSTexture* texture;
 		u32 refcount;
-		u16 age;
+		u32 last_used; // Hash cache frame the last reference was dropped on.
 		std::pair<u8, u8> alpha_minmax;
 		bool valid_alpha_minmax;
 		bool is_replacement;
+		u16 lru_index = 0; // Position in the LRU list while unreferenced, zero otherwise.
+		u32 load_cost = 0; // Microseconds it took to create, i.e. what evicting it costs if it comes back.
+		const HashCacheKey* key = nullptr;
+	};
+
+	struct HashCacheStats
+	{
+		u32 evicted_by_age;
+		u32 evicted_by_size; // Over the entry limit or the memory budget.
+		u64 evicted_bytes;
+		u32 recreated; // Misses on entries which were evicted earlier.
 	};
 
 	using HashCacheMap = std::unordered_map<HashCacheKey, HashCacheEntry, HashCacheKeyHash>;
 
+	/// Texture data hash from the last time a texture was hashed, along with the newest page generation it covered.
+	struct TextureHashMemoKey
+	{
+		GIFRegTEX0 TEX0;
+		GIFRegTEXA TEXA;
+		SourceRegion region;
+
+		__fi bool operator==(const TextureHashMemoKey& e) const { return std::memcmp(this, &e, sizeof(*this)) == 0; }
+	};
+	static_assert(sizeof(TextureHashMemoKey) == 24, "TextureHashMemoKey has no padding");
+
+	struct TextureHashMemoKeyHash
+	{
+		u64 operator()(const TextureHashMemoKey& key) const;
+	};
+
+	struct TextureHashMemoEntry
+	{
+		HashType hash;
+		u64 generation;
+	};
+
+	using TextureHashMemoMap = std::unordered_map<TextureHashMemoKey, TextureHashMemoEntry, TextureHashMemoKeyHash>;
+
 	class Surface : public GSAlignedClass<32>
 	{
 	protected:
@@ -231,6 +268,10 @@ public:
 		GSVector4i m_drawn_since_read{};
 		int readbacks_since_draw = 0;
 
+		// Bumped whenever the texture contents may have changed, a readback copied at an older version is stale.
+		u64 m_content_version = 0;
+		u64 m_last_readback_frame = 0;
+
 	public:
 		Target(GIFRegTEX0 TEX0, int type, const GSVector2i& unscaled_size, float scale, GSTexture* texture);
 		~Target();
@@ -259,6 +300,9 @@ public:
 		/// Resizes target texture, DOES NOT RESCALE.
 		bool ResizeTexture(int new_unscaled_width, int new_unscaled_height, bool recycle_old = true);
 
+		/// Invalidates any readbacks of the target which were issued ahead of time.
+		void ContentChanged();
+
 	private:
 		void UpdateTextureDebugName();
 	};
@@ -299,6 +343,8 @@ public:
 		GIFRegTEX0 m_from_target_TEX0 = {}; // TEX0 of the target texture, if any, else equal to texture TEX0
 		GIFRegTEX0 m_layer_TEX0[7] = {}; // Detect already loaded value
 		HashType m_layer_hash[7] = {};
+		GIFRegTEX0 m_layer_hash_TEX0[7] = {}; // Where the hash was computed, pages only have generations relative to each other
+		u64 m_layer_generation[7] = {};
 		// Keep a GSTextureCache::SourceMap::m_map iterator to allow fast erase
 		// Deliberately not initialized to save cycles.
 		std::array<u16, MAX_PAGES> m_erase_it;
@@ -413,6 +459,14 @@ protected:
 	HashCacheMap m_hash_cache;
 	u64 m_hash_cache_memory_usage = 0;
 	u64 m_hash_cache_replacement_memory_usage = 0;
+	HashCacheStats m_hash_cache_stats = {};
+	std::unordered_set<u64> m_hash_cache_evicted_keys;
+
+	// Every write to local memory stamps the pages it covers with a new generation, so a texture only needs
+	// rehashing when one of its pages has a newer generation than when it was last hashed.
+	std::array<u64, MAX_PAGES> m_page_generation = {};
+	u64 m_page_generation_counter = 0;
+	TextureHashMemoMap m_texture_hash_memo;
 
 	FastList<Target*> m_dst[2];
 	FastList<TargetHeightElem> m_target_heights;
@@ -432,6 +486,21 @@ protected:
 	std::unique_ptr<GSDownloadTexture> m_uint16_download_texture;
 	std::unique_ptr<GSDownloadTexture> m_uint32_download_texture;
 
+	/// Copy of a target queued at the end of a frame, in case the game reads it back again during the next one.
+	struct SpeculativeReadback
+	{
+		const Target* target = nullptr;
+		u64 content_version = 0;
+		GSVector4i rect = {};
+		GSTexture::Format format = GSTexture::Format::Invalid;
+		Common::Timer::Value issue_time = 0;
+		bool consumed = false;
+		std::unique_ptr<GSDownloadTexture> dltex;
+	};
+
+	static constexpr u32 NUM_SPECULATIVE_READBACKS = 2;
+	std::array<SpeculativeReadback, NUM_SPECULATIVE_READBACKS> m_speculative_readbacks;
+
 	Source* CreateSource(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, Target* t, bool half_right, int x_offset, int y_offset, const GSVector2i* lod, const GSVector4i* src_range, GSTexture* gpu_clut, SourceRegion region);
 
 	bool PreloadTarget(GIFRegTEX0 TEX0, const GSVector2i& size, const GSVector2i& valid_size, bool is_frame,
@@ -447,12 +516,34 @@ protected:
 	/// Resizes the download texture if needed.
 	bool PrepareDownloadTexture(u32 width, u32 height, GSTexture::Format format, std::unique_ptr<GSDownloadTexture>* tex);
 
+	static bool GetTargetReadbackFormat(const Target* t, GSTexture::Format* fmt, ShaderConvert* ps_shader);
+	static u32 GetTargetReadbackWriteMask(const Target* t);
+	std::unique_ptr<GSDownloadTexture>* GetReadbackDownloadTexture(GSTexture::Format fmt);
+
+	/// Queues a GPU copy of the target area into the download texture, without waiting for it.
+	bool CopyTargetForReadback(Target* t, const GSVector4i& r, GSTexture::Format fmt, ShaderConvert ps_shader,
+		std::unique_ptr<GSDownloadTexture>* dltex);
+	void WriteTargetReadback(const Target* t, const GSVector4i& r, const u8* bits, u32 pitch, u32 write_mask);
+
+	/// Writes the target area back to local memory from a speculative copy, if one is still valid.
+	bool ReadSpeculativeReadback(const Target* t, const GSVector4i& r, GSTexture::Format fmt, u32 write_mask);
+	void IssueSpeculativeReadbacks();
+
 	HashCacheEntry* LookupHashCache(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, bool& paltex, const u32* clut, const GSVector2i* lod, SourceRegion region);
+	HashCacheEntry* InsertIntoHashCache(const HashCacheKey& key, const HashCacheEntry& entry);
 	void RemoveFromHashCache(HashCacheMap::iterator it);
+	void EvictFromHashCache(HashCacheEntry* entry, bool by_age);
 	void AgeHashCache();
 
+	static void AcquireHashCacheEntry(HashCacheEntry* entry);
+	static void ReleaseHashCacheEntry(HashCacheEntry* entry);
+
 	static void PreloadTexture(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, SourceRegion region, GSLocalMemory& mem, bool paltex, GSTexture* tex, u32 level, std::pair<u8, u8>* alpha_minmax);
 	static HashType HashTexture(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, SourceRegion region);
+	static HashType HashTexture(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, const GSVector2i* lod, SourceRegion region);
+
+	/// Returns the texture data hash, reusing the last one computed if none of the pages it covers were written since.
+	HashType LookupTextureHash(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, const GSVector2i* lod, SourceRegion region);
 
 	// TODO: virtual void Write(Source* s, const GSVector4i& r) = 0;
 	// TODO: virtual void Write(Target* t, const GSVector4i& r) = 0;
@@ -466,6 +557,7 @@ public:
 	__fi u64 GetHashCacheMemoryUsage() const { return m_hash_cache_memory_usage; }
 	__fi u64 GetHashCacheReplacementMemoryUsage() const { return m_hash_cache_replacement_memory_usage; }
 	__fi u64 GetTotalHashCacheMemoryUsage() const { return (m_hash_cache_memory_usage + m_hash_cache_replacement_memory_usage); }
+	__fi const HashCacheStats& GetHashCacheStats() const { return m_hash_cache_stats; }
 	__fi u64 GetSourceMemoryUsage() const { return m_source_memory_usage; }
 	__fi u64 GetTargetMemoryUsage() const { return m_target_memory_usage; }
 
@@ -514,9 +606,18 @@ public:
 	void InvalidateVideoMem(const GSOffset& off, const GSVector4i& r, bool target = true);
 	void InvalidateLocalMem(const GSOffset& off, const GSVector4i& r, bool full_flush = false);
 
+	/// Stamps the pages covered by a write to local memory with a new generation.
+	void MarkPagesWritten(const GSOffset& off, const GSVector4i& r);
+
+	/// Returns the newest generation of the pages read when hashing or loading a texture level.
+	u64 GetPageGeneration(const GIFRegTEX0& TEX0, SourceRegion region) const;
+
 	/// Removes any sources which point to the specified target.
 	void InvalidateSourcesFromTarget(const Target* t);
 
+	/// Bumps the content version of the target owning the texture, for draws which bypass UpdateDrawn().
+	void TargetTextureChanged(const GSTexture* tex);
+
 	/// Replaces a source's texture externally. Required for some CRC hacks.
 	void ReplaceSourceTexture(Source* s, GSTexture* new_texture, float new_scale, const GSVector2i& new_unscaled_size,
 		HashCacheEntry* hc_entry, bool new_texture_is_shared);
@@ -7,6 +7,7 @@
 #include "GS/Renderers/SW/GSRasterizer.h"
 
 #include "common/Console.h"
+#include "common/Threading.h"
 
 #include <fstream>
 
@@ -34,6 +35,8 @@ GSDrawScanline::GSDrawScanline()
 
 GSDrawScanline::~GSDrawScanline()
 {
+	StopPregenerating();
+
 	if (const size_t used = GSCodeReserve::GetMemoryUsed(); used > 0)
 		DevCon.WriteLn("SW JIT generated %zu bytes of code", used);
 }
@@ -115,11 +118,68 @@ void GSDrawScanline::BeginDraw(const GSRasterizerData& data, GSScanlineLocalData
 void GSDrawScanline::ResetCodeCache()
 {
 	Console.Warning("GS Software JIT cache overflow, resetting.");
+	StopPregenerating();
 	m_sp_map.Clear();
 	m_ds_map.Clear();
 	GSCodeReserve::ResetMemory();
 }
 
+void GSDrawScanline::Pregenerate(std::vector<u64> ds_keys, std::vector<u64> sp_keys)
+{
+	StopPregenerating();
+
+#ifdef ENABLE_JIT_RASTERIZER
+	if (ds_keys.empty() && sp_keys.empty())
+		return;
+
+	m_pregenerate_thread = std::thread([this, ds_keys = std::move(ds_keys), sp_keys = std::move(sp_keys)]() {
+		Threading::SetNameOfCurrentThread("GS-SW-JIT");
+
+		const Common::Timer timer;
+		size_t count = 0;
+
+		// Setup functions are few and shared by many draws, do them first
+		for (const u64 key : sp_keys)
+		{
+			if (m_pregenerate_cancel.load(std::memory_order_relaxed) || !m_sp_map.Pregenerate(key))
+				return;
+			count++;
+		}
+
+		for (const u64 key : ds_keys)
+		{
+			if (m_pregenerate_cancel.load(std::memory_order_relaxed) || !m_ds_map.Pregenerate(key))
+				return;
+			count++;
+		}
+
+		DevCon.WriteLn("SW JIT pregenerated %zu functions in %.2f ms", count, timer.GetTimeMilliseconds());
+	});
+#endif
+}
+
+void GSDrawScanline::StopPregenerating()
+{
+	if (!m_pregenerate_thread.joinable())
+		return;
+
+	m_pregenerate_cancel.store(true, std::memory_order_relaxed);
+	m_pregenerate_thread.join();
+	m_pregenerate_cancel.store(false, std::memory_order_relaxed);
+}
+
+void GSDrawScanline::TakeUsedSelectors(std::vector<u64>* ds_keys, std::vector<u64>* sp_keys)
+{
+	*ds_keys = m_ds_map.TakeUsedKeys();
+	*sp_keys = m_sp_map.TakeUsedKeys();
+}
+
+void GSDrawScanline::ResetUsedSelectors()
+{
+	m_ds_map.ResetUsedKeys();
+	m_sp_map.ResetUsedKeys();
+}
+
 bool GSDrawScanline::SetupDraw(GSRasterizerData& data)
 {
 	const GSScanlineGlobalData& global = data.global;
@@ -14,6 +14,10 @@
 #include "GS/Renderers/SW/GSDrawScanlineCodeGenerator.arm64.h"
 #endif
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 struct GSScanlineLocalData;
 
 MULTI_ISA_UNSHARED_START
@@ -39,6 +43,18 @@ public:
 	/// Flushes the code cache, forcing everything to be recompiled.
 	void ResetCodeCache();
 
+	/// Compiles the given selectors on a background thread, so the draws asking for them don't wait on the JIT.
+	void Pregenerate(std::vector<u64> ds_keys, std::vector<u64> sp_keys);
+
+	/// Stops compiling ahead of time, waiting for the background thread to exit.
+	void StopPregenerating();
+
+	/// Returns the selectors draws have asked for since the last call.
+	void TakeUsedSelectors(std::vector<u64>* ds_keys, std::vector<u64>* sp_keys);
+
+	/// Starts recording the selectors draws ask for afresh, including ones already in use. No draws may be in flight.
+	void ResetUsedSelectors();
+
 	/// Populates function pointers. If this returns false, we ran out of code space.
 	bool SetupDraw(GSRasterizerData& data);
 
@@ -55,6 +71,9 @@ private:
 	GSCodeGeneratorFunctionMap<GSSetupPrimCodeGenerator, u64, SetupPrimPtr> m_sp_map;
 	GSCodeGeneratorFunctionMap<GSDrawScanlineCodeGenerator, u64, DrawScanlinePtr> m_ds_map;
 
+	std::thread m_pregenerate_thread;
+	std::atomic_bool m_pregenerate_cancel{false};
+
 	static void CSetupPrim(const GSVertexSW* vertex, const u16* index, const GSVertexSW& dscan, GSScanlineLocalData& local);
 	static void CDrawScanline(int pixels, int left, int top, const GSVertexSW& scan, GSScanlineLocalData& local);
 	static void CDrawEdge(int pixels, int left, int top, const GSVertexSW& scan, GSScanlineLocalData& local);
@@ -68,8 +68,8 @@ using namespace Xbyak;
 	#define _rip_local_d_p(x) _rip_local_d(x)
 #endif
 
-GSDrawScanlineCodeGenerator::GSDrawScanlineCodeGenerator(u64 key, void* code, size_t maxsize)
-	: GSNewCodeGenerator(code, maxsize)
+GSDrawScanlineCodeGenerator::GSDrawScanlineCodeGenerator(u64 key, void* code, size_t maxsize, bool allow_avx512)
+	: GSNewCodeGenerator(code, maxsize, allow_avx512)
 #ifdef _WIN32
 	, a0(rcx), a1(rdx)
 	, a2(r8) , a3(r9)
@@ -230,6 +230,13 @@ void GSDrawScanlineCodeGenerator::alltrue(const XYm& test)
 
 void GSDrawScanlineCodeGenerator::blend(const XYm& a, const XYm& b, const XYm& mask)
 {
+	if (hasAVX512)
+	{
+		// a = mask ? b : a
+		vpternlogd(a, b, mask, 0xd8);
+		return;
+	}
+
 	pand(b, mask);
 	pandn(mask, a);
 	if (hasAVX)
@@ -1124,6 +1131,20 @@ void GSDrawScanlineCodeGenerator::TestZ(const XYm& temp1, const XYm& temp2)
 			psrld(temp2, static_cast<u8>(m_sel.zpsm * 8));
 		}
 
+		if (hasAVX512 && (m_sel.ztst == ZTST_GEQUAL || m_sel.ztst == ZTST_GREATER))
+		{
+			// Compare unsigned straight into a mask register, then set the failing lanes of test
+			// Saves biasing both sides by 0x80000000 and the signed compare/invert dance below
+
+			// GEQUAL: test |= zs < zd;
+			// GREATER: test |= zs <= zd;
+			vpcmpud(k1, xym0, temp2, m_sel.ztst == ZTST_GEQUAL ? 1 /* LT */ : 2 /* LE */);
+			vpternlogd(_test | k1, _test, _test, 0xff);
+
+			alltrue(_test);
+			return;
+		}
+
 		if (m_sel.zpsm == 0)
 		{
 			// GSVector4i o = GSVector4i::x80000000();
@@ -2252,8 +2273,15 @@ void GSDrawScanlineCodeGenerator::TestAlpha()
 			// t = (ga >> 16) != m_local.gd->aref;
 			THREEARG(psrld, xym1, _ga, 16);
 			BROADCAST_AND_OP(vbroadcasti128, pcmpeqd, xym1, xym0, _rip_global(aref));
-			pcmpeqd(xym0, xym0);
-			pxor(xym1, xym0);
+			if (hasAVX512)
+			{
+				vpternlogd(xym1, xym1, xym1, 0x55); // t = ~t
+			}
+			else
+			{
+				pcmpeqd(xym0, xym0);
+				pxor(xym1, xym0);
+			}
 			break;
 
 		case ATST_GEQUAL:
@@ -2434,6 +2462,26 @@ void GSDrawScanlineCodeGenerator::TestDestAlpha()
 
 	// test |= ((fd [<< 16]) ^ m_local.gd->datm).sra32(31);
 
+	if (m_sel.datm && hasAVX512)
+	{
+		// test |= ~((fd [<< 16]).sra32(31));
+
+		if (m_sel.fpsm == 2)
+		{
+			THREEARG(pslld, xym1, _fd, 16);
+			psrad(xym1, 31);
+		}
+		else
+		{
+			THREEARG(psrad, xym1, _fd, 31);
+		}
+
+		vpternlogd(_test, xym1, xym1, 0xf3);
+
+		alltrue(_test);
+		return;
+	}
+
 	if (m_sel.datm)
 	{
 		if (m_sel.fpsm == 2)
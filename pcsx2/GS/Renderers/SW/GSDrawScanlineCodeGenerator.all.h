@@ -71,7 +71,7 @@ class GSDrawScanlineCodeGenerator : public GSNewCodeGenerator
 	const XYm _z, _f, _s, _t, _q, _f_rb, _f_ga;
 
 public:
-	GSDrawScanlineCodeGenerator(u64 key, void* code, size_t maxsize);
+	GSDrawScanlineCodeGenerator(u64 key, void* code, size_t maxsize, bool allow_avx512 = true);
 	void Generate();
 
 private:
@@ -33,6 +33,7 @@ public:
 	using Xmm = Xbyak::Xmm;
 	using Ymm = Xbyak::Ymm;
 	using Zmm = Xbyak::Zmm;
+	using Opmask = Xbyak::Opmask;
 
 private:
 	void requireAVX()
@@ -47,10 +48,11 @@ public:
 	using AddressReg = Xbyak::Reg64;
 	using RipType = Xbyak::RegRip;
 
-	const bool hasAVX, hasAVX2, hasFMA;
+	const bool hasAVX, hasAVX2, hasAVX512, hasFMA;
 
 	const Xmm xmm0{0}, xmm1{1}, xmm2{2}, xmm3{3}, xmm4{4}, xmm5{5}, xmm6{6}, xmm7{7}, xmm8{8}, xmm9{9}, xmm10{10}, xmm11{11}, xmm12{12}, xmm13{13}, xmm14{14}, xmm15{15};
 	const Ymm ymm0{0}, ymm1{1}, ymm2{2}, ymm3{3}, ymm4{4}, ymm5{5}, ymm6{6}, ymm7{7}, ymm8{8}, ymm9{9}, ymm10{10}, ymm11{11}, ymm12{12}, ymm13{13}, ymm14{14}, ymm15{15};
+	const Opmask k1{1};
 	const AddressReg rax{0}, rcx{1}, rdx{2}, rbx{3}, rsp{4}, rbp{5}, rsi{6}, rdi{7}, r8{8},  r9{9},  r10{10},  r11{11},  r12{12},  r13{13},  r14{14},  r15{15};
 	const Reg32      eax{0}, ecx{1}, edx{2}, ebx{3}, esp{4}, ebp{5}, esi{6}, edi{7}, r8d{8}, r9d{9}, r10d{10}, r11d{11}, r12d{12}, r13d{13}, r14d{14}, r15d{15};
 	const Reg16       ax{0},  cx{1},  dx{2},  bx{3},  sp{4},  bp{5},  si{6},  di{7};
@@ -59,10 +61,12 @@ public:
 	const RipType rip{};
 	const Xbyak::AddressFrame ptr{0}, byte{8}, word{16}, dword{32}, qword{64}, xword{128}, yword{256}, zword{512};
 
-	GSNewCodeGenerator(void* code, size_t maxsize)
+	/// allow_avx512 = false emits the VEX sequences even on AVX-512 hosts, so the two can be compared.
+	GSNewCodeGenerator(void* code, size_t maxsize, bool allow_avx512 = true)
 		: actual(maxsize, code)
 		, hasAVX(g_cpu.vectorISA >= ProcessorFeatures::VectorISA::AVX)
 		, hasAVX2(g_cpu.vectorISA >= ProcessorFeatures::VectorISA::AVX2)
+		, hasAVX512(allow_avx512 && g_cpu.hasAVX512)
 		, hasFMA(g_cpu.hasFMA)
 	{
 	}
@@ -83,6 +87,7 @@ public:
 //   SSEONLY: available only on SSE (exception on AVX)
 //   AVX:     available only on AVX (exception on SSE)
 //   AVX2:    available only on AVX2 (exception on AVX/SSE)
+//   AVX512:  available only on AVX-512 F/BW/DQ/VL, EVEX encoded, can be used on xmm/ymm registers (exception otherwise)
 //   FMA:     available only with FMA
 // SFORWARD forwards an SSE-AVX pair where the AVX variant takes the same number of registers (e.g. pshufd dst, src + vpshufd dst, src)
 // AFORWARD forwards an SSE-AVX pair where the AVX variant takes an extra destination register (e.g. shufps dst, src + vshufps dst, src, src)
@@ -118,6 +123,12 @@ public:
 	else \
 		pxFailRel("used AVX instruction in SSE code");
 
+#define ACTUAL_FORWARD_AVX512(name, ...) \
+	if (hasAVX512) \
+		actual.name(__VA_ARGS__); \
+	else \
+		pxFailRel("used AVX-512 instruction in non AVX-512 code");
+
 #define ACTUAL_FORWARD_FMA(name, ...) \
 	if (hasFMA) \
 		actual.name(__VA_ARGS__); \
@@ -333,6 +344,8 @@ public:
 	FORWARD(3, AVX2, vpgatherdd,     const Xmm&, const Address&, const Xmm&);
 	FORWARD(3, AVX2, vpsravd,        ARGS_XXO)
 	FORWARD(3, AVX2, vpsrlvd,        ARGS_XXO)
+	FORWARD(4, AVX512, vpcmpud,      const Opmask&, ARGS_XOI)
+	FORWARD(4, AVX512, vpternlogd,   ARGS_XXO, u8)
 
 #undef ARGS_OI
 #undef ARGS_OO
@@ -355,6 +368,7 @@ public:
 #undef FORWARD2
 #undef FORWARD1
 #undef ACTUAL_FORWARD_FMA
+#undef ACTUAL_FORWARD_AVX512
 #undef ACTUAL_FORWARD_AVX2
 #undef ACTUAL_FORWARD_AVX
 #undef ACTUAL_FORWARD_SSE
@@ -125,7 +125,12 @@ int GSRasterizer::GetPixels(bool reset)
 
 void GSRasterizer::Draw(GSRasterizerData& data)
 {
-	if ((data.vertex && data.vertex_count == 0) || (data.index && data.index_count == 0))
+	Draw(data, data.scissor, data.index, data.index_count);
+}
+
+void GSRasterizer::Draw(GSRasterizerData& data, const GSVector4i& clip, const u16* index, int index_count)
+{
+	if ((data.vertex && data.vertex_count == 0) || (index && index_count == 0))
 		return;
 
 	m_pixels.actual = 0;
@@ -143,16 +148,16 @@ void GSRasterizer::Draw(GSRasterizerData& data)
 	const GSVertexSW* vertex = data.vertex;
 	const GSVertexSW* vertex_end = data.vertex + data.vertex_count;
 
-	const u16* index = data.index;
-	const u16* index_end = data.index + data.index_count;
+	const u16* index_end = index + index_count;
 
 	static constexpr u16 tmp_index[] = {0, 1, 2};
 
-	bool scissor_test = !data.bbox.eq(data.bbox.rintersect(data.scissor));
+	const GSVector4i scissor = data.scissor.rintersect(clip);
+	bool scissor_test = !data.bbox.eq(data.bbox.rintersect(scissor));
 
-	m_scissor = data.scissor;
-	m_fscissor_x = GSVector4(data.scissor).xzxz();
-	m_fscissor_y = GSVector4(data.scissor).ywyw();
+	m_scissor = scissor;
+	m_fscissor_x = GSVector4(scissor).xzxz();
+	m_fscissor_y = GSVector4(scissor).ywyw();
 	m_scanmsk_value = data.scanmsk_value;
 
 	switch (data.primclass)
@@ -161,11 +166,11 @@ void GSRasterizer::Draw(GSRasterizerData& data)
 
 			if (scissor_test)
 			{
-				DrawPoint<true>(vertex, data.vertex_count, index, data.index_count);
+				DrawPoint<true>(vertex, data.vertex_count, index, index_count);
 			}
 			else
 			{
-				DrawPoint<false>(vertex, data.vertex_count, index, data.index_count);
+				DrawPoint<false>(vertex, data.vertex_count, index, index_count);
 			}
 
 			break;
@@ -1205,10 +1210,17 @@ GSRasterizerList::GSRasterizerList(int threads)
 
 GSRasterizerList::~GSRasterizerList()
 {
+	StopTileWorkers();
 	PerformanceMetrics::SetGSSWThreadCount(0);
 	_aligned_free(m_scanline);
 }
 
+GSRasterizerList::BinnedDraw::~BinnedDraw()
+{
+	if (index)
+		GSRingHeap::free(index);
+}
+
 void GSRasterizerList::OnWorkerStartup(int i, u64 affinity)
 {
 	Threading::SetNameOfCurrentThread(StringUtil::StdStringFromFormat("GS-SW-%d", i).c_str());
@@ -1227,6 +1239,217 @@ void GSRasterizerList::OnWorkerShutdown(int i)
 {
 }
 
+void GSRasterizerList::TileWorkerLoop(int id, u64 affinity)
+{
+	OnWorkerStartup(id, affinity);
+
+	TileWorker& worker = *m_tile_workers[id];
+	GSRasterizer& r = *m_r[id];
+	while (true)
+	{
+		worker.sema.WaitForWorkWithSpin();
+		if (m_tile_exit)
+			break;
+
+		for (int tile = TakeTile(id); tile >= 0; tile = TakeTile(id))
+			DrawTile(r, tile);
+	}
+
+	OnWorkerShutdown(id);
+}
+
+int GSRasterizerList::TakeTile(int id)
+{
+	const int threads = static_cast<int>(m_tile_workers.size());
+	for (int i = 0; i < threads; i++)
+	{
+		TileWorker& worker = *m_tile_workers[(id + i) % threads];
+		std::lock_guard<std::mutex> lock(worker.ready_lock);
+		if (worker.ready.empty())
+			continue;
+
+		// Our own tiles in order, other workers' from the back, which they'd get to last
+		int tile;
+		if (i == 0)
+		{
+			tile = worker.ready.front();
+			worker.ready.pop_front();
+		}
+		else
+		{
+			tile = worker.ready.back();
+			worker.ready.pop_back();
+			m_tile_steals.fetch_add(1, std::memory_order_relaxed);
+		}
+		return tile;
+	}
+
+	return -1;
+}
+
+void GSRasterizerList::DrawTile(GSRasterizer& r, int tile)
+{
+	Tile& t = m_tiles[tile];
+	const int tx = tile % TILES_PER_ROW;
+	const int ty = tile / TILES_PER_ROW;
+	const GSVector4i clip = GSVector4i(tx, ty, tx + 1, ty + 1).sll32<TILE_SHIFT>();
+
+	while (true)
+	{
+		TileJob job;
+		{
+			std::lock_guard<std::mutex> lock(t.lock);
+			if (t.jobs.empty())
+			{
+				t.scheduled = false;
+				break;
+			}
+
+			job = std::move(t.jobs.front());
+			t.jobs.pop_front();
+		}
+
+		GSRasterizerData& data = *job.draw->data.get();
+		if (job.draw->index)
+			r.Draw(data, clip, job.draw->index + job.first, job.count);
+		else
+			r.Draw(data, clip, data.index, data.index_count);
+
+		// drop the draw before counting the job done, so it's been released by the time the rasterizer looks synced
+		job.draw = nullptr;
+		m_pending_tile_jobs.fetch_sub(1, std::memory_order_release);
+	}
+}
+
+void GSRasterizerList::QueueTiled(const GSRingHeap::SharedPtr<GSRasterizerData>& data, const GSVector4i& r)
+{
+	if (r.rempty())
+		return;
+
+	const GSVector4i tiles = (r - GSVector4i(0, 0, 1, 1)).sra32<TILE_SHIFT>().sat_i32(GSVector4i::zero(), GSVector4i(TILES_PER_ROW - 1));
+	const int width = tiles.z - tiles.x + 1;
+	const int height = tiles.w - tiles.y + 1;
+	const int count = width * height;
+
+	// Sort the primitives into the tiles they touch, so each worker only walks the ones which hit its tile.
+	// Draws on a single tile, or without an index buffer, get walked in full.
+	GSRingHeap::SharedPtr<BinnedDraw> shared = m_bin_heap.make_shared<BinnedDraw>();
+	BinnedDraw* draw = shared.get();
+	draw->data = data;
+
+	static constexpr int s_prim_vertices[] = {1, 2, 3, 2};
+	const int nverts = (static_cast<u32>(data->primclass) < std::size(s_prim_vertices)) ? s_prim_vertices[data->primclass] : 0;
+	m_bin_offsets.assign(count + 1, 0);
+	if (count > 1 && data->index && nverts > 0)
+	{
+		const int nprims = data->index_count / nverts;
+		const GSVertexSW* vertex = data->vertex;
+		const u16* index = data->index;
+		m_prim_tiles.resize(nprims);
+
+		// Bounds get a pixel of slack either side, a primitive landing in a tile it doesn't touch only costs time
+		for (int i = 0; i < nprims; i++, index += nverts)
+		{
+			GSVector4 pmin = vertex[index[0]].p;
+			GSVector4 pmax = pmin;
+			for (int j = 1; j < nverts; j++)
+			{
+				pmin = pmin.min(vertex[index[j]].p);
+				pmax = pmax.max(vertex[index[j]].p);
+			}
+
+			const GSVector4i pr = (GSVector4i(pmin.xyxy(pmax).floor()) + GSVector4i(-1, -1, 1, 1))
+			                          .sra32<TILE_SHIFT>().sat_i32(tiles.xyxy(), tiles.zwzw()) - tiles.xyxy();
+			m_prim_tiles[i] = pr;
+			for (int y = pr.y; y <= pr.w; y++)
+				for (int x = pr.x; x <= pr.z; x++)
+					m_bin_offsets[y * width + x + 1]++;
+		}
+
+		for (int i = 0; i < count; i++)
+			m_bin_offsets[i + 1] += m_bin_offsets[i];
+
+		draw->index = static_cast<u16*>(m_bin_heap.alloc(sizeof(u16) * nverts * m_bin_offsets[count], 32));
+
+		m_bin_fill.assign(m_bin_offsets.begin(), m_bin_offsets.end() - 1);
+		index = data->index;
+		for (int i = 0; i < nprims; i++, index += nverts)
+		{
+			const GSVector4i& pr = m_prim_tiles[i];
+			for (int y = pr.y; y <= pr.w; y++)
+			{
+				for (int x = pr.x; x <= pr.z; x++)
+				{
+					u16* dst = draw->index + m_bin_fill[y * width + x]++ * nverts;
+					for (int j = 0; j < nverts; j++)
+						dst[j] = index[j];
+				}
+			}
+		}
+	}
+
+	const int threads = static_cast<int>(m_tile_workers.size());
+	u64 notify = 0;
+	int scheduled = 0;
+	for (int y = 0; y < height; y++)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			const int bin = y * width + x;
+			const u32 first = m_bin_offsets[bin] * nverts;
+			const u32 prims = m_bin_offsets[bin + 1] - m_bin_offsets[bin];
+			if (draw->index && prims == 0)
+				continue;
+
+			const int tile = (tiles.y + y) * TILES_PER_ROW + tiles.x + x;
+			Tile& t = m_tiles[tile];
+			bool schedule;
+			m_pending_tile_jobs.fetch_add(1, std::memory_order_relaxed);
+			{
+				std::lock_guard<std::mutex> lock(t.lock);
+				t.jobs.push_back({shared, first, prims * nverts});
+				schedule = !t.scheduled;
+				t.scheduled = true;
+			}
+
+			if (schedule)
+			{
+				const int owner = m_tile_owner[tile];
+				TileWorker& worker = *m_tile_workers[owner];
+				std::lock_guard<std::mutex> lock(worker.ready_lock);
+				worker.ready.push_back(static_cast<u16>(tile));
+				notify |= static_cast<u64>(1) << owner;
+				scheduled++;
+			}
+		}
+	}
+
+	// Wake everyone if there's more tiles than owners woken, the others can steal
+	if (scheduled > std::popcount(notify))
+		notify = ~static_cast<u64>(0);
+
+	for (int i = 0; i < threads; i++)
+	{
+		if (notify & (static_cast<u64>(1) << i))
+			m_tile_workers[i]->sema.NotifyOfWork();
+	}
+}
+
+void GSRasterizerList::StopTileWorkers()
+{
+	if (m_tile_workers.empty())
+		return;
+
+	Sync();
+	m_tile_exit = true;
+	for (std::unique_ptr<TileWorker>& worker : m_tile_workers)
+	{
+		worker->sema.NotifyOfWork();
+		worker->thread.join();
+	}
+	m_tile_workers.clear();
+}
+
 void GSRasterizerList::Queue(const GSRingHeap::SharedPtr<GSRasterizerData>& data)
 {
 	GSVector4i r = data->bbox.rintersect(data->scissor);
@@ -1240,6 +1463,12 @@ void GSRasterizerList::Queue(const GSRingHeap::SharedPtr<GSRasterizerData>& data
 
 	pxAssert(r.top >= 0 && r.top < 2048 && r.bottom >= 0 && r.bottom < 2048);
 
+	if (!m_tile_workers.empty())
+	{
+		QueueTiled(data, r);
+		return;
+	}
+
 	int top = r.top >> m_thread_height;
 	int bottom = std::min<int>((r.bottom + (1 << m_thread_height) - 1) >> m_thread_height, top + m_workers.size());
 
@@ -1258,12 +1487,20 @@ void GSRasterizerList::Sync()
 			m_workers[i]->Wait();
 		}
 
+		// Only this thread hands out tiles, so once every worker's idle, nothing can be left
+		for (const std::unique_ptr<TileWorker>& worker : m_tile_workers)
+			worker->sema.WaitForEmptyWithSpin();
+		pxAssert(m_pending_tile_jobs.load(std::memory_order_acquire) == 0);
+
 		g_perfmon.Put(GSPerfMon::SyncPoint, 1);
 	}
 }
 
 bool GSRasterizerList::IsSynced() const
 {
+	if (m_pending_tile_jobs.load(std::memory_order_acquire) != 0)
+		return false;
+
 	for (size_t i = 0; i < m_workers.size(); i++)
 	{
 		if (!m_workers[i]->IsEmpty())
@@ -1279,7 +1516,7 @@ int GSRasterizerList::GetPixels(bool reset)
 {
 	int pixels = 0;
 
-	for (size_t i = 0; i < m_workers.size(); i++)
+	for (size_t i = 0; i < m_r.size(); i++)
 	{
 		pixels += m_r[i]->GetPixels(reset);
 	}
@@ -1303,6 +1540,35 @@ std::unique_ptr<IRasterizer> GSRasterizerList::Create(int threads)
 	if (EmuConfig.EnableThreadPinning && !pin)
 		WARNING_LOG("Not pinning SW threads, we need {} processors, but only have {}", threads, procs.size());
 
+	if (GSConfig.SWRasterMode == GSSWRasterMode::Tiled)
+	{
+		// Every worker draws whole tiles, so each rasterizer owns all scanlines
+		threads = std::min<int>(threads, 64);
+		rl->m_tiles = std::make_unique<Tile[]>(TILES_PER_ROW * TILES_PER_ROW);
+		rl->m_tile_owner = std::make_unique<u8[]>(TILES_PER_ROW * TILES_PER_ROW);
+
+		// Spread neighbouring tiles over different workers, since draws tend to be local
+		for (int y = 0; y < TILES_PER_ROW; y++)
+		{
+			for (int x = 0; x < TILES_PER_ROW; x++)
+				rl->m_tile_owner[y * TILES_PER_ROW + x] = static_cast<u8>((x + y * 5) % threads);
+		}
+
+		for (int i = 0; i < threads; i++)
+		{
+			rl->m_r.push_back(std::unique_ptr<GSRasterizer>(new GSRasterizer(&rl->m_ds, 0, 1)));
+			rl->m_tile_workers.push_back(std::make_unique<TileWorker>());
+		}
+
+		for (int i = 0; i < threads; i++)
+		{
+			const u64 affinity = pin ? (static_cast<u64>(1u) << procs[i]) : 0;
+			rl->m_tile_workers[i]->thread = std::thread(&GSRasterizerList::TileWorkerLoop, rl.get(), i, affinity);
+		}
+
+		return rl;
+	}
+
 	for (int i = 0; i < threads; i++)
 	{
 		const u64 affinity = pin ? (static_cast<u64>(1u) << procs[i]) : 0;
@@ -1319,4 +1585,6 @@ std::unique_ptr<IRasterizer> GSRasterizerList::Create(int threads)
 
 void GSRasterizerList::PrintStats()
 {
+	if (!m_tile_workers.empty())
+		DevCon.WriteLn("GSRasterizerList: %llu tiles stolen", static_cast<unsigned long long>(m_tile_steals.load(std::memory_order_relaxed)));
 }
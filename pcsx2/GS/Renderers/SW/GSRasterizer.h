@@ -11,6 +11,9 @@
 #include "GS/GSRingHeap.h"
 #include "GS/MultiISA.h"
 
+#include <atomic>
+#include <deque>
+
 MULTI_ISA_UNSHARED_START
 
 class GSDrawScanline;
@@ -117,6 +120,8 @@ public:
 	__forceinline int FindMyNextScanline(int top) const;
 
 	void Draw(GSRasterizerData& data);
+	/// Draw only the pixels inside `clip`, using the given subset of the draw's indices
+	void Draw(GSRasterizerData& data, const GSVector4i& clip, const u16* index, int index_count);
 	int GetPixels(bool reset);
 };
 
@@ -130,6 +135,7 @@ public:
 	virtual bool IsSynced() const = 0;
 	virtual int GetPixels(bool reset = true) = 0;
 	virtual void PrintStats() = 0;
+	virtual GSDrawScanline& GetDrawScanline() = 0;
 };
 
 class GSSingleRasterizer final : public IRasterizer
@@ -143,6 +149,7 @@ public:
 	bool IsSynced() const override;
 	int GetPixels(bool reset = true) override;
 	void PrintStats() override;
+	GSDrawScanline& GetDrawScanline() override { return m_ds; }
 
 	void Draw(GSRasterizerData& data);
 
@@ -156,6 +163,44 @@ class GSRasterizerList final : public IRasterizer
 protected:
 	using GSWorker = GSJobQueue<GSRingHeap::SharedPtr<GSRasterizerData>, 65536>;
 
+	static constexpr int TILE_SHIFT = 6;
+	static constexpr int TILES_PER_ROW = 2048 >> TILE_SHIFT;
+
+	/// A draw with its primitives sorted by the tiles they touch
+	struct BinnedDraw
+	{
+		GSRingHeap::SharedPtr<GSRasterizerData> data;
+		/// Index lists of all tiles back to back, or null if tiles walk all of the draw's primitives
+		u16* index = nullptr;
+
+		~BinnedDraw();
+	};
+
+	struct TileJob
+	{
+		GSRingHeap::SharedPtr<BinnedDraw> draw;
+		u32 first;
+		u32 count;
+	};
+
+	struct Tile
+	{
+		std::mutex lock;
+		/// Draws touching this tile, in submission order
+		std::deque<TileJob> jobs;
+		/// True while the tile is in a worker's ready list or being drawn, so only one worker has it at a time
+		bool scheduled = false;
+	};
+
+	struct TileWorker
+	{
+		std::thread thread;
+		Threading::WorkSema sema;
+		std::mutex ready_lock;
+		/// Tiles with pending jobs, owned by this worker until someone else steals them
+		std::deque<u16> ready;
+	};
+
 	GSDrawScanline m_ds;
 
 	// Worker threads depend on the rasterizers, so don't change the order.
@@ -164,11 +209,31 @@ protected:
 	u8* m_scanline;
 	int m_thread_height;
 
+	// Tile binning mode, used instead of m_workers when GSConfig.SWRasterMode is Tiled.
+	std::unique_ptr<Tile[]> m_tiles;
+	std::unique_ptr<u8[]> m_tile_owner;
+	std::vector<std::unique_ptr<TileWorker>> m_tile_workers;
+	std::atomic<u32> m_pending_tile_jobs{0};
+	std::atomic<u64> m_tile_steals{0};
+	bool m_tile_exit = false;
+	GSRingHeap m_bin_heap;
+	std::vector<GSVector4i> m_prim_tiles;
+	std::vector<u32> m_bin_offsets;
+	std::vector<u32> m_bin_fill;
+
 	GSRasterizerList(int threads);
 
 	static void OnWorkerStartup(int i, u64 affinity);
 	static void OnWorkerShutdown(int i);
 
+	void TileWorkerLoop(int id, u64 affinity);
+	/// Take a tile from this worker's ready list, or steal one from another worker
+	int TakeTile(int id);
+	/// Run all jobs of a tile which the calling worker holds
+	void DrawTile(GSRasterizer& r, int tile);
+	void QueueTiled(const GSRingHeap::SharedPtr<GSRasterizerData>& data, const GSVector4i& r);
+	void StopTileWorkers();
+
 public:
 	~GSRasterizerList() override;
 
@@ -181,6 +246,7 @@ public:
 	bool IsSynced() const override;
 	int GetPixels(bool reset) override;
 	void PrintStats() override;
+	GSDrawScanline& GetDrawScanline() override { return m_ds; }
 };
 
 MULTI_ISA_UNSHARED_END
@@ -5,7 +5,13 @@
 #include "GS/GSGL.h"
 #include "GS/GSPng.h"
 #include "GS/GSUtil.h"
+#include "BuildVersion.h"
+#include "Config.h"
+#include "VMManager.h"
 
+#include "common/Console.h"
+#include "common/FileSystem.h"
+#include "common/Path.h"
 #include "common/StringUtil.h"
 
 MULTI_ISA_UNSHARED_IMPL;
@@ -22,7 +28,7 @@ GSRenderer* CURRENT_ISA::makeGSRendererSW(int threads)
 static constexpr GSVector4 s_pos_scale = GSVector4::cxpr(1.0f / 16, 1.0f / 16, 1.0f, 128.0f);
 
 GSRendererSW::GSRendererSW(int threads)
-	: GSRenderer(), m_fzb(NULL)
+	: GSRenderer()
 {
 	m_nativeres = true; // ignore ini, sw is always native
 
@@ -31,8 +37,9 @@ GSRendererSW::GSRendererSW(int threads)
 
 	m_output = (u8*)_aligned_malloc(1024 * 1024 * sizeof(u32), VECTOR_ALIGNMENT);
 
-	std::fill(std::begin(m_fzb_pages), std::end(m_fzb_pages), 0);
-	std::fill(std::begin(m_tex_pages), std::end(m_tex_pages), 0);
+	m_draw_retired = std::make_unique<std::atomic<bool>[]>(DRAW_RING_SIZE);
+
+	LoadSelectors();
 }
 
 GSRendererSW::~GSRendererSW()
@@ -54,6 +61,9 @@ void GSRendererSW::Reset(bool hardware_reset)
 
 void GSRendererSW::Destroy()
 {
+	if (m_rl)
+		SaveSelectors();
+
 	// Need to destroy worker queue first to stop any pending thread work
 	m_rl.reset();
 	m_tc.reset();
@@ -68,6 +78,128 @@ void GSRendererSW::Destroy()
 	m_output = nullptr;
 }
 
+void GSRendererSW::GameChanged()
+{
+	if (VMManager::GetDiscSerial() == m_selector_serial)
+		return;
+
+	// draws still in flight use the active functions LoadSelectors() drops
+	Sync(-1);
+
+	SaveSelectors();
+	LoadSelectors();
+}
+
+// The selectors a game's draws needed are kept per serial, so the next run can compile them before they're asked for.
+
+static constexpr u32 SELECTOR_CACHE_MAGIC = 0x544A5753; // SWJT
+static constexpr u32 SELECTOR_CACHE_VERSION = 2;
+
+struct SelectorCacheHeader
+{
+	u32 magic;
+	u32 version;
+	u64 build;
+	u32 ds_count;
+	u32 sp_count;
+};
+
+/// Selector keys are only meaningful to the build which wrote them, since their bit layout changes between versions.
+static u64 GetSelectorCacheBuild()
+{
+	u64 hash = std::hash<std::string_view>()(BuildVersion::GitHash);
+	hash = hash * 31 + sizeof(GSScanlineSelector);
+	return hash;
+}
+
+static std::string GetSelectorCachePath(const std::string& serial)
+{
+	return Path::Combine(EmuFolders::Cache, fmt::format("sw_jit_{}.bin", Path::SanitizeFileName(serial)));
+}
+
+void GSRendererSW::LoadSelectors()
+{
+	GSDrawScanline& ds = m_rl->GetDrawScanline();
+	ds.StopPregenerating();
+	g_gs_code_cache_stats.Reset();
+
+	m_selector_serial = VMManager::GetDiscSerial();
+	m_saved_ds_selectors.clear();
+	m_saved_sp_selectors.clear();
+
+	// don't carry over what the previous game used
+	ds.ResetUsedSelectors();
+
+	if (m_selector_serial.empty())
+		return;
+
+	const std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(GetSelectorCachePath(m_selector_serial).c_str());
+	if (!data.has_value() || data->size() < sizeof(SelectorCacheHeader))
+		return;
+
+	SelectorCacheHeader header;
+	std::memcpy(&header, data->data(), sizeof(header));
+
+	if (header.magic == SELECTOR_CACHE_MAGIC && (header.version != SELECTOR_CACHE_VERSION || header.build != GetSelectorCacheBuild()))
+	{
+		DevCon.WriteLn("(GSRendererSW) JIT selector cache for %s is from another build, ignoring", m_selector_serial.c_str());
+		return;
+	}
+
+	if (header.magic != SELECTOR_CACHE_MAGIC ||
+		data->size() != sizeof(header) + (static_cast<size_t>(header.ds_count) + header.sp_count) * sizeof(u64))
+	{
+		Console.Warning("(GSRendererSW) Ignoring invalid JIT selector cache for %s", m_selector_serial.c_str());
+		return;
+	}
+
+	const u8* keys = data->data() + sizeof(header);
+	m_saved_ds_selectors.resize(header.ds_count);
+	m_saved_sp_selectors.resize(header.sp_count);
+	std::memcpy(m_saved_ds_selectors.data(), keys, header.ds_count * sizeof(u64));
+	std::memcpy(m_saved_sp_selectors.data(), keys + header.ds_count * sizeof(u64), header.sp_count * sizeof(u64));
+
+	DevCon.WriteLn("(GSRendererSW) Pregenerating %u scanline and %u setup functions for %s",
+		header.ds_count, header.sp_count, m_selector_serial.c_str());
+
+	ds.Pregenerate(m_saved_ds_selectors, m_saved_sp_selectors);
+}
+
+void GSRendererSW::SaveSelectors()
+{
+	if (m_selector_serial.empty())
+		return;
+
+	std::vector<u64> ds_keys, sp_keys;
+	m_rl->GetDrawScanline().TakeUsedSelectors(&ds_keys, &sp_keys);
+
+	const auto merge = [](std::vector<u64>& keys, const std::vector<u64>& saved) {
+		keys.insert(keys.end(), saved.begin(), saved.end());
+		std::sort(keys.begin(), keys.end());
+		keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+	};
+	merge(ds_keys, m_saved_ds_selectors);
+	merge(sp_keys, m_saved_sp_selectors);
+
+	// nothing new since it was loaded
+	if (ds_keys.size() == m_saved_ds_selectors.size() && sp_keys.size() == m_saved_sp_selectors.size())
+		return;
+
+	const SelectorCacheHeader header = {SELECTOR_CACHE_MAGIC, SELECTOR_CACHE_VERSION, GetSelectorCacheBuild(),
+		static_cast<u32>(ds_keys.size()), static_cast<u32>(sp_keys.size())};
+
+	std::vector<u8> data(sizeof(header) + (ds_keys.size() + sp_keys.size()) * sizeof(u64));
+	std::memcpy(data.data(), &header, sizeof(header));
+	std::memcpy(data.data() + sizeof(header), ds_keys.data(), ds_keys.size() * sizeof(u64));
+	std::memcpy(data.data() + sizeof(header) + ds_keys.size() * sizeof(u64), sp_keys.data(), sp_keys.size() * sizeof(u64));
+
+	if (!FileSystem::WriteBinaryFile(GetSelectorCachePath(m_selector_serial).c_str(), data.data(), data.size()))
+		Console.Warning("(GSRendererSW) Failed to write JIT selector cache for %s", m_selector_serial.c_str());
+
+	m_saved_ds_selectors = std::move(ds_keys);
+	m_saved_sp_selectors = std::move(sp_keys);
+}
+
 void GSRendererSW::VSync(u32 field, bool registers_written, bool idle_frame)
 {
 	Sync(0); // IncAge might delete a cached texture in use
@@ -413,23 +545,19 @@ void GSRendererSW::Draw()
 		zb_pages = &_zb_pages;
 	}
 
+	AdvanceRetired();
+
 	// check if there is an overlap between this and previous targets
 
-	if (CheckTargetPages(fb_pages, zb_pages, r))
-	{
-		sd->m_syncpoint = SharedData::SyncTarget;
-	}
+	sd->m_target_dep = CheckTargetPages(fb_pages, zb_pages, sd->global.sel.fwrite, sd->global.sel.zwrite);
 
 	// check if the texture is not part of a target currently in use
 
-	if (CheckSourcePages(sd))
-	{
-		sd->m_syncpoint = SharedData::SyncSource;
-	}
+	sd->m_source_dep = CheckSourcePages(sd);
 
-	// addref source and target pages
+	// number the draw and mark its source and target pages
 
-	sd->UsePages(fb_pages, m_context->offset.fb.psm(), zb_pages, m_context->offset.zb.psm());
+	sd->UsePages(fb_pages, m_context->offset.fb, zb_pages, m_context->offset.zb, r);
 
 	//
 
@@ -528,19 +656,15 @@ void GSRendererSW::Queue(GSRingHeap::SharedPtr<GSRasterizerData>& item)
 {
 	SharedData* sd = (SharedData*)item.get();
 
-	if (sd->m_syncpoint == SharedData::SyncSource)
-	{
-		Sync(4);
-	}
+	// only the draws writing to the texture have to finish, later ones can keep going
+
+	WaitForDraw(sd->m_source_dep, GSPerfMon::SyncSource);
 
 	// update previously invalidated parts
 
 	sd->UpdateSource();
 
-	if (sd->m_syncpoint == SharedData::SyncTarget)
-	{
-		Sync(5);
-	}
+	WaitForDraw(sd->m_target_dep, GSPerfMon::SyncTarget);
 
 	if constexpr (LOG)
 	{
@@ -557,6 +681,7 @@ void GSRendererSW::Queue(GSRingHeap::SharedPtr<GSRasterizerData>& item)
 	}
 
 	m_rl->Queue(item);
+	m_queued_seq = sd->m_seq;
 
 	// invalidate new parts rendered onto
 
@@ -577,6 +702,9 @@ void GSRendererSW::Sync(int reason)
 
 	u64 t = LOG ? GetCPUTicks() : 0;
 
+	if (!m_rl->IsSynced())
+		g_perfmon.Put((reason == 2 || reason == 3) ? GSPerfMon::SyncDump : GSPerfMon::SyncFrame, 1);
+
 	m_rl->Sync();
 
 	if constexpr (LOG && false)
@@ -622,19 +750,24 @@ void GSRendererSW::InvalidateVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, const GS
 	GSOffset off = m_mem.GetOffset(BITBLTBUF.DBP, BITBLTBUF.DBW, BITBLTBUF.DPSM);
 	GSOffset::PageLooper pages = off.pageLooperForRect(r);
 
-	// check if the changing pages either used as a texture or a target
+	// wait for the draws using the changing pages either as a texture or a target
 
-	if (!m_rl->IsSynced())
+	// This can't be queued behind them like a draw. GSState swizzles the data into local memory as soon as this
+	// returns, and the rasterizer has no job that every worker would have to reach before any of them continues,
+	// which a deferred copy needs so that no worker reads the pages before another one has written them.
+
+	AdvanceRetired();
+
+	if (m_retired_seq < m_draw_seq)
 	{
-		pages.loopPagesWithBreak([this](u32 page)
+		u64 dep = 0;
+		pages.loopPages([this, &dep](u32 page)
 		{
-			if (m_fzb_pages[page] | m_tex_pages[page])
-			{
-				Sync(6);
-				return false;
-			}
-			return true;
+			const PageUse& use = m_page_use[page];
+			dep = std::max({dep, use.fb, use.zb, use.tex});
 		});
+
+		WaitForDraw(dep, GSPerfMon::SyncTransfer);
 	}
 
 	m_tc->InvalidatePages(pages, off.psm()); // if texture update runs on a thread and Sync(5) happens then this must come later
@@ -648,283 +781,295 @@ void GSRendererSW::InvalidateLocalMem(const GIFRegBITBLTBUF& BITBLTBUF, const GS
 		fflush(s_fp);
 	}
 
-	if (!m_rl->IsSynced())
+	// only the draws writing to the blocks being read back have to finish
+
+	AdvanceRetired();
+
+	if (m_retired_seq < m_draw_seq)
 	{
 		GSOffset off = m_mem.GetOffset(BITBLTBUF.SBP, BITBLTBUF.SBW, BITBLTBUF.SPSM);
-		GSOffset::PageLooper pages = off.pageLooperForRect(r);
 
-		pages.loopPagesWithBreak([this](u32 page)
-		{
-			if (m_fzb_pages[page])
-			{
-				Sync(7);
-				return false;
-			}
-			return true;
-		});
+		WaitForDraw(GetWriteDependency(off, r), GSPerfMon::SyncReadback);
 	}
 }
 
-void GSRendererSW::UsePages(const GSOffset::PageLooper& pages, const int type)
+/// Identifies how a buffer maps pixels to memory, two buffers with the same layout put a pixel at the same address
+static u32 GetPageLayout(const GSOffset& off)
 {
-	pages.loopPages([this, type](u32 page)
+	return off.bp() | (off.bw() << 14) | (off.psm() << 20);
+}
+
+/// Calls fn(page, blocks) with a mask of the blocks the rectangle covers, for every page it touches
+template <typename Fn>
+static void LoopPageBlocks(const GSOffset& off, const GSVector4i& r, Fn&& fn)
+{
+	const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[off.psm()];
+	const GSVector4i rb = r.ralign<Align_Outside>(psm.bs);
+
+	const auto loop_blocks = [&off, &fn](const GSVector4i& br)
 	{
-		switch (type)
+		if (br.rempty())
+			return;
+
+		const int bottom = br.bottom >> off.blockShiftY();
+		const int right = br.right >> off.blockShiftX();
+
+		for (GSOffset::BNHelper bn = off.bnMulti(br.left, br.top); bn.blkY() < bottom; bn.nextBlockY())
 		{
-			case 0:
-				pxAssert((m_fzb_pages[page] & 0xFFFF) < USHRT_MAX);
-				m_fzb_pages[page] += 1;
-				break;
-			case 1:
-				pxAssert((m_fzb_pages[page] >> 16) < USHRT_MAX);
-				m_fzb_pages[page] += 0x10000;
-				break;
-			case 2:
-				pxAssert(m_tex_pages[page] < USHRT_MAX);
-				m_tex_pages[page] += 1;
-				break;
-			default:
-				break;
+			for (; bn.blkX() < right; bn.nextBlockX())
+			{
+				const u32 block = bn.value();
+
+				fn(block >> 5, 1u << (block & 31));
+			}
 		}
+	};
+
+	// whole pages inside the rectangle don't need walking block by block, as long as the buffer starts on a page
+
+	const GSVector4i inner = rb.ralign<Align_Inside>(psm.pgs);
+
+	if ((off.bp() & 31) != 0 || inner.rempty())
+	{
+		loop_blocks(rb);
+		return;
+	}
+
+	off.pageLooperForRect(inner).loopPages([&fn](u32 page)
+	{
+		fn(page, 0xFFFFFFFFu);
 	});
+
+	loop_blocks(GSVector4i(rb.left, rb.top, rb.right, inner.top));
+	loop_blocks(GSVector4i(rb.left, inner.bottom, rb.right, rb.bottom));
+	loop_blocks(GSVector4i(rb.left, inner.top, inner.left, inner.bottom));
+	loop_blocks(GSVector4i(inner.right, inner.top, rb.right, inner.bottom));
 }
 
-void GSRendererSW::ReleasePages(const GSOffset::PageLooper& pages, const int type)
+u64 GSRendererSW::BeginDraw()
 {
-	pages.loopPages([this, type](u32 page)
+	// the flag of the draw one lap behind must have been consumed before it can be reused
+
+	if (m_draw_seq + 1 - m_retired_seq > DRAW_RING_SIZE)
 	{
-		switch (type)
-		{
-			case 0:
-				pxAssert((m_fzb_pages[page] & 0xFFFF) > 0);
-				m_fzb_pages[page] -= 1;
-				break;
-			case 1:
-				pxAssert((m_fzb_pages[page] >> 16) > 0);
-				m_fzb_pages[page] -= 0x10000;
-				break;
-			case 2:
-				pxAssert(m_tex_pages[page] > 0);
-				m_tex_pages[page] -= 1;
-				break;
-			default:
-				break;
-		}
-	});
+		m_rl->Sync();
+		WaitForRetired(m_draw_seq + 1 - DRAW_RING_SIZE);
+	}
+
+	return ++m_draw_seq;
 }
 
-bool GSRendererSW::CheckTargetPages(const GSOffset::PageLooper* fb_pages, const GSOffset::PageLooper* zb_pages, const GSVector4i& r)
+void GSRendererSW::RetireDraw(const u64 seq)
 {
-	const bool synced = m_rl->IsSynced();
+	// called from the worker dropping the last reference, everything the draw wrote is visible to whoever sees the flag
 
-	const bool fb = (fb_pages != nullptr);
-	const bool zb = (zb_pages != nullptr);
+	m_draw_retired[seq & (DRAW_RING_SIZE - 1)].store(true, std::memory_order_release);
 
-	GSOffset::PageLooper _fb_pages, _zb_pages;
-	const auto requirePages = [this, &fb_pages, &zb_pages, &r, &_fb_pages, &_zb_pages]
+	// pairs with the fence in WaitForRetired, either it sees the flag or we see it waiting
+
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	if (m_retire_waiting.load(std::memory_order_relaxed) && m_retire_waiting.exchange(false, std::memory_order_relaxed))
 	{
-		if (!fb_pages)
-		{
-			_fb_pages = m_context->offset.fb.pageLooperForRect(r);
-			fb_pages = &_fb_pages;
-		}
-		if (!zb_pages)
-		{
-			_zb_pages = m_context->offset.zb.pageLooperForRect(r);
-			zb_pages = &_zb_pages;
-		}
-	};
+		m_retire_sema.Post();
+	}
+}
 
-	bool res = false;
+void GSRendererSW::AdvanceRetired()
+{
+	// draws finish out of order, only move past the ones without anything unfinished before them
 
-	if (m_fzb != m_context->offset.fzb4)
+	while (m_retired_seq < m_draw_seq)
 	{
-		// targets changed, check everything
+		std::atomic<bool>& retired = m_draw_retired[(m_retired_seq + 1) & (DRAW_RING_SIZE - 1)];
 
-		m_fzb = m_context->offset.fzb4;
-		m_fzb_bbox = r;
+		if (!retired.load(std::memory_order_acquire))
+			break;
 
-		memset(m_fzb_cur_pages, 0, sizeof(m_fzb_cur_pages));
+		retired.store(false, std::memory_order_relaxed);
+		m_retired_seq++;
+	}
+}
 
-		u32 used = 0;
+void GSRendererSW::WaitForDraw(u64 seq, GSPerfMon::counter_t reason)
+{
+	AdvanceRetired();
 
-		requirePages();
+	if (seq <= m_retired_seq)
+		return;
 
-		fb_pages->loopPages([this, &used](u32 i)
-		{
-			const u32 row = i >> 5;
-			const u32 col = 1 << (i & 31);
+	g_perfmon.Put(reason, 1);
 
-			m_fzb_cur_pages[row] |= col;
+	if constexpr (LOG)
+	{
+		fprintf(s_fp, "wait n=%d r=%d seq=%" PRIu64 " last=%" PRIu64 "\n", s_n, (int)reason, seq, m_queued_seq);
+		fflush(s_fp);
+	}
 
-			used |= m_fzb_pages[i];
-			used |= m_tex_pages[i];
-		});
+	// nothing queued after it, letting the workers go idle is the same but doesn't poll
 
-		zb_pages->loopPages([this, &used](u32 i)
-		{
-			const u32 row = i >> 5;
-			const u32 col = 1 << (i & 31);
+	if (seq >= m_queued_seq)
+	{
+		m_rl->Sync();
+	}
 
-			m_fzb_cur_pages[row] |= col;
+	WaitForRetired(seq);
+}
 
-			used |= m_fzb_pages[i];
-			used |= m_tex_pages[i];
-		});
+void GSRendererSW::WaitForRetired(u64 seq)
+{
+	// most waits are for a draw that's nearly done, so spin for a bit before going to sleep
 
-		if (!synced)
-		{
-			if (used)
-			{
-				if constexpr (LOG)
-				{
-					fprintf(s_fp, "syncpoint 0\n");
-					fflush(s_fp);
-				}
+	for (u32 spins = 0; spins < 64; spins++)
+	{
+		AdvanceRetired();
 
-				res = true;
-			}
+		if (seq <= m_retired_seq)
+			return;
 
-			//if(LOG) {fprintf(s_fp, "no syncpoint *\n"); fflush(s_fp);}
-		}
+		Threading::SpinWait();
 	}
-	else
+
+	// each wake up only means some draw retired, which might not be the one we want yet
+
+	for (;;)
 	{
-		// same target, only check new areas and cross-rendering between frame and z-buffer
+		m_retire_waiting.store(true, std::memory_order_relaxed);
+
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		AdvanceRetired();
+
+		if (seq <= m_retired_seq)
+		{
+			// a worker which already took the flag is about to post, eat it so the next wait doesn't return early
+
+			if (!m_retire_waiting.exchange(false, std::memory_order_relaxed))
+			{
+				m_retire_sema.Wait();
+			}
 
-		const GSVector4i bbox = m_fzb_bbox.runion(r);
+			return;
+		}
 
-		const bool check = !m_fzb_bbox.eq(bbox);
+		m_retire_sema.Wait();
+	}
+}
 
-		m_fzb_bbox = bbox;
+void GSRendererSW::UsePages(const GSOffset::PageLooper& pages, const int type, const u64 seq, const u32 layout)
+{
+	pages.loopPages([this, type, seq, layout](u32 page)
+	{
+		PageUse& use = m_page_use[page];
 
-		if (check)
+		switch (type)
 		{
-			// drawing area is larger than previous time, check new parts only to avoid false positives (m_fzb_cur_pages guards)
+			case 0:
+				use.fb_layout = (use.fb <= m_retired_seq || use.fb_layout == layout) ? layout : LAYOUT_MIXED;
+				use.fb = seq;
+				break;
+			case 1:
+				use.zb_layout = (use.zb <= m_retired_seq || use.zb_layout == layout) ? layout : LAYOUT_MIXED;
+				use.zb = seq;
+				break;
+			case 2:
+				use.tex = seq;
+				break;
+			default:
+				break;
+		}
+	});
+}
 
-			requirePages();
+void GSRendererSW::UseBlocks(const GSOffset& off, const GSVector4i& r, const u64 seq)
+{
+	LoopPageBlocks(off, r, [this, seq](u32 page, u32 blocks)
+	{
+		PageUse& use = m_page_use[page];
 
-			u32 used = 0;
+		if (use.write <= m_retired_seq)
+			use.write_blocks = 0;
 
-			fb_pages->loopPages([this, &used](u32 i)
-			{
-				u32 row = i >> 5;
-				u32 col = 1 << (i & 31);
+		use.write_blocks |= blocks;
+		use.write = seq;
+	});
+}
 
-				if ((m_fzb_cur_pages[row] & col) == 0)
-				{
-					m_fzb_cur_pages[row] |= col;
+u64 GSRendererSW::GetWriteDependency(const GSOffset& off, const GSVector4i& r) const
+{
+	u64 dep = 0;
 
-					used |= m_fzb_pages[i];
-				}
-			});
+	LoopPageBlocks(off, r, [this, &dep](u32 page, u32 blocks)
+	{
+		const PageUse& use = m_page_use[page];
 
-			zb_pages->loopPages([this, &used](u32 i)
-			{
-				u32 row = i >> 5;
-				u32 col = 1 << (i & 31);
+		if (use.write > dep && (use.write_blocks & blocks) != 0)
+			dep = use.write;
+	});
 
-				if ((m_fzb_cur_pages[row] & col) == 0)
-				{
-					m_fzb_cur_pages[row] |= col;
+	return dep > m_retired_seq ? dep : 0;
+}
 
-					used |= m_fzb_pages[i];
-				}
-			});
+u64 GSRendererSW::CheckTargetPages(const GSOffset::PageLooper* fb_pages, const GSOffset::PageLooper* zb_pages, bool fwrite, bool zwrite)
+{
+	// Draws with the same frame buffer layout put each pixel on the same worker, which keeps them in order by themselves.
+	// Everything else sharing a page has to finish first: a different layout of the same buffer, frame and z-buffer
+	// overlapping each other (Bully FBP/ZBP = 0x2300), or a texture about to be overwritten.
 
-			if (!synced)
-			{
-				if (used)
-				{
-					if constexpr (LOG)
-					{
-						fprintf(s_fp, "syncpoint 1\n");
-						fflush(s_fp);
-					}
+	u64 dep = 0;
 
-					res = true;
-				}
-			}
-		}
+	if (fb_pages)
+	{
+		const u32 layout = GetPageLayout(m_context->offset.fb);
 
-		if (!synced)
+		fb_pages->loopPages([this, layout, fwrite, &dep](u32 page)
 		{
-			// chross-check frame and z-buffer pages, they cannot overlap with eachother and with previous batches in queue,
-			// have to be careful when the two buffers are mutually enabled/disabled and alternating (Bully FBP/ZBP = 0x2300)
+			const PageUse& use = m_page_use[page];
 
-			if (fb && !res)
-			{
-				fb_pages->loopPagesWithBreak([this, &res](u32 page)
-				{
-					if (m_fzb_pages[page] & 0xffff0000)
-					{
-						if constexpr (LOG)
-						{
-							fprintf(s_fp, "syncpoint 2\n");
-							fflush(s_fp);
-						}
+			if (use.fb > m_retired_seq && use.fb_layout != layout)
+				dep = std::max(dep, use.fb);
 
-						res = true;
-						return false;
-					}
+			dep = std::max(dep, use.zb);
 
-					return true;
-				});
-			}
+			if (fwrite)
+				dep = std::max(dep, use.tex);
+		});
+	}
 
-			if (zb && !res)
-			{
-				zb_pages->loopPagesWithBreak([this, &res](u32 page)
-				{
-					if (m_fzb_pages[page] & 0x0000ffff)
-					{
-						if constexpr (LOG)
-						{
-							fprintf(s_fp, "syncpoint 3\n");
-							fflush(s_fp);
-						}
+	if (zb_pages)
+	{
+		const u32 layout = GetPageLayout(m_context->offset.zb);
 
-						res = true;
-						return false;
-					}
+		zb_pages->loopPages([this, layout, zwrite, &dep](u32 page)
+		{
+			const PageUse& use = m_page_use[page];
 
-					return true;
-				});
-			}
-		}
+			if (use.zb > m_retired_seq && use.zb_layout != layout)
+				dep = std::max(dep, use.zb);
+
+			dep = std::max(dep, use.fb);
+
+			if (zwrite)
+				dep = std::max(dep, use.tex);
+		});
 	}
 
-	return res;
+	return dep > m_retired_seq ? dep : 0;
 }
 
-bool GSRendererSW::CheckSourcePages(SharedData* sd)
+u64 GSRendererSW::CheckSourcePages(SharedData* sd)
 {
-	if (!m_rl->IsSynced())
-	{
-		for (size_t i = 0; sd->m_tex[i].t != NULL; i++)
-		{
-			GSOffset::PageLooper pages = sd->m_tex[i].t->m_offset.pageLooperForRect(sd->m_tex[i].r);
+	// TODO: 8H 4HL 4HH texture at the same place as the render target (24 bit, or 32-bit where the alpha channel is masked, Valkyrie Profile 2)
 
-			bool ret = false;
-			pages.loopPagesWithBreak([this, &ret](u32 pages)
-			{
-				// TODO: 8H 4HL 4HH texture at the same place as the render target (24 bit, or 32-bit where the alpha channel is masked, Valkyrie Profile 2)
+	u64 dep = 0;
 
-				if (m_fzb_pages[pages]) // currently being drawn to? => sync
-				{
-					ret = true;
-					return false;
-				}
-				return true;
-			});
-			if (ret)
-				return true;
-		}
+	for (size_t i = 0; sd->m_tex[i].t != NULL; i++)
+	{
+		dep = std::max(dep, GetWriteDependency(sd->m_tex[i].t->m_offset, sd->m_tex[i].r));
 	}
 
-	return false;
+	return dep;
 }
-
 bool GSRendererSW::GetScanlineGlobalData(SharedData* data)
 {
 	GSScanlineGlobalData& gd = data->global;
@@ -1427,7 +1572,9 @@ GSRendererSW::SharedData::SharedData()
 	: m_fpsm(0)
 	, m_zpsm(0)
 	, m_using_pages(false)
-	, m_syncpoint(SyncNone)
+	, m_seq(0)
+	, m_source_dep(0)
+	, m_target_dep(0)
 {
 	m_tex[0].t = NULL;
 
@@ -1457,38 +1604,42 @@ GSRendererSW::SharedData::~SharedData()
 	}
 }
 
-//static TransactionScope::Lock s_lock;
-
-void GSRendererSW::SharedData::UsePages(const GSOffset::PageLooper* fb_pages, int fpsm, const GSOffset::PageLooper* zb_pages, int zpsm)
+void GSRendererSW::SharedData::UsePages(const GSOffset::PageLooper* fb_pages, const GSOffset& fb_off, const GSOffset::PageLooper* zb_pages, const GSOffset& zb_off, const GSVector4i& r)
 {
 	if (m_using_pages)
 		return;
 
+	GSRendererSW* const sw = GSRendererSW::GetInstance();
+
+	m_seq = sw->BeginDraw();
+
+	if (global.sel.fb)
 	{
-		//TransactionScope scope(s_lock);
+		sw->UsePages(*fb_pages, 0, m_seq, GetPageLayout(fb_off));
 
-		if (global.sel.fb)
-		{
-			GSRendererSW::GetInstance()->UsePages(*fb_pages, 0);
-		}
+		if (global.sel.fwrite)
+			sw->UseBlocks(fb_off, r, m_seq);
+	}
 
-		if (global.sel.zb)
-		{
-			GSRendererSW::GetInstance()->UsePages(*zb_pages, 1);
-		}
+	if (global.sel.zb)
+	{
+		sw->UsePages(*zb_pages, 1, m_seq, GetPageLayout(zb_off));
 
-		for (size_t i = 0; m_tex[i].t != NULL; i++)
-		{
-			GSRendererSW::GetInstance()->UsePages(m_tex[i].t->m_pages, 2);
-		}
+		if (global.sel.zwrite)
+			sw->UseBlocks(zb_off, r, m_seq);
+	}
+
+	for (size_t i = 0; m_tex[i].t != NULL; i++)
+	{
+		sw->UsePages(m_tex[i].t->m_pages, 2, m_seq, LAYOUT_MIXED);
 	}
 
 	if (fb_pages)
 		m_fb_pages = *fb_pages;
 	if (zb_pages)
 		m_zb_pages = *zb_pages;
-	m_fpsm = fpsm;
-	m_zpsm = zpsm;
+	m_fpsm = fb_off.psm();
+	m_zpsm = zb_off.psm();
 
 	m_using_pages = true;
 }
@@ -1498,24 +1649,7 @@ void GSRendererSW::SharedData::ReleasePages()
 	if (!m_using_pages)
 		return;
 
-	{
-		//TransactionScope scope(s_lock);
-
-		if (global.sel.fb)
-		{
-			GSRendererSW::GetInstance()->ReleasePages(m_fb_pages, 0);
-		}
-
-		if (global.sel.zb)
-		{
-			GSRendererSW::GetInstance()->ReleasePages(m_zb_pages, 1);
-		}
-
-		for (size_t i = 0; m_tex[i].t != NULL; i++)
-		{
-			GSRendererSW::GetInstance()->ReleasePages(m_tex[i].t->m_pages, 2);
-		}
-	}
+	GSRendererSW::GetInstance()->RetireDraw(m_seq);
 
 	m_using_pages = false;
 }
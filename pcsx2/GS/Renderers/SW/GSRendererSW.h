@@ -28,18 +28,15 @@ public:
 		int m_zpsm;
 		bool m_using_pages;
 		TextureLevel m_tex[7 + 1]; // NULL terminated
-		enum
-		{
-			SyncNone,
-			SyncSource,
-			SyncTarget
-		} m_syncpoint;
+		u64 m_seq; // position in the draw order, assigned when the pages are taken
+		u64 m_source_dep; // last earlier draw which has to finish before the textures can be updated
+		u64 m_target_dep; // last earlier draw which has to finish before this one can start
 
 	public:
 		SharedData();
 		virtual ~SharedData();
 
-		void UsePages(const GSOffset::PageLooper* fb_pages, int fpsm, const GSOffset::PageLooper* zb_pages, int zpsm);
+		void UsePages(const GSOffset::PageLooper* fb_pages, const GSOffset& fb_off, const GSOffset::PageLooper* zb_pages, const GSOffset& zb_off, const GSVector4i& r);
 		void ReleasePages();
 
 		void SetSource(GSTextureCacheSW::Texture* t, const GSVector4i& r, int level);
@@ -52,15 +49,41 @@ protected:
 	GSRingHeap m_vertex_heap;
 	std::array<GSTexture*, 3> m_texture = {};
 	u8* m_output;
-	GSPixelOffset4* m_fzb;
-	GSVector4i m_fzb_bbox;
-	u32 m_fzb_cur_pages[16];
-	std::atomic<u32> m_fzb_pages[512]; // u16 frame/zbuf pages interleaved
-	std::atomic<u16> m_tex_pages[512];
+
+	// Draws are numbered in submission order. Each page remembers the last draws which used it, so a draw
+	// depending on earlier ones only waits until those are done, instead of draining every worker.
+
+	static constexpr u32 DRAW_RING_SIZE = 1 << 16;
+	static constexpr u32 LAYOUT_MIXED = 0xFFFFFFFFu;
+
+	struct PageUse
+	{
+		u64 fb; // last draw with the page in its frame buffer
+		u64 zb; // last draw with the page in its z buffer
+		u64 tex; // last draw sampling a texture on the page
+		u64 write; // last draw writing to the page
+		u32 write_blocks; // blocks written by the in-flight draws
+		u32 fb_layout; // frame buffer layout of the in-flight draws, or LAYOUT_MIXED
+		u32 zb_layout;
+	};
+
+	PageUse m_page_use[MAX_PAGES] = {};
+	u64 m_draw_seq = 0; // last number handed out
+	u64 m_queued_seq = 0; // last draw given to the rasterizer
+	u64 m_retired_seq = 0; // every draw up to this one has finished
+	std::unique_ptr<std::atomic<bool>[]> m_draw_retired; // finished flags, indexed by number modulo DRAW_RING_SIZE
+	std::atomic<bool> m_retire_waiting{false}; // the GS thread is asleep on m_retire_sema, or about to be
+	Threading::KernelSemaphore m_retire_sema;
+
+	std::string m_selector_serial; // game the used JIT selectors get recorded for
+	std::vector<u64> m_saved_ds_selectors;
+	std::vector<u64> m_saved_sp_selectors;
+
 	GIFRegDIMX m_last_dimx = {};
 	GSVector4i m_dimx[8] = {};
 
 	void Reset(bool hardware_reset) override;
+	void GameChanged() override;
 	void VSync(u32 field, bool registers_written, bool idle_frame) override;
 	GSTexture* GetOutput(int i, float& scale, int& y_offset) override;
 	GSTexture* GetFeedbackOutput(float& scale) override;
@@ -68,17 +91,26 @@ protected:
 	void Draw() override;
 	void Queue(GSRingHeap::SharedPtr<GSRasterizerData>& item);
 	void Sync(int reason);
+	void WaitForDraw(u64 seq, GSPerfMon::counter_t reason);
+	void WaitForRetired(u64 seq);
+	void AdvanceRetired();
 	void InvalidateVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r) override;
 	void InvalidateLocalMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r, bool clut = false) override;
 
-	void UsePages(const GSOffset::PageLooper& pages, const int type);
-	void ReleasePages(const GSOffset::PageLooper& pages, const int type);
+	u64 BeginDraw();
+	void UsePages(const GSOffset::PageLooper& pages, const int type, const u64 seq, const u32 layout);
+	void UseBlocks(const GSOffset& off, const GSVector4i& r, const u64 seq);
+	void RetireDraw(const u64 seq);
 
-	bool CheckTargetPages(const GSOffset::PageLooper* fb_pages, const GSOffset::PageLooper* zb_pages, const GSVector4i& r);
-	bool CheckSourcePages(SharedData* sd);
+	u64 GetWriteDependency(const GSOffset& off, const GSVector4i& r) const;
+	u64 CheckTargetPages(const GSOffset::PageLooper* fb_pages, const GSOffset::PageLooper* zb_pages, bool fwrite, bool zwrite);
+	u64 CheckSourcePages(SharedData* sd);
 
 	bool GetScanlineGlobalData(SharedData* data);
 
+	void LoadSelectors();
+	void SaveSelectors();
+
 public:
 	GSRendererSW(int threads);
 	~GSRendererSW() override;
@@ -35,11 +35,14 @@ static void GSDumpReplayerCpuExecute();
 static void GSDumpReplayerExitExecution();
 static void GSDumpReplayerCancelInstruction();
 static void GSDumpReplayerCpuClear(u32 addr, u32 size);
+static void GSDumpReplayerSetFastForward(bool enabled);
 
 static std::unique_ptr<GSDumpFile> s_dump_file;
 static u32 s_current_packet = 0;
 static u32 s_dump_frame_number = 0;
 static s32 s_dump_loop_count = 0;
+static u32 s_dump_start_frame = 0;
+static bool s_dump_fast_forwarding = false;
 static bool s_dump_running = false;
 static bool s_needs_state_loaded = false;
 static u64 s_frame_ticks = 0;
@@ -84,6 +87,11 @@ int GSDumpReplayer::GetLoopCount()
 	return s_dump_loop_count;
 }
 
+void GSDumpReplayer::SetStartFrame(u32 frame)
+{
+	s_dump_start_frame = frame;
+}
+
 bool GSDumpReplayer::Initialize(const char* filename)
 {
 	Common::Timer timer;
@@ -101,6 +109,13 @@ bool GSDumpReplayer::Initialize(const char* filename)
 
 	Console.WriteLn("(GSDumpReplayer) Read file in %.2f ms.", timer.GetTimeMilliseconds());
 
+	if (s_dump_start_frame > 0 && s_dump_start_frame >= s_dump_file->GetFrameCount())
+	{
+		Console.Warning("(GSDumpReplayer) Start frame %u is past the end of the dump (%u frames), playing from frame 0.",
+			s_dump_start_frame, s_dump_file->GetFrameCount());
+		s_dump_start_frame = 0;
+	}
+
 	// We replace all CPUs.
 	Cpu = &GSDumpReplayerCpu;
 	psxCpu = &psxInt;
@@ -132,6 +147,9 @@ bool GSDumpReplayer::ChangeDump(const char* filename)
 		return false;
 	}
 
+	if (s_dump_fast_forwarding)
+		GSDumpReplayerSetFastForward(false);
+
 	s_dump_file = std::move(new_dump);
 	s_current_packet = 0;
 
@@ -149,6 +167,13 @@ void GSDumpReplayer::Shutdown()
 	CpuVU0 = nullptr;
 	CpuVU1 = nullptr;
 	s_dump_file.reset();
+
+	// The GS thread is idle once the VM has shut down.
+	if (s_dump_fast_forwarding)
+	{
+		s_dump_fast_forwarding = false;
+		GSSetSkipPresent(false);
+	}
 }
 
 std::string GSDumpReplayer::GetDumpSerial()
@@ -192,6 +217,9 @@ void GSDumpReplayerCpuShutdown()
 
 void GSDumpReplayerCpuReset()
 {
+	if (s_dump_fast_forwarding)
+		GSDumpReplayerSetFastForward(false);
+
 	s_needs_state_loaded = true;
 	s_current_packet = 0;
 	s_dump_frame_number = 0;
@@ -226,6 +254,13 @@ static void GSDumpReplayerSendPacketToMTGS(GIF_PATH path, const u8* data, u32 le
 	Gif_AddCompletedGSPacket(gsPack, path);
 }
 
+static void GSDumpReplayerSetFastForward(bool enabled)
+{
+	// Queued in order with the packets, so the GS stops skipping at the vsync of the start frame.
+	s_dump_fast_forwarding = enabled;
+	MTGS::RunOnGSThread([enabled]() { GSSetSkipPresent(enabled); });
+}
+
 static void GSDumpReplayerUpdateFrameLimit()
 {
 	constexpr u32 default_frame_limit = 60;
@@ -261,8 +296,16 @@ void GSDumpReplayerCpuStep()
 		s_needs_state_loaded = false;
 	}
 
-	const GSDumpFile::GSData& packet = s_dump_file->GetPackets()[s_current_packet];
-	s_current_packet = (s_current_packet + 1) % static_cast<u32>(s_dump_file->GetPackets().size());
+	if (s_dump_start_frame > 0)
+	{
+		if (s_current_packet == 0 && s_dump_start_frame < s_dump_file->GetFrameCount())
+			GSDumpReplayerSetFastForward(true);
+		else if (s_dump_fast_forwarding && s_current_packet == s_dump_file->GetFrameStartPacket(s_dump_start_frame))
+			GSDumpReplayerSetFastForward(false);
+	}
+
+	const GSDumpFile::GSData& packet = s_dump_file->GetPacket(s_current_packet);
+	s_current_packet = (s_current_packet + 1) % static_cast<u32>(s_dump_file->GetPacketCount());
 	if (s_current_packet == 0)
 	{
 		s_dump_frame_number = 0;
@@ -308,8 +351,11 @@ void GSDumpReplayerCpuStep()
 		case GSDumpTypes::GSType::VSync:
 		{
 			s_dump_frame_number++;
-			GSDumpReplayerUpdateFrameLimit();
-			GSDumpReplayerFrameLimit();
+			if (!s_dump_fast_forwarding)
+			{
+				GSDumpReplayerUpdateFrameLimit();
+				GSDumpReplayerFrameLimit();
+			}
 			MTGS::PostVsyncStart(false);
 			VMManager::Internal::VSyncOnCPUThread();
 			if (VMManager::Internal::IsExecutionInterrupted())
@@ -384,11 +430,11 @@ void GSDumpReplayer::RenderUI()
 		position_y += text_size.y + spacing; \
 	} while (0)
 
-	fmt::format_to(std::back_inserter(text), "Dump Frame: {}", s_dump_frame_number);
+	fmt::format_to(std::back_inserter(text), "Dump Frame: {}/{}", s_dump_frame_number, s_dump_file->GetFrameCount());
 	DRAW_LINE(font, text.c_str(), IM_COL32(255, 255, 255, 255));
 
 	text.clear();
-	fmt::format_to(std::back_inserter(text), "Packet Number: {}/{}", s_current_packet, static_cast<u32>(s_dump_file->GetPackets().size()));
+	fmt::format_to(std::back_inserter(text), "Packet Number: {}/{}", s_current_packet, static_cast<u32>(s_dump_file->GetPacketCount()));
 	DRAW_LINE(font, text.c_str(), IM_COL32(255, 255, 255, 255));
 
 #undef DRAW_LINE
@@ -13,6 +13,9 @@ namespace GSDumpReplayer
 	/// If set, playback will repeat once it reaches the last frame.
 	void SetLoopCount(s32 loop_count = 0);
 	int GetLoopCount();
+
+	/// Replays the packets before this frame without presenting them or limiting their speed, on every loop.
+	void SetStartFrame(u32 frame);
 	bool IsRunner();
 	void SetIsDumpRunner(bool is_runner);
 
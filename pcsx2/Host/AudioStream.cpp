@@ -2,12 +2,14 @@
 // SPDX-License-Identifier: GPL-3.0+
 
 #include "Host/AudioStream.h"
+#include "Host/AudioStretcher.h"
 #include "FreeSurroundDecoder.h"
 #include "Host.h"
 #include "GS/GSVector.h"
 
 #include "common/Assertions.h"
 #include "common/BitUtils.h"
+#include "common/boost_spsc_queue.hpp"
 #include "common/Console.h"
 #include "common/Error.h"
 #include "common/Pcsx2Defs.h"
@@ -227,6 +229,79 @@ u32 AudioStream::GetBufferedFramesRelaxed() const
 	return (wpos + m_buffer_size - rpos) % m_buffer_size;
 }
 
+/// Polyphase windowed-sinc interpolation, for spreading a short read over a larger number of frames.
+static constexpr u32 RESAMPLE_TAPS = 8;
+static constexpr u32 RESAMPLE_PHASE_BITS = 6;
+static constexpr u32 RESAMPLE_PHASES = 1u << RESAMPLE_PHASE_BITS;
+using ResampleFilter = std::array<std::array<float, RESAMPLE_TAPS>, RESAMPLE_PHASES>;
+
+static const ResampleFilter& GetResampleFilter()
+{
+	static const ResampleFilter filter = []() {
+		static constexpr double PI = 3.14159265358979323846;
+
+		ResampleFilter ret;
+		for (u32 phase = 0; phase < RESAMPLE_PHASES; phase++)
+		{
+			const double frac = static_cast<double>(phase) / static_cast<double>(RESAMPLE_PHASES);
+			double sum = 0.0;
+			for (u32 tap = 0; tap < RESAMPLE_TAPS; tap++)
+			{
+				// Tap (RESAMPLE_TAPS / 2 - 1) is the frame at or before the output position.
+				const double x = static_cast<double>(tap) - static_cast<double>(RESAMPLE_TAPS / 2 - 1) - frac;
+				const double sinc = (x == 0.0) ? 1.0 : (std::sin(PI * x) / (PI * x));
+				const double n = (x / static_cast<double>(RESAMPLE_TAPS)) + 0.5;
+				const double blackman = 0.42 - 0.5 * std::cos(2.0 * PI * n) + 0.08 * std::cos(4.0 * PI * n);
+				ret[phase][tap] = static_cast<float>(sinc * blackman);
+				sum += sinc * blackman;
+			}
+
+			// Unity gain for every phase, otherwise the interpolation adds a buzz at the output rate.
+			for (float& coef : ret[phase])
+				coef = static_cast<float>(coef / sum);
+		}
+
+		return ret;
+	}();
+
+	return filter;
+}
+
+/// src needs MAX_OUTPUT_CHANNELS samples of padding after the last frame, every tap loads a whole vector of channels.
+static void ResampleFrames(s16* dest, u32 dest_frames, const s16* src, u32 src_frames, u32 channels)
+{
+	const ResampleFilter& filter = GetResampleFilter();
+	const u32 increment = static_cast<u32>((static_cast<u64>(src_frames) << 16) / dest_frames);
+	const s32 last_frame = static_cast<s32>(src_frames) - 1;
+	const bool high_channels = (channels > 4);
+
+	u32 pos = 0; // 16.16
+	for (u32 i = 0; i < dest_frames; i++, pos += increment)
+	{
+		const std::array<float, RESAMPLE_TAPS>& coefs = filter[(pos >> (16 - RESAMPLE_PHASE_BITS)) & (RESAMPLE_PHASES - 1)];
+		const s32 first = static_cast<s32>(pos >> 16) - static_cast<s32>(RESAMPLE_TAPS / 2 - 1);
+
+		GSVector4 acc_lo = GSVector4::zero(); // channels 0-3
+		GSVector4 acc_hi = GSVector4::zero(); // channels 4-7
+		for (u32 tap = 0; tap < RESAMPLE_TAPS; tap++)
+		{
+			// Edges repeat the first/last frame, there's nothing either side of the read.
+			const s16* frame = &src[std::clamp<s32>(first + static_cast<s32>(tap), 0, last_frame) * channels];
+			const GSVector4i iv = GSVector4i::load<false>(frame); // [0, 1, 2, 3, 4, 5, 6, 7]
+			const GSVector4 coef = GSVector4(coefs[tap]);
+			acc_lo += GSVector4(iv.upl16(iv).sra32<16>()) * coef;
+			if (high_channels)
+				acc_hi += GSVector4(iv.uph16(iv).sra32<16>()) * coef;
+		}
+
+		// ps32 saturates to the s16 range.
+		alignas(16) s16 out[AudioStream::MAX_OUTPUT_CHANNELS];
+		GSVector4i::store<true>(out, GSVector4i(acc_lo).ps32(GSVector4i(acc_hi)));
+		std::memcpy(dest, out, channels * sizeof(s16));
+		dest += channels;
+	}
+}
+
 void AudioStream::ReadFrames(SampleType* samples, u32 num_frames)
 {
 	const u32 available_frames = GetBufferedFramesRelaxed();
@@ -291,27 +366,13 @@ void AudioStream::ReadFrames(SampleType* samples, u32 num_frames)
 	{
 		if (frames_to_read > 0)
 		{
-			// super basic resampler - spread the input samples evenly across the output samples. will sound like ass and have
-			// aliasing, but better than popping by inserting silence.
-			const u32 increment =
-				static_cast<u32>(65536.0f * (static_cast<float>(frames_to_read) / static_cast<float>(num_frames)));
-
+			// stretch what we have over the whole request, rather than popping by inserting silence.
+			const u32 resample_samples = frames_to_read * m_output_channels;
 			SampleType* resample_ptr =
-				static_cast<SampleType*>(alloca(frames_to_read * m_output_channels * sizeof(SampleType)));
-			std::memcpy(resample_ptr, samples, frames_to_read * m_output_channels * sizeof(SampleType));
-
-			SampleType* out_ptr = samples;
-			const u32 copy_stride = sizeof(SampleType) * m_output_channels;
-			u32 resample_subpos = 0;
-			for (u32 i = 0; i < num_frames; i++)
-			{
-				std::memcpy(out_ptr, resample_ptr, copy_stride);
-				out_ptr += m_output_channels;
-
-				resample_subpos += increment;
-				resample_ptr += (resample_subpos >> 16) * m_output_channels;
-				resample_subpos %= 65536u;
-			}
+				static_cast<SampleType*>(alloca((resample_samples + MAX_OUTPUT_CHANNELS) * sizeof(SampleType)));
+			std::memcpy(resample_ptr, samples, resample_samples * sizeof(SampleType));
+			std::memset(resample_ptr + resample_samples, 0, MAX_OUTPUT_CHANNELS * sizeof(SampleType));
+			ResampleFrames(samples, num_frames, resample_ptr, frames_to_read, m_output_channels);
 
 			LOG_UNDERRUN("Audio buffer underflow, resampled {} frames to {}", frames_to_read, num_frames);
 		}
@@ -458,9 +519,11 @@ void AudioStream::EmptyBuffer()
 
 	if (IsStretchEnabled())
 	{
-		m_soundtouch->clear();
-		if (IsStretchEnabled())
-			m_soundtouch->setTempo(m_nominal_rate);
+		if (m_stretcher)
+			m_stretcher->Clear();
+		else
+			m_soundtouch->clear();
+		StretchSetTempo(m_nominal_rate);
 	}
 
 	m_wpos.store(m_rpos.load(std::memory_order_acquire), std::memory_order_release);
@@ -483,7 +546,7 @@ void AudioStream::UpdateTargetTempo(float tempo)
 	m_average_position = AVERAGING_WINDOW;
 	m_average_available = AVERAGING_WINDOW;
 	std::fill_n(m_average_fullness.data(), AVERAGING_WINDOW, tempo);
-	m_soundtouch->setTempo(tempo);
+	StretchSetTempo(tempo);
 	m_stretch_reset = 0;
 	m_stretch_inactive = false;
 	m_stretch_ok_count = 0;
@@ -516,6 +579,78 @@ void AudioStream::SetPaused(bool paused)
 	m_paused = paused;
 }
 
+// 128 chunks is ~170ms at 48KHz, the stream's own buffer should drain it long before that fills.
+struct AudioStreamWriteThread::Queue : public ringbuffer_base<Chunk, 128>
+{
+};
+
+AudioStreamWriteThread::AudioStreamWriteThread() = default;
+
+AudioStreamWriteThread::~AudioStreamWriteThread()
+{
+	Stop();
+}
+
+void AudioStreamWriteThread::Start(AudioStream* stream)
+{
+	if (m_thread.joinable())
+		return;
+
+	m_stream = stream;
+	m_queue = std::make_unique<Queue>();
+	m_exit.store(false, std::memory_order_release);
+	m_sema.Reset();
+	m_thread = std::thread(&AudioStreamWriteThread::ThreadEntryPoint, this);
+}
+
+void AudioStreamWriteThread::Stop()
+{
+	if (!m_thread.joinable())
+		return;
+
+	m_sema.WaitForEmpty();
+	m_exit.store(true, std::memory_order_release);
+	m_sema.NotifyOfWork();
+	m_thread.join();
+	m_queue.reset();
+}
+
+void AudioStreamWriteThread::Sync()
+{
+	if (m_thread.joinable())
+		m_sema.WaitForEmpty();
+}
+
+void AudioStreamWriteThread::SetStream(AudioStream* stream)
+{
+	m_stream = stream;
+}
+
+void AudioStreamWriteThread::Write(const Chunk& chunk)
+{
+	while (!m_queue->push(chunk))
+		std::this_thread::yield();
+
+	m_sema.NotifyOfWork();
+}
+
+void AudioStreamWriteThread::ThreadEntryPoint()
+{
+	Threading::SetNameOfCurrentThread("Audio Stream Writer");
+
+	const auto write_chunk = [this](const Chunk& chunk) { m_stream->WriteChunk(chunk.data()); };
+
+	for (;;)
+	{
+		m_sema.WaitForWork();
+		if (m_exit.load(std::memory_order_acquire))
+			break;
+
+		while (m_queue->consume_one(write_chunk))
+			;
+	}
+}
+
 void AudioStream::SetOutputVolume(u32 volume)
 {
 	m_volume = volume;
@@ -671,18 +806,28 @@ void AudioStream::StretchAllocate()
 	if (!IsStretchEnabled())
 		return;
 
-	m_soundtouch = std::make_unique<soundtouch::SoundTouch>();
-	m_soundtouch->setSampleRate(m_sample_rate);
-	m_soundtouch->setChannels(m_internal_channels);
+	if (m_parameters.stretch_use_soundtouch)
+	{
+		m_soundtouch = std::make_unique<soundtouch::SoundTouch>();
+		m_soundtouch->setSampleRate(m_sample_rate);
+		m_soundtouch->setChannels(m_internal_channels);
 
-	m_soundtouch->setSetting(SETTING_USE_QUICKSEEK, m_parameters.stretch_use_quickseek);
-	m_soundtouch->setSetting(SETTING_USE_AA_FILTER, m_parameters.stretch_use_aa_filter);
+		m_soundtouch->setSetting(SETTING_USE_QUICKSEEK, m_parameters.stretch_use_quickseek);
+		m_soundtouch->setSetting(SETTING_USE_AA_FILTER, m_parameters.stretch_use_aa_filter);
 
-	m_soundtouch->setSetting(SETTING_SEQUENCE_MS, m_parameters.stretch_sequence_length_ms);
-	m_soundtouch->setSetting(SETTING_SEEKWINDOW_MS, m_parameters.stretch_seekwindow_ms);
-	m_soundtouch->setSetting(SETTING_OVERLAP_MS, m_parameters.stretch_overlap_ms);
+		m_soundtouch->setSetting(SETTING_SEQUENCE_MS, m_parameters.stretch_sequence_length_ms);
+		m_soundtouch->setSetting(SETTING_SEEKWINDOW_MS, m_parameters.stretch_seekwindow_ms);
+		m_soundtouch->setSetting(SETTING_OVERLAP_MS, m_parameters.stretch_overlap_ms);
+	}
+	else
+	{
+		// The AA filter only applies to SoundTouch's rate transposer, which isn't used, since the rate never changes.
+		m_stretcher = std::make_unique<AudioStretcher>(m_sample_rate, m_internal_channels,
+			m_parameters.stretch_sequence_length_ms, m_parameters.stretch_seekwindow_ms,
+			m_parameters.stretch_overlap_ms, m_parameters.stretch_use_quickseek);
+	}
 
-	m_soundtouch->setTempo(m_nominal_rate);
+	StretchSetTempo(m_nominal_rate);
 
 	m_stretch_reset = STRETCH_RESET_THRESHOLD;
 	m_stretch_inactive = false;
@@ -696,20 +841,40 @@ void AudioStream::StretchAllocate()
 
 void AudioStream::StretchDestroy()
 {
+	m_stretcher.reset();
 	m_soundtouch.reset();
 }
 
+void AudioStream::StretchSetTempo(float tempo)
+{
+	if (m_stretcher)
+		m_stretcher->SetTempo(tempo);
+	else
+		m_soundtouch->setTempo(tempo);
+}
+
 void AudioStream::StretchWriteBlock(const float* block)
 {
 	if (IsStretchEnabled())
 	{
-		m_soundtouch->putSamples(block, CHUNK_SIZE);
-
 		u32 tempProgress;
-		while (tempProgress = m_soundtouch->receiveSamples(m_float_buffer.get(), CHUNK_SIZE), tempProgress != 0)
+		if (m_stretcher)
+		{
+			m_stretcher->PutFrames(block, CHUNK_SIZE);
+			while (tempProgress = m_stretcher->ReceiveFrames(m_float_buffer.get(), CHUNK_SIZE), tempProgress != 0)
+			{
+				FloatChunkToS16(m_staging_buffer.get(), m_float_buffer.get(), tempProgress * m_internal_channels);
+				InternalWriteFrames(m_staging_buffer.get(), tempProgress);
+			}
+		}
+		else
 		{
-			FloatChunkToS16(m_staging_buffer.get(), m_float_buffer.get(), tempProgress * m_internal_channels);
-			InternalWriteFrames(m_staging_buffer.get(), tempProgress);
+			m_soundtouch->putSamples(block, CHUNK_SIZE);
+			while (tempProgress = m_soundtouch->receiveSamples(m_float_buffer.get(), CHUNK_SIZE), tempProgress != 0)
+			{
+				FloatChunkToS16(m_staging_buffer.get(), m_float_buffer.get(), tempProgress * m_internal_channels);
+				InternalWriteFrames(m_staging_buffer.get(), tempProgress);
+			}
 		}
 
 		if (IsStretchEnabled())
@@ -830,7 +995,7 @@ void AudioStream::UpdateStretchTempo()
 		iterations++;
 	}
 
-	m_soundtouch->setTempo(tempo);
+	StretchSetTempo(tempo);
 
 	if (m_stretch_reset >= STRETCH_RESET_THRESHOLD)
 		m_stretch_reset = 0;
@@ -864,6 +1029,7 @@ void AudioStreamParameters::LoadSave(SettingsWrapper& wrap, const char* section)
 	stretch_overlap_ms = static_cast<u16>(std::clamp<int>(wrap.EntryBitfield(section, "StretchOverlapMS", DEFAULT_STRETCH_OVERLAP), 0, std::numeric_limits<u16>::max()));
 	stretch_use_quickseek = wrap.EntryBitBool(section, "StretchUseQuickSeek", DEFAULT_STRETCH_USE_QUICKSEEK);
 	stretch_use_aa_filter = wrap.EntryBitBool(section, "StretchUseAAFilter", DEFAULT_STRETCH_USE_AA_FILTER);
+	stretch_use_soundtouch = wrap.EntryBitBool(section, "StretchUseSoundTouch", DEFAULT_STRETCH_USE_SOUNDTOUCH);
 
 	expand_block_size = static_cast<u16>(std::clamp<int>(wrap.EntryBitfield(section, "ExpandBlockSize", DEFAULT_EXPAND_BLOCK_SIZE), 0, std::numeric_limits<u16>::max()));
 	wrap.Entry(section, "ExpandCircularWrap", expand_circular_wrap, DEFAULT_EXPAND_CIRCULAR_WRAP);
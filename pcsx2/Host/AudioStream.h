@@ -5,16 +5,20 @@
 
 #include "Host/AudioStreamTypes.h"
 
+#include "common/Threading.h"
+
 #include <array>
 #include <atomic>
 #include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <vector>
 
 class Error;
 
+class AudioStretcher;
 class FreeSurroundDecoder;
 namespace soundtouch
 {
@@ -156,6 +160,7 @@ private:
 
 	void StretchAllocate();
 	void StretchDestroy();
+	void StretchSetTempo(float tempo);
 	void StretchWriteBlock(const float* block);
 	void StretchUnderrun();
 	void StretchOverrun();
@@ -170,6 +175,7 @@ private:
 	std::atomic<u32> m_rpos{0};
 	std::atomic<u32> m_wpos{0};
 
+	std::unique_ptr<AudioStretcher> m_stretcher;
 	std::unique_ptr<soundtouch::SoundTouch> m_soundtouch;
 
 	u32 m_target_buffer_size = 0;
@@ -188,7 +194,7 @@ private:
 	// temporary staging buffer, used for timestretching
 	std::unique_ptr<s16[]> m_staging_buffer;
 
-	// float buffer, soundtouch only accepts float samples as input
+	// float buffer, the stretchers only accept float samples as input
 	std::unique_ptr<float[]> m_float_buffer;
 
 	std::unique_ptr<FreeSurroundDecoder> m_expander;
@@ -199,6 +205,43 @@ private:
 	u32 m_expand_buffer_pos = 0;
 };
 
+/// Passes chunks to a stream's WriteChunk() on a thread of its own, so format conversion, expansion and time
+/// stretching don't run on the thread producing the audio. Nothing else may touch the stream's write side while
+/// chunks are queued, call Sync() first.
+class AudioStreamWriteThread
+{
+public:
+	using Chunk = std::array<AudioStream::SampleType, AudioStream::CHUNK_SIZE * AudioStream::NUM_INPUT_CHANNELS>;
+
+	AudioStreamWriteThread();
+	~AudioStreamWriteThread();
+
+	bool IsRunning() const { return m_thread.joinable(); }
+
+	void Start(AudioStream* stream);
+	void Stop();
+
+	/// Waits for every queued chunk to be written.
+	void Sync();
+
+	/// Points the thread at a new stream, after Sync().
+	void SetStream(AudioStream* stream);
+
+	/// Queues a chunk. Only blocks if the thread has fallen a long way behind.
+	void Write(const Chunk& chunk);
+
+private:
+	struct Queue;
+
+	void ThreadEntryPoint();
+
+	AudioStream* m_stream = nullptr;
+	std::unique_ptr<Queue> m_queue;
+	Threading::WorkSema m_sema;
+	std::thread m_thread;
+	std::atomic_bool m_exit{false};
+};
+
 template <AudioExpansionMode mode, AudioStream::ReadChannel c0, AudioStream::ReadChannel c1, AudioStream::ReadChannel c2,
 	AudioStream::ReadChannel c3, AudioStream::ReadChannel c4, AudioStream::ReadChannel c5,
 	AudioStream::ReadChannel c6, AudioStream::ReadChannel c7>
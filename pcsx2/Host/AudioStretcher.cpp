@@ -0,0 +1,217 @@
+// SPDX-FileCopyrightText: 2002-2024 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#include "Host/AudioStretcher.h"
+
+#include "common/Assertions.h"
+#include "common/BitUtils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+AudioStretcher::AudioStretcher(u32 sample_rate, u32 channels, u32 sequence_ms, u32 seekwindow_ms, u32 overlap_ms, bool quickseek)
+	: m_channels(channels)
+	, m_quickseek(quickseek)
+{
+	pxAssert(channels > 0 && channels <= MAX_CHANNELS);
+	MULTI_ISA_SELECT(AudioStretcherPopulateKernels)(m_kernels);
+
+	// Keeping the overlap a multiple of 8 frames makes every kernel count a multiple of 8 floats, whatever the channel count.
+	m_overlap_length = std::max<u32>(Common::AlignUpPow2((sample_rate * overlap_ms) / 1000, 8), 16);
+	m_sequence_length = std::max<u32>((sample_rate * sequence_ms) / 1000, m_overlap_length * 2);
+	m_seek_length = std::max<u32>((sample_rate * seekwindow_ms) / 1000, 1);
+
+	const u32 overlap_samples = m_overlap_length * m_channels;
+	m_mid_buffer.resize(overlap_samples);
+	m_reference.resize(overlap_samples);
+	m_window.resize(overlap_samples);
+	m_ramp.resize(overlap_samples);
+
+	const float half = static_cast<float>(m_overlap_length) * 0.5f;
+	for (u32 i = 0; i < m_overlap_length; i++)
+	{
+		const float window = (static_cast<float>(i) * static_cast<float>(m_overlap_length - i)) / (half * half);
+		const float ramp = static_cast<float>(i) / static_cast<float>(m_overlap_length);
+		for (u32 c = 0; c < m_channels; c++)
+		{
+			m_window[i * m_channels + c] = window;
+			m_ramp[i * m_channels + c] = ramp;
+		}
+	}
+
+	SetTempo(1.0f);
+}
+
+AudioStretcher::~AudioStretcher() = default;
+
+void AudioStretcher::SetTempo(float tempo)
+{
+	m_tempo = tempo;
+	m_nominal_skip = tempo * static_cast<float>(m_sequence_length - m_overlap_length);
+
+	// Enough input to skip ahead, and still search the whole seek window for the next sequence.
+	const u32 skip = static_cast<u32>(m_nominal_skip + 0.5f);
+	m_frames_required = std::max(skip + m_overlap_length, m_sequence_length) + m_seek_length;
+}
+
+void AudioStretcher::PutFrames(const float* frames, u32 num_frames)
+{
+	std::memcpy(GetWritePointer(m_input, num_frames), frames, num_frames * m_channels * sizeof(float));
+	CommitFrames(m_input, num_frames);
+	ProcessSequences();
+}
+
+u32 AudioStretcher::ReceiveFrames(float* dest, u32 max_frames)
+{
+	const u32 num_frames = std::min(max_frames, m_output.frames);
+	if (num_frames == 0)
+		return 0;
+
+	std::memcpy(dest, GetReadPointer(m_output), num_frames * m_channels * sizeof(float));
+	ConsumeFrames(m_output, num_frames);
+	return num_frames;
+}
+
+void AudioStretcher::Clear()
+{
+	m_input.start = 0;
+	m_input.frames = 0;
+	m_output.start = 0;
+	m_output.frames = 0;
+	m_first_sequence = true;
+	m_skip_fract = 0.0f;
+}
+
+float* AudioStretcher::GetWritePointer(FrameBuffer& buf, u32 num_frames)
+{
+	if (((buf.start + buf.frames + num_frames) * m_channels) > buf.data.size())
+	{
+		// Move what's left to the front before growing, so the buffer doesn't creep forward forever.
+		if (buf.start > 0)
+		{
+			std::memmove(buf.data.data(), &buf.data[buf.start * m_channels], buf.frames * m_channels * sizeof(float));
+			buf.start = 0;
+		}
+
+		if (((buf.frames + num_frames) * m_channels) > buf.data.size())
+			buf.data.resize((buf.frames + num_frames) * m_channels);
+	}
+
+	return &buf.data[(buf.start + buf.frames) * m_channels];
+}
+
+void AudioStretcher::CommitFrames(FrameBuffer& buf, u32 num_frames)
+{
+	buf.frames += num_frames;
+}
+
+void AudioStretcher::ConsumeFrames(FrameBuffer& buf, u32 num_frames)
+{
+	pxAssert(num_frames <= buf.frames);
+	buf.frames -= num_frames;
+	buf.start = (buf.frames > 0) ? (buf.start + num_frames) : 0;
+}
+
+void AudioStretcher::ProcessSequences()
+{
+	const u32 overlap_samples = m_overlap_length * m_channels;
+	const u32 direct_frames = m_sequence_length - m_overlap_length * 2;
+
+	while (m_input.frames >= m_frames_required)
+	{
+		const float* input = GetReadPointer(m_input);
+		u32 offset;
+
+		if (m_first_sequence)
+		{
+			// Nothing to overlap with yet, so the start of the input goes straight through.
+			offset = 0;
+			std::memcpy(GetWritePointer(m_output, m_overlap_length), input, overlap_samples * sizeof(float));
+			m_first_sequence = false;
+		}
+		else
+		{
+			// Fade from the end of the previous sequence into the most similar part of the seek window.
+			offset = SeekBestOverlap(input);
+			m_kernels.Overlap(GetWritePointer(m_output, m_overlap_length), m_mid_buffer.data(),
+				input + offset * m_channels, m_ramp.data(), overlap_samples);
+		}
+		CommitFrames(m_output, m_overlap_length);
+		offset += m_overlap_length;
+
+		if (direct_frames > 0)
+		{
+			std::memcpy(GetWritePointer(m_output, direct_frames), input + offset * m_channels,
+				direct_frames * m_channels * sizeof(float));
+			CommitFrames(m_output, direct_frames);
+			offset += direct_frames;
+		}
+
+		// The end of the sequence is held back, and faded into the next one.
+		std::memcpy(m_mid_buffer.data(), input + offset * m_channels, overlap_samples * sizeof(float));
+		UpdateReference();
+
+		m_skip_fract += m_nominal_skip;
+		const u32 skip = static_cast<u32>(m_skip_fract);
+		m_skip_fract -= static_cast<float>(skip);
+		ConsumeFrames(m_input, skip);
+	}
+}
+
+u32 AudioStretcher::SeekBestOverlap(const float* input) const
+{
+	u32 best_offset = 0;
+	float best_score = GetOverlapScore(input, 0);
+
+	const u32 step = m_quickseek ? QUICKSEEK_STEP : 1;
+	for (u32 offset = step; offset < m_seek_length; offset += step)
+	{
+		const float score = GetOverlapScore(input, offset);
+		if (score > best_score)
+		{
+			best_score = score;
+			best_offset = offset;
+		}
+	}
+
+	if (m_quickseek)
+	{
+		const u32 start = (best_offset >= step) ? (best_offset - step + 1) : 0;
+		const u32 end = std::min(best_offset + step, m_seek_length);
+		const u32 coarse_offset = best_offset;
+		for (u32 offset = start; offset < end; offset++)
+		{
+			if (offset == coarse_offset)
+				continue;
+
+			const float score = GetOverlapScore(input, offset);
+			if (score > best_score)
+			{
+				best_score = score;
+				best_offset = offset;
+			}
+		}
+	}
+
+	return best_offset;
+}
+
+float AudioStretcher::GetOverlapScore(const float* input, u32 offset) const
+{
+	float corr, norm;
+	m_kernels.Correlate(m_reference.data(), input + offset * m_channels, m_overlap_length * m_channels, &corr, &norm);
+	corr /= std::sqrt(std::max(norm, 1e-9f));
+
+	// Slightly favour the middle of the seek window, which keeps the output tempo steadier on
+	// material without a clear period.
+	const float pos = static_cast<float>(2 * offset) / static_cast<float>(m_seek_length) - 1.0f;
+	return (corr + 0.1f) * (1.0f - 0.25f * pos * pos);
+}
+
+void AudioStretcher::UpdateReference()
+{
+	const u32 count = m_overlap_length * m_channels;
+	for (u32 i = 0; i < count; i++)
+		m_reference[i] = m_mid_buffer[i] * m_window[i];
+}
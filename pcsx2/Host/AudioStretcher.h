@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: 2002-2024 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#pragma once
+
+#include "common/Pcsx2Defs.h"
+
+#include "GS/MultiISA.h"
+
+#include <vector>
+
+/// Correlation and cross-fade kernels, compiled for each vector ISA and picked at startup.
+/// Counts are in floats, and always a multiple of 8.
+struct AudioStretcherKernels
+{
+	/// Returns sum(ref * cmp) in corr and sum(cmp * cmp) in norm.
+	void (*Correlate)(const float* ref, const float* cmp, u32 count, float* corr, float* norm);
+
+	/// dest = a + (b - a) * ramp, i.e. fades from a to b.
+	void (*Overlap)(float* dest, const float* a, const float* b, const float* ramp, u32 count);
+};
+
+MULTI_ISA_DEF(void AudioStretcherPopulateKernels(AudioStretcherKernels& kernels);)
+
+/// WSOLA (waveform similarity overlap-add) time stretcher, changes the tempo of the audio without changing
+/// its pitch. Takes the same sequence/seek window/overlap tuning as SoundTouch, but works on whole blocks of
+/// interleaved float frames, and the inner loops use the vector kernels above.
+class AudioStretcher
+{
+public:
+	static constexpr u32 MAX_CHANNELS = 8;
+
+	AudioStretcher(u32 sample_rate, u32 channels, u32 sequence_ms, u32 seekwindow_ms, u32 overlap_ms, bool quickseek);
+	~AudioStretcher();
+
+	__fi float GetTempo() const { return m_tempo; }
+	__fi u32 GetChannels() const { return m_channels; }
+
+	/// Tempo is the ratio of input frames consumed to output frames produced.
+	void SetTempo(float tempo);
+
+	/// Appends frames to the input, processing as many sequences as possible.
+	void PutFrames(const float* frames, u32 num_frames);
+
+	/// Copies up to max_frames of processed output to dest, returns the number of frames copied.
+	u32 ReceiveFrames(float* dest, u32 max_frames);
+
+	/// Discards all buffered input and output.
+	void Clear();
+
+private:
+	/// Interleaved frames, consumed from the front.
+	struct FrameBuffer
+	{
+		std::vector<float> data;
+		u32 start = 0;
+		u32 frames = 0;
+	};
+
+	/// Offsets are checked every QUICKSEEK_STEP frames first, then refined around the best match.
+	static constexpr u32 QUICKSEEK_STEP = 8;
+
+	float* GetWritePointer(FrameBuffer& buf, u32 num_frames);
+	void CommitFrames(FrameBuffer& buf, u32 num_frames);
+	void ConsumeFrames(FrameBuffer& buf, u32 num_frames);
+	__fi const float* GetReadPointer(const FrameBuffer& buf) const { return &buf.data[buf.start * m_channels]; }
+
+	void ProcessSequences();
+	u32 SeekBestOverlap(const float* input) const;
+	float GetOverlapScore(const float* input, u32 offset) const;
+	void UpdateReference();
+
+	AudioStretcherKernels m_kernels;
+
+	u32 m_channels;
+	u32 m_sequence_length; // frames
+	u32 m_seek_length; // frames
+	u32 m_overlap_length; // frames
+	bool m_quickseek;
+	bool m_first_sequence = true;
+
+	float m_tempo = 1.0f;
+	float m_nominal_skip = 0.0f;
+	float m_skip_fract = 0.0f;
+	u32 m_frames_required = 0;
+
+	FrameBuffer m_input;
+	FrameBuffer m_output;
+
+	/// End of the previous sequence, which the next one is overlapped with.
+	std::vector<float> m_mid_buffer;
+
+	/// m_mid_buffer with a window applied, so the middle of the overlap counts more when correlating.
+	std::vector<float> m_reference;
+
+	/// Per-sample window and fade-in ramp, expanded to the channel count.
+	std::vector<float> m_window;
+	std::vector<float> m_ramp;
+};
@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2002-2024 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#include "Host/AudioStretcher.h"
+#include "GS/GSVector.h"
+
+MULTI_ISA_UNSHARED_IMPL;
+
+static void Correlate(const float* ref, const float* cmp, u32 count, float* corr, float* norm)
+{
+#if _M_SSE >= 0x500
+
+	// Two sets of accumulators, so consecutive multiply-adds don't wait on each other.
+	GSVector8 vcorr0 = GSVector8::zero();
+	GSVector8 vcorr1 = GSVector8::zero();
+	GSVector8 vnorm0 = GSVector8::zero();
+	GSVector8 vnorm1 = GSVector8::zero();
+	u32 i = 0;
+	for (; (i + 16) <= count; i += 16)
+	{
+		const GSVector8 c0 = GSVector8::load<false>(cmp + i);
+		const GSVector8 c1 = GSVector8::load<false>(cmp + i + 8);
+		vcorr0 = vcorr0.addm(GSVector8::load<false>(ref + i), c0);
+		vcorr1 = vcorr1.addm(GSVector8::load<false>(ref + i + 8), c1);
+		vnorm0 = vnorm0.addm(c0, c0);
+		vnorm1 = vnorm1.addm(c1, c1);
+	}
+	if (i < count)
+	{
+		const GSVector8 c0 = GSVector8::load<false>(cmp + i);
+		vcorr0 = vcorr0.addm(GSVector8::load<false>(ref + i), c0);
+		vnorm0 = vnorm0.addm(c0, c0);
+	}
+
+	const GSVector8 vcorr = vcorr0 + vcorr1;
+	const GSVector8 vnorm = vnorm0 + vnorm1;
+	const GSVector4 sum = (vcorr.extract<0>() + vcorr.extract<1>()).hadd(vnorm.extract<0>() + vnorm.extract<1>()).hadd();
+	*corr = sum.x;
+	*norm = sum.y;
+
+#else
+
+	GSVector4 vcorr0 = GSVector4::zero();
+	GSVector4 vcorr1 = GSVector4::zero();
+	GSVector4 vnorm0 = GSVector4::zero();
+	GSVector4 vnorm1 = GSVector4::zero();
+	for (u32 i = 0; i < count; i += 8)
+	{
+		const GSVector4 c0 = GSVector4::load<false>(cmp + i);
+		const GSVector4 c1 = GSVector4::load<false>(cmp + i + 4);
+		vcorr0 = vcorr0.addm(GSVector4::load<false>(ref + i), c0);
+		vcorr1 = vcorr1.addm(GSVector4::load<false>(ref + i + 4), c1);
+		vnorm0 = vnorm0.addm(c0, c0);
+		vnorm1 = vnorm1.addm(c1, c1);
+	}
+
+	const GSVector4 sum = (vcorr0 + vcorr1).hadd(vnorm0 + vnorm1).hadd();
+	*corr = sum.x;
+	*norm = sum.y;
+
+#endif
+}
+
+static void Overlap(float* dest, const float* a, const float* b, const float* ramp, u32 count)
+{
+#if _M_SSE >= 0x500
+
+	for (u32 i = 0; i < count; i += 8)
+	{
+		const GSVector8 va = GSVector8::load<false>(a + i);
+		const GSVector8 vb = GSVector8::load<false>(b + i);
+		GSVector8::store<false>(dest + i, va.addm(vb - va, GSVector8::load<false>(ramp + i)));
+	}
+
+#else
+
+	for (u32 i = 0; i < count; i += 4)
+	{
+		const GSVector4 va = GSVector4::load<false>(a + i);
+		const GSVector4 vb = GSVector4::load<false>(b + i);
+		GSVector4::store<false>(dest + i, va.addm(vb - va, GSVector4::load<false>(ramp + i)));
+	}
+
+#endif
+}
+
+void CURRENT_ISA::AudioStretcherPopulateKernels(AudioStretcherKernels& kernels)
+{
+	kernels.Correlate = Correlate;
+	kernels.Overlap = Overlap;
+}
@@ -10,9 +10,11 @@
 #include "Input/InputManager.h"
 #include "Recording/InputRecording.h"
 #include "SPU2/spu2.h"
+#include "SPU2/Trace.h"
 #include "VMManager.h"
 
 #include "common/Assertions.h"
+#include "common/Error.h"
 #include "common/FileSystem.h"
 #include "common/Path.h"
 #include "common/Timer.h"
@@ -203,6 +205,35 @@ DEFINE_HOTKEY("Mute", TRANSLATE_NOOP("Hotkeys", "System"), TRANSLATE_NOOP("Hotke
 	if (!pressed && VMManager::HasValidVM())
 		HotkeyAdjustVolume((SPU2::GetOutputVolume() == 0) ? SPU2::GetResetVolume() : 0, 0);
 })
+DEFINE_HOTKEY("ToggleSPU2Trace", TRANSLATE_NOOP("Hotkeys", "System"), TRANSLATE_NOOP("Hotkeys", "Toggle SPU2 Trace Capture"),
+	[](s32 pressed) {
+		if (pressed || !VMManager::HasValidVM())
+			return;
+
+		if (SPU2Trace::IsRecording())
+		{
+			SPU2Trace::StopRecording();
+			Host::AddIconOSDMessage("SPU2Trace", ICON_FA_VOLUME_UP,
+				fmt::format(TRANSLATE_FS("Hotkeys", "Saved SPU2 trace to '{}'."),
+					Path::GetFileName(SPU2Trace::GetRecordingFilename())),
+				Host::OSD_INFO_DURATION);
+			return;
+		}
+
+		Error error;
+		if (!SPU2Trace::StartRecording(GSGetBaseSnapshotFilename() + ".spu2trace", &error))
+		{
+			Host::AddIconOSDMessage("SPU2Trace", ICON_FA_VOLUME_UP,
+				fmt::format(TRANSLATE_FS("Hotkeys", "Failed to start SPU2 trace: {}"), error.GetDescription()),
+				Host::OSD_ERROR_DURATION);
+			return;
+		}
+
+		Host::AddIconOSDMessage("SPU2Trace", ICON_FA_VOLUME_UP,
+			fmt::format(TRANSLATE_FS("Hotkeys", "Recording SPU2 trace to '{}'."),
+				Path::GetFileName(SPU2Trace::GetRecordingFilename())),
+			Host::OSD_INFO_DURATION);
+	})
 DEFINE_HOTKEY(
 	"FrameAdvance", TRANSLATE_NOOP("Hotkeys", "System"), TRANSLATE_NOOP("Hotkeys", "Frame Advance"), [](s32 pressed) {
 		if (!pressed && VMManager::HasValidVM())
@@ -10,6 +10,11 @@
 #include <limits.h>
 #include "Config.h"
 
+#include "common/Threading.h"
+
+#include <atomic>
+#include <thread>
+
 // the BP doesn't advance and returns -1 if there is no data to be read
 alignas(16) tIPU_cmd ipu_cmd;
 alignas(16) tIPU_BP g_BP;
@@ -17,6 +22,14 @@ alignas(16) decoder_t decoder;
 IPUStatus IPUCoreStatus;
 
 static void (*IPUWorker)();
+static void (*IPUSyncMacroblock)();
+
+// Macroblock reconstruction thread, started the first time IDEC/BDEC submits a macroblock with
+// Speedhacks.ipuThread enabled. Jobs are tiny (a few microseconds), so both sides spin before sleeping.
+static Threading::WorkSema s_ipu_thread_sema;
+static std::thread s_ipu_thread;
+static std::atomic_bool s_ipu_thread_exit{false};
+static void (*s_ipu_thread_job)();
 
 // Color conversion stuff, the memory layout is a total hack
 // convert_data_buffer is a pointer to the internal rgb struct (the first param in convert_init_t)
@@ -84,12 +97,76 @@ __fi void IPUProcessInterrupt()
 		IPUWorker();
 }
 
+static void IPUThreadEntryPoint()
+{
+	Threading::SetNameOfCurrentThread("IPU Worker");
+
+	for (;;)
+	{
+		s_ipu_thread_sema.WaitForWorkWithSpin();
+		if (s_ipu_thread_exit.load(std::memory_order_acquire))
+			break;
+
+		s_ipu_thread_job();
+	}
+}
+
+static bool s_ipu_thread_forced = false;
+
+bool IPUThreadEnabled()
+{
+	// Nothing to overlap with on a single core, and both sides spin while waiting, so it would only slow things down.
+	static const bool multi_core = (std::thread::hardware_concurrency() > 1);
+	return EmuConfig.Speedhacks.ipuThread && (multi_core || s_ipu_thread_forced);
+}
+
+void IPUThreadSetForced(bool forced)
+{
+	s_ipu_thread_forced = forced;
+}
+
+void IPUThreadSubmit(void (*job)())
+{
+	if (!s_ipu_thread.joinable())
+	{
+		s_ipu_thread_exit.store(false, std::memory_order_release);
+		s_ipu_thread_sema.Reset();
+		s_ipu_thread = std::thread(&IPUThreadEntryPoint);
+	}
+	else
+	{
+		s_ipu_thread_sema.WaitForEmptyWithSpin();
+	}
+
+	s_ipu_thread_job = job;
+	s_ipu_thread_sema.NotifyOfWork();
+}
+
+void IPUThreadWait()
+{
+	if (s_ipu_thread.joinable())
+		s_ipu_thread_sema.WaitForEmptyWithSpin();
+}
+
+void ipuShutdown()
+{
+	if (!s_ipu_thread.joinable())
+		return;
+
+	s_ipu_thread_sema.WaitForEmpty();
+	s_ipu_thread_exit.store(true, std::memory_order_release);
+	s_ipu_thread_sema.NotifyOfWork();
+	s_ipu_thread.join();
+}
+
 /////////////////////////////////////////////////////////
 // Register accesses (run on EE thread)
 
 void ipuReset()
 {
 	IPUWorker = MULTI_ISA_SELECT(IPUWorker);
+	IPUSyncMacroblock = MULTI_ISA_SELECT(IPUSyncMacroblock);
+	IPUSyncMacroblock();
 	std::memset(&ipuRegs, 0, sizeof(ipuRegs));
 	std::memset(&g_BP, 0, sizeof(g_BP));
 	std::memset(&decoder, 0, sizeof(decoder));
@@ -125,6 +202,9 @@ bool SaveStateBase::ipuFreeze()
 	if (!FreezeTag("IPU"))
 		return false;
 
+	// Finish the macroblock on the IPU thread, the state is the same as it would be without it.
+	IPUSyncMacroblock();
+
 	Freeze(ipu_fifo);
 
 	Freeze(g_BP);
@@ -307,6 +387,7 @@ __fi u64 ipuRead64(u32 mem)
 
 void ipuSoftReset()
 {
+	IPUSyncMacroblock();
 	ipu_fifo.clear();
 	std::memset(&g_BP, 0, sizeof(g_BP));
 
@@ -456,6 +537,7 @@ __fi void IPUCMD_WRITE(u32 val)
 {
 	// don't process anything if currently busy
 	//if (ipuRegs.ctrl.BUSY) Console.WriteLn("IPU BUSY!"); // wait for thread
+	IPUSyncMacroblock();
 	ipuRegs.ctrl.ECD = 0;
 	ipuRegs.ctrl.SCD = 0;
 	ipu_cmd.clear();
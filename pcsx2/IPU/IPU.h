@@ -296,4 +296,13 @@ extern bool ipuWrite64(u32 mem,u64 value);
 extern void IPUCMD_WRITE(u32 val);
 extern void ipuSoftReset();
 extern void IPUProcessInterrupt();
+extern void ipuShutdown();
+
+// Runs a macroblock's IDCTs and colour conversion on the IPU thread (Speedhacks.ipuThread).
+// Only one can be in flight, IPUThreadWait() has to be called before touching the decoder's output.
+extern bool IPUThreadEnabled();
+// Uses the thread when Speedhacks.ipuThread is set even on a single core host, so tests can compare both paths.
+extern void IPUThreadSetForced(bool forced);
+extern void IPUThreadSubmit(void (*job)());
+extern void IPUThreadWait();
 
@@ -66,6 +66,7 @@ MULTI_ISA_UNSHARED_START
 
 static void ipu_csc(macroblock_8& mb8, macroblock_rgb32& rgb32, int sgn);
 static void ipu_vq(macroblock_rgb16& rgb16, u8* indx4);
+static void ipu_mb8_to_mb16(const macroblock_8& mb8, macroblock_16& mb16);
 
 // --------------------------------------------------------------------------------------
 //  Buffer reader
@@ -375,6 +376,122 @@ __ri static void IDCT_Add(const int last, s16* block, s16* dest, const int strid
 	}
 }
 
+// --------------------------------------------------------------------------------------
+//  Macroblock reconstruction
+// --------------------------------------------------------------------------------------
+// The VLC decode has to stay in step with the bitstream, but the IDCTs and the colour conversion only
+// feed the output FIFO. With the IPU thread enabled, the coefficient blocks are queued as they're decoded,
+// and the rest of the macroblock is built on that thread while the output is held back by IPU_INT_PROCESS.
+// The output stage waits for it before writing anything to the FIFO, so nothing the EE sees changes.
+
+enum class MacroblockOutput : u8
+{
+	MB16, // BDEC non-intra, the IDCTs write mb16
+	MB8ToMB16, // BDEC intra
+	RGB32, // IDEC
+	RGB16, // IDEC with OFM set
+};
+
+struct QueuedBlock
+{
+	alignas(16) s16 coefs[64];
+	void* dest;
+	int stride;
+	int last; // for IDCT_Add, -1 for intra blocks
+};
+
+static struct
+{
+	QueuedBlock blocks[6];
+	u32 num_blocks;
+	MacroblockOutput output;
+	int sgn;
+	int dte;
+} s_mb_job;
+
+__ri static void ReconstructBlock(int last, s16* block, void* dest, int stride)
+{
+	if (last < 0)
+		IDCT_Copy(block, static_cast<u8*>(dest), stride);
+	else
+		IDCT_Add(last, block, static_cast<s16*>(dest), stride);
+}
+
+__ri static void ReconstructQueuedBlocks()
+{
+	for (u32 i = 0; i < s_mb_job.num_blocks; i++)
+	{
+		QueuedBlock& block = s_mb_job.blocks[i];
+		ReconstructBlock(block.last, block.coefs, block.dest, block.stride);
+	}
+
+	s_mb_job.num_blocks = 0;
+}
+
+static void ReconstructMacroblock()
+{
+	ReconstructQueuedBlocks();
+
+	switch (s_mb_job.output)
+	{
+		case MacroblockOutput::MB16:
+			break;
+
+		case MacroblockOutput::MB8ToMB16:
+			ipu_mb8_to_mb16(decoder.mb8, decoder.mb16);
+			break;
+
+		case MacroblockOutput::RGB32:
+			ipu_csc(decoder.mb8, decoder.rgb32, s_mb_job.sgn);
+			break;
+
+		case MacroblockOutput::RGB16:
+			ipu_csc(decoder.mb8, decoder.rgb32, s_mb_job.sgn);
+			ipu_dither(decoder.rgb32, decoder.rgb16, s_mb_job.dte);
+			break;
+
+		jNO_DEFAULT
+	}
+}
+
+// Takes the block just decoded into decoder.DCTblock, leaving it cleared for the next one.
+__ri static void QueueBlock(int last, void* dest, int stride)
+{
+	if (!IPUThreadEnabled())
+	{
+		ReconstructBlock(last, decoder.DCTblock, dest, stride);
+		return;
+	}
+
+	pxAssert(s_mb_job.num_blocks < std::size(s_mb_job.blocks));
+	QueuedBlock& block = s_mb_job.blocks[s_mb_job.num_blocks++];
+	std::memcpy(block.coefs, decoder.DCTblock, sizeof(block.coefs));
+	std::memset(decoder.DCTblock, 0, sizeof(decoder.DCTblock));
+	block.dest = dest;
+	block.stride = stride;
+	block.last = last;
+}
+
+__ri static void SubmitMacroblock(MacroblockOutput output)
+{
+	s_mb_job.output = output;
+	s_mb_job.sgn = decoder.sgn;
+	s_mb_job.dte = decoder.dte;
+
+	if (IPUThreadEnabled())
+		IPUThreadSubmit(&ReconstructMacroblock);
+	else
+		ReconstructMacroblock();
+}
+
+void IPUSyncMacroblock()
+{
+	// Blocks of a partly decoded macroblock are reconstructed too, so the decoder state matches
+	// what it would be without the thread.
+	IPUThreadWait();
+	ReconstructQueuedBlocks();
+}
+
 /* Bitstream and buffer needs to be reallocated in order for successful
 	reading of the old data. Here the old data stored in the 2nd slot
 	of the internal buffer is copied to 1st slot, and the new data read
@@ -933,7 +1050,7 @@ __ri static bool slice_intra_DCT(const int cc, u8 * const dest, const int stride
 		return false;
 	}
 
-	IDCT_Copy(decoder.DCTblock, dest, stride);
+	QueueBlock(-1, dest, stride);
 
 	return true;
 }
@@ -947,7 +1064,7 @@ __ri static bool slice_non_intra_DCT(s16 * const dest, const int stride, const b
 	if (!get_non_intra_block(&last))
 		return false;
 
-	IDCT_Add(last, decoder.DCTblock, dest, stride);
+	QueueBlock(last, dest, stride);
 	return true;
 }
 
@@ -1085,13 +1202,14 @@ __ri static bool mpeg2sliceIDEC()
 				}
 
 				// Send The MacroBlock via DmaIpuFrom
-				ipu_csc(mb8, rgb32, decoder.sgn);
-
 				if (decoder.ofm == 0)
+				{
+					SubmitMacroblock(MacroblockOutput::RGB32);
 					decoder.SetOutputTo(rgb32);
+				}
 				else
 				{
-					ipu_dither(rgb32, rgb16, decoder.dte);
+					SubmitMacroblock(MacroblockOutput::RGB16);
 					decoder.SetOutputTo(rgb16);
 				}
 				ipu_cmd.pos[1] = 2;
@@ -1107,6 +1225,7 @@ __ri static bool mpeg2sliceIDEC()
 					ipu_cmd.pos[1] = 2;
 					return false;
 				}
+				IPUThreadWait();
 				pxAssert(decoder.ipu0_data > 0);
 				uint read = ipu_fifo.out.write((u32*)decoder.GetIpuDataPtr(), decoder.ipu0_data);
 				decoder.AdvanceIpuDataBy(read);
@@ -1363,51 +1482,6 @@ __fi static bool mpeg2_slice()
 
 			jNO_DEFAULT;
 			}
-
-			// Copy macroblock8 to macroblock16 - without sign extension.
-			// Manually inlined due to MSVC refusing to inline the SSE-optimized version.
-			{
-				const u8	*s = (const u8*)&mb8;
-				u16			*d = (u16*)&mb16;
-
-				//Y  bias	- 16 * 16
-				//Cr bias	- 8 * 8
-				//Cb bias	- 8 * 8
-
-#if defined(_M_X86)
-				__m128i zeroreg = _mm_setzero_si128();
-
-				for (uint i = 0; i < (256+64+64) / 32; ++i)
-				{
-					//*d++ = *s++;
-					__m128i woot1 = _mm_load_si128((__m128i*)s);
-					__m128i woot2 = _mm_load_si128((__m128i*)s+1);
-					_mm_store_si128((__m128i*)d,	_mm_unpacklo_epi8(woot1, zeroreg));
-					_mm_store_si128((__m128i*)d+1,	_mm_unpackhi_epi8(woot1, zeroreg));
-					_mm_store_si128((__m128i*)d+2,	_mm_unpacklo_epi8(woot2, zeroreg));
-					_mm_store_si128((__m128i*)d+3,	_mm_unpackhi_epi8(woot2, zeroreg));
-					s += 32;
-					d += 32;
-				}
-#elif defined(_M_ARM64)
-				uint8x16_t zeroreg = vmovq_n_u8(0);
-
-				for (uint i = 0; i < (256 + 64 + 64) / 32; ++i)
-				{
-					//*d++ = *s++;
-					uint8x16_t woot1 = vld1q_u8((uint8_t*)s);
-					uint8x16_t woot2 = vld1q_u8((uint8_t*)s + 16);
-					vst1q_u8((uint8_t*)d, vzip1q_u8(woot1, zeroreg));
-					vst1q_u8((uint8_t*)d + 16, vzip2q_u8(woot1, zeroreg));
-					vst1q_u8((uint8_t*)d + 32, vzip1q_u8(woot2, zeroreg));
-					vst1q_u8((uint8_t*)d + 48, vzip2q_u8(woot2, zeroreg));
-					s += 32;
-					d += 32;
-				}
-#else
-#error Unsupported arch
-#endif
-			}
 		}
 		else
 		{
@@ -1505,6 +1579,7 @@ __fi static bool mpeg2_slice()
 		}
 
 		// Send The MacroBlock via DmaIpuFrom
+		SubmitMacroblock((decoder.macroblock_modes & MACROBLOCK_INTRA) ? MacroblockOutput::MB8ToMB16 : MacroblockOutput::MB16);
 		ipuRegs.ctrl.SCD = 0;
 		coded_block_pattern = decoder.coded_block_pattern;
 
@@ -1522,6 +1597,7 @@ __fi static bool mpeg2_slice()
 			return false;
 		}
 
+		IPUThreadWait();
 		pxAssert(decoder.ipu0_data > 0);
 		uint read = ipu_fifo.out.write((u32*)decoder.GetIpuDataPtr(), decoder.ipu0_data);
 		decoder.AdvanceIpuDataBy(read);
@@ -1909,6 +1985,51 @@ __fi static void ipu_csc(macroblock_8& mb8, macroblock_rgb32& rgb32, int sgn)
 	}
 }
 
+// Copy macroblock8 to macroblock16 - without sign extension.
+__fi static void ipu_mb8_to_mb16(const macroblock_8& mb8, macroblock_16& mb16)
+{
+	const u8	*s = (const u8*)&mb8;
+	u16			*d = (u16*)&mb16;
+
+	//Y  bias	- 16 * 16
+	//Cr bias	- 8 * 8
+	//Cb bias	- 8 * 8
+
+#if defined(_M_X86)
+	__m128i zeroreg = _mm_setzero_si128();
+
+	for (uint i = 0; i < (256+64+64) / 32; ++i)
+	{
+		//*d++ = *s++;
+		__m128i woot1 = _mm_load_si128((__m128i*)s);
+		__m128i woot2 = _mm_load_si128((__m128i*)s+1);
+		_mm_store_si128((__m128i*)d,	_mm_unpacklo_epi8(woot1, zeroreg));
+		_mm_store_si128((__m128i*)d+1,	_mm_unpackhi_epi8(woot1, zeroreg));
+		_mm_store_si128((__m128i*)d+2,	_mm_unpacklo_epi8(woot2, zeroreg));
+		_mm_store_si128((__m128i*)d+3,	_mm_unpackhi_epi8(woot2, zeroreg));
+		s += 32;
+		d += 32;
+	}
+#elif defined(_M_ARM64)
+	uint8x16_t zeroreg = vmovq_n_u8(0);
+
+	for (uint i = 0; i < (256 + 64 + 64) / 32; ++i)
+	{
+		//*d++ = *s++;
+		uint8x16_t woot1 = vld1q_u8((uint8_t*)s);
+		uint8x16_t woot2 = vld1q_u8((uint8_t*)s + 16);
+		vst1q_u8((uint8_t*)d, vzip1q_u8(woot1, zeroreg));
+		vst1q_u8((uint8_t*)d + 16, vzip2q_u8(woot1, zeroreg));
+		vst1q_u8((uint8_t*)d + 32, vzip1q_u8(woot2, zeroreg));
+		vst1q_u8((uint8_t*)d + 48, vzip2q_u8(woot2, zeroreg));
+		s += 32;
+		d += 32;
+	}
+#else
+#error Unsupported arch
+#endif
+}
+
 __fi static void ipu_vq(macroblock_rgb16& rgb16, u8* indx4)
 {
 	const auto closest_index = [&](int i, int j) {
@@ -145,6 +145,7 @@ MULTI_ISA_DEF(
 	extern void ipu_dither(const macroblock_rgb32& rgb32, macroblock_rgb16& rgb16, int dte);
 
 	void IPUWorker();
+	void IPUSyncMacroblock();
 )
 
 // Quantization matrix
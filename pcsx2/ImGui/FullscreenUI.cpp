@@ -4011,6 +4011,9 @@ void FullscreenUI::DrawGraphicsSettingsPage(SettingsInterface* bsi, bool show_ad
 				"Uploads full textures to the GPU on use, rather than only the utilized regions. Can improve performance in some games."),
 			"EmuCore/GS", "texture_preloading", static_cast<int>(TexturePreloadingLevel::Off), s_preloading_options,
 			std::size(s_preloading_options), true);
+		DrawIntRangeSetting(bsi, FSUI_CSTR("Hash Cache Budget"),
+			FSUI_CSTR("Limits the video memory used by cached textures, dropping the ones not in use to stay within it. 0 disables the limit."),
+			"EmuCore/GS", "HashCacheBudget", 0, 0, 8192, FSUI_CSTR("%d MB"));
 	}
 
 	EndMenuButtons();
@@ -7191,6 +7194,9 @@ TRANSLATE_NOOP("FullscreenUI", "Disable Vertex Shader Expand");
 TRANSLATE_NOOP("FullscreenUI", "Falls back to the CPU for expanding sprites/lines.");
 TRANSLATE_NOOP("FullscreenUI", "Texture Preloading");
 TRANSLATE_NOOP("FullscreenUI", "Uploads full textures to the GPU on use, rather than only the utilized regions. Can improve performance in some games.");
+TRANSLATE_NOOP("FullscreenUI", "Hash Cache Budget");
+TRANSLATE_NOOP("FullscreenUI", "%d MB");
+TRANSLATE_NOOP("FullscreenUI", "Limits the video memory used by cached textures, dropping the ones not in use to stay within it. 0 disables the limit.");
 TRANSLATE_NOOP("FullscreenUI", "Audio Control");
 TRANSLATE_NOOP("FullscreenUI", "Controls the volume of the audio played on the host.");
 TRANSLATE_NOOP("FullscreenUI", "Controls the volume of the audio played on the host when fast forwarding.");
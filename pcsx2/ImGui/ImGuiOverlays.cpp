@@ -478,6 +478,8 @@ __ri void ImGuiManager::DrawSettingsOverlay(float scale, float margin, float spa
 			APPEND("RBSG ");
 		if (GSConfig.HWSpinCPUForReadbacks)
 			APPEND("RBSC ");
+		if (GSConfig.HWSpeculativeReadbacks)
+			APPEND("RBSP ");
 	}
 
 #undef APPEND
@@ -406,6 +406,7 @@ void Pcsx2Config::SpeedhackOptions::LoadSave(SettingsWrapper& wrap)
 	SettingsWrapBitBool(vuFlagHack);
 	SettingsWrapBitBool(vuThread);
 	SettingsWrapBitBool(vu1Instant);
+	SettingsWrapBitBool(ipuThread);
 
 	EECycleRate = std::clamp(EECycleRate, MIN_EE_CYCLE_RATE, MAX_EE_CYCLE_RATE);
 	EECycleSkip = std::min(EECycleSkip, MAX_EE_CYCLE_SKIP);
@@ -453,6 +454,12 @@ Pcsx2Config::RecompilerOptions::RecompilerOptions()
 	EnableVU1 = true;
 	EnableFastmem = true;
 	PauseOnTLBMiss = false;
+	EnableEEBlockReuse = false;
+	EnableVU1AsyncCompile = false;
+	EnableEEBlockProfiler = false;
+	EnableEESuperblocks = false;
+	EnableIOPBlockLinking = true;
+	EnableIOPLinkStats = false;
 
 	// vu and fpu clamping default to standard overflow.
 	vu0Overflow = true;
@@ -531,6 +538,12 @@ void Pcsx2Config::RecompilerOptions::LoadSave(SettingsWrapper& wrap)
 	SettingsWrapBitBool(EnableVU1);
 	SettingsWrapBitBool(EnableFastmem);
 	SettingsWrapBitBool(PauseOnTLBMiss);
+	SettingsWrapBitBool(EnableEEBlockReuse);
+	SettingsWrapBitBool(EnableVU1AsyncCompile);
+	SettingsWrapBitBool(EnableEEBlockProfiler);
+	SettingsWrapBitBool(EnableEESuperblocks);
+	SettingsWrapBitBool(EnableIOPBlockLinking);
+	SettingsWrapBitBool(EnableIOPLinkStats);
 
 	SettingsWrapBitBool(vu0Overflow);
 	SettingsWrapBitBool(vu0ExtraOverflow);
@@ -730,6 +743,7 @@ Pcsx2Config::GSOptions::GSOptions()
 	HWDownloadMode = GSHardwareDownloadMode::Enabled;
 	HWSpinGPUForReadbacks = false;
 	HWSpinCPUForReadbacks = false;
+	HWSpeculativeReadbacks = false;
 	GPUPaletteConversion = false;
 	AutoFlushSW = true;
 	PreloadFrameWithGSData = false;
@@ -811,6 +825,7 @@ bool Pcsx2Config::GSOptions::OptionsAreEqual(const GSOptions& right) const
 		OpEqu(MaxAnisotropy) &&
 		OpEqu(SWExtraThreads) &&
 		OpEqu(SWExtraThreadsHeight) &&
+		OpEqu(SWRasterMode) &&
 		OpEqu(TriFilter) &&
 		OpEqu(TVShader) &&
 		OpEqu(GetSkipCountFunctionId) &&
@@ -838,6 +853,7 @@ bool Pcsx2Config::GSOptions::OptionsAreEqual(const GSOptions& right) const
 		OpEqu(ShadeBoost_Contrast) &&
 		OpEqu(ShadeBoost_Saturation) &&
 		OpEqu(PNGCompressionLevel) &&
+		OpEqu(HashCacheBudget) &&
 		OpEqu(SaveN) &&
 		OpEqu(SaveL) &&
 
@@ -940,6 +956,7 @@ void Pcsx2Config::GSOptions::LoadSave(SettingsWrapper& wrap)
 
 	SettingsWrapBitBool(HWSpinGPUForReadbacks);
 	SettingsWrapBitBool(HWSpinCPUForReadbacks);
+	SettingsWrapBitBool(HWSpeculativeReadbacks);
 	SettingsWrapBitBoolEx(GPUPaletteConversion, "paltex");
 	SettingsWrapBitBoolEx(AutoFlushSW, "autoflush_sw");
 	SettingsWrapBitBoolEx(PreloadFrameWithGSData, "preload_frame_with_gs_data");
@@ -994,6 +1011,7 @@ void Pcsx2Config::GSOptions::LoadSave(SettingsWrapper& wrap)
 	SettingsWrapIntEnumEx(AccurateBlendingUnit, "accurate_blending_unit");
 	SettingsWrapIntEnumEx(TextureFiltering, "filter");
 	SettingsWrapIntEnumEx(TexturePreloading, "texture_preloading");
+	SettingsWrapBitfieldEx(HashCacheBudget, "HashCacheBudget");
 	SettingsWrapIntEnumEx(GSDumpCompression, "GSDumpCompression");
 	SettingsWrapIntEnumEx(HWDownloadMode, "HWDownloadMode");
 	SettingsWrapIntEnumEx(CASMode, "CASMode");
@@ -1002,6 +1020,7 @@ void Pcsx2Config::GSOptions::LoadSave(SettingsWrapper& wrap)
 	SettingsWrapBitfieldEx(MaxAnisotropy, "MaxAnisotropy");
 	SettingsWrapBitfieldEx(SWExtraThreads, "extrathreads");
 	SettingsWrapBitfieldEx(SWExtraThreadsHeight, "extrathreads_height");
+	SettingsWrapIntEnumEx(SWRasterMode, "SWRasterMode");
 	SettingsWrapBitfieldEx(TVShader, "TVShader");
 	SettingsWrapBitfieldEx(SkipDrawStart, "UserHacks_SkipDraw_Start");
 	SettingsWrapBitfieldEx(SkipDrawEnd, "UserHacks_SkipDraw_End");
@@ -1192,6 +1211,7 @@ void Pcsx2Config::SPU2Options::LoadSave(SettingsWrapper& wrap)
 		SettingsWrapEntry(OutputVolume);
 		SettingsWrapEntry(FastForwardVolume);
 		SettingsWrapEntry(OutputMuted);
+		SettingsWrapEntry(StreamWriteThread);
 		SettingsWrapParsedEnum(Backend, "Backend", &AudioStream::ParseBackendName, &AudioStream::GetBackendName);
 		SettingsWrapParsedEnum(SyncMode, "SyncMode", &ParseSyncMode, &GetSyncModeName);
 		SettingsWrapEntry(DriverName);
@@ -1211,6 +1231,7 @@ bool Pcsx2Config::SPU2Options::operator==(const SPU2Options& right) const
 		   OpEqu(OutputVolume) &&
 		   OpEqu(FastForwardVolume) &&
 		   OpEqu(OutputMuted) &&
+		   OpEqu(StreamWriteThread) &&
 		   OpEqu(Backend) &&
 		   OpEqu(StreamParameters) &&
 		   OpEqu(DriverName) &&
@@ -1909,6 +1930,7 @@ Pcsx2Config::Pcsx2Config()
 	}
 
 	GzipIsoIndexTemplate = "$(f).pindex.tmp";
+	CdvdCacheBuffers = 8;
 	PINESlot = 28011;
 }
 
@@ -1956,6 +1978,7 @@ void Pcsx2Config::LoadSaveCore(SettingsWrapper& wrap)
 	Achievements.LoadSave(wrap);
 
 	SettingsWrapEntry(GzipIsoIndexTemplate);
+	SettingsWrapEntry(CdvdCacheBuffers);
 	SettingsWrapEntry(PINESlot);
 
 	// For now, this in the derived config for backwards ini compatibility.
@@ -310,7 +310,8 @@ __forceinline static s32 GaussianInterpolate(s32 pv4, s32 pv3, s32 pv2, s32 pv1,
 	return out;
 }
 
-static __forceinline s32 GetVoiceValues(V_Core& thiscore, uint voiceidx)
+// Steps the sample pointer, and returns the interpolation table index for the new position.
+static __forceinline s32 FetchVoiceSamples(V_Core& thiscore, uint voiceidx)
 {
 	V_Voice& vc(thiscore.Voices[voiceidx]);
 
@@ -325,7 +326,16 @@ static __forceinline s32 GetVoiceValues(V_Core& thiscore, uint voiceidx)
 
 	const s32 mu = vc.SP + 0x1000;
 
-	return GaussianInterpolate(vc.PV4, vc.PV3, vc.PV2, vc.PV1, (mu & 0x0ff0) >> 4);
+	return (mu & 0x0ff0) >> 4;
+}
+
+static __forceinline s32 GetVoiceValues(V_Core& thiscore, uint voiceidx)
+{
+	V_Voice& vc(thiscore.Voices[voiceidx]);
+
+	const s32 i = FetchVoiceSamples(thiscore, voiceidx);
+
+	return GaussianInterpolate(vc.PV4, vc.PV3, vc.PV2, vc.PV1, i);
 }
 
 // This is Dr. Hell's noise algorithm as implemented in pcsxr
@@ -457,7 +467,8 @@ static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
 
 const VoiceMixSet VoiceMixSet::Empty((StereoOut32()), (StereoOut32())); // Don't use SteroOut32::Empty because C++ doesn't make any dep/order checks on global initializers.
 
-static __forceinline void MixCoreVoices(VoiceMixSet& dest, const uint coreidx)
+// Reference mixer, runs every voice through MixVoice in turn.
+void MixCoreVoicesScalar(VoiceMixSet& dest, const uint coreidx)
 {
 	V_Core& thiscore(Cores[coreidx]);
 
@@ -474,6 +485,127 @@ static __forceinline void MixCoreVoices(VoiceMixSet& dest, const uint coreidx)
 	}
 }
 
+// Does the parts of MixVoice which can't be batched: volume slides, pitch, sample
+// fetch and ADSR. Returns true if the voice was playing at the start of the tick.
+static __forceinline bool PrepareVoice(V_VoiceBatch& batch, uint coreidx, uint voiceidx)
+{
+	V_Core& thiscore(Cores[coreidx]);
+	V_Voice& vc(thiscore.Voices[voiceidx]);
+
+	pxAssertMsg((vc.SCurrent <= 28) && (vc.SCurrent != 0), "Current sample should always range from 1->28");
+
+	vc.Volume.Update();
+	UpdatePitch(coreidx, voiceidx);
+
+	const bool playing = (vc.ADSR.Phase > V_ADSR::PHASE_STOPPED);
+	if (playing)
+	{
+		if (vc.Noise)
+		{
+			batch.Coef[0][voiceidx] = 0;
+			batch.Coef[1][voiceidx] = 0;
+			batch.Coef[2][voiceidx] = 0;
+			batch.Coef[3][voiceidx] = 0x8000;
+			batch.Sample[0][voiceidx] = 0;
+			batch.Sample[1][voiceidx] = 0;
+			batch.Sample[2][voiceidx] = 0;
+			batch.Sample[3][voiceidx] = GetNoiseValues(thiscore);
+		}
+		else
+		{
+			const auto& coefs = interpTable[FetchVoiceSamples(thiscore, voiceidx)];
+			batch.Coef[0][voiceidx] = coefs[0];
+			batch.Coef[1][voiceidx] = coefs[1];
+			batch.Coef[2][voiceidx] = coefs[2];
+			batch.Coef[3][voiceidx] = coefs[3];
+			batch.Sample[0][voiceidx] = vc.PV4;
+			batch.Sample[1][voiceidx] = vc.PV3;
+			batch.Sample[2][voiceidx] = vc.PV2;
+			batch.Sample[3][voiceidx] = vc.PV1;
+		}
+
+		CalculateADSR(thiscore, voiceidx);
+		batch.Env[voiceidx] = vc.ADSR.Value;
+	}
+	else
+	{
+		while (vc.SP >= 0)
+			GetNextDataDummy(thiscore, voiceidx); // Dummy is enough
+
+		for (int i = 0; i < 4; i++)
+		{
+			batch.Coef[i][voiceidx] = 0;
+			batch.Sample[i][voiceidx] = 0;
+		}
+		batch.Env[voiceidx] = 0;
+	}
+
+	batch.VolL[voiceidx] = vc.Volume.Left.Value;
+	batch.VolR[voiceidx] = vc.Volume.Right.Value;
+
+	batch.DryL[voiceidx] = thiscore.VoiceGates[voiceidx].DryL;
+	batch.DryR[voiceidx] = thiscore.VoiceGates[voiceidx].DryR;
+	batch.WetL[voiceidx] = thiscore.VoiceGates[voiceidx].WetL;
+	batch.WetR[voiceidx] = thiscore.VoiceGates[voiceidx].WetR;
+
+	return playing;
+}
+
+// Output of a single voice of the batch, computed the same way as MixVoiceBatch.
+static __forceinline s32 GetBatchVoiceValue(const V_VoiceBatch& batch, uint voiceidx)
+{
+	s32 out = 0;
+	out =  (batch.Coef[0][voiceidx] * batch.Sample[0][voiceidx]) >> 15;
+	out += (batch.Coef[1][voiceidx] * batch.Sample[1][voiceidx]) >> 15;
+	out += (batch.Coef[2][voiceidx] * batch.Sample[2][voiceidx]) >> 15;
+	out += (batch.Coef[3][voiceidx] * batch.Sample[3][voiceidx]) >> 15;
+
+	return ApplyVolume(out, batch.Env[voiceidx]);
+}
+
+void MixCoreVoices(VoiceMixSet& dest, const uint coreidx)
+{
+	V_Core& thiscore(Cores[coreidx]);
+	V_VoiceBatch batch;
+	u32 playing = 0;
+
+	for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; ++voiceidx)
+	{
+		V_Voice& vc(thiscore.Voices[voiceidx]);
+
+		if (PrepareVoice(batch, coreidx, voiceidx))
+			playing |= 1u << voiceidx;
+
+		// The pitch of a modulated voice depends on the output of the voice before it, and voices 1
+		// and 3 are written back to ram before the next voice reads its samples. Work those out now.
+		const bool modulates_next = (voiceidx + 1 < V_Core::NumVoices) && thiscore.Voices[voiceidx + 1].Modulated;
+		if (modulates_next || voiceidx == 1 || voiceidx == 3)
+		{
+			const s32 Value = GetBatchVoiceValue(batch, voiceidx);
+			if (playing & (1u << voiceidx))
+				vc.OutX = Value;
+
+			if (voiceidx == 1)
+				spu2M_WriteFast(((0 == coreidx) ? 0x400 : 0xc00) + OutPos, Value);
+			else if (voiceidx == 3)
+				spu2M_WriteFast(((0 == coreidx) ? 0x600 : 0xe00) + OutPos, Value);
+		}
+	}
+
+	MixVoiceBatch(batch, dest);
+
+	for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; ++voiceidx)
+	{
+		if (!(playing & (1u << voiceidx)))
+			continue;
+
+		thiscore.Voices[voiceidx].OutX = batch.Out[voiceidx];
+
+		if (IsDevBuild)
+			DebugCores[coreidx].Voices[voiceidx].displayPeak = std::max(DebugCores[coreidx].Voices[voiceidx].displayPeak, batch.Out[voiceidx]);
+	}
+}
+
 StereoOut32 V_Core::Mix(const VoiceMixSet& inVoices, const StereoOut32& Input, const StereoOut32& Ext)
 {
 	MasterVol.Update();
@@ -0,0 +1,374 @@
+// SPDX-FileCopyrightText: 2002-2024 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#include "SPU2/Trace.h"
+#include "SPU2/defs.h"
+#include "SPU2/spu2.h"
+#include "IopMem.h"
+#include "R3000A.h"
+
+#include "common/Console.h"
+#include "common/Error.h"
+#include "common/FileSystem.h"
+
+#include <cstring>
+
+namespace SPU2Trace
+{
+	static constexpr size_t FLUSH_THRESHOLD = 1024 * 1024;
+
+	template <typename T>
+	static void Append(T value);
+	static void AppendEvent(EventType type);
+	static void AppendBytes(const void* data, size_t size);
+	static void Flush();
+	static u32 GetIOPOffset(const u16* mem);
+
+	static std::FILE* s_file = nullptr;
+	static std::string s_filename;
+	static std::vector<u8> s_buffer;
+	static u32 s_last_cycle = 0;
+	static u64 s_event_count = 0;
+} // namespace SPU2Trace
+
+template <typename T>
+void SPU2Trace::Append(T value)
+{
+	AppendBytes(&value, sizeof(value));
+}
+
+void SPU2Trace::AppendBytes(const void* data, size_t size)
+{
+	const u8* bytes = static_cast<const u8*>(data);
+	s_buffer.insert(s_buffer.end(), bytes, bytes + size);
+}
+
+void SPU2Trace::AppendEvent(EventType type)
+{
+	if (s_buffer.size() >= FLUSH_THRESHOLD)
+		Flush();
+
+	Append(static_cast<u8>(type));
+	Append(psxRegs.cycle - s_last_cycle);
+	s_last_cycle = psxRegs.cycle;
+	s_event_count++;
+}
+
+void SPU2Trace::Flush()
+{
+	if (s_buffer.empty())
+		return;
+
+	if (std::fwrite(s_buffer.data(), s_buffer.size(), 1, s_file) != 1)
+	{
+		Console.ErrorFmt("SPU2Trace: Failed to write to '{}', stopping.", s_filename);
+		s_buffer.clear();
+		std::fclose(s_file);
+		s_file = nullptr;
+		return;
+	}
+
+	s_buffer.clear();
+}
+
+u32 SPU2Trace::GetIOPOffset(const u16* mem)
+{
+	return static_cast<u32>(reinterpret_cast<const u8*>(mem) - iopPhysMem(0));
+}
+
+bool SPU2Trace::StartRecording(std::string path, Error* error)
+{
+	StopRecording();
+
+	const s32 state_size = SPU2Savestate::SizeIt();
+	std::vector<u8> state(static_cast<size_t>(state_size));
+	SPU2Savestate::FreezeIt(*reinterpret_cast<SPU2Savestate::DataBlock*>(state.data()));
+
+	s_file = FileSystem::OpenCFile(path.c_str(), "wb", error);
+	if (!s_file)
+		return false;
+
+	Header header = {};
+	header.magic = MAGIC;
+	header.version = VERSION;
+	header.state_size = static_cast<u32>(state_size);
+	header.start_cycle = psxRegs.cycle;
+	header.psx_mode = SPU2::IsRunningPSXMode();
+	header.dc_filter_in[0] = DCFilterIn.Left;
+	header.dc_filter_in[1] = DCFilterIn.Right;
+	header.dc_filter_out[0] = DCFilterOut.Left;
+	header.dc_filter_out[1] = DCFilterOut.Right;
+
+	s_filename = std::move(path);
+	s_buffer.reserve(FLUSH_THRESHOLD + Ps2MemSize::IopRam);
+	s_last_cycle = psxRegs.cycle;
+	s_event_count = 0;
+
+	Append(header);
+	AppendBytes(state.data(), state.size());
+	AppendBytes(iopPhysMem(0), Ps2MemSize::IopRam);
+	AppendBytes(iopHw, Ps2MemSize::IopHardware);
+	Flush();
+	if (!s_file)
+	{
+		Error::SetStringFmt(error, "Failed to write header to '{}'", s_filename);
+		return false;
+	}
+
+	Console.WriteLnFmt("SPU2Trace: Recording to '{}'.", s_filename);
+	return true;
+}
+
+void SPU2Trace::StopRecording()
+{
+	if (!s_file)
+		return;
+
+	Flush();
+	if (s_file)
+	{
+		std::fclose(s_file);
+		s_file = nullptr;
+		Console.WriteLnFmt("SPU2Trace: Wrote {} events to '{}'.", s_event_count, s_filename);
+	}
+
+	s_buffer = {};
+}
+
+bool SPU2Trace::IsRecording()
+{
+	return (s_file != nullptr);
+}
+
+const std::string& SPU2Trace::GetRecordingFilename()
+{
+	return s_filename;
+}
+
+void SPU2Trace::RecordRead(u32 mem)
+{
+	AppendEvent(EventType::Read);
+	Append(mem);
+}
+
+void SPU2Trace::RecordWrite(u32 mem, u16 value)
+{
+	AppendEvent(EventType::Write);
+	Append(mem);
+	Append(value);
+}
+
+void SPU2Trace::RecordDMARead(u32 core, const u16* mem, u32 size)
+{
+	AppendEvent(EventType::DMARead);
+	Append(static_cast<u8>(core));
+	Append(GetIOPOffset(mem));
+	Append(size);
+}
+
+void SPU2Trace::RecordDMAWrite(u32 core, const u16* mem, u32 size)
+{
+	// Transfers are consumed gradually from IOP memory, but nothing should touch the source
+	// until the transfer completes, so the payload at the start is what the SPU2 will see.
+	AppendEvent(EventType::DMAWrite);
+	Append(static_cast<u8>(core));
+	Append(GetIOPOffset(mem));
+	Append(size);
+	AppendBytes(mem, size * sizeof(u16));
+}
+
+void SPU2Trace::RecordAsync()
+{
+	AppendEvent(EventType::Async);
+}
+
+SPU2Trace::Player::Player() = default;
+
+SPU2Trace::Player::~Player() = default;
+
+bool SPU2Trace::Player::Open(const std::string& path, Error* error)
+{
+	std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(path.c_str());
+	if (!data.has_value())
+	{
+		Error::SetStringFmt(error, "Failed to read '{}'", path);
+		return false;
+	}
+
+	m_data = std::move(data.value());
+	m_header = reinterpret_cast<const Header*>(m_data.data());
+	if (m_data.size() < sizeof(Header) || m_header->magic != MAGIC)
+	{
+		Error::SetStringView(error, "File is not a SPU2 trace.");
+		return false;
+	}
+	if (m_header->version != VERSION)
+	{
+		Error::SetStringFmt(error, "Unsupported trace version {}.", m_header->version);
+		return false;
+	}
+	if (m_header->state_size != static_cast<u32>(SPU2Savestate::SizeIt()))
+	{
+		Error::SetStringView(error, "Trace was recorded with a different SPU2 state layout.");
+		return false;
+	}
+
+	const size_t state_start = sizeof(Header);
+	const size_t iop_ram_start = state_start + m_header->state_size;
+	const size_t iop_hw_start = iop_ram_start + Ps2MemSize::IopRam;
+	m_events_start = iop_hw_start + Ps2MemSize::IopHardware;
+	if (m_data.size() < m_events_start)
+	{
+		Error::SetStringView(error, "Trace is truncated.");
+		return false;
+	}
+
+	m_state.assign(m_data.begin() + state_start, m_data.begin() + iop_ram_start);
+	m_iop_ram = m_data.data() + iop_ram_start;
+	m_iop_hw = m_data.data() + iop_hw_start;
+
+	// Count the events, which also checks the trace is complete.
+	m_event_count = 0;
+	size_t pos = m_events_start;
+	while (pos < m_data.size())
+	{
+		const EventType type = static_cast<EventType>(m_data[pos]);
+		pos += sizeof(u8) + sizeof(u32);
+		switch (type)
+		{
+			case EventType::Read:
+				pos += sizeof(u32);
+				break;
+			case EventType::Write:
+				pos += sizeof(u32) + sizeof(u16);
+				break;
+			case EventType::DMARead:
+				pos += sizeof(u8) + sizeof(u32) + sizeof(u32);
+				break;
+			case EventType::DMAWrite:
+			{
+				u32 size = 0;
+				if ((pos + sizeof(u8) + sizeof(u32) * 2) <= m_data.size())
+					std::memcpy(&size, &m_data[pos + sizeof(u8) + sizeof(u32)], sizeof(size));
+				pos += sizeof(u8) + sizeof(u32) + sizeof(u32) + size * sizeof(u16);
+				break;
+			}
+			case EventType::Async:
+				break;
+			default:
+				Error::SetStringFmt(error, "Unknown event type {} at offset {}.", static_cast<u8>(type), pos);
+				return false;
+		}
+
+		if (pos > m_data.size())
+		{
+			Console.WarningFmt("SPU2Trace: Trace is truncated after {} events.", m_event_count);
+			break;
+		}
+
+		m_event_count++;
+	}
+
+	return true;
+}
+
+u32 SPU2Trace::Player::GetSampleRate() const
+{
+	return m_header->psx_mode ? SPU2::PSX_SAMPLE_RATE : SPU2::SAMPLE_RATE;
+}
+
+void SPU2Trace::Player::Reset()
+{
+	// IOP memory first, ThawIt() rebases the DMA pointers on it.
+	std::memcpy(iopPhysMem(0), m_iop_ram, Ps2MemSize::IopRam);
+	std::memcpy(iopHw, m_iop_hw, Ps2MemSize::IopHardware);
+	psxRegs.cycle = m_header->start_cycle;
+
+	// Init() sets up the per-ISA mixer functions, which the savestate doesn't touch.
+	Cores[0].Init(0);
+	Cores[1].Init(1);
+
+	// ThawIt() takes the block by reference, so restore from a copy.
+	std::vector<u8> state(m_state);
+	SPU2Savestate::ThawIt(*reinterpret_cast<SPU2Savestate::DataBlock*>(state.data()));
+
+	DCFilterIn = StereoOut32(m_header->dc_filter_in[0], m_header->dc_filter_in[1]);
+	DCFilterOut = StereoOut32(m_header->dc_filter_out[0], m_header->dc_filter_out[1]);
+}
+
+void SPU2Trace::Player::Run()
+{
+	const u8* ptr = m_data.data() + m_events_start;
+	const auto read = [&ptr](auto& value) {
+		std::memcpy(&value, ptr, sizeof(value));
+		ptr += sizeof(value);
+	};
+
+	for (size_t i = 0; i < m_event_count; i++)
+	{
+		u8 type;
+		u32 delta;
+		read(type);
+		read(delta);
+		psxRegs.cycle += delta;
+
+		switch (static_cast<EventType>(type))
+		{
+			case EventType::Read:
+			{
+				u32 mem;
+				read(mem);
+				SPU2read(mem);
+			}
+			break;
+
+			case EventType::Write:
+			{
+				u32 mem;
+				u16 value;
+				read(mem);
+				read(value);
+				SPU2write(mem, value);
+			}
+			break;
+
+			case EventType::DMARead:
+			{
+				u8 core;
+				u32 offset, size;
+				read(core);
+				read(offset);
+				read(size);
+
+				u16* mem = reinterpret_cast<u16*>(iopPhysMem(offset));
+				if (core == 0)
+					SPU2readDMA4Mem(mem, size);
+				else
+					SPU2readDMA7Mem(mem, size);
+			}
+			break;
+
+			case EventType::DMAWrite:
+			{
+				u8 core;
+				u32 offset, size;
+				read(core);
+				read(offset);
+				read(size);
+
+				u16* mem = reinterpret_cast<u16*>(iopPhysMem(offset));
+				std::memcpy(mem, ptr, size * sizeof(u16));
+				ptr += size * sizeof(u16);
+				if (core == 0)
+					SPU2writeDMA4Mem(mem, size);
+				else
+					SPU2writeDMA7Mem(mem, size);
+			}
+			break;
+
+			case EventType::Async:
+				SPU2async();
+				break;
+		}
+	}
+}
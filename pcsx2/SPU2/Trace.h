@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2002-2024 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#pragma once
+
+#include "common/Pcsx2Defs.h"
+
+#include <string>
+#include <vector>
+
+class Error;
+
+/// SPU2 register traces.
+///
+/// A trace is a snapshot of the SPU2 state (as a savestate block), IOP RAM and IOP hardware registers,
+/// followed by every call the IOP made into the SPU2: register reads and writes, DMA transfers (with their
+/// payloads) and async updates, each tagged with the number of IOP cycles since the previous call.
+/// Replaying the calls against the snapshot reproduces the audio output exactly, without the rest of the VM.
+/// DMA completion interrupts are raised by the SPU2 itself, so the replay regenerates them and they are not
+/// recorded.
+namespace SPU2Trace
+{
+	static constexpr u32 MAGIC = 0x54325053; // SP2T
+	static constexpr u32 VERSION = 1;
+
+	enum class EventType : u8
+	{
+		Read,
+		Write,
+		DMARead,
+		DMAWrite,
+		Async,
+	};
+
+	struct Header
+	{
+		u32 magic;
+		u32 version;
+		u32 state_size;
+		u32 start_cycle;
+		u32 psx_mode;
+		s32 dc_filter_in[2];
+		s32 dc_filter_out[2];
+		u32 reserved[7];
+	};
+	static_assert(sizeof(Header) == 64);
+
+	/// Starts recording a trace of the SPU2 from its current state. Must be called on the CPU thread.
+	bool StartRecording(std::string path, Error* error);
+	void StopRecording();
+	bool IsRecording();
+
+	/// Returns the filename of the trace currently being recorded.
+	const std::string& GetRecordingFilename();
+
+	void RecordRead(u32 mem);
+	void RecordWrite(u32 mem, u16 value);
+	void RecordDMARead(u32 core, const u16* mem, u32 size);
+	void RecordDMAWrite(u32 core, const u16* mem, u32 size);
+	void RecordAsync();
+
+	/// Replays a recorded trace. The SPU2 and IOP memory must already be allocated, and SPU2 output should be
+	/// redirected with SPU2::SetOutputCallback() before running.
+	class Player
+	{
+	public:
+		Player();
+		~Player();
+
+		bool Open(const std::string& path, Error* error);
+
+		u32 GetSampleRate() const;
+		size_t GetEventCount() const { return m_event_count; }
+
+		/// Restores the snapshot, so the trace can be run again from the start.
+		void Reset();
+
+		/// Runs every complete event in the trace.
+		void Run();
+
+	private:
+		std::vector<u8> m_data;
+		std::vector<u8> m_state;
+		const u8* m_iop_ram = nullptr;
+		const u8* m_iop_hw = nullptr;
+		const Header* m_header = nullptr;
+		size_t m_events_start = 0;
+		size_t m_event_count = 0;
+	};
+} // namespace SPU2Trace
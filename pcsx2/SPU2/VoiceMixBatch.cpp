@@ -0,0 +1,67 @@
+// SPDX-FileCopyrightText: 2002-2024 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#include "GS/GSVector.h"
+#include "SPU2/defs.h"
+
+MULTI_ISA_UNSHARED_START
+
+// Same math as GaussianInterpolate/ApplyVolume in Mixer.cpp, one voice per 32-bit lane.
+// Every product is computed at full 32 bits before the shift, so the result is bit-exact
+// with the scalar mixer.
+template <typename Vector>
+static __forceinline void MixVoiceBatchImpl(V_VoiceBatch& batch, VoiceMixSet& dest)
+{
+	static constexpr uint Lanes = sizeof(Vector) / sizeof(s32);
+	static_assert((V_Core::NumVoices % Lanes) == 0);
+
+	Vector dryl = Vector::zero();
+	Vector dryr = Vector::zero();
+	Vector wetl = Vector::zero();
+	Vector wetr = Vector::zero();
+
+	for (uint i = 0; i < V_Core::NumVoices; i += Lanes)
+	{
+		Vector value = Vector::template load<true>(&batch.Coef[0][i]).mul32l(Vector::template load<true>(&batch.Sample[0][i])).template sra32<15>();
+		value = value.add32(Vector::template load<true>(&batch.Coef[1][i]).mul32l(Vector::template load<true>(&batch.Sample[1][i])).template sra32<15>());
+		value = value.add32(Vector::template load<true>(&batch.Coef[2][i]).mul32l(Vector::template load<true>(&batch.Sample[2][i])).template sra32<15>());
+		value = value.add32(Vector::template load<true>(&batch.Coef[3][i]).mul32l(Vector::template load<true>(&batch.Sample[3][i])).template sra32<15>());
+
+		// Envelope
+		value = value.mul32l(Vector::template load<true>(&batch.Env[i])).template sra32<15>();
+		Vector::template store<true>(&batch.Out[i], value);
+
+		const Vector left = value.mul32l(Vector::template load<true>(&batch.VolL[i])).template sra32<15>();
+		const Vector right = value.mul32l(Vector::template load<true>(&batch.VolR[i])).template sra32<15>();
+
+		dryl = dryl.add32(left & Vector::template load<true>(&batch.DryL[i]));
+		dryr = dryr.add32(right & Vector::template load<true>(&batch.DryR[i]));
+		wetl = wetl.add32(left & Vector::template load<true>(&batch.WetL[i]));
+		wetr = wetr.add32(right & Vector::template load<true>(&batch.WetR[i]));
+	}
+
+	alignas(32) s32 sums[4][Lanes];
+	Vector::template store<true>(sums[0], dryl);
+	Vector::template store<true>(sums[1], dryr);
+	Vector::template store<true>(sums[2], wetl);
+	Vector::template store<true>(sums[3], wetr);
+
+	for (uint i = 0; i < Lanes; i++)
+	{
+		dest.Dry.Left += sums[0][i];
+		dest.Dry.Right += sums[1][i];
+		dest.Wet.Left += sums[2][i];
+		dest.Wet.Right += sums[3][i];
+	}
+}
+
+void MixVoiceBatch(V_VoiceBatch& batch, VoiceMixSet& dest)
+{
+#if _M_SSE >= 0x501
+	MixVoiceBatchImpl<GSVector8i>(batch, dest);
+#else
+	MixVoiceBatchImpl<GSVector4i>(batch, dest);
+#endif
+}
+
+MULTI_ISA_UNSHARED_END
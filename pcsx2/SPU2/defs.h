@@ -575,13 +575,38 @@ struct V_Core
 	void FinishDMAwrite();
 };
 
+// Struct-of-arrays copy of the voice state used to mix a core's voices for one tick.
+// The sample fetch, ADSR and volume slides are stepped one voice at a time, then the
+// interpolation, envelope, volume and gating of every voice are done by MixVoiceBatch.
+struct alignas(32) V_VoiceBatch
+{
+	// Gaussian interpolation coefficients and the samples they apply to, oldest first.
+	// Noise voices use {0, 0, 0, 0x8000} to pass the noise value through unchanged.
+	s32 Coef[4][V_Core::NumVoices];
+	s32 Sample[4][V_Core::NumVoices];
+
+	s32 Env[V_Core::NumVoices];
+	s32 VolL[V_Core::NumVoices];
+	s32 VolR[V_Core::NumVoices];
+
+	s32 DryL[V_Core::NumVoices];
+	s32 DryR[V_Core::NumVoices];
+	s32 WetL[V_Core::NumVoices];
+	s32 WetR[V_Core::NumVoices];
+
+	// Voice output after the envelope (OutX)
+	s32 Out[V_Core::NumVoices];
+};
+
 MULTI_ISA_DEF(
 	StereoOut32 ReverbUpsample(V_Core& core);
 	s32 ReverbDownsample(V_Core& core, bool right);
+	void MixVoiceBatch(V_VoiceBatch& batch, VoiceMixSet& dest);
 )
 
 extern StereoOut32 (*ReverbUpsample)(V_Core& core);
 extern s32 (*ReverbDownsample)(V_Core& core, bool right);
+extern void (*MixVoiceBatch)(V_VoiceBatch& batch, VoiceMixSet& dest);
 
 extern V_Core Cores[2];
 extern V_SPDIF Spdif;
@@ -603,6 +628,9 @@ extern void SetIrqCall(int core);
 extern void SetIrqCallDMA(int core);
 extern void StartVoices(int core, u32 value);
 extern void StopVoices(int core, u32 value);
+extern void StartQueuedVoices();
+extern void MixCoreVoices(VoiceMixSet& dest, uint coreidx);
+extern void MixCoreVoicesScalar(VoiceMixSet& dest, uint coreidx);
 extern void CalculateADSR(V_Voice& vc);
 extern void UpdateSpdifMode();
 
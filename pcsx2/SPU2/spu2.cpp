@@ -5,6 +5,7 @@
 #include "SPU2/defs.h"
 #include "SPU2/Debug.h"
 #include "SPU2/Dma.h"
+#include "SPU2/Trace.h"
 #include "Host/AudioStream.h"
 #include "Host.h"
 #include "GS/GSCapture.h"
@@ -30,8 +31,12 @@ static bool s_audio_capture_active = false;
 static bool s_psxmode = false;
 
 static std::unique_ptr<AudioStream> s_output_stream;
-static std::array<s16, AudioStream::CHUNK_SIZE * 2> s_current_chunk;
+static AudioStreamWriteThread::Chunk s_current_chunk;
 static u32 s_current_chunk_pos;
+static std::function<void(const s16*, u32)> s_output_callback;
+
+// When running, completed chunks are queued for it instead of being written to the stream directly.
+static AudioStreamWriteThread s_stream_write_thread;
 
 u32 SPU2::GetConsoleSampleRate()
 {
@@ -45,6 +50,9 @@ u32 SPU2::GetConsoleSampleRate()
 
 void SPU2readDMA4Mem(u16* pMem, u32 size) // size now in 16bit units
 {
+	if (SPU2Trace::IsRecording()) [[unlikely]]
+		SPU2Trace::RecordDMARead(0, pMem, size);
+
 	TimeUpdate(psxRegs.cycle);
 
 	SPU2::FileLog("[%10d] SPU2 readDMA4Mem size %x\n", Cycles, size << 1);
@@ -53,6 +61,9 @@ void SPU2readDMA4Mem(u16* pMem, u32 size) // size now in 16bit units
 
 void SPU2writeDMA4Mem(u16* pMem, u32 size) // size now in 16bit units
 {
+	if (SPU2Trace::IsRecording()) [[unlikely]]
+		SPU2Trace::RecordDMAWrite(0, pMem, size);
+
 	TimeUpdate(psxRegs.cycle);
 
 	SPU2::FileLog("[%10d] SPU2 writeDMA4Mem size %x at address %x\n", Cycles, size << 1, Cores[0].TSA);
@@ -80,6 +91,9 @@ void SPU2interruptDMA7()
 
 void SPU2readDMA7Mem(u16* pMem, u32 size)
 {
+	if (SPU2Trace::IsRecording()) [[unlikely]]
+		SPU2Trace::RecordDMARead(1, pMem, size);
+
 	TimeUpdate(psxRegs.cycle);
 
 	SPU2::FileLog("[%10d] SPU2 readDMA7Mem size %x\n", Cycles, size << 1);
@@ -88,6 +102,9 @@ void SPU2readDMA7Mem(u16* pMem, u32 size)
 
 void SPU2writeDMA7Mem(u16* pMem, u32 size)
 {
+	if (SPU2Trace::IsRecording()) [[unlikely]]
+		SPU2Trace::RecordDMAWrite(1, pMem, size);
+
 	TimeUpdate(psxRegs.cycle);
 
 	SPU2::FileLog("[%10d] SPU2 writeDMA7Mem size %x at address %x\n", Cycles, size << 1, Cores[1].TSA);
@@ -97,6 +114,9 @@ void SPU2writeDMA7Mem(u16* pMem, u32 size)
 
 void SPU2::CreateOutputStream()
 {
+	// Anything which touches the stream's write side has to wait for queued chunks first.
+	s_stream_write_thread.Sync();
+
 	// Persist volume through stream recreates.
 	const u32 volume = s_output_stream ? s_output_stream->GetOutputVolume() : GetResetVolume();
 	const u32 sample_rate = GetConsoleSampleRate();
@@ -117,6 +137,7 @@ void SPU2::CreateOutputStream()
 	s_output_stream->SetOutputVolume(volume);
 	s_output_stream->SetNominalRate(GetNominalRate());
 	s_output_stream->SetPaused(VMManager::GetState() == VMState::Paused);
+	s_stream_write_thread.SetStream(s_output_stream.get());
 }
 
 void SPU2::UpdateSampleRate()
@@ -173,6 +194,13 @@ bool SPU2::IsAudioCaptureActive()
 	return s_audio_capture_active;
 }
 
+void SPU2::SetOutputCallback(std::function<void(const s16*, u32)> callback)
+{
+	s_stream_write_thread.Sync();
+	s_output_callback = std::move(callback);
+	s_current_chunk_pos = 0;
+}
+
 void SPU2::InternalReset(bool psxmode)
 {
 	s_current_chunk_pos = 0;
@@ -193,6 +221,7 @@ void SPU2::InternalReset(bool psxmode)
 
 void SPU2::Reset(bool psxmode)
 {
+	SPU2Trace::StopRecording();
 	InternalReset(psxmode);
 	UpdateSampleRate();
 }
@@ -202,6 +231,8 @@ void SPU2::OnTargetSpeedChanged()
 	if (!s_output_stream)
 		return;
 
+	s_stream_write_thread.Sync();
+
 	if (!s_output_stream->IsStretchEnabled())
 	{
 		s_output_stream->EmptyBuffer();
@@ -232,6 +263,8 @@ bool SPU2::Open()
 	InternalReset(false);
 
 	CreateOutputStream();
+	if (EmuConfig.SPU2.StreamWriteThread)
+		s_stream_write_thread.Start(s_output_stream.get());
 #ifdef PCSX2_DEVBUILD
 	WaveDump::Open();
 #endif
@@ -243,6 +276,8 @@ void SPU2::Close()
 {
 	FileLog("[%10d] SPU2 Close\n", Cycles);
 
+	SPU2Trace::StopRecording();
+	s_stream_write_thread.Stop();
 	s_output_stream.reset();
 
 #ifdef PCSX2_DEVBUILD
@@ -282,9 +317,18 @@ void SPU2::CheckForConfigChanges(const Pcsx2Config& old_config)
 	}
 	else if (opts.IsTimeStretchEnabled() != oldopts.IsTimeStretchEnabled())
 	{
+		s_stream_write_thread.Sync();
 		s_output_stream->SetStretchEnabled(opts.IsTimeStretchEnabled());
 	}
 
+	if (opts.StreamWriteThread != oldopts.StreamWriteThread)
+	{
+		if (opts.StreamWriteThread)
+			s_stream_write_thread.Start(s_output_stream.get());
+		else
+			s_stream_write_thread.Stop();
+	}
+
 #ifdef PCSX2_DEVBUILD
 	// AccessLog controls file output.
 	if (opts.AccessLog != oldopts.AccessLog)
@@ -299,11 +343,17 @@ void SPU2::CheckForConfigChanges(const Pcsx2Config& old_config)
 
 void SPU2async()
 {
+	if (SPU2Trace::IsRecording()) [[unlikely]]
+		SPU2Trace::RecordAsync();
+
 	TimeUpdate(psxRegs.cycle);
 }
 
 u16 SPU2read(u32 rmem)
 {
+	if (SPU2Trace::IsRecording()) [[unlikely]]
+		SPU2Trace::RecordRead(rmem);
+
 	u16 ret = 0xDEAD;
 	u32 core = 0;
 	const u32 mem = rmem & 0xFFFF;
@@ -360,6 +410,9 @@ void SPU2write(u32 rmem, u16 value)
 	// If the SPU2 isn't in in sync with the IOP, samples can end up playing at rather
 	// incorrect pitches and loop lengths.
 
+	if (SPU2Trace::IsRecording()) [[unlikely]]
+		SPU2Trace::RecordWrite(rmem, value);
+
 	TimeUpdate(psxRegs.cycle);
 
 	if (rmem >> 16 == 0x1f80)
@@ -401,6 +454,7 @@ s32 SPU2freeze(FreezeAction mode, freezeData* data)
 	switch (mode)
 	{
 		case FreezeAction::Load:
+			SPU2Trace::StopRecording();
 			return SPU2Savestate::ThawIt(spud);
 		case FreezeAction::Save:
 			return SPU2Savestate::FreezeIt(spud);
@@ -421,7 +475,16 @@ __forceinline void spu2Output(StereoOut32 out)
 	{
 		s_current_chunk_pos = 0;
 
-		s_output_stream->WriteChunk(s_current_chunk.data());
+		if (s_output_callback) [[unlikely]]
+		{
+			s_output_callback(s_current_chunk.data(), AudioStream::CHUNK_SIZE);
+			return;
+		}
+
+		if (s_stream_write_thread.IsRunning())
+			s_stream_write_thread.Write(s_current_chunk);
+		else
+			s_output_stream->WriteChunk(s_current_chunk.data());
 
 		if (SPU2::IsAudioCaptureActive()) [[unlikely]]
 			GSCapture::DeliverAudioPacket(s_current_chunk.data());
@@ -6,6 +6,7 @@
 #include "SaveState.h"
 #include "IopCounters.h"
 
+#include <functional>
 #include <memory>
 
 struct Pcsx2Config;
@@ -54,6 +55,10 @@ u32 GetConsoleSampleRate();
 /// Tells SPU2 to forward audio packets to GSCapture.
 void SetAudioCaptureActive(bool active);
 bool IsAudioCaptureActive();
+
+/// Sends output chunks (interleaved stereo frames) to the callback instead of the output stream.
+/// Used for replaying traces without a host audio device, pass nullptr to go back to the stream.
+void SetOutputCallback(std::function<void(const s16* frames, u32 count)> callback);
 } // namespace SPU2
 
 void SPU2write(u32 mem, u16 value);
@@ -37,6 +37,7 @@ static bool has_to_call_irq[2] = { false, false };
 static bool has_to_call_irq_dma[2] = { false, false };
 StereoOut32 (*ReverbUpsample)(V_Core& core);
 s32 (*ReverbDownsample)(V_Core& core, bool right);
+void (*MixVoiceBatch)(V_VoiceBatch& batch, VoiceMixSet& dest);
 
 
 static bool psxmode = false;
@@ -105,6 +106,7 @@ void V_Core::Init(int index)
 
 	ReverbDownsample = MULTI_ISA_SELECT(ReverbDownsample);
 	ReverbUpsample = MULTI_ISA_SELECT(ReverbUpsample);
+	MixVoiceBatch = MULTI_ISA_SELECT(MixVoiceBatch);
 
 	//memset(this, 0, sizeof(V_Core));
 	// Explicitly initializing variables instead.
@@ -254,6 +256,16 @@ __forceinline static bool StartQueuedVoice(uint coreidx, uint voiceidx)
 	return true;
 }
 
+// Start Queued Voices, they start after 2T (Tested on real HW)
+void StartQueuedVoices()
+{
+	for (int c = 0; c < 2; c++)
+		for (int v = 0; v < 24; v++)
+			if (Cores[c].KeyOn & (1 << v))
+				if (StartQueuedVoice(c, v))
+					Cores[c].KeyOn &= ~(1 << v);
+}
+
 __forceinline void TimeUpdate(u32 cClocks)
 {
 	u32 dClocks = cClocks - lClocks;
@@ -298,13 +310,7 @@ __forceinline void TimeUpdate(u32 cClocks)
 		lClocks += TickInterval;
 		Cycles++;
 
-		// Start Queued Voices, they start after 2T (Tested on real HW)
-		for(int c = 0; c < 2; c++)
-			for (int v = 0; v < 24; v++)
-				if(Cores[c].KeyOn & (1 << v))
-					if(StartQueuedVoice(c, v))
-						Cores[c].KeyOn &= ~(1 << v);
-
+		StartQueuedVoices();
 		spu2Mix();
 	}
 
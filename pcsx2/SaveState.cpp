@@ -184,6 +184,8 @@ bool SaveStateBase::FreezeInternals(Error* error)
 	Freeze(fpuRegs);
 	Freeze(tlb);			// tlbs
 	Freeze(cachedTlbs);		// cached tlbs
+	if (IsLoading())
+		vtlb_UpdateCachedPages();
 	Freeze(AllowParams1);	//OSDConfig written (Fast Boot)
 	Freeze(AllowParams2);
 
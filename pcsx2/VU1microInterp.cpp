@@ -237,6 +237,11 @@ InterpVU1::InterpVU1()
 void InterpVU1::Reset()
 {
 	DevCon.Warning("VU1 Int Reset");
+	ResetPipelines();
+}
+
+void InterpVU1::ResetPipelines()
+{
 	VU1.fmacwritepos = 0;
 	VU1.fmacreadpos = 0;
 	VU1.fmaccount = 0;
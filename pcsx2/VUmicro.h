@@ -109,6 +109,8 @@ public:
 
 	void Shutdown() override {}
 	void Reset() override;
+	// Empties the FMAC/IALU pipelines, for starting a program handed over from the recompiler
+	void ResetPipelines();
 
 	void SetStartPC(u32 startPC) override;
 	void Step() override;
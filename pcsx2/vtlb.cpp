@@ -183,6 +183,40 @@ __inline int CheckCache(u32 addr)
 
 	return false;
 }
+
+// Rebuilds vtlbdata.cached, the per page result of CheckCache() for recompiled code.
+// Needs calling whenever the cache enable bit in CP0 Config changes, or cachedTlbs is replaced wholesale.
+void vtlb_UpdateCachedPages()
+{
+	std::memset(vtlbdata.cached, 0, sizeof(vtlbdata.cached));
+	if (((cpuRegs.CP0.n.Config >> 16) & 0x1) == 0)
+		return;
+
+	// TLB pages are at least 4KB and aligned to their size, so each range covers whole vtlb pages.
+	const auto mark = [](u32 start, u32 mask) {
+		const u64 end = static_cast<u64>(start) + mask;
+		for (u64 page = start >> VTLB_PAGE_BITS; page <= (end >> VTLB_PAGE_BITS); page++)
+			vtlbdata.cached[page] = 1;
+	};
+
+	for (size_t i = 0; i < cachedTlbs.count; i++)
+	{
+		if (cachedTlbs.CacheEnabled0[i])
+			mark(cachedTlbs.PFN0s[i], cachedTlbs.PageMasks[i]);
+		if (cachedTlbs.CacheEnabled1[i])
+			mark(cachedTlbs.PFN1s[i], cachedTlbs.PageMasks[i]);
+	}
+}
+
+// Refreshes vtlbdata.cached for the pages of one mapping, after it was added to or removed from cachedTlbs.
+// Other entries can overlap the same pages, so each page is looked up again rather than set or cleared.
+void vtlb_UpdateCachedPages(u32 pfn, u32 mask)
+{
+	const u64 end = static_cast<u64>(pfn) + mask;
+	for (u64 page = pfn >> VTLB_PAGE_BITS; page <= (end >> VTLB_PAGE_BITS); page++)
+		vtlbdata.cached[page] = CheckCache(static_cast<u32>(page << VTLB_PAGE_BITS)) ? 1 : 0;
+}
+
 // --------------------------------------------------------------------------------------
 // Interpreter Implementations of VTLB Memory Operations.
 // --------------------------------------------------------------------------------------
@@ -196,27 +230,24 @@ DataType vtlb_memRead(u32 addr)
 
 	if (!vmv.isHandler(addr))
 	{
-		if (!CHECK_EEREC)
+		if (CHECK_CACHE && CheckCache(addr))
 		{
-			if (CHECK_CACHE && CheckCache(addr))
+			switch (DataSize)
 			{
-				switch (DataSize)
-				{
-					case 8:
-						return readCache8(addr);
-						break;
-					case 16:
-						return readCache16(addr);
-						break;
-					case 32:
-						return readCache32(addr);
-						break;
-					case 64:
-						return readCache64(addr);
-						break;
-
-						jNO_DEFAULT;
-				}
+				case 8:
+					return readCache8(addr);
+					break;
+				case 16:
+					return readCache16(addr);
+					break;
+				case 32:
+					return readCache32(addr);
+					break;
+				case 64:
+					return readCache64(addr);
+					break;
+
+					jNO_DEFAULT;
 			}
 		}
 
@@ -251,12 +282,9 @@ RETURNS_R128 vtlb_memRead128(u32 mem)
 
 	if (!vmv.isHandler(mem))
 	{
-		if (!CHECK_EEREC)
+		if (CHECK_CACHE && CheckCache(mem))
 		{
-			if (CHECK_CACHE && CheckCache(mem))
-			{
-				return readCache128(mem);
-			}
+			return readCache128(mem);
 		}
 
 		return r128_load(reinterpret_cast<const void*>(vmv.assumePtr(mem)));
@@ -279,25 +307,22 @@ void vtlb_memWrite(u32 addr, DataType data)
 
 	if (!vmv.isHandler(addr))
 	{
-		if (!CHECK_EEREC)
+		if (CHECK_CACHE && CheckCache(addr))
 		{
-			if (CHECK_CACHE && CheckCache(addr))
+			switch (DataSize)
 			{
-				switch (DataSize)
-				{
-					case 8:
-						writeCache8(addr, data);
-						return;
-					case 16:
-						writeCache16(addr, data);
-						return;
-					case 32:
-						writeCache32(addr, data);
-						return;
-					case 64:
-						writeCache64(addr, data);
-						return;
-				}
+				case 8:
+					writeCache8(addr, data);
+					return;
+				case 16:
+					writeCache16(addr, data);
+					return;
+				case 32:
+					writeCache32(addr, data);
+					return;
+				case 64:
+					writeCache64(addr, data);
+					return;
 			}
 		}
 
@@ -318,14 +343,11 @@ void TAKES_R128 vtlb_memWrite128(u32 mem, r128 value)
 
 	if (!vmv.isHandler(mem))
 	{
-		if (!CHECK_EEREC)
+		if (CHECK_CACHE && CheckCache(mem))
 		{
-			if (CHECK_CACHE && CheckCache(mem))
-			{
-				alignas(16) const u128 r = r128_to_u128(value);
-				writeCache128(mem, &r);
-				return;
-			}
+			alignas(16) const u128 r = r128_to_u128(value);
+			writeCache128(mem, &r);
+			return;
 		}
 
 		r128_store_unaligned((void*)vmv.assumePtr(mem), value);
@@ -601,7 +623,7 @@ static void TAKES_R128 vtlbUnmappedVWriteLg(u32 addr, r128 data) { vtlb_Miss(add
 template <typename OperandType>
 static OperandType vtlbUnmappedPReadSm(u32 addr) {
 	vtlb_BusError(addr, 0);
-	if(!CHECK_EEREC && CHECK_CACHE && CheckCache(addr)){
+	if(CHECK_CACHE && CheckCache(addr)){
 		switch (sizeof(OperandType)) {
 			case 1: return readCache8(addr, false);
 			case 2: return readCache16(addr, false);
@@ -612,12 +634,12 @@ static OperandType vtlbUnmappedPReadSm(u32 addr) {
 	}
 	return 0;
 }
-static RETURNS_R128 vtlbUnmappedPReadLg(u32 addr) { vtlb_BusError(addr, 0); if(!CHECK_EEREC && CHECK_CACHE && CheckCache(addr)){ return readCache128(addr, false); } return r128_zero(); }
+static RETURNS_R128 vtlbUnmappedPReadLg(u32 addr) { vtlb_BusError(addr, 0); if(CHECK_CACHE && CheckCache(addr)){ return readCache128(addr, false); } return r128_zero(); }
 
 template <typename OperandType>
 static void vtlbUnmappedPWriteSm(u32 addr, OperandType data) {
 	vtlb_BusError(addr, 1);
-	if (!CHECK_EEREC && CHECK_CACHE && CheckCache(addr)) {
+	if (CHECK_CACHE && CheckCache(addr)) {
 		switch (sizeof(OperandType)) {
 			case 1: writeCache8(addr, data, false); break;
 			case 2: writeCache16(addr, data, false); break;
@@ -627,7 +649,7 @@ static void vtlbUnmappedPWriteSm(u32 addr, OperandType data) {
 		}
 	}
 }
-static void TAKES_R128 vtlbUnmappedPWriteLg(u32 addr, r128 data) { vtlb_BusError(addr, 1); if(!CHECK_EEREC && CHECK_CACHE && CheckCache(addr)) { writeCache128(addr, reinterpret_cast<mem128_t*>(&data) /*Safe??*/, false); }}
+static void TAKES_R128 vtlbUnmappedPWriteLg(u32 addr, r128 data) { vtlb_BusError(addr, 1); if(CHECK_CACHE && CheckCache(addr)) { writeCache128(addr, reinterpret_cast<mem128_t*>(&data) /*Safe??*/, false); }}
 // clang-format on
 
 // --------------------------------------------------------------------------------------
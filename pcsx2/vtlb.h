@@ -46,6 +46,8 @@ extern void vtlb_Init();
 extern void vtlb_Shutdown();
 extern void vtlb_Reset();
 extern void vtlb_ResetFastmem();
+extern void vtlb_UpdateCachedPages();
+extern void vtlb_UpdateCachedPages(u32 pfn, u32 mask);
 
 extern vtlbHandler vtlb_NewHandler();
 
@@ -195,6 +197,8 @@ namespace vtlb_private
 
 		u32* ppmap;               //4MB (allocated by vtlb_init) // PS2 virtual to PS2 physical
 
+		u8 cached[VTLB_VMAP_ITEMS]; //1MB // Non-zero for virtual pages that go through the EE data cache
+
 		uptr fastmem_base;
 
 		MapData()
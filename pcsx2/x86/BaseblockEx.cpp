@@ -57,6 +57,41 @@ BASEBLOCKEX* BaseBlocks::GetByX86(uptr ip)
 }
 #endif
 
+void BaseBlockReuseCache::Insert(const BASEBLOCKEX& block, const u32* code, bool manual_protection)
+{
+	Entry entry;
+	entry.fnptr = block.fnptr;
+	entry.size = block.size;
+	entry.x86size = block.x86size;
+	entry.manual_protection = manual_protection;
+	entry.code = std::make_unique<u32[]>(block.size);
+	std::memcpy(entry.code.get(), code, block.size * sizeof(u32));
+	entries[block.startpc].push_back(std::move(entry));
+}
+
+const BaseBlockReuseCache::Entry* BaseBlockReuseCache::Find(u32 startpc, const u32* code) const
+{
+	const auto it = entries.find(startpc);
+	if (it == entries.end())
+		return nullptr;
+
+	// Newest translations first, they're the most likely to match what's loaded now.
+	for (auto entry = it->second.rbegin(); entry != it->second.rend(); ++entry)
+	{
+		if (std::memcmp(entry->code.get(), code, entry->size * sizeof(u32)) == 0)
+			return &*entry;
+	}
+
+	return nullptr;
+}
+
+void BaseBlockReuseCache::Reset()
+{
+	entries.clear();
+	hits = 0;
+	misses = 0;
+}
+
 void BaseBlocks::Link(u32 pc, s32* jumpptr)
 {
 	BASEBLOCKEX* targetblock = Get(pc);
@@ -65,4 +100,27 @@ void BaseBlocks::Link(u32 pc, s32* jumpptr)
 	else
 		*jumpptr = (s32)(recompiler - (sptr)(jumpptr + 1));
 	links.insert(std::pair<u32, uptr>(pc, (uptr)jumpptr));
+	link_sources[(uptr)jumpptr] = pc;
+}
+
+void BaseBlocks::UnlinkOutgoing(const BASEBLOCKEX& block)
+{
+	const auto first = link_sources.lower_bound(block.fnptr);
+	const auto last = link_sources.lower_bound(block.fnptr + block.x86size);
+	for (auto it = first; it != last; ++it)
+	{
+		*(s32*)it->first = (s32)(dispatcher - (it->first + 4));
+
+		std::pair<linkiter_t, linkiter_t> range = links.equal_range(it->second);
+		for (linkiter_t i = range.first; i != range.second; ++i)
+		{
+			if (i->second == it->first)
+			{
+				links.erase(i);
+				break;
+			}
+		}
+	}
+
+	link_sources.erase(first, last);
 }
@@ -5,6 +5,9 @@
 
 #include <cstring>
 #include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include "common/Assertions.h"
 
@@ -145,13 +148,20 @@ protected:
 
 	// switch to a hash map later?
 	std::multimap<u32, uptr> links;
+	std::map<uptr, u32> link_sources; // jump -> target pc, ordered by host address
 	uptr recompiler;
+	uptr dispatcher;
 	BaseBlockArray blocks;
+	bool retain_code;
+
+	void UnlinkOutgoing(const BASEBLOCKEX& block);
 
 public:
 	BaseBlocks()
 		: recompiler(0)
+		, dispatcher(0)
 		, blocks(0x4000)
+		, retain_code(false)
 	{
 	}
 
@@ -160,6 +170,19 @@ public:
 		recompiler = reinterpret_cast<uptr>(recompiler_);
 	}
 
+	// When set, the links out of a removed block are pointed at this dispatcher (which looks the
+	// target up from the guest pc) and forgotten, instead of piling up until the next reset.
+	void SetDispatcher(const void *dispatcher_)
+	{
+		dispatcher = reinterpret_cast<uptr>(dispatcher_);
+	}
+
+	// When set, removed blocks keep their host code intact so it can be mapped back in later.
+	void SetRetainRemovedCode(bool retain)
+	{
+		retain_code = retain;
+	}
+
 	BASEBLOCKEX* New(u32 startpc, uptr fnptr);
 	int LastIndex(u32 startpc) const;
 	//BASEBLOCKEX* GetByX86(uptr ip);
@@ -201,7 +224,7 @@ public:
 			for (linkiter_t i = range.first; i != range.second; ++i)
 				*(u32*)i->second = recompiler - (i->second + 4);
 
-			if (IsDevBuild)
+			if (IsDevBuild && !retain_code)
 			{
 				// Clear the first instruction to 0xcc (breakpoint), as a way to assert if some
 				// static jumps get left behind to this block.  Note: Do not clear more than the
@@ -213,7 +236,13 @@ public:
 			}
 		} while (idx++ < last);
 
-		// TODO: remove links from this block?
+		// Retained code can be mapped back in, so its links have to stay patchable.
+		if (dispatcher && !retain_code)
+		{
+			for (idx = first; idx <= last; idx++)
+				UnlinkOutgoing(blocks[idx]);
+		}
+
 		blocks.erase(first, last + 1);
 	}
 
@@ -223,9 +252,44 @@ public:
 	{
 		blocks.clear();
 		links.clear();
+		link_sources.clear();
 	}
 };
 
+// Remembers every block translated since the last recompiler reset, along with a copy of the
+// guest code it was translated from. Removing a block only unlinks it, so its host code stays
+// valid in the code buffer until the next reset; if identical guest code later shows up at the
+// same address again (e.g. an overlay being reloaded), the old translation can be mapped back in
+// instead of recompiling it.
+//
+// Entries are deliberately not saved to disk. A translation is only valid in the process that
+// emitted it: it calls interpreter fallbacks and vtlb handlers with rel32 calls into the
+// executable, addresses cpuRegs and recLUT relative to wherever the executable got loaded, and
+// jumps to the dispatchers and to linked blocks elsewhere in the code buffer. ASLR moves all of
+// those between runs, and the emitter keeps no relocation records that a loader could patch.
+class BaseBlockReuseCache
+{
+public:
+	struct Entry
+	{
+		uptr fnptr;
+		u32 size;    // in dwords, as BASEBLOCKEX
+		u32 x86size;
+		bool manual_protection; // block verifies its own code instead of relying on page protection
+		std::unique_ptr<u32[]> code;
+	};
+
+	void Insert(const BASEBLOCKEX& block, const u32* code, bool manual_protection);
+	const Entry* Find(u32 startpc, const u32* code) const;
+	void Reset();
+
+	u32 hits = 0;
+	u32 misses = 0;
+
+private:
+	std::unordered_map<u32, std::vector<Entry>> entries;
+};
+
 #define PC_GETBLOCK_(x, reclut) ((BASEBLOCK*)(reclut[((u32)(x)) >> 16] + (x) * (sizeof(BASEBLOCK) / 4)))
 
 /**
@@ -0,0 +1,289 @@
+// SPDX-FileCopyrightText: 2002-2024 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#include "Common.h"
+#include "Config.h"
+#include "DebugTools/SymbolGuardian.h"
+#include "VMManager.h"
+#include "x86/R5900_BlockProfiler.h"
+
+#include "common/Console.h"
+#include "common/FileSystem.h"
+#include "common/Path.h"
+#include "common/emitter/x86emitter.h"
+
+#include "fmt/format.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <ctime>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include <zlib.h>
+
+namespace EE::BlockProfiler
+{
+	struct Counters
+	{
+		u64 visits; // First, the entry counter addresses it without an offset
+		u64 ticks;
+	};
+
+	// Node based, so recompiled code can hold pointers to the counters.
+	static std::unordered_map<u32, Counters> s_counters;
+
+	// Time outside of recompiled code (and before the first block) lands here and is dropped.
+	static Counters s_unattributed;
+	static Counters* s_last = &s_unattributed;
+	static u64 s_last_tsc = 0;
+
+	// Just enough of a protobuf encoder to write profile.proto messages.
+	class ProtoWriter
+	{
+	public:
+		void Varint(u64 value)
+		{
+			while (value >= 0x80)
+			{
+				m_data.push_back(static_cast<u8>(value) | 0x80);
+				value >>= 7;
+			}
+			m_data.push_back(static_cast<u8>(value));
+		}
+
+		void UInt(u32 field, u64 value)
+		{
+			Varint(field << 3);
+			Varint(value);
+		}
+
+		void Bytes(u32 field, const void* data, size_t size)
+		{
+			Varint((field << 3) | 2);
+			Varint(size);
+			m_data.insert(m_data.end(), static_cast<const u8*>(data), static_cast<const u8*>(data) + size);
+		}
+
+		void Message(u32 field, const ProtoWriter& msg) { Bytes(field, msg.m_data.data(), msg.m_data.size()); }
+
+		const std::vector<u8>& GetData() const { return m_data; }
+
+	private:
+		std::vector<u8> m_data;
+	};
+
+	struct BlockSample
+	{
+		u32 pc;
+		u64 visits;
+		u64 ticks;
+		std::string function;
+	};
+
+	static std::vector<BlockSample> GetSamples();
+	static bool WritePprof(const std::string& path, const std::vector<BlockSample>& samples);
+	static bool WriteCollapsed(const std::string& path, const std::vector<BlockSample>& samples);
+} // namespace EE::BlockProfiler
+
+void EE::BlockProfiler::EmitBlockEntry(u32 pc)
+{
+	using namespace x86Emitter;
+
+	Counters* counters = &s_counters.try_emplace(pc, Counters{}).first->second;
+
+	// Charge the ticks since the previous block entry to that block.
+	xRDTSC();
+	xSHL(rdx, 32);
+	xOR(rax, rdx);
+	xMOV(rcx, rax);
+	xSUB(rax, ptr64[&s_last_tsc]);
+	xMOV(ptr64[&s_last_tsc], rcx);
+	xMOV(rcx, ptr64[&s_last]);
+	xADD(ptr64[rcx + offsetof(Counters, ticks)], rax);
+
+	xLoadFarAddr(rcx, counters);
+	xMOV(ptr64[&s_last], rcx);
+	xADD(ptr64[rcx], 1);
+}
+
+void EE::BlockProfiler::Pause()
+{
+	s_last = &s_unattributed;
+}
+
+bool EE::BlockProfiler::HasSamples()
+{
+	return std::any_of(s_counters.begin(), s_counters.end(), [](const auto& it) { return it.second.visits != 0; });
+}
+
+u64 EE::BlockProfiler::GetVisits(u32 pc)
+{
+	const auto it = s_counters.find(pc);
+	return (it != s_counters.end()) ? it->second.visits : 0;
+}
+
+void EE::BlockProfiler::Clear()
+{
+	s_counters.clear();
+	s_unattributed = {};
+	s_last = &s_unattributed;
+	s_last_tsc = 0;
+}
+
+std::vector<EE::BlockProfiler::BlockSample> EE::BlockProfiler::GetSamples()
+{
+	std::vector<BlockSample> samples;
+	for (const auto& [pc, counters] : s_counters)
+	{
+		if (counters.visits != 0)
+			samples.push_back({pc, counters.visits, counters.ticks, {}});
+	}
+
+	R5900SymbolGuardian.Read([&samples](const ccc::SymbolDatabase& database) {
+		for (BlockSample& sample : samples)
+		{
+			if (const ccc::Function* function = database.functions.symbol_overlapping_address(sample.pc))
+				sample.function = function->name();
+		}
+	});
+
+	for (BlockSample& sample : samples)
+	{
+		if (sample.function.empty())
+			sample.function = fmt::format("sub_{:08x}", sample.pc);
+	}
+
+	std::sort(samples.begin(), samples.end(), [](const BlockSample& lhs, const BlockSample& rhs) { return lhs.ticks > rhs.ticks; });
+	return samples;
+}
+
+bool EE::BlockProfiler::WritePprof(const std::string& path, const std::vector<BlockSample>& samples)
+{
+	// See https://github.com/google/pprof/blob/main/proto/profile.proto
+	std::vector<std::string> strings = {std::string(), "visits", "count", "host_time", "ticks"};
+	std::map<std::string, u64> function_ids;
+	ProtoWriter profile;
+
+	auto add_string = [&strings](std::string str) {
+		strings.push_back(std::move(str));
+		return static_cast<u64>(strings.size() - 1);
+	};
+
+	for (const u64 type : {1, 3})
+	{
+		ProtoWriter value_type;
+		value_type.UInt(1, type);
+		value_type.UInt(2, type + 1);
+		profile.Message(1, value_type);
+	}
+
+	u64 location_id = 0;
+	for (const BlockSample& sample : samples)
+	{
+		location_id++;
+
+		// Varint encoding of the packed fields only works because these are all non-negative.
+		ProtoWriter location_ids;
+		location_ids.Varint(location_id);
+		ProtoWriter values;
+		values.Varint(sample.visits);
+		values.Varint(sample.ticks);
+
+		ProtoWriter sample_msg;
+		sample_msg.Bytes(1, location_ids.GetData().data(), location_ids.GetData().size());
+		sample_msg.Bytes(2, values.GetData().data(), values.GetData().size());
+		profile.Message(2, sample_msg);
+
+		auto [it, inserted] = function_ids.try_emplace(sample.function, function_ids.size() + 1);
+		if (inserted)
+		{
+			ProtoWriter function;
+			function.UInt(1, it->second);
+			function.UInt(2, add_string(sample.function));
+			profile.Message(5, function);
+		}
+
+		ProtoWriter line;
+		line.UInt(1, it->second);
+
+		ProtoWriter location;
+		location.UInt(1, location_id);
+		location.UInt(3, sample.pc);
+		location.Message(4, line);
+		profile.Message(4, location);
+	}
+
+	for (const std::string& str : strings)
+		profile.Bytes(6, str.data(), str.size());
+
+	gzFile fp = gzopen(path.c_str(), "wb");
+	if (!fp)
+		return false;
+
+	const std::vector<u8>& data = profile.GetData();
+	const bool result = (gzwrite(fp, data.data(), static_cast<unsigned>(data.size())) == static_cast<int>(data.size()));
+	gzclose(fp);
+	return result;
+}
+
+bool EE::BlockProfiler::WriteCollapsed(const std::string& path, const std::vector<BlockSample>& samples)
+{
+	auto fp = FileSystem::OpenManagedCFile(path.c_str(), "wb");
+	if (!fp)
+		return false;
+
+	for (const BlockSample& sample : samples)
+		std::fprintf(fp.get(), "%s;%08x %llu\n", sample.function.c_str(), sample.pc, static_cast<unsigned long long>(sample.ticks));
+
+	return std::ferror(fp.get()) == 0;
+}
+
+void EE::BlockProfiler::Export()
+{
+	const std::vector<BlockSample> samples = GetSamples();
+	if (samples.empty())
+		return;
+
+	std::string name = "eeprofile";
+	if (std::string serial = VMManager::GetDiscSerial(); !serial.empty())
+	{
+		Path::SanitizeFileName(&serial);
+		name += '_';
+		name += serial;
+	}
+
+	const time_t cur_time = time(nullptr);
+	char local_time[16];
+	if (strftime(local_time, sizeof(local_time), "%Y%m%d%H%M%S", localtime(&cur_time)))
+	{
+		name += '_';
+		name += local_time;
+	}
+
+	const std::string base = Path::Combine(EmuFolders::Logs, name);
+	const std::string pprof_path = base + ".pb.gz";
+	const std::string collapsed_path = base + ".folded";
+
+	u64 total_ticks = 0;
+	for (const BlockSample& sample : samples)
+		total_ticks += sample.ticks;
+
+	Console.WriteLn("(EE) Block profiler: %zu blocks, %llu ticks. Hottest blocks:", samples.size(), static_cast<unsigned long long>(total_ticks));
+	for (size_t i = 0; i < std::min<size_t>(samples.size(), 10); i++)
+	{
+		const BlockSample& sample = samples[i];
+		Console.WriteLn("  %08x %-32s %5.2f%% [visits=%llu]", sample.pc, sample.function.c_str(),
+			total_ticks ? static_cast<double>(sample.ticks) / static_cast<double>(total_ticks) * 100.0 : 0.0,
+			static_cast<unsigned long long>(sample.visits));
+	}
+
+	for (const auto& [path, result] : {std::make_pair(&pprof_path, WritePprof(pprof_path, samples)),
+			 std::make_pair(&collapsed_path, WriteCollapsed(collapsed_path, samples))})
+	{
+		if (result)
+			Console.WriteLn("(EE) Block profiler: Wrote '%s'", path->c_str());
+		else
+			Console.Error("(EE) Block profiler: Failed to write '%s'", path->c_str());
+	}
+}
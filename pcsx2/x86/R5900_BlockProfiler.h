@@ -0,0 +1,32 @@
+// SPDX-FileCopyrightText: 2002-2024 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#pragma once
+
+#include "common/Pcsx2Defs.h"
+
+// Block-level profiler for the EE recompiler.
+// When EnableEEBlockProfiler is set, every block counts its entries and is charged the host
+// TSC ticks until the next block is entered, so time spent in helpers called by the block
+// (memory handlers, events) counts towards it. Results are attributed to functions through
+// the symbol database and written as a pprof profile and a collapsed-stack (flame graph) file.
+namespace EE::BlockProfiler
+{
+	/// Emits the entry counter for the block starting at pc. Clobbers rax, rcx and rdx.
+	void EmitBlockEntry(u32 pc);
+
+	/// Stops charging time to the last block entered, call when leaving recompiled code.
+	void Pause();
+
+	/// Returns true if any instrumented block has run since the last Clear().
+	bool HasSamples();
+
+	/// Returns the number of times the block starting at pc has been entered since the last Clear().
+	u64 GetVisits(u32 pc);
+
+	/// Writes the collected samples to the logs folder.
+	void Export();
+
+	/// Drops all counters. Only call when no recompiled code references them anymore.
+	void Clear();
+} // namespace EE::BlockProfiler
@@ -81,6 +81,14 @@ u32 s_psxBlockCycles = 0; // cycles of current block recompiling
 static u32 s_savenBlockCycles = 0;
 static bool s_recompilingDelaySlot = false;
 
+// Block exit counters. The code that bumps the runtime ones is only emitted with EnableIOPLinkStats.
+static struct
+{
+	u64 linked_exits; // exits through a patchable jump, straight into the next block once it's compiled
+	u64 dispatcher_entries; // exits looked up through psxRecLUT
+	u32 blocks_compiled;
+} s_linkStats;
+
 static void iPsxBranchTest(u32 newpc, u32 cpuBranch);
 void psxRecompileNextInstruction(int delayslot);
 
@@ -195,6 +203,9 @@ static const void* _DynGen_DispatcherReg()
 {
 	u8* retval = xGetPtr();
 
+	if (EmuConfig.Cpu.Recompiler.EnableIOPLinkStats)
+		xADD(ptr64[&s_linkStats.dispatcher_entries], 1);
+
 	xMOV(eax, ptr[&psxRegs.pc]);
 	xMOV(ebx, eax);
 	xSHR(eax, 16);
@@ -248,6 +259,7 @@ static void _DynGen_Dispatchers()
 	iopEnterRecompiledCode = _DynGen_EnterRecompiledCode();
 
 	recBlocks.SetJITCompile(iopJITCompile);
+	recBlocks.SetDispatcher(iopDispatcherReg);
 
 	Perf::any.Register(start, xGetPtr() - start, "IOP Dispatcher");
 }
@@ -890,10 +902,27 @@ static void recReserve()
 		pxFailRel("Failed to allocate R3000 InstCache array.");
 }
 
+static void recLogLinkStats()
+{
+	if (s_linkStats.blocks_compiled == 0)
+		return;
+
+	if (EmuConfig.Cpu.Recompiler.EnableIOPLinkStats)
+	{
+		Console.WriteLn("(IOP) Block links: %llu linked exits, %llu dispatcher entries, %u blocks compiled",
+			static_cast<unsigned long long>(s_linkStats.linked_exits),
+			static_cast<unsigned long long>(s_linkStats.dispatcher_entries), s_linkStats.blocks_compiled);
+	}
+
+	s_linkStats = {};
+}
+
 void recResetIOP()
 {
 	DevCon.WriteLn("iR3000A Recompiler reset.");
 
+	recLogLinkStats();
+
 	xSetPtr(SysMemory::GetIOPRec());
 	_DynGen_Dispatchers();
 	recPtr = xGetPtr();
@@ -951,6 +980,8 @@ void recResetIOP()
 
 static void recShutdown()
 {
+	recLogLinkStats();
+
 	safe_aligned_free(m_recBlockAlloc);
 
 	safe_free(s_pInstCache);
@@ -1066,6 +1097,15 @@ void psxSetBranchReg(u32 reg)
 {
 	psxbranch = 1;
 
+	// A known target can be linked like an immediate branch, sparing the dispatcher.
+	if (reg != 0xffffffff && PSX_IS_CONST1(reg) && g_psxConstRegs[reg] != 0 && !(g_psxConstRegs[reg] & 3))
+	{
+		const u32 newpc = g_psxConstRegs[reg];
+		psxRecompileNextInstruction(true, false);
+		psxSetBranchImm(newpc);
+		return;
+	}
+
 	if (reg != 0xffffffff)
 	{
 		const bool swap = psxTrySwapDelaySlot(reg, 0, 0);
@@ -1108,6 +1148,22 @@ void psxSetBranchReg(u32 reg)
 	JMP32((uptr)iopDispatcherReg - ((uptr)x86Ptr + 5));
 }
 
+// Jumps straight to the block at pc, psxRegs.pc must already be set.
+// Without EnableIOPBlockLinking the exit goes through the dispatcher instead, so the two can be compared.
+static void psxLinkBlock(u32 pc)
+{
+	if (!EmuConfig.Cpu.Recompiler.EnableIOPBlockLinking)
+	{
+		JMP32((uptr)iopDispatcherReg - ((uptr)x86Ptr + 5));
+		return;
+	}
+
+	if (EmuConfig.Cpu.Recompiler.EnableIOPLinkStats)
+		xADD(ptr64[&s_linkStats.linked_exits], 1);
+
+	recBlocks.Link(HWADDR(pc), xJcc32());
+}
+
 void psxSetBranchImm(u32 imm)
 {
 	psxbranch = 1;
@@ -1118,7 +1174,7 @@ void psxSetBranchImm(u32 imm)
 	_psxFlushCall(FLUSH_EVERYTHING);
 	iPsxBranchTest(imm, imm <= psxpc);
 
-	recBlocks.Link(HWADDR(imm), xJcc32());
+	psxLinkBlock(imm);
 }
 
 static __fi u32 psxScaleBlockCycles()
@@ -1577,6 +1633,8 @@ static void iopRecRecompile(const u32 startpc)
 	if (!s_pCurBlockEx || s_pCurBlockEx->startpc != HWADDR(startpc))
 		s_pCurBlockEx = recBlocks.New(HWADDR(startpc), (uptr)recPtr);
 
+	s_linkStats.blocks_compiled++;
+
 	psxbranch = 0;
 
 	s_pCurBlock->SetFnptr((uptr)x86Ptr);
@@ -1748,7 +1806,7 @@ StartRecomp:
 			pxAssert(psxpc == s_nEndBlock);
 			_psxFlushCall(FLUSH_EVERYTHING);
 			xMOV(ptr32[&psxRegs.pc], psxpc);
-			recBlocks.Link(HWADDR(s_nEndBlock), xJcc32());
+			psxLinkBlock(s_nEndBlock);
 			psxbranch = 3;
 		}
 	}
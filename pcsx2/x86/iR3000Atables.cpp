@@ -1421,6 +1421,22 @@ static void rpsxJR()
 static void rpsxJALR()
 {
 	const u32 newpc = psxpc + 4;
+
+	// Known target, link it like JAL.
+	if (PSX_IS_CONST1(_Rs_) && g_psxConstRegs[_Rs_] != 0 && !(g_psxConstRegs[_Rs_] & 3))
+	{
+		const u32 target = g_psxConstRegs[_Rs_];
+		if (_Rd_)
+		{
+			_psxDeleteReg(_Rd_, DELETE_REG_FREE_NO_WRITEBACK);
+			PSX_SET_CONST(_Rd_);
+			g_psxConstRegs[_Rd_] = newpc;
+		}
+
+		psxRecompileNextInstruction(true, false);
+		psxSetBranchImm(target);
+		return;
+	}
 	const bool swap = (_Rd_ == _Rs_) ? false : psxTrySwapDelaySlot(_Rs_, 0, _Rd_);
 
 	// jalr Rs
@@ -197,13 +197,11 @@ void recCOP1_Unknown()
 **********************************************************/
 
 // Suikoden 3 uses it a lot
-void recCACHE() //Interpreter only!
+// Only the data cache is emulated, so there's nothing to do without it.
+void recCACHE()
 {
-	//xMOV(ptr32[&cpuRegs.code], (u32)cpuRegs.code );
-	//xMOV(ptr32[&cpuRegs.pc], (u32)pc );
-	//iFlushCall(FLUSH_EVERYTHING);
-	//xFastCall((void*)(uptr)R5900::Interpreter::OpcodeImpl::CACHE );
-	//branch = 2;
+	if (CHECK_CACHE)
+		recCall(R5900::Interpreter::OpcodeImpl::CACHE);
 }
 
 void recTGE()
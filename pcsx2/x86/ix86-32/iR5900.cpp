@@ -13,6 +13,7 @@
 #include "VMManager.h"
 #include "vtlb.h"
 #include "x86/BaseblockEx.h"
+#include "x86/R5900_BlockProfiler.h"
 #include "x86/iR5900.h"
 #include "x86/iR5900Analysis.h"
 
@@ -80,6 +81,7 @@ static BASEBLOCK* recROM1 = nullptr; // also here
 static BASEBLOCK* recROM2 = nullptr; // also here
 
 static BaseBlocks recBlocks;
+static BaseBlockReuseCache recBlockReuse;
 static u8* recPtr = nullptr;
 static u8* recPtrEnd = nullptr;
 EEINST* s_pInstCache = nullptr;
@@ -98,10 +100,43 @@ static EEINST* s_psaveInstInfo = nullptr;
 
 static u32 s_savenBlockCycles = 0;
 
+// Superblocks: forward conditional branches whose fall-through path is compiled into the
+// same block, with the taken path leaving through a side exit. Holds the fall-through pc
+// of every branch stitched into the block being compiled.
+static constexpr u32 MAX_SUPERBLOCK_EDGES = 16;
+static u32 s_superblockEdges[MAX_SUPERBLOCK_EDGES];
+static u32 s_nSuperblockEdges = 0;
+
+// With the block profiler running, a branch is only stitched once its two paths have been entered
+// often enough to tell which one is hot, and only when that's the fall-through, so the hot path stays
+// in the block and the cold one takes the side exit. Branches without enough data are left as block
+// ends, which keeps both paths counted, and the blocks holding them are cleared a while later to be
+// formed again with the counts in hand. Each block is only formed again a few times, so cold code
+// that never gets enough entries settles instead of being recompiled forever.
+static constexpr u64 SUPERBLOCK_MIN_VISITS = 64;
+static constexpr u32 SUPERBLOCK_REFORM_CYCLES = 294912000; // about a second
+static constexpr u8 SUPERBLOCK_MAX_REFORMS = 4;
+static u32 s_superblockReformCycle = 0;
+static bool s_superblockReformPending = false;
+static bool s_superblockDeferred = false; // block being compiled left a branch waiting for data
+static std::vector<u32> s_superblockDeferredBlocks;
+static std::unordered_map<u32, u8> s_superblockReforms; // by physical start pc
+
+static struct
+{
+	u32 blocks;
+	u32 edges;
+	u32 insts;
+	u32 deferred; // no profile data yet
+	u32 cold; // taken more often than not
+} s_superblockStats;
+
 static void iBranchTest(u32 newpc = 0xffffffff);
 static void ClearRecLUT(BASEBLOCK* base, int count);
 static u32 scaleblockcycles();
 static void recExitExecution();
+static void recResetEE();
+void recClear(u32 addr, u32 size);
 
 #ifdef TRACE_BLOCKS
 static void pauseAAA()
@@ -355,10 +390,37 @@ static const void* EnterRecompiledCode = nullptr;
 static const void* DispatchBlockDiscard = nullptr;
 static const void* DispatchPageReset = nullptr;
 
+// Clears the blocks which were waiting for profile data, so they're formed again from the counts the
+// next time they're entered. Everything else keeps its translation.
+static void recReformSuperblocks()
+{
+	s_superblockReformPending = false;
+
+	std::vector<u32> blocks;
+	blocks.swap(s_superblockDeferredBlocks);
+
+	u32 cleared = 0;
+	for (const u32 startpc : blocks)
+	{
+		const BASEBLOCKEX* block = recBlocks.Get(HWADDR(startpc));
+		if (!block || block->startpc != HWADDR(startpc))
+			continue;
+
+		s_superblockReforms[HWADDR(startpc)]++;
+		recClear(startpc, block->size);
+		cleared++;
+	}
+
+	DevCon.WriteLn("(EE) Superblocks: Forming %u blocks again from the block profile", cleared);
+}
+
 static void recEventTest()
 {
 	_cpuEventTest_Shared();
 
+	if (s_superblockReformPending && static_cast<s32>(cpuRegs.cycle - s_superblockReformCycle) >= 0)
+		recReformSuperblocks();
+
 	if (eeRecExitRequested)
 	{
 		eeRecExitRequested = false;
@@ -485,6 +547,7 @@ static void _DynGen_Dispatchers()
 	DispatchPageReset = _DynGen_DispatchPageReset();
 
 	recBlocks.SetJITCompile(JITCompile);
+	recBlocks.SetDispatcher(DispatcherReg);
 
 	Perf::any.Register(start, static_cast<u32>(xGetPtr() - start), "EE Dispatcher");
 }
@@ -572,6 +635,29 @@ static void recReserve()
 alignas(16) static u16 manual_page[Ps2MemSize::TotalRam >> 12];
 alignas(16) static u8 manual_counter[Ps2MemSize::TotalRam >> 12];
 
+static void recLogBlockReuseStats()
+{
+	if (recBlockReuse.hits == 0 && recBlockReuse.misses == 0)
+		return;
+
+	DevCon.WriteLn("(EE) Block reuse: %u hits, %u misses", recBlockReuse.hits, recBlockReuse.misses);
+}
+
+static void recLogSuperblockStats()
+{
+	if (s_superblockStats.blocks == 0 && s_superblockStats.deferred == 0 && s_superblockStats.cold == 0)
+		return;
+
+	Console.WriteLn("(EE) Superblocks: %u blocks, %u stitched branches, %.1f insts per block",
+		s_superblockStats.blocks, s_superblockStats.edges,
+		s_superblockStats.blocks ? static_cast<double>(s_superblockStats.insts) / static_cast<double>(s_superblockStats.blocks) : 0.0);
+	if (EmuConfig.Cpu.Recompiler.EnableEEBlockProfiler)
+	{
+		Console.WriteLn("(EE) Superblocks: %u branches waiting for profile data, %u left unstitched with a hot taken path",
+			s_superblockStats.deferred, s_superblockStats.cold);
+	}
+}
+
 ////////////////////////////////////////////////////
 static void recResetRaw()
 {
@@ -585,6 +671,24 @@ static void recResetRaw()
 
 	EE::Profiler.Reset();
 
+	recLogBlockReuseStats();
+	recBlockReuse.Reset();
+	recBlocks.SetRetainRemovedCode(EmuConfig.Cpu.Recompiler.EnableEEBlockReuse);
+
+	recLogSuperblockStats();
+	s_superblockStats = {};
+	s_superblockReformPending = false;
+	s_superblockDeferredBlocks.clear();
+	s_superblockReforms.clear();
+
+	// Counters survive resets while profiling, and are written out once it's switched off.
+	if (!EmuConfig.Cpu.Recompiler.EnableEEBlockProfiler)
+	{
+		if (EE::BlockProfiler::HasSamples())
+			EE::BlockProfiler::Export();
+		EE::BlockProfiler::Clear();
+	}
+
 	xSetPtr(SysMemory::GetEERec());
 	_DynGen_Dispatchers();
 	vtlb_DynGenDispatchers();
@@ -610,8 +714,17 @@ void recShutdown()
 	recRAMCopy.deallocate();
 	recLutReserve_RAM.deallocate();
 
+	recLogBlockReuseStats();
+	recBlockReuse.Reset();
 	recBlocks.Reset();
 
+	recLogSuperblockStats();
+	s_superblockStats = {};
+
+	if (EE::BlockProfiler::HasSamples())
+		EE::BlockProfiler::Export();
+	EE::BlockProfiler::Clear();
+
 	recRAM = recROM = recROM1 = recROM2 = nullptr;
 
 	safe_free(s_pInstCache);
@@ -698,6 +811,7 @@ static void recExecute()
 
 	eeCpuExecuting = false;
 
+	EE::BlockProfiler::Pause();
 	EE::Profiler.Print();
 }
 
@@ -879,8 +993,23 @@ void SetBranchReg(u32 reg)
 	iBranchTest();
 }
 
+static bool recIsSuperblockEdge(u32 fallthrough)
+{
+	return std::find(s_superblockEdges, s_superblockEdges + s_nSuperblockEdges, fallthrough) !=
+		   s_superblockEdges + s_nSuperblockEdges;
+}
+
 void SetBranchImm(u32 imm)
 {
+	// Fall-through of a branch stitched into a superblock, keep compiling with the
+	// current register allocation. The taken path has already left through its side exit.
+	if (imm == pc && pc < s_nEndBlock && recIsSuperblockEdge(pc))
+	{
+		g_branch = 0;
+		s_superblockStats.edges++;
+		return;
+	}
+
 	g_branch = 1;
 
 	pxAssert(imm);
@@ -1181,6 +1310,7 @@ void SaveBranchState()
 	s_saveFlushedConstReg = g_cpuFlushedConstReg;
 	s_psaveInstInfo = g_pCurInstInfo;
 
+	memcpy(s_saveX86regs, x86regs, sizeof(x86regs));
 	memcpy(s_saveXMMregs, xmmregs, sizeof(xmmregs));
 }
 
@@ -1193,6 +1323,7 @@ void LoadBranchState()
 	g_cpuFlushedConstReg = s_saveFlushedConstReg;
 	g_pCurInstInfo = s_psaveInstInfo;
 
+	memcpy(x86regs, s_saveX86regs, sizeof(x86regs));
 	memcpy(xmmregs, s_saveXMMregs, sizeof(xmmregs));
 }
 
@@ -2009,17 +2140,26 @@ void dyna_page_reset(u32 start, u32 sz)
 	mmap_MarkCountedRamPage(start);
 }
 
-static void memory_protect_recompiled_code(u32 startpc, u32 size)
+// The kernel context register is stored @ 0x800010C0-0x80001300
+// The EENULL thread context register is stored @ 0x81000-....
+static bool block_contains_thread_stack(u32 startpc)
+{
+	return ((startpc >> 12) == 0x81) || ((startpc >> 12) == 0x80001);
+}
+
+static vtlb_ProtectionMode get_block_protection_mode(u32 startpc)
+{
+	// note: blocks are guaranteed to reside within the confines of a single page.
+	return block_contains_thread_stack(startpc) ? ProtMode_Manual : mmap_GetRamPageInfo(HWADDR(startpc));
+}
+
+static vtlb_ProtectionMode memory_protect_recompiled_code(u32 startpc, u32 size)
 {
 	u32 inpage_ptr = HWADDR(startpc);
 	const u32 inpage_sz = size * 4;
 
-	// The kernel context register is stored @ 0x800010C0-0x80001300
-	// The EENULL thread context register is stored @ 0x81000-....
-	const bool contains_thread_stack = ((startpc >> 12) == 0x81) || ((startpc >> 12) == 0x80001);
-
-	// note: blocks are guaranteed to reside within the confines of a single page.
-	const vtlb_ProtectionMode PageType = contains_thread_stack ? ProtMode_Manual : mmap_GetRamPageInfo(inpage_ptr);
+	const bool contains_thread_stack = block_contains_thread_stack(startpc);
+	const vtlb_ProtectionMode PageType = get_block_protection_mode(startpc);
 
 	switch (PageType)
 	{
@@ -2089,6 +2229,8 @@ static void memory_protect_recompiled_code(u32 startpc, u32 size)
 			}
 			break;
 	}
+
+	return PageType;
 }
 
 // Skip MPEG Game-Fix
@@ -2171,6 +2313,193 @@ static bool recSkipTimeoutLoop(s32 reg, bool is_timeout_loop)
 	return true;
 }
 
+// Marks [startpc, endpc) as translated by s_pCurBlockEx, discarding any overlapping blocks
+// whose guest code has changed since they were compiled.
+static void recCommitBlock(u32 startpc, u32 endpc)
+{
+	if (HWADDR(endpc) <= Ps2MemSize::ExposedRam)
+	{
+		BASEBLOCKEX* oldBlock;
+		int i;
+
+		i = recBlocks.LastIndex(HWADDR(endpc) - 4);
+		while ((oldBlock = recBlocks[i--]))
+		{
+			if (oldBlock == s_pCurBlockEx)
+				continue;
+			if (oldBlock->startpc >= HWADDR(endpc))
+				continue;
+			if ((oldBlock->startpc + oldBlock->size * 4) <= HWADDR(startpc))
+				break;
+
+			if (memcmp(&recRAMCopy[oldBlock->startpc / 4], PSM(oldBlock->startpc),
+					oldBlock->size * 4))
+			{
+				recClear(startpc, (endpc - startpc) / 4);
+				s_pCurBlockEx = recBlocks.Get(HWADDR(startpc));
+				pxAssert(s_pCurBlockEx->startpc == HWADDR(startpc));
+				break;
+			}
+		}
+
+		memcpy(&recRAMCopy[HWADDR(startpc) / 4], PSM(startpc), endpc - startpc);
+	}
+
+	s_pCurBlock->SetFnptr(s_pCurBlockEx->fnptr);
+
+	for (u32 i = 1; i < static_cast<u32>(s_pCurBlockEx->size); i++)
+	{
+		if ((uptr)JITCompile == s_pCurBlock[i].GetFnptr())
+			s_pCurBlock[i].SetFnptr((uptr)JITCompileInBlock);
+	}
+
+	if (!(endpc & 0x10000000))
+		maxrecmem = std::max((endpc & ~0xa0000000), maxrecmem);
+}
+
+// Blocks which have side effects at compile time, or whose shape depends on debugger state,
+// always go through the full recompiler.
+static bool recCanReuseBlock(u32 startpc)
+{
+	if (!EmuConfig.Cpu.Recompiler.EnableEEBlockReuse || EmuConfig.Gamefixes.GoemonTlbHack ||
+		CBreakPoints::GetNumBreakpoints() != 0 || CBreakPoints::GetNumMemchecks() != 0)
+	{
+		return false;
+	}
+
+	// A block formed again from the profile mustn't get its old shape back.
+	const u32 hwstart = HWADDR(startpc);
+	if (s_superblockReforms.find(hwstart) != s_superblockReforms.end())
+		return false;
+
+	return (hwstart != EELOAD_START && (!g_eeloadMain || hwstart != HWADDR(g_eeloadMain)) &&
+			(!g_eeloadExec || hwstart != HWADDR(g_eeloadExec)));
+}
+
+// Maps a previous translation of the code at startpc back in, if the guest code is unchanged.
+static bool recTryReuseBlock(u32 startpc)
+{
+	const BaseBlockReuseCache::Entry* entry = recBlockReuse.Find(HWADDR(startpc), static_cast<const u32*>(PSM(startpc)));
+	if (!entry)
+	{
+		recBlockReuse.misses++;
+		return false;
+	}
+
+	// Blocks compiled without self-checks depend on the page being write protected, which might
+	// no longer be the case if the page has since been demoted to manual protection.
+	const vtlb_ProtectionMode PageType = get_block_protection_mode(startpc);
+	if (!entry->manual_protection)
+	{
+		if (PageType == ProtMode_Manual)
+		{
+			recBlockReuse.misses++;
+			return false;
+		}
+		else if (PageType != ProtMode_NotRequired)
+		{
+			mmap_MarkCountedRamPage(HWADDR(startpc));
+			manual_page[HWADDR(startpc) >> 12] = 0;
+		}
+	}
+
+	s_pCurBlockEx = recBlocks.New(HWADDR(startpc), entry->fnptr);
+	s_pCurBlockEx->size = entry->size;
+	s_pCurBlockEx->x86size = entry->x86size;
+	recCommitBlock(startpc, startpc + entry->size * 4);
+
+	eeRecPerfLog.Write("Reusing block @ %08X : size=%d insts", startpc, entry->size);
+	recBlockReuse.hits++;
+	return true;
+}
+
+static void recMarkAllLive(EEINST* pinst)
+{
+	for (u8& reg : pinst->regs)
+		reg |= EEINST_LIVE;
+	for (u8& reg : pinst->fpuregs)
+		reg |= EEINST_LIVE;
+	for (u8& reg : pinst->vfregs)
+		reg |= EEINST_LIVE;
+	for (u8& reg : pinst->viregs)
+		reg |= EEINST_LIVE;
+}
+
+// Decides whether the scan of the block at startpc can carry on past the conditional branch in
+// cpuRegs.code at branchpc, compiling its fall-through path into the same block.
+static bool recTryStitchBranch(u32 startpc, u32 branchpc, u32 target, bool has_cop2)
+{
+	// The COP2 analysis passes assume a single exit at the end of the block.
+	if (!EmuConfig.Cpu.Recompiler.EnableEESuperblocks || has_cop2 || s_nSuperblockEdges == MAX_SUPERBLOCK_EDGES)
+		return false;
+
+	// Likely branches skip the delay slot when not taken, which backpropagation can't express.
+	if (GetInstruction(cpuRegs.code).flags & IS_LIKELY)
+		return false;
+
+	// Loops keep their own block so the backedge links straight to the header, and the wait
+	// and timeout loop detection still sees them.
+	if ((target >= startpc && target <= branchpc) || target == branchpc + 8)
+		return false;
+
+	const u32 delayslot = branchpc + 4;
+	if ((delayslot & 0xffc) == 0x0)
+		return false;
+
+	const u32 delaycode = *(u32*)PSM(delayslot);
+	if ((GetInstruction(delaycode).flags & IS_BRANCH) || (delaycode >> 26) == 022 || (delaycode >> 26) == 066 || (delaycode >> 26) == 076)
+		return false;
+
+	if (EmuConfig.Cpu.Recompiler.EnableEEBlockProfiler)
+	{
+		const u64 taken = EE::BlockProfiler::GetVisits(HWADDR(target));
+		const u64 not_taken = EE::BlockProfiler::GetVisits(HWADDR(branchpc + 8));
+		if (taken + not_taken < SUPERBLOCK_MIN_VISITS)
+		{
+			const auto reforms = s_superblockReforms.find(HWADDR(startpc));
+			if (reforms == s_superblockReforms.end() || reforms->second < SUPERBLOCK_MAX_REFORMS)
+			{
+				s_superblockStats.deferred++;
+				s_superblockDeferred = true;
+			}
+			return false;
+		}
+
+		if (taken > not_taken)
+		{
+			s_superblockStats.cold++;
+			return false;
+		}
+	}
+
+	s_superblockEdges[s_nSuperblockEdges++] = branchpc + 8;
+	return true;
+}
+
+// Drops the last stitched branch when the block is cut right after it, so it ends the block as usual.
+static bool recTrimSuperblockEdge(u32 endpc)
+{
+	if (s_nSuperblockEdges == 0 || s_superblockEdges[s_nSuperblockEdges - 1] != endpc)
+		return false;
+
+	s_nSuperblockEdges--;
+	return true;
+}
+
+// Cuts the block being scanned at endpc, the header of a loop closed further down, dropping the
+// branches stitched past it. Fails when endpc is the delay slot of a stitched branch.
+static bool recCutSuperblock(u32 endpc)
+{
+	if (recIsSuperblockEdge(endpc + 4))
+		return false;
+
+	while (s_nSuperblockEdges > 0 && s_superblockEdges[s_nSuperblockEdges - 1] > endpc)
+		s_nSuperblockEdges--;
+
+	recTrimSuperblockEdge(endpc);
+	return true;
+}
+
 static void recRecompile(const u32 startpc)
 {
 	u32 i = 0;
@@ -2191,9 +2520,6 @@ static void recRecompile(const u32 startpc)
 		recResetRaw();
 	}
 
-	xSetPtr(recPtr);
-	recPtr = xGetAlignedCallTarget();
-
 	s_pCurBlock = PC_GETBLOCK(startpc);
 
 	pxAssert(s_pCurBlock->GetFnptr() == (uptr)JITCompile || s_pCurBlock->GetFnptr() == (uptr)JITCompileInBlock);
@@ -2201,6 +2527,17 @@ static void recRecompile(const u32 startpc)
 	s_pCurBlockEx = recBlocks.Get(HWADDR(startpc));
 	pxAssert(!s_pCurBlockEx || s_pCurBlockEx->startpc != HWADDR(startpc));
 
+	const bool can_reuse_block = recCanReuseBlock(startpc);
+	if (can_reuse_block && recTryReuseBlock(startpc))
+	{
+		s_pCurBlock = nullptr;
+		s_pCurBlockEx = nullptr;
+		return;
+	}
+
+	xSetPtr(recPtr);
+	recPtr = xGetAlignedCallTarget();
+
 	s_pCurBlockEx = recBlocks.New(HWADDR(startpc), (uptr)recPtr);
 
 	pxAssert(s_pCurBlockEx);
@@ -2252,6 +2589,9 @@ static void recRecompile(const u32 startpc)
 	xFastCall((void*)PreBlockCheck, pc);
 #endif
 
+	if (EmuConfig.Cpu.Recompiler.EnableEEBlockProfiler)
+		EE::BlockProfiler::EmitBlockEntry(HWADDR(startpc));
+
 	if (EmuConfig.Gamefixes.GoemonTlbHack)
 	{
 		if (pc == 0x33ad48 || pc == 0x35060c)
@@ -2272,6 +2612,9 @@ static void recRecompile(const u32 startpc)
 	i = startpc;
 	s_nEndBlock = 0xffffffff;
 	s_branchTo = -1;
+	s_nSuperblockEdges = 0;
+	s_superblockDeferred = false;
+	bool has_cop2 = false;
 
 	// Timeout loop speedhack.
 	// God of War 2 and other games (e.g. NFS series) have these timeout loops which just spin for a few thousand
@@ -2310,6 +2653,7 @@ static void recRecompile(const u32 startpc)
 		// stop before breakpoints
 		if (isBreakpointNeeded(i) != 0 || isMemcheckNeeded(i) != 0)
 		{
+			recTrimSuperblockEdge(i);
 			s_nEndBlock = i;
 			break;
 		}
@@ -2318,7 +2662,7 @@ static void recRecompile(const u32 startpc)
 		{
 			if ((i & 0xffc) == 0x0) // breaks blocks at 4k page boundaries
 			{
-				willbranch3 = 1;
+				willbranch3 = !recTrimSuperblockEdge(i);
 				s_nEndBlock = i;
 
 				eeRecPerfLog.Write("Pagesplit @ %08X : size=%d insts", startpc, (i - startpc) / 4);
@@ -2327,7 +2671,7 @@ static void recRecompile(const u32 startpc)
 
 			if (pblock->GetFnptr() != (uptr)JITCompile && pblock->GetFnptr() != (uptr)JITCompileInBlock)
 			{
-				willbranch3 = 1;
+				willbranch3 = !recTrimSuperblockEdge(i);
 				s_nEndBlock = i;
 				break;
 			}
@@ -2336,6 +2680,19 @@ static void recRecompile(const u32 startpc)
 		//HUH ? PSM ? whut ? THIS IS VIRTUAL ACCESS GOD DAMMIT
 		cpuRegs.code = *(int*)PSM(i);
 
+		if (_Opcode_ == 022 || _Opcode_ == 066 || _Opcode_ == 076)
+		{
+			// Keep COP2 code out of superblocks.
+			if (s_nSuperblockEdges > 0)
+			{
+				willbranch3 = !recTrimSuperblockEdge(i);
+				s_nEndBlock = i;
+				break;
+			}
+
+			has_cop2 = true;
+		}
+
 		if (is_timeout_loop)
 		{
 			if ((cpuRegs.code >> 26) == 8 || (cpuRegs.code >> 26) == 9)
@@ -2379,7 +2736,14 @@ static void recRecompile(const u32 startpc)
 				{
 					// branches
 					s_branchTo = _Imm_ * 4 + i + 4;
-					if (s_branchTo > startpc && s_branchTo < i)
+					if (recTryStitchBranch(startpc, i, s_branchTo, has_cop2))
+					{
+						is_timeout_loop = false;
+						i += 8;
+						continue;
+					}
+
+					if (s_branchTo > startpc && s_branchTo < i && recCutSuperblock(s_branchTo))
 						s_nEndBlock = s_branchTo;
 					else
 						s_nEndBlock = i + 8;
@@ -2404,7 +2768,14 @@ static void recRecompile(const u32 startpc)
 			case 22:
 			case 23:
 				s_branchTo = _Imm_ * 4 + i + 4;
-				if (s_branchTo > startpc && s_branchTo < i)
+				if (recTryStitchBranch(startpc, i, s_branchTo, has_cop2))
+				{
+					is_timeout_loop = false;
+					i += 8;
+					continue;
+				}
+
+				if (s_branchTo > startpc && s_branchTo < i && recCutSuperblock(s_branchTo))
 					s_nEndBlock = s_branchTo;
 				else
 					s_nEndBlock = i + 8;
@@ -2430,7 +2801,14 @@ static void recRecompile(const u32 startpc)
 					// BC1F, BC1T, BC1FL, BC1TL
 					// BC2F, BC2T, BC2FL, BC2TL
 					s_branchTo = _Imm_ * 4 + i + 4;
-					if (s_branchTo > startpc && s_branchTo < i)
+					if (recTryStitchBranch(startpc, i, s_branchTo, has_cop2))
+					{
+						is_timeout_loop = false;
+						i += 8;
+						continue;
+					}
+
+					if (s_branchTo > startpc && s_branchTo < i && recCutSuperblock(s_branchTo))
 						s_nEndBlock = s_branchTo;
 					else
 						s_nEndBlock = i + 8;
@@ -2550,6 +2928,11 @@ StartRecomp:
 		for (i = s_nEndBlock; i > startpc; i -= 4)
 		{
 			cpuRegs.code = *(int*)PSM(i - 4);
+
+			// Everything is live when leaving through a side exit, same as at the end of the block.
+			if (s_nSuperblockEdges > 0 && recIsSuperblockEdge(i))
+				recMarkAllLive(pcur);
+
 			pcur[-1] = pcur[0];
 			recBackpropBSC(cpuRegs.code, pcur - 1, pcur);
 			pcur--;
@@ -2588,7 +2971,7 @@ StartRecomp:
 #endif
 
 	// Detect and handle self-modified code
-	memory_protect_recompiled_code(startpc, (s_nEndBlock - startpc) >> 2);
+	const vtlb_ProtectionMode PageType = memory_protect_recompiled_code(startpc, (s_nEndBlock - startpc) >> 2);
 
 	// Skip Recompilation if sceMpegIsEnd Pattern detected
 	const bool doRecompilation = !skipMPEG_By_Pattern(startpc) && !recSkipTimeoutLoop(timeout_reg, is_timeout_loop);
@@ -2634,45 +3017,25 @@ StartRecomp:
 	pxAssert((pc - startpc) >> 2 <= 0xffff);
 	s_pCurBlockEx->size = (pc - startpc) >> 2;
 
-	if (HWADDR(pc) <= Ps2MemSize::ExposedRam)
+	if (s_nSuperblockEdges > 0)
 	{
-		BASEBLOCKEX* oldBlock;
-		int i;
-
-		i = recBlocks.LastIndex(HWADDR(pc) - 4);
-		while ((oldBlock = recBlocks[i--]))
-		{
-			if (oldBlock == s_pCurBlockEx)
-				continue;
-			if (oldBlock->startpc >= HWADDR(pc))
-				continue;
-			if ((oldBlock->startpc + oldBlock->size * 4) <= HWADDR(startpc))
-				break;
-
-			if (memcmp(&recRAMCopy[oldBlock->startpc / 4], PSM(oldBlock->startpc),
-					oldBlock->size * 4))
-			{
-				recClear(startpc, (pc - startpc) / 4);
-				s_pCurBlockEx = recBlocks.Get(HWADDR(startpc));
-				pxAssert(s_pCurBlockEx->startpc == HWADDR(startpc));
-				break;
-			}
-		}
-
-		memcpy(&recRAMCopy[HWADDR(startpc) / 4], PSM(startpc), pc - startpc);
+		s_superblockStats.blocks++;
+		s_superblockStats.insts += s_pCurBlockEx->size;
+		eeRecPerfLog.Write("Superblock @ %08X : size=%d insts, %u stitched branches", startpc, s_pCurBlockEx->size, s_nSuperblockEdges);
 	}
 
-	s_pCurBlock->SetFnptr((uptr)recPtr);
+	recCommitBlock(startpc, pc);
 
-	for (i = 1; i < static_cast<u32>(s_pCurBlockEx->size); i++)
+	if (s_superblockDeferred)
 	{
-		if ((uptr)JITCompile == s_pCurBlock[i].GetFnptr())
-			s_pCurBlock[i].SetFnptr((uptr)JITCompileInBlock);
+		s_superblockDeferredBlocks.push_back(startpc);
+		if (!s_superblockReformPending)
+		{
+			s_superblockReformPending = true;
+			s_superblockReformCycle = cpuRegs.cycle + SUPERBLOCK_REFORM_CYCLES;
+		}
 	}
 
-	if (!(pc & 0x10000000))
-		maxrecmem = std::max((pc & ~0xa0000000), maxrecmem);
-
 	if (g_branch == 2)
 	{
 		// Branch type 2 - This is how I "think" this works (air):
@@ -2724,6 +3087,9 @@ StartRecomp:
 #endif
 	Perf::ee.RegisterPC((void*)s_pCurBlockEx->fnptr, s_pCurBlockEx->x86size, s_pCurBlockEx->startpc);
 
+	if (can_reuse_block && s_pCurBlockEx->size > 0)
+		recBlockReuse.Insert(*s_pCurBlockEx, static_cast<const u32*>(PSM(startpc)), PageType == ProtMode_Manual);
+
 	recPtr = xGetPtr();
 
 	pxAssert((g_cpuHasConstReg & g_cpuFlushedConstReg) == g_cpuHasConstReg);
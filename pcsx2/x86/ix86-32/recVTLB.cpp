@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-3.0+
 
 #include "Common.h"
+#include "Cache.h"
 #include "vtlb.h"
 #include "x86/iCore.h"
 #include "x86/iR5900.h"
@@ -122,6 +123,28 @@ namespace vtlb_private
 	// Prepares eax, ecx, and, ebx for Direct or Indirect operations.
 	// Returns the writeback pointer for ebx (return address from indirect handling)
 	//
+	static void DynGen_PrepValue(int value_reg, u32 sz, bool xmm)
+	{
+		if (sz == 128)
+		{
+			pxAssert(xmm);
+			_freeXMMreg(xRegisterSSE::GetArgRegister(1, 0).GetId());
+			xMOVAPS(xRegisterSSE::GetArgRegister(1, 0), xRegisterSSE::GetInstance(value_reg));
+		}
+		else if (xmm)
+		{
+			// 32bit xmms are passed in GPRs
+			pxAssert(sz == 32);
+			_freeX86reg(arg2regd);
+			xMOVD(arg2regd, xRegisterSSE(value_reg));
+		}
+		else
+		{
+			_freeX86reg(arg2regd);
+			xMOV(arg2reg, xRegister64(value_reg));
+		}
+	}
+
 	static void DynGen_PrepRegs(int addr_reg, int value_reg, u32 sz, bool xmm)
 	{
 		EE::Profiler.EmitMem();
@@ -130,26 +153,11 @@ namespace vtlb_private
 		xMOV(arg1regd, xRegister32(addr_reg));
 
 		if (value_reg >= 0)
-		{
-			if (sz == 128)
-			{
-				pxAssert(xmm);
-				_freeXMMreg(xRegisterSSE::GetArgRegister(1, 0).GetId());
-				xMOVAPS(xRegisterSSE::GetArgRegister(1, 0), xRegisterSSE::GetInstance(value_reg));
-			}
-			else if (xmm)
-			{
-				// 32bit xmms are passed in GPRs
-				pxAssert(sz == 32);
-				_freeX86reg(arg2regd);
-				xMOVD(arg2regd, xRegisterSSE(value_reg));
-			}
-			else
-			{
-				_freeX86reg(arg2regd);
-				xMOV(arg2reg, xRegister64(value_reg));
-			}
-		}
+			DynGen_PrepValue(value_reg, sz, xmm);
+
+		// The cache lookup needs the guest address after the TLB lookup.
+		if (CHECK_CACHE)
+			xMOV(r11d, arg1regd);
 
 		xMOV(eax, arg1regd);
 		xSHR(eax, VTLB_PAGE_BITS);
@@ -223,6 +231,130 @@ namespace vtlb_private
 				break;
 		}
 	}
+
+	// ------------------------------------------------------------------------
+	// Looks the line up in the EE data cache, and accesses it there on a hit in an unlocked way.
+	// Anything else (filling, write back, locked lines) is left to the C++ implementation.
+	// In: arg1reg: host pointer, r11d: guest address, arg2reg/xmm arg 1: data (if writing)
+	// Out: rax/xmm0: result (if reading). Clobbers r9, r10, arg3reg.
+	static void DynGen_CachedAccess(int mode, u32 bits, bool sign)
+	{
+		// A tag matches when it's valid, unlocked and holds the host page of the access.
+		static constexpr s32 TAG_MATCH_MASK = ~0xFFF | CACHE_TAG_VALID | CACHE_TAG_LOCK;
+
+		xMOV(r9, arg1reg);
+		xAND(r9, ~0xFFF);
+		xOR(r9, CACHE_TAG_VALID);
+
+		// set * 2 * CACHE_TAG_SIZE
+		xMOV(eax, arg1regd);
+		xAND(eax, 0xFC0);
+		xSHR(eax, 1);
+		xLoadFarAddr(r10, GetCacheTagsPtr());
+
+		xMOV(arg3reg, ptr64[r10 + rax]);
+		xAND(arg3reg, TAG_MATCH_MASK);
+		xCMP(arg3reg, r9);
+		xForwardJE8 hit;
+		xADD(eax, CACHE_TAG_SIZE);
+		xMOV(arg3reg, ptr64[r10 + rax]);
+		xAND(arg3reg, TAG_MATCH_MASK);
+		xCMP(arg3reg, r9);
+		xForwardJNE8 miss;
+		hit.SetTarget();
+
+		if (mode)
+			xOR(ptr32[r10 + rax], CACHE_TAG_DIRTY);
+
+		// Lines are CACHE_LINE_SIZE / CACHE_TAG_SIZE times the size of tags.
+		xLoadFarAddr(r10, GetCacheDataPtr());
+		xLEA(r10, ptr[rax * 4 + r10]);
+		xMOV(eax, arg1regd);
+		xAND(eax, (CACHE_LINE_SIZE - 1) & ~(bits / 8 - 1));
+		xLEA(arg1reg, ptr[r10 + rax]);
+		if (mode)
+			DynGen_DirectWrite(bits);
+		else
+			DynGen_DirectRead(bits, sign);
+		xForwardJump32 done;
+
+		miss.SetTarget();
+		xMOV(arg1regd, r11d);
+		switch (bits)
+		{
+			case 8:
+				if (mode)
+					xFastCall((void*)recWriteCache8);
+				else
+				{
+					xFastCall((void*)recReadCache8);
+					sign ? xMOVSX(rax, al) : xMOVZX(rax, al);
+				}
+				break;
+
+			case 16:
+				if (mode)
+					xFastCall((void*)recWriteCache16);
+				else
+				{
+					xFastCall((void*)recReadCache16);
+					sign ? xMOVSX(rax, ax) : xMOVZX(rax, ax);
+				}
+				break;
+
+			case 32:
+				if (mode)
+					xFastCall((void*)recWriteCache32);
+				else
+				{
+					xFastCall((void*)recReadCache32);
+					if (sign)
+						xCDQE();
+				}
+				break;
+
+			case 64:
+				xFastCall(mode ? (void*)recWriteCache64 : (void*)recReadCache64);
+				break;
+
+			case 128:
+				xFastCall(mode ? (void*)recWriteCache128 : (void*)recReadCache128);
+				break;
+
+				jNO_DEFAULT
+		}
+
+		done.SetTarget();
+	}
+
+	// ------------------------------------------------------------------------
+	// Picks between the direct and cached access with the cached flag of the guest page.
+	// In: arg1reg: host pointer (never a handler), r11d: guest address
+	template <typename GenDirectFn>
+	static void DynGen_CacheTest(const GenDirectFn& gen_direct, int mode, u32 bits, bool sign)
+	{
+		xMOV(eax, r11d);
+		xSHR(eax, VTLB_PAGE_BITS);
+		xCMP(ptr8[xComplexAddress(arg3reg, vtlbdata.cached, rax)], 0);
+		xForwardJNZ32 to_cache;
+		gen_direct();
+		xForwardJump32 done;
+		to_cache.SetTarget();
+		DynGen_CachedAccess(mode, bits, sign);
+		done.SetTarget();
+	}
+
+	// ------------------------------------------------------------------------
+	// Sets up a cache test for an address resolved at compile time. Flushes like a handler call,
+	// as a miss ends up in C++.
+	static void DynGen_PrepCachedConst(u32 addr_const, uptr ppf)
+	{
+		iFlushCall(FLUSH_FULLVTLB);
+
+		_freeX86reg(arg1regd);
+		xLoadFarAddr(arg1reg, reinterpret_cast<void*>(ppf));
+		xMOV(r11d, addr_const);
+	}
 } // namespace vtlb_private
 
 static constexpr u32 INDIRECT_DISPATCHER_SIZE = 32;
@@ -259,6 +391,19 @@ static void DynGen_HandlerTest(const GenDirectFn& gen_direct, int mode, int bits
 		case 128: szidx = 4; break;
 		jNO_DEFAULT;
 	}
+
+	if (CHECK_CACHE)
+	{
+		// The cache lookup doesn't fit in a short jump.
+		xForwardJS32 to_handler;
+		DynGen_CacheTest(gen_direct, mode, bits, sign);
+		xForwardJump32 done;
+		to_handler.SetTarget();
+		xFastCall(GetIndirectDispatcherPtr(mode, szidx, sign));
+		done.SetTarget();
+		return;
+	}
+
 	xForwardJS8 to_handler;
 	gen_direct();
 	xForwardJump8 done;
@@ -453,7 +598,23 @@ int vtlb_DynGenReadNonQuad_Const(u32 bits, bool sign, bool xmm, u32 addr_const,
 
 	int x86_dest_reg;
 	auto vmv = vtlbdata.vmap[addr_const >> VTLB_PAGE_BITS];
-	if (!vmv.isHandler(addr_const))
+	if (!vmv.isHandler(addr_const) && CHECK_CACHE)
+	{
+		DynGen_PrepCachedConst(addr_const, vmv.assumePtr(addr_const));
+		DynGen_CacheTest([bits, sign]() { DynGen_DirectRead(bits, sign); }, 0, bits, sign && bits < 64);
+
+		if (!xmm)
+		{
+			x86_dest_reg = dest_reg_alloc ? dest_reg_alloc() : (_freeX86reg(eax), eax.GetId());
+			xMOV(xRegister64(x86_dest_reg), rax);
+		}
+		else
+		{
+			x86_dest_reg = dest_reg_alloc ? dest_reg_alloc() : (_freeXMMreg(0), 0);
+			xMOVDZX(xRegisterSSE(x86_dest_reg), eax);
+		}
+	}
+	else if (!vmv.isHandler(addr_const))
 	{
 		auto ppf = vmv.assumePtr(addr_const);
 		if (!xmm)
@@ -600,7 +761,16 @@ int vtlb_DynGenReadQuad_Const(u32 bits, u32 addr_const, vtlb_ReadRegAllocCallbac
 
 	int reg;
 	auto vmv = vtlbdata.vmap[addr_const >> VTLB_PAGE_BITS];
-	if (!vmv.isHandler(addr_const))
+	if (!vmv.isHandler(addr_const) && CHECK_CACHE)
+	{
+		DynGen_PrepCachedConst(addr_const, vmv.assumePtr(addr_const));
+		DynGen_CacheTest([bits]() { DynGen_DirectRead(bits, false); }, 0, bits, false);
+
+		reg = dest_reg_alloc ? dest_reg_alloc() : (_freeXMMreg(0), 0);
+		if (reg >= 0)
+			xMOVAPS(xRegisterSSE(reg), xmm0);
+	}
+	else if (!vmv.isHandler(addr_const))
 	{
 		void* ppf = reinterpret_cast<void*>(vmv.assumePtr(addr_const));
 		reg = dest_reg_alloc ? dest_reg_alloc() : (_freeXMMreg(0), 0);
@@ -804,7 +974,13 @@ void vtlb_DynGenWrite_Const(u32 bits, bool xmm, u32 addr_const, int value_reg)
 #endif
 
 	auto vmv = vtlbdata.vmap[addr_const >> VTLB_PAGE_BITS];
-	if (!vmv.isHandler(addr_const))
+	if (!vmv.isHandler(addr_const) && CHECK_CACHE)
+	{
+		DynGen_PrepCachedConst(addr_const, vmv.assumePtr(addr_const));
+		DynGen_PrepValue(value_reg, bits, xmm);
+		DynGen_CacheTest([bits]() { DynGen_DirectWrite(bits); }, 1, bits, false);
+	}
+	else if (!vmv.isHandler(addr_const))
 	{
 		auto ppf = vmv.assumePtr(addr_const);
 		if (!xmm)
@@ -6,6 +6,15 @@
 #include "common/AlignedMalloc.h"
 #include "common/Perf.h"
 #include "common/StringUtil.h"
+#include "common/Timer.h"
+
+#include "VMManager.h"
+
+#include <atomic>
+
+#define XXH_STATIC_LINKING_ONLY 1
+#define XXH_INLINE_ALL 1
+#include "xxhash.h"
 
 //------------------------------------------------------------------
 // Micro VU - Main Functions
@@ -80,6 +89,9 @@ void mVUreset(microVU& mVU, bool resetReserve)
 		mVU.prog.quick[i].block = NULL;
 		mVU.prog.quick[i].prog = NULL;
 	}
+
+	mVU.progHash.index.clear();
+	mVUinvalidateProgHash(mVU);
 }
 
 // Free Allocated Resources
@@ -97,11 +109,21 @@ void mVUclose(microVU& mVU)
 		}
 		safe_delete(mVU.prog.prog[i]);
 	}
+	mVU.progHash.index.clear();
 }
 
 // Clears Block Data in specified range
 __fi void mVUclear(mV, u32 addr, u32 size)
 {
+	if (size > 0)
+	{
+		const u32 numChunks = mVU.microMemSize / microProgHash::chunkSize;
+		const u32 first = addr / microProgHash::chunkSize;
+		const u32 last = (addr + size - 1) / microProgHash::chunkSize;
+		for (u32 i = first; i <= last; i++)
+			mVU.progHash.dirty |= 1ULL << (i & (numChunks - 1));
+	}
+
 	if (!mVU.prog.cleared)
 	{
 		mVU.prog.cleared = 1; // Next execution searches/creates a new microprogram
@@ -214,11 +236,37 @@ void mVUprintUniqueRatio(microVU& mVU)
 	DevCon.WriteLn("%d / %d [%3.1f%%]", v.size(), total, 100. - (double)v.size() / (double)total * 100.);
 }
 
+// Forces the whole of micro memory to be rehashed on the next search
+void mVUinvalidateProgHash(microVU& mVU)
+{
+	std::memset(mVU.progHash.chunk, 0, sizeof(mVU.progHash.chunk));
+	mVU.progHash.value = 0;
+	mVU.progHash.dirty = (mVU.microMemSize / microProgHash::chunkSize == 64) ?
+		~0ULL : ((1ULL << (mVU.microMemSize / microProgHash::chunkSize)) - 1);
+}
+
+// Rehashes dirty chunks of micro memory and returns the index key for the current startPC
+static u64 mVUprogHashKey(microVU& mVU, u32 startPC)
+{
+	microProgHash& hash = mVU.progHash;
+	for (u64 dirty = hash.dirty; dirty != 0; dirty &= dirty - 1)
+	{
+		const u32 i = static_cast<u32>(std::countr_zero(dirty));
+		const u64 chunk = XXH3_64bits_withSeed(mVU.regs().Micro + i * microProgHash::chunkSize, microProgHash::chunkSize, i);
+		hash.value ^= hash.chunk[i] ^ chunk;
+		hash.chunk[i] = chunk;
+	}
+	hash.dirty = 0;
+
+	return hash.value + static_cast<u64>(startPC) * 0x9E3779B97F4A7C15ULL;
+}
+
 // Compare Cached microProgram to mVU.regs().Micro
 __fi bool mVUcmpProg(microVU& mVU, microProgram& prog)
 {
 	if (doWholeProgCompare)
 	{
+		mVU.profiler.SearchCompare(mVU.microMemSize);
 		if (memcmp((u8*)prog.data, mVU.regs().Micro, mVU.microMemSize))
 			return false;
 	}
@@ -232,6 +280,7 @@ __fi bool mVUcmpProg(microVU& mVU, microProgram& prog)
 #endif
 			auto cmpOffset = [&](void* x) { return (u8*)x + range.start; };
 
+			mVU.profiler.SearchCompare(range.end - range.start);
 			if (memcmp(cmpOffset(prog.data), cmpOffset(mVU.regs().Micro), (range.end - range.start)))
 				return false;
 		}
@@ -242,19 +291,34 @@ __fi bool mVUcmpProg(microVU& mVU, microProgram& prog)
 	return true;
 }
 
-// Searches for Cached Micro Program and sets prog.cur to it (returns entry-point to program)
-_mVUt __fi void* mVUsearchProg(u32 startPC, uptr pState)
+// Searches for Cached Micro Program started at progPC and sets prog.cur to it (returns entry-point to program)
+_mVUt static void* mVUsearchProgFrom(u32 progPC, u32 startPC, uptr pState)
 {
 	microVU& mVU = mVUx;
-	microProgramQuick& quick = mVU.prog.quick[mVU.regs().start_pc / 8];
-	microProgramList*  list  = mVU.prog.prog [mVU.regs().start_pc / 8];
+	microProgramQuick& quick = mVU.prog.quick[progPC / 8];
+	microProgramList*  list  = mVU.prog.prog [progPC / 8];
 
 	if (!quick.prog) // If null, we need to search for new program
 	{
+		// Micro memory usually has exactly the same contents as the last time this program ran,
+		// so try the program which matched then first, and only scan the list if it doesn't match.
+		const u64 hashKey = mVUprogHashKey(mVU, progPC);
+		const auto indexed = mVU.progHash.index.find(hashKey);
+		microProgram* const indexedProg = (indexed != mVU.progHash.index.end()) ? indexed->second : nullptr;
+		const bool indexedMatch = indexedProg && mVUcmpProg(mVU, *indexedProg);
+		if (indexedMatch)
+			mVU.profiler.SearchHit();
+		else
+			mVU.profiler.SearchMiss();
+
 		std::deque<microProgram*>::iterator it(list->begin());
 		for (; it != list->end(); ++it)
 		{
-			bool b = mVUcmpProg(mVU, *it[0]);
+			bool b;
+			if (indexedMatch)
+				b = (it[0] == indexedProg); // Already confirmed, just find its position in the list
+			else
+				b = (it[0] != indexedProg) && mVUcmpProg(mVU, *it[0]);
 
 			if (b)
 			{
@@ -262,6 +326,7 @@ _mVUt __fi void* mVUsearchProg(u32 startPC, uptr pState)
 				quick.prog  = it[0];
 				list->erase(it);
 				list->push_front(quick.prog);
+				mVU.progHash.index[hashKey] = quick.prog;
 
 				// Sanity check, in case for some reason the program compilation aborted half way through (JALR for example)
 				if (quick.block == nullptr)
@@ -276,11 +341,12 @@ _mVUt __fi void* mVUsearchProg(u32 startPC, uptr pState)
 		// If cleared and program not found, make a new program instance
 		mVU.prog.cleared = 0;
 		mVU.prog.isSame  = 1;
-		mVU.prog.cur     = mVUcreateProg(mVU, mVU.regs().start_pc/8);
+		mVU.prog.cur     = mVUcreateProg(mVU, progPC/8);
 		void* entryPoint = mVUblockFetch(mVU,  startPC, pState);
 		quick.block      = mVU.prog.cur->block[startPC/8];
 		quick.prog       = mVU.prog.cur;
 		list->push_front(mVU.prog.cur);
+		mVU.progHash.index[hashKey] = mVU.prog.cur;
 		//mVUprintUniqueRatio(mVU);
 		return entryPoint;
 	}
@@ -301,6 +367,233 @@ _mVUt __fi void* mVUsearchProg(u32 startPC, uptr pState)
 	return mVUentryGet(mVU, quick.block, startPC, pState);
 }
 
+// Searches for Cached Micro Program and sets prog.cur to it (returns entry-point to program)
+_mVUt __fi void* mVUsearchProg(u32 startPC, uptr pState)
+{
+	return mVUsearchProgFrom<vuIndex>(mVUx.regs().start_pc, startPC, pState);
+}
+
+//------------------------------------------------------------------
+// VU1 Background Compilation
+//------------------------------------------------------------------
+// When EnableVU1AsyncCompile is set (and MTVU is off), a VU1 program which isn't in the cache
+// yet is run on the interpreter, while a worker thread compiles it for the next time it runs.
+// The worker owns microVU1 while a job is in flight, so the EE thread only runs the interpreter
+// until it's done, and waits for it before micro memory is written or the cache is reset.
+
+static Threading::Thread s_vu1CompileThread;
+static Threading::WorkSema s_vu1CompileSema;
+static std::atomic<bool> s_vu1CompileBusy{false};
+static std::atomic<bool> s_vu1CompileShutdown{false};
+alignas(16) static microRegInfo s_vu1CompileState; // Pipeline state the queued program is compiled for
+static u32 s_vu1CompileStartPC = 0;
+
+static bool s_vu1InterpRunning = false; // A program is running on the interpreter
+static bool s_vu1RecRunning = false; // A program is running on the recompiler
+
+// Stats, reported on reset/shutdown
+static u32 s_vu1InterpPrograms = 0;
+static u32 s_vu1AsyncCompiles = 0;
+static u64 s_vu1AsyncCompileTicks = 0;
+static u64 s_vu1AsyncCompileMaxTicks = 0;
+
+// EE thread stalls on VU1 compiles: rec executions which compiled something, and waits for the compile thread.
+// Compare a run with EnableVU1AsyncCompile against one without to see the hitches it removes.
+static u32 s_vu1Stalls = 0;
+static u64 s_vu1StallTicks = 0;
+static u64 s_vu1StallMaxTicks = 0;
+
+static void mVUaddStall(u64 ticks)
+{
+	s_vu1Stalls++;
+	s_vu1StallTicks += ticks;
+	s_vu1StallMaxTicks = std::max(s_vu1StallMaxTicks, ticks);
+}
+
+// Converts a status flag to the layout microVU keeps its flag instances in (see mVUallocSFLAGd())
+static __fi u32 mVUdenormalizeStatus(u32 status)
+{
+	return ((status >> 3) & 0x18u) | ((status << 11) & 0x1800u) | ((status << 14) & 0x3cf0000u);
+}
+
+static void mVUasyncCompileThread()
+{
+	Threading::SetNameOfCurrentThread("microVU1 Compile");
+
+	for (;;)
+	{
+		s_vu1CompileSema.WaitForWork();
+		if (s_vu1CompileShutdown.load(std::memory_order_acquire))
+			break;
+		if (!s_vu1CompileBusy.load(std::memory_order_acquire))
+			continue;
+
+		microVU& mVU = microVU1;
+		const Common::Timer::Value start = Common::Timer::GetCurrentValue();
+
+		xSetPtr(mVU.prog.x86ptr);
+		mVUsearchProgFrom<1>(s_vu1CompileStartPC, s_vu1CompileStartPC, (uptr)&s_vu1CompileState);
+		mVU.prog.x86ptr = x86Ptr;
+
+		if ((xGetPtr() < mVU.prog.x86start) || (xGetPtr() >= mVU.prog.x86end))
+		{
+			Console.WriteLn(Color_Orange, "microVU1: Program cache limit reached.");
+			mVUreset(mVU, false);
+		}
+
+		const u64 ticks = Common::Timer::GetCurrentValue() - start;
+		s_vu1AsyncCompileTicks += ticks;
+		s_vu1AsyncCompileMaxTicks = std::max(s_vu1AsyncCompileMaxTicks, ticks);
+		s_vu1AsyncCompiles++;
+
+		s_vu1CompileBusy.store(false, std::memory_order_release);
+	}
+
+	s_vu1CompileSema.Kill();
+}
+
+// Waits for the compile thread to finish its job, handing microVU1 back to the EE thread
+static void mVUasyncWait()
+{
+	if (s_vu1CompileBusy.load(std::memory_order_acquire))
+	{
+		const Common::Timer::Value start = Common::Timer::GetCurrentValue();
+		s_vu1CompileSema.WaitForEmpty();
+		mVUaddStall(Common::Timer::GetCurrentValue() - start);
+	}
+}
+
+static void mVUasyncShutdown()
+{
+	if (!s_vu1CompileThread.Joinable())
+		return;
+
+	s_vu1CompileShutdown.store(true, std::memory_order_release);
+	s_vu1CompileSema.NotifyOfWork();
+	s_vu1CompileThread.Join();
+	s_vu1CompileBusy.store(false, std::memory_order_relaxed);
+}
+
+static void mVUasyncQueue(microVU& mVU, u32 startPC)
+{
+	if (!s_vu1CompileThread.Joinable())
+	{
+		s_vu1CompileSema.Reset();
+		s_vu1CompileShutdown.store(false, std::memory_order_relaxed);
+		s_vu1CompileThread.SetStackSize(VMManager::EMU_THREAD_STACK_SIZE);
+		s_vu1CompileThread.Start(mVUasyncCompileThread);
+	}
+
+	// Compiled for the pipeline state the program is being started with, so it's found the next time
+	// it's started the same way.
+	std::memcpy(&s_vu1CompileState, &mVU.prog.lpState, sizeof(s_vu1CompileState));
+	s_vu1CompileStartPC = startPC;
+	s_vu1CompileBusy.store(true, std::memory_order_release);
+	s_vu1CompileSema.NotifyOfWork();
+}
+
+static void mVUasyncPrintStats()
+{
+	if (s_vu1InterpPrograms)
+	{
+		DevCon.WriteLn(Color_Orange, "microVU1: %u programs interpreted while compiling, %u compiled in background "
+			"(%.2f ms total, longest %.2f ms)", s_vu1InterpPrograms, s_vu1AsyncCompiles,
+			Common::Timer::ConvertValueToMilliseconds(s_vu1AsyncCompileTicks),
+			Common::Timer::ConvertValueToMilliseconds(s_vu1AsyncCompileMaxTicks));
+	}
+	if (s_vu1Stalls)
+	{
+		DevCon.WriteLn(Color_Orange, "microVU1: %u EE thread stalls on compiles (%.2f ms total, longest %.2f ms)",
+			s_vu1Stalls, Common::Timer::ConvertValueToMilliseconds(s_vu1StallTicks),
+			Common::Timer::ConvertValueToMilliseconds(s_vu1StallMaxTicks));
+	}
+	s_vu1InterpPrograms = 0;
+	s_vu1AsyncCompiles = 0;
+	s_vu1AsyncCompileTicks = 0;
+	s_vu1AsyncCompileMaxTicks = 0;
+	s_vu1Stalls = 0;
+	s_vu1StallTicks = 0;
+	s_vu1StallMaxTicks = 0;
+}
+
+// Checks if the program at startPC is compiled for pState, without compiling anything
+static bool mVUisProgCached(microVU& mVU, u32 startPC, microRegInfo* pState)
+{
+	microProgram* prog = mVU.prog.quick[mVU.regs().start_pc / 8].prog;
+	if (!prog)
+	{
+		const auto indexed = mVU.progHash.index.find(mVUprogHashKey(mVU, mVU.regs().start_pc));
+		if (indexed == mVU.progHash.index.end() || !mVUcmpProg(mVU, *indexed->second))
+			return false;
+		prog = indexed->second;
+	}
+
+	microBlockManager* block = prog->block[startPC / 8];
+	return block && block->search(mVU, pState);
+}
+
+// Hands the flags and P/Q back to the rec the way it leaves them on an E-bit
+static void mVUasyncInterpDone(microVU& mVU)
+{
+	for (u32 i = 0; i < 4; i++)
+	{
+		VU1.micro_statusflags[i] = mVUdenormalizeStatus(VU1.VI[REG_STATUS_FLAG].UL);
+		VU1.micro_macflags[i] = VU1.VI[REG_MAC_FLAG].UL;
+		VU1.micro_clipflags[i] = VU1.VI[REG_CLIP_FLAG].UL;
+	}
+	VU1.pending_q = VU1.VI[REG_Q].UL;
+	VU1.pending_p = VU1.VI[REG_P].UL;
+	std::memset(&mVU.prog.lpState, 0, sizeof(mVU.prog.lpState));
+	s_vu1InterpRunning = false;
+}
+
+// Runs VU1 on the interpreter if the current program isn't compiled yet, queueing it for the
+// compile thread.  Returns false if the recompiler should run it instead.
+static bool mVUasyncExecuteVU1(u32 cycles)
+{
+	microVU& mVU = microVU1;
+
+	if (!s_vu1InterpRunning)
+	{
+		if (!EmuConfig.Cpu.Recompiler.EnableVU1AsyncCompile || s_vu1RecRunning)
+			return false;
+
+		const u32 startPC = (VU1.VI[REG_TPC].UL << 3) & (mVU.microMemSize - 8);
+		const bool busy = s_vu1CompileBusy.load(std::memory_order_acquire);
+		if (!busy)
+		{
+			if (mVUisProgCached(mVU, startPC, &mVU.prog.lpState))
+				return false;
+
+			// Only compile for the program start, mid-program entries are compiled as the program runs.
+			if (startPC == VU1.start_pc)
+				mVUasyncQueue(mVU, startPC);
+		}
+
+		// Results still in flight in the rec's pipeline land now, the interpreter starts with empty pipes.
+		if (mVU.prog.lpState.q)
+			VU1.VI[REG_Q].UL = VU1.pending_q;
+		if (mVU.prog.lpState.p)
+			VU1.VI[REG_P].UL = VU1.pending_p;
+		VU1.statusflag = VU1.VI[REG_STATUS_FLAG].UL;
+		VU1.macflag = VU1.VI[REG_MAC_FLAG].UL;
+		VU1.clipflag = VU1.VI[REG_CLIP_FLAG].UL;
+		VU1.fdiv.enable = 0;
+		VU1.efu.enable = 0;
+		CpuIntVU1.ResetPipelines();
+
+		s_vu1InterpRunning = true;
+		s_vu1InterpPrograms++;
+	}
+
+	CpuIntVU1.Execute(cycles);
+
+	if (!(VU0.VI[REG_VPU_STAT].UL & 0x100))
+		mVUasyncInterpDone(mVU);
+
+	return true;
+}
+
 //------------------------------------------------------------------
 // recMicroVU0 / recMicroVU1
 //------------------------------------------------------------------
@@ -329,6 +622,8 @@ void recMicroVU1::Shutdown()
 {
 	if (vu1Thread.IsOpen())
 		vu1Thread.WaitVU();
+	mVUasyncShutdown();
+	mVUasyncPrintStats();
 	mVUclose(microVU1);
 }
 
@@ -345,6 +640,8 @@ void recMicroVU1::Reset()
 {
 	vu1Thread.WaitVU();
 	vu1Thread.Get_MTVUChanges();
+	mVUasyncWait();
+	mVUasyncPrintStats();
 	mVUreset(microVU1, true);
 }
 
@@ -385,10 +682,18 @@ void recMicroVU1::Execute(u32 cycles)
 	{
 		if (!(VU0.VI[REG_VPU_STAT].UL & 0x100))
 			return;
+		if (mVUasyncExecuteVU1(cycles))
+			return;
 	}
+	// Anything compiled moves the code pointer, the execution it happened in counts as a stall.
+	const u8* const x86ptr = microVU1.prog.x86ptr;
+	const Common::Timer::Value start = THREAD_VU1 ? 0 : Common::Timer::GetCurrentValue();
 	VU1.VI[REG_TPC].UL <<= 3;
 	((mVUrecCall)microVU1.startFunct)(VU1.VI[REG_TPC].UL, cycles);
 	VU1.VI[REG_TPC].UL >>= 3;
+	if (!THREAD_VU1 && microVU1.prog.x86ptr != x86ptr)
+		mVUaddStall(Common::Timer::GetCurrentValue() - start);
+	s_vu1RecRunning = !THREAD_VU1 && (VU0.VI[REG_VPU_STAT].UL & 0x100);
 	if (microVU1.regs().flags & 0x4 && !THREAD_VU1)
 	{
 		microVU1.regs().flags &= ~0x4;
@@ -402,6 +707,7 @@ void recMicroVU0::Clear(u32 addr, u32 size)
 }
 void recMicroVU1::Clear(u32 addr, u32 size)
 {
+	mVUasyncWait();
 	mVUclear(microVU1, addr, size);
 }
 
@@ -416,9 +722,27 @@ bool SaveStateBase::vuJITFreeze()
 {
 	if (IsSaving())
 		vu1Thread.WaitVU();
+	mVUasyncWait();
 
 	Freeze(microVU0.prog.lpState);
 	Freeze(microVU1.prog.lpState);
+
+	// A program running on the interpreter carries on there after loading, since its pipelines are
+	// in the interpreter's registers rather than in lpState.
+	Freeze(s_vu1InterpRunning);
+
+	if (IsLoading())
+	{
+		// MTVU only runs the rec.
+		if (s_vu1InterpRunning && THREAD_VU1)
+			mVUasyncInterpDone(microVU1);
+		s_vu1RecRunning = !s_vu1InterpRunning && !THREAD_VU1 && (VU0.VI[REG_VPU_STAT].UL & 0x100);
+
+		// Micro memory was replaced without going through mVUclear().
+		mVUinvalidateProgHash(microVU0);
+		mVUinvalidateProgHash(microVU1);
+	}
+
 	return IsOkay();
 }
 
@@ -9,6 +9,7 @@
 #include <deque>
 #include <algorithm>
 #include <memory>
+#include <unordered_map>
 #include "Common.h"
 #include "VU.h"
 #include "MTVU.h"
@@ -76,6 +77,21 @@ struct microProgManager
 	microRegInfo       lpState;            // Pipeline state from where program left off (useful for continuing execution)
 };
 
+// Content hash of VU micro memory, kept per chunk so that only the chunks which have been
+// written since the last search need to be rehashed. Used to find previously seen programs
+// without comparing against every cached program for the current startPC.
+struct microProgHash
+{
+	static constexpr u32 chunkSize = 0x100;
+	static constexpr u32 maxChunks = 0x4000 / chunkSize;
+	static_assert(maxChunks <= 64, "Dirty mask is too small");
+
+	u64 chunk[maxChunks];                          // Hash of each chunk of micro memory
+	u64 dirty;                                     // Chunks written since they were last hashed
+	u64 value;                                     // Combined hash of all chunks
+	std::unordered_map<u64, microProgram*> index;  // (Memory hash, startPC) -> last matching microProgram
+};
+
 static const uint mVUcacheSafeZone =  3; // Safe-Zone for program recompilation (in megabytes)
 
 struct microVU
@@ -96,6 +112,7 @@ struct microVU
 	u32 cacheSize;    // VU Cache Size
 
 	microProgManager               prog;     // Micro Program Data
+	microProgHash                  progHash; // Micro Memory Hash / Program Index
 	microProfiler                  profiler; // Opcode Profiler
 	std::unique_ptr<microRegAlloc> regAlloc; // Reg Alloc Class
 	std::FILE*                     logFile;  // Log File Pointer
@@ -288,6 +305,7 @@ mVUop(mVUopL);
 // Private Functions
 extern void mVUcacheProg(microVU& mVU, microProgram& prog);
 extern void mVUdeleteProg(microVU& mVU, microProgram*& prog);
+extern void mVUinvalidateProgHash(microVU& mVU);
 _mVUt extern void* mVUsearchProg(u32 startPC, uptr pState);
 extern void* mVUexecuteVU0(u32 startPC, u32 cycles);
 extern void* mVUexecuteVU1(u32 startPC, u32 cycles);
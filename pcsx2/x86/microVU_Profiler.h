@@ -92,6 +92,9 @@ struct microProfiler
 {
 	static const u32 progLimit = 10000;
 	u64 opStats[opLastOpcode];
+	u64 searchHits;     // Program searches resolved through the hash index
+	u64 searchMisses;   // Program searches which had to scan the program list
+	u64 searchCmpBytes; // Bytes of micro memory compared while searching
 	u32 progCount;
 	int index;
 	void Reset(int _index)
@@ -104,6 +107,9 @@ struct microProfiler
 		xADD(ptr32[&(((u32*)opStats)[op * 2 + 0])], 1);
 		xADC(ptr32[&(((u32*)opStats)[op * 2 + 1])], 0);
 	}
+	void SearchHit() { searchHits++; }
+	void SearchMiss() { searchMisses++; }
+	void SearchCompare(u32 bytes) { searchCmpBytes += bytes; }
 	void Print()
 	{
 		progCount++;
@@ -129,7 +135,9 @@ struct microProfiler
 				DevCon.WriteLn("%s - [%3.4f%%][count=%u]",
 					str.c_str(), stat, (u32)count);
 			}
-			DevCon.WriteLn("Total = 0x%x%x\n\n", (u32)(u64)(total >> 32), (u32)total);
+			DevCon.WriteLn("Total = 0x%x%x", (u32)(u64)(total >> 32), (u32)total);
+			DevCon.WriteLn("Program search: hits = %u, misses = %u, compared = %u kb\n\n",
+				(u32)searchHits, (u32)searchMisses, (u32)(searchCmpBytes / _1kb));
 		}
 	}
 };
@@ -138,6 +146,9 @@ struct microProfiler
 {
 	__fi void Reset(int _index) {}
 	__fi void EmitOp(microOpcode op) {}
+	__fi void SearchHit() {}
+	__fi void SearchMiss() {}
+	__fi void SearchCompare(u32 bytes) {}
 	__fi void Print() {}
 };
 #endif
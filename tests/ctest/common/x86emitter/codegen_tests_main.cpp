@@ -118,6 +118,11 @@ TEST(CodegenTests, MathTest)
 	CODEGEN_TEST(xDIV(ecx), "f7 f9");
 }
 
+TEST(CodegenTests, MiscTest)
+{
+	CODEGEN_TEST(xRDTSC(), "0f 31");
+}
+
 TEST(CodegenTests, BitwiseTest)
 {
 	CODEGEN_TEST(xSHR(r8, cl), "49 d3 e8");
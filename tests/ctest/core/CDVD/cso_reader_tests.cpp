@@ -0,0 +1,252 @@
+// SPDX-FileCopyrightText: 2002-2024 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#include "benchmark_utils.h"
+#include "pcsx2/CDVD/CsoFileReader.h"
+#include "pcsx2/CDVD/GzippedFileReader.h"
+#include "pcsx2/Host.h"
+#include "common/FileSystem.h"
+#include "common/MemorySettingsInterface.h"
+
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include <cstring>
+#include <vector>
+
+static constexpr u32 SECTOR_SIZE = 2048;
+static constexpr u32 SECTOR_COUNT = 16384; // 32MB
+
+/// Fill sectors with data that compresses somewhat, like a real disc: runs of text and noise
+static std::vector<u8> MakeImage()
+{
+	std::vector<u8> image(SECTOR_COUNT * SECTOR_SIZE);
+	BenchmarkUtils::Random rng;
+	for (u32 sector = 0; sector < SECTOR_COUNT; sector++)
+	{
+		u8* data = &image[sector * SECTOR_SIZE];
+		for (u32 i = 0; i < SECTOR_SIZE; i++)
+			data[i] = (i & 0x100) ? rng.NextU8() : static_cast<u8>("SLUS_123.45;1 "[i % 14] + (sector & 7));
+	}
+	return image;
+}
+
+/// Write a CSOv1 file with one raw deflate frame per sector
+static bool WriteCso(const std::string& path, const std::vector<u8>& image)
+{
+	std::vector<u32> index(SECTOR_COUNT + 1);
+	std::vector<u8> frames;
+	const u32 header_size = 24;
+	u32 pos = header_size + static_cast<u32>(index.size() * sizeof(u32));
+
+	std::vector<u8> out(compressBound(SECTOR_SIZE));
+	for (u32 sector = 0; sector < SECTOR_COUNT; sector++)
+	{
+		z_stream z = {};
+		if (deflateInit2(&z, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+			return false;
+		z.next_in = const_cast<Bytef*>(&image[sector * SECTOR_SIZE]);
+		z.avail_in = SECTOR_SIZE;
+		z.next_out = out.data();
+		z.avail_out = static_cast<uInt>(out.size());
+		const int status = deflate(&z, Z_FINISH);
+		const u32 size = static_cast<u32>(z.total_out);
+		deflateEnd(&z);
+		if (status != Z_STREAM_END)
+			return false;
+
+		index[sector] = pos;
+		if (size >= SECTOR_SIZE)
+		{
+			// Store frames that don't shrink uncompressed, like maxcso does
+			index[sector] |= 0x80000000;
+			frames.insert(frames.end(), &image[sector * SECTOR_SIZE], &image[(sector + 1) * SECTOR_SIZE]);
+			pos += SECTOR_SIZE;
+		}
+		else
+		{
+			frames.insert(frames.end(), out.data(), out.data() + size);
+			pos += size;
+		}
+	}
+	index[SECTOR_COUNT] = pos;
+
+	u8 header[header_size] = {'C', 'I', 'S', 'O'};
+	const u64 total_bytes = image.size();
+	const u32 frame_size = SECTOR_SIZE;
+	std::memcpy(&header[4], &header_size, sizeof(header_size));
+	std::memcpy(&header[8], &total_bytes, sizeof(total_bytes));
+	std::memcpy(&header[16], &frame_size, sizeof(frame_size));
+	header[20] = 1; // ver
+
+	auto fp = FileSystem::OpenManagedCFile(path.c_str(), "wb");
+	return fp && std::fwrite(header, sizeof(header), 1, fp.get()) == 1 &&
+		   std::fwrite(index.data(), sizeof(u32), index.size(), fp.get()) == index.size() &&
+		   std::fwrite(frames.data(), 1, frames.size(), fp.get()) == frames.size();
+}
+
+/// Write the image as a single gzip member, the way `gzip` does
+static bool WriteGzip(const std::string& path, const std::vector<u8>& image)
+{
+	z_stream z = {};
+	if (deflateInit2(&z, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+		return false;
+
+	std::vector<u8> out(deflateBound(&z, static_cast<uLong>(image.size())));
+	z.next_in = const_cast<Bytef*>(image.data());
+	z.avail_in = static_cast<uInt>(image.size());
+	z.next_out = out.data();
+	z.avail_out = static_cast<uInt>(out.size());
+	const int status = deflate(&z, Z_FINISH);
+	const size_t size = z.total_out;
+	deflateEnd(&z);
+
+	return status == Z_STREAM_END && FileSystem::WriteBinaryFile(path.c_str(), out.data(), size);
+}
+
+/// The image is written once per suite, as both a CSO and a gzip file
+class CsoFileReaderTest : public BenchmarkUtils::TempDirectoryTest<CsoFileReaderTest>
+{
+public:
+	static constexpr const char* TEMP_PREFIX = "pcsx2_cso_reader_test";
+
+	static bool WriteFiles(const BenchmarkUtils::TempDirectory& dir)
+	{
+		// The gzip reader looks up where to keep its index in the settings, the default puts it next to the image.
+		static MemorySettingsInterface s_settings;
+		if (!Host::Internal::GetBaseSettingsLayer())
+			Host::Internal::SetBaseSettingsLayer(&s_settings);
+
+		s_image = MakeImage();
+		s_path = dir.Combine("test.cso");
+		s_gz_path = dir.Combine("test.gz");
+		return WriteCso(s_path, s_image) && WriteGzip(s_gz_path, s_image);
+	}
+
+	static void ReleaseFiles()
+	{
+		s_path = {};
+		s_gz_path = {};
+		s_image = {};
+	}
+
+protected:
+	static void CheckSequentialReads(ThreadedFileReader& reader);
+	static void CheckRandomReads(ThreadedFileReader& reader);
+
+	static std::string s_path;
+	static std::string s_gz_path;
+	static std::vector<u8> s_image;
+};
+
+std::string CsoFileReaderTest::s_path;
+std::string CsoFileReaderTest::s_gz_path;
+std::vector<u8> CsoFileReaderTest::s_image;
+
+class CsoFileReaderBenchmark : public CsoFileReaderTest
+{
+};
+
+/// Reads the size of a typical DVD streaming request, so readahead gets to overlap with them
+static constexpr u32 SECTORS_PER_READ = 32;
+
+void CsoFileReaderTest::CheckSequentialReads(ThreadedFileReader& reader)
+{
+	ASSERT_EQ(reader.GetBlockCount(), SECTOR_COUNT);
+
+	std::vector<u8> buffer(SECTORS_PER_READ * SECTOR_SIZE);
+	for (u32 sector = 0; sector < SECTOR_COUNT; sector += SECTORS_PER_READ)
+	{
+		ASSERT_EQ(reader.ReadSync(buffer.data(), sector, SECTORS_PER_READ), static_cast<int>(buffer.size()));
+		ASSERT_EQ(std::memcmp(buffer.data(), &s_image[sector * SECTOR_SIZE], buffer.size()), 0)
+			<< "Mismatch in sectors " << sector << " to " << sector + SECTORS_PER_READ - 1;
+	}
+}
+
+void CsoFileReaderTest::CheckRandomReads(ThreadedFileReader& reader)
+{
+	std::vector<u8> buffer(16 * SECTOR_SIZE);
+	BenchmarkUtils::Random rng(1);
+	for (u32 i = 0; i < 256; i++)
+	{
+		const u32 count = 1 + rng.NextBelow(16);
+		const u32 sector = rng.NextBelow(SECTOR_COUNT - count);
+		ASSERT_EQ(reader.ReadSync(buffer.data(), sector, count), static_cast<int>(count * SECTOR_SIZE));
+		ASSERT_EQ(std::memcmp(buffer.data(), &s_image[sector * SECTOR_SIZE], count * SECTOR_SIZE), 0) << "sector " << sector;
+	}
+}
+
+TEST_F(CsoFileReaderTest, SequentialReadMatchesSource)
+{
+	CsoFileReader reader;
+	ASSERT_TRUE(reader.Open(s_path, nullptr));
+	CheckSequentialReads(reader);
+	reader.Close();
+}
+
+TEST_F(CsoFileReaderTest, RandomReadMatchesSource)
+{
+	CsoFileReader reader;
+	ASSERT_TRUE(reader.Open(s_path, nullptr));
+	CheckRandomReads(reader);
+	reader.Close();
+}
+
+/// The first open builds the index from the whole file, the second reads it back from disk.
+TEST_F(CsoFileReaderTest, GzipSequentialReadMatchesSource)
+{
+	for (u32 pass = 0; pass < 2; pass++)
+	{
+		SCOPED_TRACE(pass == 0 ? "new index" : "saved index");
+		GzippedFileReader reader;
+		ASSERT_TRUE(reader.Open(s_gz_path, nullptr));
+		CheckSequentialReads(reader);
+		reader.Close();
+	}
+}
+
+TEST_F(CsoFileReaderTest, GzipRandomReadMatchesSource)
+{
+	GzippedFileReader reader;
+	ASSERT_TRUE(reader.Open(s_gz_path, nullptr));
+	CheckRandomReads(reader);
+	reader.Close();
+}
+
+/// Sequential throughput from a freshly opened reader, so every pass starts with a cold cache.
+template <typename Reader>
+static void SequentialReadBenchmark(const char* group, const std::string& path, size_t image_size)
+{
+	std::vector<u8> buffer(SECTORS_PER_READ * SECTOR_SIZE);
+	ThreadedFileReader::CacheStats stats = {};
+	const double passes_per_second = BenchmarkUtils::CallsPerSecond(1.0, 1, [&](u32) {
+		Reader reader;
+		ASSERT_TRUE(reader.Open(path, nullptr));
+		for (u32 sector = 0; sector < SECTOR_COUNT; sector += SECTORS_PER_READ)
+			reader.ReadSync(buffer.data(), sector, SECTORS_PER_READ);
+		stats = reader.GetCacheStats();
+		reader.Close();
+	});
+
+	BenchmarkUtils::Result()
+		.Add("group", group)
+		.Add("kernel", "ReadSync")
+		.Add("variant", "sequential")
+		.Add("mbps", passes_per_second * image_size / (1024.0 * 1024.0))
+		.Add("hits", stats.hits)
+		.Add("misses", stats.misses)
+		.Add("chunks_read_ahead", stats.chunksReadAhead)
+		.Add("parallel_fills", stats.parallelFills)
+		.Print();
+}
+
+TEST_F(CsoFileReaderBenchmark, DISABLED_SequentialRead)
+{
+	SequentialReadBenchmark<CsoFileReader>("CsoFileReader", s_path, s_image.size());
+}
+
+/// The index is built on the first open, which is the warm up pass.
+TEST_F(CsoFileReaderBenchmark, DISABLED_GzipSequentialRead)
+{
+	SequentialReadBenchmark<GzippedFileReader>("GzippedFileReader", s_gz_path, s_image.size());
+}
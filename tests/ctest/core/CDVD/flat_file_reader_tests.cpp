@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2002-2024 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#include "benchmark_utils.h"
+#include "pcsx2/CDVD/FlatFileReader.h"
+#include "common/FileSystem.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+static constexpr u32 SECTOR_SIZE = 2048;
+static constexpr u32 SECTOR_COUNT = 4096; // 8MB
+
+static std::vector<u8> MakeImage()
+{
+	std::vector<u8> image(SECTOR_COUNT * SECTOR_SIZE);
+	BenchmarkUtils::Random rng;
+	for (u8& b : image)
+		b = rng.NextU8();
+	return image;
+}
+
+/// The image is written once per suite
+class FlatFileReaderTest : public BenchmarkUtils::TempDirectoryTest<FlatFileReaderTest>
+{
+public:
+	static constexpr const char* TEMP_PREFIX = "pcsx2_flat_file_reader_test";
+
+	static bool WriteFiles(const BenchmarkUtils::TempDirectory& dir)
+	{
+		s_image = MakeImage();
+		s_path = dir.Combine("test.iso");
+		return FileSystem::WriteBinaryFile(s_path.c_str(), s_image.data(), s_image.size());
+	}
+
+	static void ReleaseFiles()
+	{
+		s_path = {};
+		s_image = {};
+	}
+
+protected:
+	static void CheckRandomReads(FlatFileReader& reader)
+	{
+		std::vector<u8> buffer(16 * SECTOR_SIZE);
+		BenchmarkUtils::Random rng(1);
+		for (u32 i = 0; i < 256; i++)
+		{
+			const u32 count = 1 + rng.NextBelow(16);
+			const u32 sector = rng.NextBelow(SECTOR_COUNT - count);
+			ASSERT_EQ(reader.ReadSync(buffer.data(), sector, count), static_cast<int>(count * SECTOR_SIZE));
+			ASSERT_EQ(std::memcmp(buffer.data(), &s_image[sector * SECTOR_SIZE], count * SECTOR_SIZE), 0) << "sector " << sector;
+		}
+	}
+
+	static std::string s_path;
+	static std::vector<u8> s_image;
+};
+
+std::string FlatFileReaderTest::s_path;
+std::vector<u8> FlatFileReaderTest::s_image;
+
+TEST_F(FlatFileReaderTest, MappedReadMatchesSource)
+{
+	FlatFileReader reader;
+	ASSERT_TRUE(reader.Open(s_path, nullptr));
+	ASSERT_EQ(reader.GetBlockCount(), SECTOR_COUNT);
+
+	// Whether the temporary directory gets mapped depends on where it is, the reads have to match either way.
+	const u8* mapped = reader.GetMappedBlock(SECTOR_COUNT / 2);
+	if (mapped)
+		EXPECT_EQ(std::memcmp(mapped, &s_image[(SECTOR_COUNT / 2) * SECTOR_SIZE], SECTOR_SIZE), 0);
+
+	CheckRandomReads(reader);
+	reader.Close();
+}
+
+TEST_F(FlatFileReaderTest, BufferedReadMatchesSource)
+{
+	FlatFileReader reader(false);
+	ASSERT_TRUE(reader.Open(s_path, nullptr));
+	EXPECT_EQ(reader.GetMappedBlock(0), nullptr);
+
+	CheckRandomReads(reader);
+	reader.Close();
+}
+
+TEST_F(FlatFileReaderTest, BufferedReadFailsPastTruncatedEnd)
+{
+	// A mapped read here would be SIGBUS, which is why anything that can go away under us isn't mapped.
+	const std::string path = GetTempDirectory().Combine("truncated.iso");
+	ASSERT_TRUE(FileSystem::WriteBinaryFile(path.c_str(), s_image.data(), s_image.size()));
+
+	FlatFileReader reader(false);
+	ASSERT_TRUE(reader.Open(path, nullptr));
+
+	std::error_code ec;
+	std::filesystem::resize_file(path, s_image.size() / 2, ec);
+	if (ec)
+	{
+		reader.Close();
+		GTEST_SKIP() << "Can't truncate an open file here: " << ec.message();
+	}
+
+	std::vector<u8> buffer(16 * SECTOR_SIZE);
+	EXPECT_EQ(reader.ReadSync(buffer.data(), 0, 16), static_cast<int>(buffer.size()));
+	EXPECT_NE(reader.ReadSync(buffer.data(), SECTOR_COUNT - 16, 16), static_cast<int>(buffer.size()));
+	reader.Close();
+}
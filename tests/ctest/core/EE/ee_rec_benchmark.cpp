@@ -0,0 +1,343 @@
+// SPDX-FileCopyrightText: 2002-2024 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#include "benchmark_utils.h"
+#include "pcsx2/Config.h"
+#include "pcsx2/Counters.h"
+#include "pcsx2/Memory.h"
+#include "pcsx2/R3000A.h"
+#include "pcsx2/R5900.h"
+#include "pcsx2/VUmicro.h"
+#include "pcsx2/vtlb.h"
+#include "pcsx2/x86/R5900_BlockProfiler.h"
+#include "common/Timer.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <initializer_list>
+
+// A loop with a rarely taken forward branch in its body, entered from an instruction just above the loop
+// header. With superblocks, the fall-through is compiled into the loop's block and the branch leaves through
+// a side exit, and the header is split out of the block holding the entry instruction so the backedge links
+// straight to it. With the block profiler, the branch is left alone until both paths have been counted, and
+// the loop's block is formed again once the reform is due.
+//
+// Separately, two overlays of a few thousand short blocks take turns at the same address, the way a game
+// swaps code in and out of one region. Each load writes its overlay over the other one and runs it once.
+// With block reuse, the translations of an overlay that was loaded before are mapped back in instead of
+// being compiled again.
+
+static constexpr u32 ENTRY = 0x00100000;
+static constexpr u32 LOOP = ENTRY + 0x4;
+static constexpr u32 JOIN = LOOP + 0x18;
+static constexpr u32 COLD = JOIN + 0x10;
+
+// Every slice ends at the first event test, which is pushed this far out.
+static constexpr u32 SLICE_CYCLES = 1u << 24;
+
+// Runs past the recompiler's superblock reform delay, about a second of EE time, twice over.
+static constexpr u32 WARMUP_CYCLES = 2 * 294912000;
+
+static constexpr u32 OVERLAY = 0x00200000;
+static constexpr u32 OVERLAY_BLOCKS = 4096;
+static constexpr u32 OVERLAY_BLOCK_SIZE = 0x20;
+static constexpr u32 OVERLAY_PARK = OVERLAY + OVERLAY_BLOCKS * OVERLAY_BLOCK_SIZE;
+static constexpr u32 OVERLAY_SLICE_CYCLES = 1u << 16;
+
+// Alternating loads of the two overlays. The first load of each compiles it with write protected pages, and
+// writing the other overlay over it moves those pages to manual protection, which the blocks compiled before
+// can't be reused under. From the fourth load on, both have been compiled with manual protection.
+static constexpr u32 OVERLAY_LOADS = 12;
+static constexpr u32 OVERLAY_FIRST_WARM_LOAD = 3;
+
+namespace MIPS
+{
+	static constexpr u32 T0 = 8;
+	static constexpr u32 S1 = 17;
+	static constexpr u32 S2 = 18;
+	static constexpr u32 S3 = 19;
+	static constexpr u32 S4 = 20;
+	static constexpr u32 S5 = 21;
+	static constexpr u32 S6 = 22;
+	static constexpr u32 S7 = 23;
+
+	static constexpr u32 NOP = 0;
+	static constexpr u32 ADDIU(u32 rt, u32 rs, u16 imm) { return (011u << 26) | (rs << 21) | (rt << 16) | imm; }
+	static constexpr u32 ANDI(u32 rt, u32 rs, u16 imm) { return (014u << 26) | (rs << 21) | (rt << 16) | imm; }
+	static constexpr u32 ADDU(u32 rd, u32 rs, u32 rt) { return (rs << 21) | (rt << 16) | (rd << 11) | 041u; }
+	static constexpr u32 XOR(u32 rd, u32 rs, u32 rt) { return (rs << 21) | (rt << 16) | (rd << 11) | 046u; }
+	static constexpr u32 BEQ(u32 pc, u32 rs, u32 rt, u32 target) { return (004u << 26) | (rs << 21) | (rt << 16) | (((target - pc - 4) >> 2) & 0xffff); }
+	static constexpr u32 BNE(u32 pc, u32 rs, u32 rt, u32 target) { return (005u << 26) | (rs << 21) | (rt << 16) | (((target - pc - 4) >> 2) & 0xffff); }
+	static constexpr u32 J(u32 target) { return (002u << 26) | ((target >> 2) & 0x3ffffff); }
+} // namespace MIPS
+
+static void WriteCode(u32 addr, std::initializer_list<u32> code)
+{
+	for (const u32 op : code)
+	{
+		memWrite32(addr, op);
+		addr += 4;
+	}
+}
+
+static void WriteLoop()
+{
+	using namespace MIPS;
+
+	WriteCode(ENTRY, {
+		ADDIU(S7, S7, 1),
+	});
+	WriteCode(LOOP, {
+		ADDIU(S1, S1, 1),
+		ANDI(T0, S1, 0xff),
+		BEQ(LOOP + 0x8, T0, 0, COLD),
+		NOP,
+		ADDIU(S2, S2, 3),
+		XOR(S3, S3, S2),
+	});
+	WriteCode(JOIN, {
+		ADDU(S6, S6, S3),
+		BNE(JOIN + 0x4, S7, 0, LOOP),
+		NOP,
+		NOP,
+	});
+	WriteCode(COLD, {
+		ADDIU(S4, S4, 1),
+		J(JOIN),
+		NOP,
+	});
+}
+
+/// Straight-line blocks chained by jumps, ending in a jump to a block that waits for the slice to end.
+static void WriteOverlay(u32 variant)
+{
+	using namespace MIPS;
+
+	for (u32 i = 0; i < OVERLAY_BLOCKS; i++)
+	{
+		const u32 block = OVERLAY + i * OVERLAY_BLOCK_SIZE;
+		const u16 imm = static_cast<u16>(i * 3 + variant * 0x1000 + 1);
+		WriteCode(block, {
+			ADDIU(S1, S1, imm),
+			XOR(S2, S2, S1),
+			ADDU(S3, S3, S2),
+			ADDIU(S4, S4, static_cast<u16>(imm ^ 0x5a5a)),
+			XOR(S5, S5, S4),
+			ADDU(S6, S6, S5),
+			J(block + OVERLAY_BLOCK_SIZE),
+			NOP,
+		});
+	}
+
+	WriteCode(OVERLAY_PARK, {
+		J(OVERLAY_PARK),
+		NOP,
+	});
+}
+
+// The IOP doesn't run, the first event test it gets called from ends the slice.
+static s32 ExitAtEvent(s32 eeCycles)
+{
+	recCpu.ExitExecution();
+	return 0;
+}
+
+static R3000Acpu s_exit_iop = {nullptr, nullptr, ExitAtEvent, nullptr, nullptr};
+static InterpVU0 s_idle_vu0;
+static InterpVU1 s_idle_vu1;
+
+class EERecBenchmark : public ::testing::Test
+{
+protected:
+	static void SetUpTestSuite()
+	{
+		ASSERT_TRUE(SysMemory::Allocate());
+		s_allocated = true;
+
+		s_saved_options = EmuConfig.Cpu.Recompiler;
+		s_saved_psx = psxCpu;
+		s_saved_vu0 = CpuVU0;
+		s_saved_vu1 = CpuVU1;
+		psxCpu = &s_exit_iop;
+		CpuVU0 = &s_idle_vu0;
+		CpuVU1 = &s_idle_vu1;
+
+		recCpu.Reserve();
+		SysMemory::Reset();
+		WriteLoop();
+	}
+
+	static void TearDownTestSuite()
+	{
+		if (!s_allocated)
+			return;
+
+		// Don't let the reset at shutdown write a profile out.
+		EE::BlockProfiler::Clear();
+		recCpu.Shutdown();
+		SysMemory::Release();
+		EmuConfig.Cpu.Recompiler = s_saved_options;
+		psxCpu = s_saved_psx;
+		CpuVU0 = s_saved_vu0;
+		CpuVU1 = s_saved_vu1;
+		s_allocated = false;
+	}
+
+	static void RunSlice(u32 cycles = SLICE_CYCLES)
+	{
+		nextStartCounter = cpuRegs.cycle;
+		nextDeltaCounter = 0x7fffffff;
+		psxNextStartCounter = psxRegs.cycle;
+		psxNextDeltaCounter = 0x7fffffff;
+		psxRegs.iopNextEventCycle = psxRegs.cycle + 0x40000000;
+		EEsCycle = 0;
+		EEoCycle = cpuRegs.cycle;
+		cpuRegs.nextEventCycle = cpuRegs.cycle + cycles;
+		recCpu.Execute();
+	}
+
+	/// Recompiles the loop with the given options, warms it up and runs it for min_seconds, returns nanoseconds per iteration.
+	static double TimeLoop(bool superblocks, bool profiler, double min_seconds)
+	{
+		ResetCpu(superblocks, profiler, false);
+		cpuRegs.pc = ENTRY;
+
+		const u32 warmup_start = cpuRegs.cycle;
+		do
+		{
+			RunSlice();
+		} while ((cpuRegs.cycle - warmup_start) < WARMUP_CYCLES);
+
+		const u32 start_iterations = cpuRegs.GPR.r[MIPS::S1].UL[0];
+
+		Common::Timer timer;
+		double seconds;
+		do
+		{
+			RunSlice();
+			seconds = timer.GetTimeSeconds();
+		} while (seconds < min_seconds);
+
+		const u32 iterations = cpuRegs.GPR.r[MIPS::S1].UL[0] - start_iterations;
+		EXPECT_GT(iterations, 0u) << "loop didn't run, superblocks " << superblocks << ", profiler " << profiler;
+		EXPECT_EQ(cpuRegs.GPR.r[MIPS::S7].UL[0], 1u) << "entered more than once, superblocks " << superblocks << ", profiler " << profiler;
+		EXPECT_NEAR(cpuRegs.GPR.r[MIPS::S4].UL[0], cpuRegs.GPR.r[MIPS::S1].UL[0] >> 8, 1)
+			<< "side exit taken wrongly, superblocks " << superblocks << ", profiler " << profiler;
+		return (iterations != 0) ? (seconds * 1e9 / iterations) : 0.0;
+	}
+
+	static void ResetCpu(bool superblocks, bool profiler, bool reuse)
+	{
+		EE::BlockProfiler::Clear();
+		EmuConfig.Cpu.Recompiler.EnableEESuperblocks = superblocks;
+		EmuConfig.Cpu.Recompiler.EnableEEBlockProfiler = profiler;
+		EmuConfig.Cpu.Recompiler.EnableEEBlockReuse = reuse;
+		recCpu.Reset();
+
+		std::memset(&cpuRegs, 0, sizeof(cpuRegs));
+		std::memset(&psxRegs, 0, sizeof(psxRegs));
+		cpuRegs.CP0.n.Config = 0x440;
+		cpuRegs.CP0.n.Status.val = 0x70400004;
+	}
+
+	struct OverlayLoads
+	{
+		double cold_ms;
+		double warm_ms; // mean over the loads from OVERLAY_FIRST_WARM_LOAD on
+		u32 results[2];
+	};
+
+	/// Loads the two overlays in turn with or without block reuse, timing each load.
+	static OverlayLoads TimeOverlayLoads(bool reuse)
+	{
+		ResetCpu(false, false, reuse);
+		mmap_ResetBlockTracking();
+
+		OverlayLoads loads = {};
+		for (u32 load = 0; load < OVERLAY_LOADS; load++)
+		{
+			const u32 variant = load & 1;
+			WriteOverlay(variant);
+			std::memset(&cpuRegs.GPR, 0, sizeof(cpuRegs.GPR));
+			cpuRegs.pc = OVERLAY;
+
+			Common::Timer timer;
+			do
+			{
+				RunSlice(OVERLAY_SLICE_CYCLES);
+			} while (cpuRegs.pc != OVERLAY_PARK);
+			const double ms = timer.GetTimeMilliseconds();
+
+			const u32 result = cpuRegs.GPR.r[MIPS::S6].UL[0];
+			if (load < 2)
+				loads.results[variant] = result;
+			else
+				EXPECT_EQ(result, loads.results[variant]) << "overlay " << variant << " load " << load << ", reuse " << reuse;
+
+			if (load == 0)
+				loads.cold_ms = ms;
+			else if (load >= OVERLAY_FIRST_WARM_LOAD)
+				loads.warm_ms += ms;
+		}
+
+		loads.warm_ms /= OVERLAY_LOADS - OVERLAY_FIRST_WARM_LOAD;
+		return loads;
+	}
+
+	static bool s_allocated;
+	static Pcsx2Config::RecompilerOptions s_saved_options;
+	static R3000Acpu* s_saved_psx;
+	static BaseVUmicroCPU* s_saved_vu0;
+	static BaseVUmicroCPU* s_saved_vu1;
+};
+
+bool EERecBenchmark::s_allocated = false;
+Pcsx2Config::RecompilerOptions EERecBenchmark::s_saved_options;
+R3000Acpu* EERecBenchmark::s_saved_psx = nullptr;
+BaseVUmicroCPU* EERecBenchmark::s_saved_vu0 = nullptr;
+BaseVUmicroCPU* EERecBenchmark::s_saved_vu1 = nullptr;
+
+/// The same loop as plain blocks, as superblocks, and as superblocks formed from the block profile.
+/// Disabled by default, run it through the ee_rec_benchmark target.
+TEST_F(EERecBenchmark, DISABLED_Superblocks)
+{
+	static constexpr double MIN_SECONDS = 0.5;
+
+	const double plain = TimeLoop(false, false, MIN_SECONDS);
+	const double stitched = TimeLoop(true, false, MIN_SECONDS);
+	const double profiled = TimeLoop(true, true, MIN_SECONDS);
+	ASSERT_GT(plain, 0.0);
+	ASSERT_GT(stitched, 0.0);
+	ASSERT_GT(profiled, 0.0);
+
+	BenchmarkUtils::Result()
+		.Add("group", "iR5900")
+		.Add("kernel", "LoopWithSideExit")
+		.Add("plain_ns_per_iteration", plain, 2)
+		.Add("superblock_ns_per_iteration", stitched, 2)
+		.Add("profiled_superblock_ns_per_iteration", profiled, 2)
+		.Add("speedup", plain / stitched, 2)
+		.Print();
+}
+
+/// Overlay loads compiled every time against loads that map earlier translations back in.
+/// Disabled by default, run it through the ee_rec_benchmark target.
+TEST_F(EERecBenchmark, DISABLED_BlockReuse)
+{
+	const OverlayLoads compiled = TimeOverlayLoads(false);
+	const OverlayLoads reused = TimeOverlayLoads(true);
+	EXPECT_EQ(compiled.results[0], reused.results[0]);
+	EXPECT_EQ(compiled.results[1], reused.results[1]);
+
+	BenchmarkUtils::Result()
+		.Add("group", "iR5900")
+		.Add("kernel", "OverlayReload")
+		.Add("blocks", static_cast<u64>(OVERLAY_BLOCKS))
+		.Add("cold_ms", compiled.cold_ms, 3)
+		.Add("warm_ms", compiled.warm_ms, 3)
+		.Add("reuse_cold_ms", reused.cold_ms, 3)
+		.Add("reuse_warm_ms", reused.warm_ms, 3)
+		.Add("speedup", compiled.warm_ms / reused.warm_ms, 2)
+		.Print();
+}
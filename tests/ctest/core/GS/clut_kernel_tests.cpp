@@ -0,0 +1,251 @@
+// SPDX-FileCopyrightText: 2002-2024 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#include "benchmark_utils.h"
+#include "multi_isa_test.h"
+#include "pcsx2/GS/GSClut.h"
+
+#include <cstring>
+
+MULTI_ISA_UNSHARED_START
+
+// Plain versions of the kernels, written from the table layouts rather than the vector code
+
+static void RefWriteCLUT_T32_I4_CSM1(const u32* src, u16* clut)
+{
+	for (int i = 0; i < 16; i++)
+	{
+		const u32 c = src[clutTableT32I8[i]];
+		clut[i] = static_cast<u16>(c);
+		clut[i + 256] = static_cast<u16>(c >> 16);
+	}
+}
+
+static void RefWriteCLUT_T32_I8_CSM1(const u32* src, u16* clut, u16 offset)
+{
+	for (int i = offset; i < 16; i++)
+	{
+		const int off = i << 4;
+		RefWriteCLUT_T32_I4_CSM1(&src[clutTableT32I8[off & 0x70] | (off & 0x80)], &clut[off]);
+	}
+}
+
+static void RefWriteCLUT_T16_I8_CSM1(const u16* src, u16* clut)
+{
+	for (int i = 0; i < 256; i++)
+		clut[i] = src[(i & ~31) + clutTableT16I4[i & 15] + ((i >> 4) & 1)];
+}
+
+static void RefReadCLUT_T32_I4(const u16* clut, u32* dst)
+{
+	for (int i = 0; i < 16; i++)
+		dst[i] = clut[i] | (static_cast<u32>(clut[i + 256]) << 16);
+}
+
+static void RefReadCLUT_T32_I8(const u16* clut, u32* dst, int offset)
+{
+	for (int i = 0; i < 256; i += 16)
+		RefReadCLUT_T32_I4(&clut[std::min(i + offset, 240)], &dst[i]);
+}
+
+static void RefExpandCLUT64_T32_I8(const u32* src, u64* dst)
+{
+	for (int hi = 0; hi < 16; hi++)
+	{
+		for (int lo = 0; lo < 16; lo++)
+			dst[hi * 16 + lo] = src[lo] | (static_cast<u64>(src[hi]) << 32);
+	}
+}
+
+static void RefExpand16(const u16* src, u32* dst, int w, const GIFRegTEXA& TEXA)
+{
+	for (int i = 0; i < w; i++)
+	{
+		const u32 c = src[i];
+		dst[i] = ((c << 3) & 0x0000f8) | ((c << 6) & 0x00f800) | ((c << 9) & 0xf80000);
+		if (c & 0x8000)
+			dst[i] |= TEXA.TA1 << 24;
+		else if (!TEXA.AEM || c)
+			dst[i] |= TEXA.TA0 << 24;
+	}
+}
+
+static const GSClutKernels s_reference = {
+	RefWriteCLUT_T32_I8_CSM1,
+	RefWriteCLUT_T32_I4_CSM1,
+	RefWriteCLUT_T16_I8_CSM1,
+	RefReadCLUT_T32_I8,
+	RefReadCLUT_T32_I4,
+	RefExpandCLUT64_T32_I8,
+	RefExpand16,
+};
+
+struct ClutTestData
+{
+	// Two blocks of source data, and the same CLUT layout as GSClut, mirrored area included
+	alignas(64) u8 src[512];
+	alignas(64) u16 clut[1024];
+	alignas(64) u32 buff32[256];
+	alignas(64) u64 buff64[256];
+
+	ClutTestData()
+	{
+		BenchmarkUtils::Random rng;
+		for (u8& b : src)
+			b = rng.NextU8();
+		for (u16& c : clut)
+			c = rng.NextU16();
+		// Make sure the AEM path sees some black entries
+		for (int i = 0; i < 1024; i += 37)
+			clut[i] = 0;
+		std::memset(buff32, 0, sizeof(buff32));
+		std::memset(buff64, 0, sizeof(buff64));
+	}
+
+	const u32* src32() const { return reinterpret_cast<const u32*>(src); }
+	const u16* src16() const { return reinterpret_cast<const u16*>(src); }
+};
+
+static GSClutKernels GetKernels()
+{
+	GSClutKernels kernels;
+	GSClutPopulateKernels(kernels);
+	return kernels;
+}
+
+static GIFRegTEXA MakeTEXA(bool aem)
+{
+	GIFRegTEXA TEXA = {};
+	TEXA.TA0 = 0x40;
+	TEXA.TA1 = 0x80;
+	TEXA.AEM = aem;
+	return TEXA;
+}
+
+MULTI_ISA_TEST(ClutTest, WriteT32I8)
+{
+	SKIP_IF_UNSUPPORTED();
+	const GSClutKernels kernels = GetKernels();
+
+	for (u16 offset = 0; offset < 16; offset++)
+	{
+		ClutTestData expected, data;
+		s_reference.WriteCLUT_T32_I8_CSM1(expected.src32(), expected.clut, offset);
+		kernels.WriteCLUT_T32_I8_CSM1(data.src32(), data.clut, offset);
+		EXPECT_EQ(std::memcmp(expected.clut, data.clut, sizeof(data.clut)), 0) << "offset " << offset;
+	}
+}
+
+MULTI_ISA_TEST(ClutTest, WriteT32I4)
+{
+	SKIP_IF_UNSUPPORTED();
+	const GSClutKernels kernels = GetKernels();
+
+	ClutTestData expected, data;
+	s_reference.WriteCLUT_T32_I4_CSM1(expected.src32(), &expected.clut[48]);
+	kernels.WriteCLUT_T32_I4_CSM1(data.src32(), &data.clut[48]);
+	EXPECT_EQ(std::memcmp(expected.clut, data.clut, sizeof(data.clut)), 0);
+}
+
+MULTI_ISA_TEST(ClutTest, WriteT16I8)
+{
+	SKIP_IF_UNSUPPORTED();
+	const GSClutKernels kernels = GetKernels();
+
+	ClutTestData expected, data;
+	s_reference.WriteCLUT_T16_I8_CSM1(expected.src16(), &expected.clut[16]);
+	kernels.WriteCLUT_T16_I8_CSM1(data.src16(), &data.clut[16]);
+	EXPECT_EQ(std::memcmp(expected.clut, data.clut, sizeof(data.clut)), 0);
+}
+
+MULTI_ISA_TEST(ClutTest, ReadT32I8)
+{
+	SKIP_IF_UNSUPPORTED();
+	const GSClutKernels kernels = GetKernels();
+
+	for (int offset = 0; offset < 256; offset += 16)
+	{
+		ClutTestData expected, data;
+		s_reference.ReadCLUT_T32_I8(expected.clut, expected.buff32, offset);
+		kernels.ReadCLUT_T32_I8(data.clut, data.buff32, offset);
+		EXPECT_EQ(std::memcmp(expected.buff32, data.buff32, sizeof(data.buff32)), 0) << "offset " << offset;
+	}
+}
+
+MULTI_ISA_TEST(ClutTest, ReadT32I4)
+{
+	SKIP_IF_UNSUPPORTED();
+	const GSClutKernels kernels = GetKernels();
+
+	ClutTestData expected, data;
+	s_reference.ReadCLUT_T32_I4(&expected.clut[64], expected.buff32);
+	kernels.ReadCLUT_T32_I4(&data.clut[64], data.buff32);
+	EXPECT_EQ(std::memcmp(expected.buff32, data.buff32, sizeof(data.buff32)), 0);
+}
+
+MULTI_ISA_TEST(ClutTest, ExpandCLUT64)
+{
+	SKIP_IF_UNSUPPORTED();
+	const GSClutKernels kernels = GetKernels();
+
+	ClutTestData expected, data;
+	s_reference.ExpandCLUT64_T32_I8(expected.src32(), expected.buff64);
+	kernels.ExpandCLUT64_T32_I8(data.src32(), data.buff64);
+	EXPECT_EQ(std::memcmp(expected.buff64, data.buff64, sizeof(data.buff64)), 0);
+}
+
+MULTI_ISA_TEST(ClutTest, Expand16)
+{
+	SKIP_IF_UNSUPPORTED();
+	const GSClutKernels kernels = GetKernels();
+
+	for (const bool aem : {false, true})
+	{
+		for (const int w : {16, 256})
+		{
+			ClutTestData expected, data;
+			s_reference.Expand16(&expected.clut[496], expected.buff32, w, MakeTEXA(aem));
+			kernels.Expand16(&data.clut[496], data.buff32, w, MakeTEXA(aem));
+			EXPECT_EQ(std::memcmp(expected.buff32, data.buff32, sizeof(data.buff32)), 0) << "aem " << aem << " w " << w;
+		}
+	}
+}
+
+/// Runs every kernel through the same function pointers the renderer uses, so numbers line up between ISAs.
+/// The sse4 build of the kernels is the old 128-bit code, compare the other ISAs against it.
+/// Disabled by default, run it through the gs_clut_benchmark target.
+MULTI_ISA_TEST(ClutBenchmark, DISABLED_Kernels)
+{
+	SKIP_IF_UNSUPPORTED();
+
+	static constexpr double MIN_SECONDS = 0.02;
+
+	const GSClutKernels kernels = GetKernels();
+	const GIFRegTEXA TEXA = MakeTEXA(true);
+	ClutTestData data;
+
+	const auto ns_per_call = [](auto&& fn) {
+		return 1e9 / BenchmarkUtils::CallsPerSecond(MIN_SECONDS, 1024, [&fn](u32) { fn(); });
+	};
+
+	const auto report = [&](const char* kernel, auto&& run) {
+		const double ref = ns_per_call([&]() { run(s_reference); });
+		const double vec = ns_per_call([&]() { run(kernels); });
+		BenchmarkUtils::Result()
+			.Add("isa", MULTI_ISA_NAME)
+			.Add("group", "GSClut")
+			.Add("kernel", kernel)
+			.Add("ns", vec)
+			.Add("reference_ns", ref)
+			.Add("speedup", ref / vec, 2)
+			.Print();
+	};
+
+	report("WriteCLUT_T32_I8_CSM1", [&](const GSClutKernels& k) { k.WriteCLUT_T32_I8_CSM1(data.src32(), data.clut, 0); });
+	report("WriteCLUT_T16_I8_CSM1", [&](const GSClutKernels& k) { k.WriteCLUT_T16_I8_CSM1(data.src16(), data.clut); });
+	report("ReadCLUT_T32_I8", [&](const GSClutKernels& k) { k.ReadCLUT_T32_I8(data.clut, data.buff32, 0); });
+	report("ExpandCLUT64_T32_I8", [&](const GSClutKernels& k) { k.ExpandCLUT64_T32_I8(data.buff32, data.buff64); });
+	report("Expand16", [&](const GSClutKernels& k) { k.Expand16(data.clut, data.buff32, 256, TEXA); });
+}
+
+MULTI_ISA_UNSHARED_END
@@ -0,0 +1,258 @@
+// SPDX-FileCopyrightText: 2002-2024 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#include "benchmark_utils.h"
+#include "pcsx2/GS/GSDump.h"
+#include "pcsx2/GS/GSLzma.h"
+#include "common/Error.h"
+#include "common/FileSystem.h"
+
+#include <gtest/gtest.h>
+#include <zstd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+using namespace GSDumpTypes;
+
+static constexpr u32 FRAME_COUNT = 96;
+static constexpr u32 TEST_CRC = 0x1234ABCD;
+static constexpr const char* TEST_SERIAL = "SLUS-12345";
+
+/// What the reader should hand back for each packet written.
+struct ExpectedPacket
+{
+	GSType id;
+	GSTransferPath path;
+	std::vector<u8> data;
+};
+
+/// Writes a zstd dump with enough transfers for several chunks, and records the packets it wrote.
+/// Each frame has a few transfers of varying size and path, sometimes a FIFO read, then the vsync.
+static bool WriteDump(const std::string& path_without_extension, std::vector<ExpectedPacket>* packets)
+{
+	BenchmarkUtils::Random rng;
+
+	std::vector<u8> state(4096);
+	for (u8& b : state)
+		b = rng.NextU8();
+	freezeData fd = {static_cast<int>(state.size()), state.data()};
+
+	auto regs = std::make_unique<GSPrivRegSet>();
+	std::memset(regs.get(), 0, sizeof(GSPrivRegSet));
+
+	std::unique_ptr<GSDumpBase> dump =
+		GSDumpBase::CreateZstDump(path_without_extension, TEST_SERIAL, TEST_CRC, 0, 0, nullptr, fd, regs.get());
+
+	static constexpr GSTransferPath paths[] = {GSTransferPath::Path1Old, GSTransferPath::Path2, GSTransferPath::Path3,
+		GSTransferPath::Path1New};
+
+	for (u32 frame = 0; frame < FRAME_COUNT; frame++)
+	{
+		const u32 transfers = 1 + rng.NextBelow(4);
+		for (u32 i = 0; i < transfers; i++)
+		{
+			ExpectedPacket packet = {GSType::Transfer, paths[rng.NextBelow(std::size(paths))]};
+			packet.data.resize(16 + rng.NextBelow(64 * 1024));
+			for (u8& b : packet.data)
+				b = rng.NextU8();
+
+			dump->Transfer(static_cast<int>(packet.path), packet.data.data(), packet.data.size());
+			packets->push_back(std::move(packet));
+		}
+
+		if (rng.NextBelow(4) == 0)
+		{
+			const u32 size = 1 + rng.NextBelow(1024);
+			dump->ReadFIFO(size);
+
+			ExpectedPacket packet = {GSType::ReadFIFO2, GSTransferPath::Dummy};
+			packet.data.resize(sizeof(size));
+			std::memcpy(packet.data.data(), &size, sizeof(size));
+			packets->push_back(std::move(packet));
+		}
+
+		// Tag the registers with the frame number, so a packet from the wrong frame stands out.
+		std::memset(regs.get(), static_cast<int>(frame & 0xFF), sizeof(GSPrivRegSet));
+		dump->VSync(frame & 1, false, regs.get());
+
+		ExpectedPacket regs_packet = {GSType::Registers, GSTransferPath::Dummy};
+		regs_packet.data.assign(reinterpret_cast<const u8*>(regs.get()), reinterpret_cast<const u8*>(regs.get() + 1));
+		packets->push_back(std::move(regs_packet));
+		packets->push_back({GSType::VSync, GSTransferPath::Dummy, {static_cast<u8>(frame & 1)}});
+	}
+
+	// Index is written when the dump is closed.
+	const bool ok = FileSystem::FileExists(dump->GetPath().c_str());
+	dump.reset();
+	return ok;
+}
+
+/// Rewrites an indexed dump the way older versions wrote it, as a single zstd frame with no packet index.
+static bool WriteLegacyDump(const std::string& indexed_path, const std::string& legacy_path)
+{
+	const std::optional<std::vector<u8>> indexed = FileSystem::ReadBinaryFile(indexed_path.c_str());
+	GSDumpPacketIndexFooter footer;
+	if (!indexed.has_value() || indexed->size() < sizeof(footer))
+		return false;
+	std::memcpy(&footer, indexed->data() + indexed->size() - sizeof(footer), sizeof(footer));
+	if (footer.magic != GS_DUMP_PACKET_INDEX_MAGIC || footer.index_offset > indexed->size())
+		return false;
+
+	// Everything before the index frame decompresses to the header and packets.
+	std::vector<u8> content;
+	ZSTD_DStream* stream = ZSTD_createDStream();
+	ZSTD_inBuffer in = {indexed->data(), static_cast<size_t>(footer.index_offset), 0};
+	std::vector<u8> out(ZSTD_DStreamOutSize());
+	while (in.pos < in.size)
+	{
+		ZSTD_outBuffer ob = {out.data(), out.size(), 0};
+		const size_t ret = ZSTD_decompressStream(stream, &ob, &in);
+		if (ZSTD_isError(ret))
+		{
+			ZSTD_freeDStream(stream);
+			return false;
+		}
+		content.insert(content.end(), out.data(), out.data() + ob.pos);
+	}
+	ZSTD_freeDStream(stream);
+
+	std::vector<u8> legacy(ZSTD_compressBound(content.size()));
+	const size_t size = ZSTD_compress(legacy.data(), legacy.size(), content.data(), content.size(), 1);
+	return !ZSTD_isError(size) && FileSystem::WriteBinaryFile(legacy_path.c_str(), legacy.data(), size);
+}
+
+static void CheckPacket(GSDumpFile* dump, size_t index, const ExpectedPacket& expected)
+{
+	const GSDumpFile::GSData& packet = dump->GetPacket(index);
+	ASSERT_EQ(packet.id, expected.id) << "packet " << index;
+	ASSERT_EQ(packet.length, expected.data.size()) << "packet " << index;
+	if (expected.id == GSType::Transfer)
+		ASSERT_EQ(packet.path, expected.path) << "packet " << index;
+	ASSERT_EQ(std::memcmp(packet.data, expected.data.data(), expected.data.size()), 0) << "packet " << index;
+}
+
+static std::unique_ptr<GSDumpFile> OpenDump(const std::string& path)
+{
+	Error error;
+	std::unique_ptr<GSDumpFile> dump = GSDumpFile::OpenGSDump(path.c_str(), &error);
+	EXPECT_TRUE(dump) << error.GetDescription();
+	if (dump && !dump->ReadFile(&error))
+	{
+		ADD_FAILURE() << error.GetDescription();
+		dump.reset();
+	}
+	return dump;
+}
+
+/// The indexed dump and its legacy copy are written once per suite
+class GSDumpTest : public BenchmarkUtils::TempDirectoryTest<GSDumpTest>
+{
+public:
+	static constexpr const char* TEMP_PREFIX = "pcsx2_gs_dump_test";
+
+	static bool WriteFiles(const BenchmarkUtils::TempDirectory& dir)
+	{
+		const std::string path = dir.Combine("test");
+		if (!WriteDump(path, &s_packets))
+			return false;
+
+		s_path = path + ".gs.zst";
+		s_legacy_path = dir.Combine("legacy.gs.zst");
+		return WriteLegacyDump(s_path, s_legacy_path);
+	}
+
+	static void ReleaseFiles()
+	{
+		s_path = {};
+		s_legacy_path = {};
+		s_packets = {};
+	}
+
+protected:
+	void SetUp() override
+	{
+		TempDirectoryTest::SetUp();
+		if (IsSkipped())
+			return;
+
+		m_dump = OpenDump(s_path);
+		ASSERT_TRUE(m_dump);
+	}
+
+	static std::string s_path;
+	static std::string s_legacy_path;
+	static std::vector<ExpectedPacket> s_packets;
+
+	std::unique_ptr<GSDumpFile> m_dump;
+};
+
+std::string GSDumpTest::s_path;
+std::string GSDumpTest::s_legacy_path;
+std::vector<ExpectedPacket> GSDumpTest::s_packets;
+
+TEST_F(GSDumpTest, HeaderRoundTrip)
+{
+	EXPECT_EQ(m_dump->GetSerial(), TEST_SERIAL);
+	EXPECT_EQ(m_dump->GetCRC(), TEST_CRC);
+	EXPECT_EQ(m_dump->GetStateData().size(), 4096u);
+	EXPECT_EQ(m_dump->GetRegsData().size(), sizeof(GSPrivRegSet));
+}
+
+TEST_F(GSDumpTest, SequentialPacketsRoundTrip)
+{
+	// More than one chunk, otherwise nothing is tested that the old reader didn't already do.
+	size_t transfer_bytes = 0;
+	for (const ExpectedPacket& packet : s_packets)
+		transfer_bytes += packet.data.size();
+	ASSERT_GT(transfer_bytes, 4 * _1mb);
+
+	ASSERT_EQ(m_dump->GetPacketCount(), s_packets.size());
+	ASSERT_EQ(m_dump->GetFrameCount(), FRAME_COUNT);
+	for (size_t i = 0; i < s_packets.size(); i++)
+		ASSERT_NO_FATAL_FAILURE(CheckPacket(m_dump.get(), i, s_packets[i]));
+}
+
+TEST_F(GSDumpTest, FrameStartPacketsSeek)
+{
+	ASSERT_EQ(m_dump->GetPacketCount(), s_packets.size());
+	ASSERT_EQ(m_dump->GetFrameCount(), FRAME_COUNT);
+
+	std::vector<size_t> frame_starts = {0};
+	for (size_t i = 0; i < s_packets.size(); i++)
+	{
+		if (s_packets[i].id == GSType::VSync)
+			frame_starts.push_back(i + 1);
+	}
+
+	EXPECT_EQ(m_dump->GetFrameStartPacket(0), 0u);
+
+	// Jump around backwards, so chunks are loaded out of order, like seeking does.
+	for (u32 frame = FRAME_COUNT - 1; frame > 0; frame -= std::min(frame, 7u))
+	{
+		const size_t start = m_dump->GetFrameStartPacket(frame);
+		ASSERT_EQ(start, frame_starts[frame]) << "frame " << frame;
+		ASSERT_NO_FATAL_FAILURE(CheckPacket(m_dump.get(), start, s_packets[start]));
+		ASSERT_NO_FATAL_FAILURE(CheckPacket(m_dump.get(), start - 1, s_packets[start - 1]));
+	}
+}
+
+TEST_F(GSDumpTest, LegacyDumpWithoutIndexLoads)
+{
+	std::unique_ptr<GSDumpFile> dump = OpenDump(s_legacy_path);
+	ASSERT_TRUE(dump);
+
+	EXPECT_EQ(dump->GetSerial(), TEST_SERIAL);
+	EXPECT_EQ(dump->GetCRC(), TEST_CRC);
+	ASSERT_EQ(dump->GetPacketCount(), s_packets.size());
+	ASSERT_EQ(dump->GetFrameCount(), FRAME_COUNT);
+	for (size_t i = 0; i < s_packets.size(); i++)
+		ASSERT_NO_FATAL_FAILURE(CheckPacket(dump.get(), i, s_packets[i]));
+
+	// The frame table comes from parsing rather than the index, but has to agree with it.
+	for (u32 frame = 0; frame < FRAME_COUNT; frame++)
+		ASSERT_EQ(dump->GetFrameStartPacket(frame), m_dump->GetFrameStartPacket(frame)) << "frame " << frame;
+}
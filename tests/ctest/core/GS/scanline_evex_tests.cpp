@@ -0,0 +1,350 @@
+// SPDX-FileCopyrightText: 2002-2024 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#include "benchmark_utils.h"
+#include "multi_isa_test.h"
+#include "pcsx2/GS/GSLocalMemory.h"
+#include "pcsx2/GS/Renderers/Common/GSFunctionMap.h"
+#include "pcsx2/GS/Renderers/SW/GSDrawScanlineCodeGenerator.all.h"
+#include "pcsx2/GS/Renderers/SW/GSVertexSW.h"
+#include "pcsx2/Memory.h"
+#include "common/HostSys.h"
+#include "common/ScopedGuard.h"
+#include "common/Timer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+// The software renderer's scanline functions use a few AVX-512 sequences (ternary logic blends, unsigned
+// compares into a mask register) on hosts that have it. These compile every selector that reaches one of
+// them twice, once with and once without, draw the same spans with both into the same local memory, and
+// expect identical results. Skipped on hosts without AVX-512, the selectors are compiled for each ISA build.
+
+MULTI_ISA_UNSHARED_START
+
+using DrawScanlinePtr = void (*)(int pixels, int left, int top, const GSVertexSW& scan, GSScanlineLocalData& local);
+
+static constexpr size_t CODE_SIZE = 8192;
+static constexpr u32 SPANS = 512;
+
+// 640x448 frame at the start of memory and a depth buffer halfway through, like a typical game
+static constexpr u32 FBW = 10;
+static constexpr u32 ZBP = 0x100;
+static constexpr int WIDTH = FBW * 64;
+static constexpr int HEIGHT = 448;
+
+struct ScanlineCase
+{
+	const char* name;
+	u64 key;
+	u32 frame_psm;
+	u32 zbuf_psm;
+	u32 fm;
+	u32 zm;
+};
+
+struct ScanlineSpan
+{
+	GSVertexSW scan;
+	int pixels, left, top;
+};
+
+struct ScanlineBatch
+{
+	std::vector<ScanlineSpan> spans;
+	std::vector<GSScanlineLocalData> locals;
+	u64 pixels = 0;
+};
+
+static GSScanlineSelector Selector(u32 fpsm, u32 zpsm)
+{
+	GSScanlineSelector sel(0);
+	sel.fpsm = fpsm;
+	sel.zpsm = zpsm;
+	sel.atst = ATST_ALWAYS;
+	sel.tfx = TFX_NONE;
+	sel.ababcd = 0xff;
+	sel.prim = GS_TRIANGLE_CLASS;
+	sel.fwrite = 1;
+	return sel;
+}
+
+static GSScanlineSelector ZSelector(u32 zpsm, u32 ztst)
+{
+	GSScanlineSelector sel = Selector(0, zpsm);
+	sel.ztst = ztst;
+	sel.zwrite = 1;
+	sel.ztest = ztst > ZTST_ALWAYS;
+	if (zpsm == 0)
+		sel.zoverflow = 1;
+	else
+		sel.zclamp = 1;
+	return sel;
+}
+
+static GSScanlineSelector AlphaSelector(u32 afail)
+{
+	GSScanlineSelector sel = (afail == AFAIL_KEEP) ? Selector(0, 0) : ZSelector(0, ZTST_ALWAYS);
+	sel.atst = ATST_EQUAL;
+	sel.afail = afail;
+	sel.ftest = 1;
+	sel.rfb = (afail == AFAIL_RGB_ONLY);
+	return sel;
+}
+
+static GSScanlineSelector DestAlphaSelector(u32 fpsm, u32 datm)
+{
+	GSScanlineSelector sel = Selector(fpsm, 0);
+	sel.date = 1;
+	sel.datm = datm;
+	sel.ftest = 1;
+	sel.rfb = 1;
+	return sel;
+}
+
+static GSScanlineSelector MaskSelector(u32 fpsm)
+{
+	GSScanlineSelector sel = Selector(fpsm, 0);
+	sel.rfb = 1;
+	return sel;
+}
+
+static std::vector<ScanlineCase> GetCases()
+{
+	return {
+		{"ZTST_GEQUAL_Z32", ZSelector(0, ZTST_GEQUAL), PSMCT32, PSMZ32, 0, 0},
+		{"ZTST_GREATER_Z32", ZSelector(0, ZTST_GREATER), PSMCT32, PSMZ32, 0, 0},
+		{"ZTST_GEQUAL_Z16", ZSelector(2, ZTST_GEQUAL), PSMCT32, PSMZ16, 0, 0xffff0000},
+		{"ZTST_GREATER_Z16", ZSelector(2, ZTST_GREATER), PSMCT32, PSMZ16, 0, 0xffff0000},
+		{"ATST_EQUAL_KEEP", AlphaSelector(AFAIL_KEEP), PSMCT32, PSMZ32, 0, 0},
+		{"ATST_EQUAL_FB_ONLY", AlphaSelector(AFAIL_FB_ONLY), PSMCT32, PSMZ32, 0, 0},
+		{"ATST_EQUAL_RGB_ONLY", AlphaSelector(AFAIL_RGB_ONLY), PSMCT32, PSMZ32, 0, 0},
+		{"DATE_DATM0_C32", DestAlphaSelector(0, 0), PSMCT32, PSMZ32, 0, 0},
+		{"DATE_DATM1_C32", DestAlphaSelector(0, 1), PSMCT32, PSMZ32, 0, 0},
+		{"DATE_DATM0_C16", DestAlphaSelector(2, 0), PSMCT16, PSMZ32, 0xffff0000, 0},
+		{"DATE_DATM1_C16", DestAlphaSelector(2, 1), PSMCT16, PSMZ32, 0xffff0000, 0},
+		{"FBMSK_C32", MaskSelector(0), PSMCT32, PSMZ32, 0x00ff00f0, 0},
+		{"FBMSK_C16", MaskSelector(2), PSMCT16, PSMZ32, 0xffff7c00, 0},
+	};
+}
+
+/// Compiles a scanline function into the software renderer's code space, the way GSCodeGeneratorFunctionMap does.
+static DrawScanlinePtr Compile(u64 key, bool allow_avx512)
+{
+	HostSys::BeginCodeWrite();
+
+	u8* code_ptr = GSCodeReserve::ReserveMemory(CODE_SIZE);
+	GSDrawScanlineCodeGenerator cg(key, code_ptr, CODE_SIZE, allow_avx512);
+	cg.Generate();
+
+	const u32 size = static_cast<u32>(cg.GetSize());
+	GSCodeReserve::CommitMemory(size);
+
+	HostSys::EndCodeWrite();
+	HostSys::FlushInstructionCache(code_ptr, size);
+
+	return reinterpret_cast<DrawScanlinePtr>(const_cast<u8*>(cg.GetCode()));
+}
+
+/// Random per-prim data with depth steps and alpha values that make the tests go both ways.
+static void FillLocalData(GSScanlineLocalData& local, BenchmarkUtils::Random& rng)
+{
+	u32* words = reinterpret_cast<u32*>(&local);
+	for (size_t i = 0; i < offsetof(GSScanlineLocalData, gd) / sizeof(u32); i++)
+		words[i] = rng.Next();
+
+	for (auto& skip : local.d)
+	{
+		for (float& z : skip.z.F32)
+			z = static_cast<float>(static_cast<int>(rng.NextBelow(8192)) - 4096);
+	}
+
+	const double z_step = static_cast<double>(static_cast<int>(rng.NextBelow(65536)) - 32768);
+#if _M_SSE >= 0x501
+	std::memcpy(&local.d8.p.z, &z_step, sizeof(z_step));
+#else
+	std::memcpy(&local.d4.z, &z_step, sizeof(z_step));
+#endif
+
+	static constexpr u32 alphas[] = {0x00, 0x40, 0x80};
+	for (u32& rb : local.c.rb.U32)
+		rb = rng.NextU8() | (static_cast<u32>(rng.NextU8()) << 16);
+	for (u32& ga : local.c.ga.U32)
+		ga = rng.NextU8() | (alphas[rng.NextBelow(std::size(alphas))] << 16);
+}
+
+static ScanlineBatch GetBatch(const ScanlineCase& test)
+{
+	const bool z16 = (test.zbuf_psm == PSMZ16);
+	BenchmarkUtils::Random rng(static_cast<u32>(test.key) ^ static_cast<u32>(test.key >> 32));
+
+	ScanlineBatch batch;
+	batch.spans.resize(SPANS);
+	batch.locals.resize(SPANS);
+	for (u32 i = 0; i < SPANS; i++)
+	{
+		ScanlineSpan& span = batch.spans[i];
+		span.scan = {};
+		span.top = static_cast<int>(rng.NextBelow(HEIGHT));
+		span.left = static_cast<int>(rng.NextBelow(WIDTH - 1));
+		span.pixels = 1 + static_cast<int>(rng.NextBelow(WIDTH - span.left));
+		batch.pixels += span.pixels;
+		FillLocalData(batch.locals[i], rng);
+
+		// Depth is a double in the z/w slots
+		const double z = z16 ? static_cast<double>(rng.NextBelow(0x20000)) :
+		                       static_cast<double>(std::clamp<u32>(rng.Next(), 0x100000, 0xfff00000));
+		std::memcpy(&span.scan.p.F32[2], &z, sizeof(z));
+	}
+
+	return batch;
+}
+
+struct ScanlineTarget
+{
+	std::unique_ptr<GSLocalMemory> mem;
+	std::vector<u8> initial;
+	alignas(32) GSScanlineGlobalData gd;
+
+	ScanlineTarget()
+		: mem(std::make_unique<GSLocalMemory>())
+		, initial(GSLocalMemory::m_vmsize)
+	{
+		BenchmarkUtils::Random rng(0x5ca11e);
+		for (u8& b : initial)
+			b = rng.NextU8();
+	}
+
+	void Setup(const ScanlineCase& test)
+	{
+		GIFRegFRAME FRAME = {};
+		FRAME.FBW = FBW;
+		FRAME.PSM = test.frame_psm;
+		GIFRegZBUF ZBUF = {};
+		ZBUF.ZBP = ZBP;
+		ZBUF.PSM = test.zbuf_psm;
+		const GSPixelOffset4* fzb4 = mem->GetPixelOffset4(FRAME, ZBUF);
+
+		std::memset(&gd, 0, sizeof(gd));
+		gd.sel.key = test.key;
+		gd.vm = mem->m_vm8;
+		gd.fzbr = fzb4->row;
+		gd.fzbc = fzb4->col;
+		gd.aref = GSVector4i(0x40);
+#if _M_SSE >= 0x501
+		gd.fm = test.fm;
+		gd.zm = test.zm;
+#else
+		gd.fm = GSVector4i(test.fm);
+		gd.zm = GSVector4i(test.zm);
+#endif
+
+		std::memcpy(mem->m_vm8, initial.data(), initial.size());
+	}
+
+	/// Only the temporaries in the local data get written, so a batch can be drawn any number of times.
+	void Draw(DrawScanlinePtr func, ScanlineBatch& batch)
+	{
+		for (u32 i = 0; i < SPANS; i++)
+		{
+			const ScanlineSpan& span = batch.spans[i];
+			batch.locals[i].gd = &gd;
+			func(span.pixels, span.left, span.top, span.scan, batch.locals[i]);
+		}
+	}
+};
+
+static bool SetupCodeSpace()
+{
+	if (!SysMemory::Allocate())
+		return false;
+
+	GSCodeReserve::ResetMemory();
+	return true;
+}
+
+MULTI_ISA_TEST(ScanlineEVEX, MatchesVEX)
+{
+	SKIP_IF_UNSUPPORTED();
+	if (!g_cpu.hasAVX512)
+		GTEST_SKIP() << "Host CPU does not support AVX-512";
+
+	ASSERT_TRUE(SetupCodeSpace());
+	ScopedGuard release([]() { SysMemory::Release(); });
+
+	ScanlineTarget target;
+	std::vector<u8> evex_result(GSLocalMemory::m_vmsize);
+
+	for (const ScanlineCase& test : GetCases())
+	{
+		ScanlineBatch batch = GetBatch(test);
+
+		target.Setup(test);
+		target.Draw(Compile(test.key, true), batch);
+		std::memcpy(evex_result.data(), target.mem->m_vm8, evex_result.size());
+
+		target.Setup(test);
+		target.Draw(Compile(test.key, false), batch);
+
+		EXPECT_NE(std::memcmp(target.initial.data(), evex_result.data(), evex_result.size()), 0)
+			<< test.name << " didn't draw anything";
+		EXPECT_EQ(std::memcmp(target.mem->m_vm8, evex_result.data(), evex_result.size()), 0)
+			<< test.name << " differs, " << GSScanlineSelector(test.key).to_string();
+	}
+}
+
+/// Pixel throughput of the same selectors with and without the AVX-512 sequences.
+/// Disabled by default, run it through the gs_scanline_evex_benchmark target.
+MULTI_ISA_TEST(ScanlineEVEXBenchmark, DISABLED_Pixels)
+{
+	SKIP_IF_UNSUPPORTED();
+	if (!g_cpu.hasAVX512)
+		GTEST_SKIP() << "Host CPU does not support AVX-512";
+
+	static constexpr double MIN_SECONDS = 0.1;
+
+	ASSERT_TRUE(SetupCodeSpace());
+	ScopedGuard release([]() { SysMemory::Release(); });
+
+	ScanlineTarget target;
+
+	const auto measure = [&target](DrawScanlinePtr func, ScanlineBatch& batch) {
+		target.Draw(func, batch);
+
+		u64 pixels = 0;
+		Common::Timer timer;
+		double seconds;
+		do
+		{
+			target.Draw(func, batch);
+			pixels += batch.pixels;
+			seconds = timer.GetTimeSeconds();
+		} while (seconds < MIN_SECONDS);
+
+		return pixels / seconds / 1e6;
+	};
+
+	for (const ScanlineCase& test : GetCases())
+	{
+		ScanlineBatch batch = GetBatch(test);
+
+		target.Setup(test);
+		const double evex = measure(Compile(test.key, true), batch);
+		target.Setup(test);
+		const double vex = measure(Compile(test.key, false), batch);
+
+		BenchmarkUtils::Result()
+			.Add("group", "GSDrawScanline")
+			.Add("isa", MULTI_ISA_NAME)
+			.Add("kernel", test.name)
+			.Add("evex_mpixels_s", evex, 1)
+			.Add("vex_mpixels_s", vex, 1)
+			.Add("speedup", evex / vex, 3)
+			.Print();
+	}
+}
+
+MULTI_ISA_UNSHARED_END
@@ -0,0 +1,218 @@
+// SPDX-FileCopyrightText: 2002-2024 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#include "benchmark_utils.h"
+#include "multi_isa_test.h"
+#include "pcsx2/GS/GSBlock.h"
+#include "pcsx2/GS/GSLocalMemory.h"
+
+#include <memory>
+#include <vector>
+
+// Throughput of the swizzle kernels and the GSLocalMemory transfer/texture tables, for every ISA build.
+// Disabled by default since it takes a few seconds, run it through the gs_swizzle_benchmark target.
+
+MULTI_ISA_UNSHARED_START
+
+/// Minimum time spent on each measurement
+static constexpr double MIN_SECONDS = 0.02;
+
+/// Kernels cycle through this many blocks so they see different addresses, without falling out of L2
+static constexpr u32 BLOCKS = 64;
+
+struct BenchmarkBuffers
+{
+	alignas(64) u8 blocks[BLOCKS][256];
+	alignas(64) u8 linear[BLOCKS][32 * 16 * 4]; // Largest unswizzled block, 4-bit expanded to 32-bit
+	alignas(64) u32 clut32[256];
+
+	BenchmarkBuffers()
+	{
+		BenchmarkUtils::Random rng;
+		for (auto& block : blocks)
+		{
+			for (u8& b : block)
+				b = rng.NextU8();
+		}
+		for (auto& block : linear)
+		{
+			for (u8& b : block)
+				b = rng.NextU8();
+		}
+		for (u32& c : clut32)
+			c = rng.Next();
+	}
+};
+
+struct PSMInfo
+{
+	u32 psm;
+	const char* name;
+};
+
+static constexpr PSMInfo s_formats[] = {
+	{PSMCT32, "PSMCT32"},
+	{PSMCT24, "PSMCT24"},
+	{PSMCT16, "PSMCT16"},
+	{PSMCT16S, "PSMCT16S"},
+	{PSMT8, "PSMT8"},
+	{PSMT4, "PSMT4"},
+	{PSMT8H, "PSMT8H"},
+	{PSMT4HL, "PSMT4HL"},
+	{PSMT4HH, "PSMT4HH"},
+	{PSMZ32, "PSMZ32"},
+	{PSMZ24, "PSMZ24"},
+	{PSMZ16, "PSMZ16"},
+	{PSMZ16S, "PSMZ16S"},
+};
+
+/// Runs fn with an increasing counter until MIN_SECONDS have passed, returns MB/s based on bytes per call
+template <typename Fn>
+static double Measure(u32 bytes, Fn&& fn)
+{
+	return BenchmarkUtils::CallsPerSecond(MIN_SECONDS, 256, std::forward<Fn>(fn)) * bytes / (1024.0 * 1024.0);
+}
+
+static void Report(const char* group, const char* kernel, const char* format, const char* unit, u32 bytes, double mbps)
+{
+	BenchmarkUtils::Result()
+		.Add("isa", MULTI_ISA_NAME)
+		.Add("group", group)
+		.Add("kernel", kernel)
+		.Add("format", format)
+		.Add("unit", unit)
+		.Add("bytes", static_cast<u64>(bytes))
+		.Add("mbps", mbps)
+		.Print();
+}
+
+#define BENCH_BLOCK(kernel, format, ...) \
+	Report("GSBlock", #kernel, format, "block", 256, Measure(256, [&](u32 i) { \
+		[[maybe_unused]] const u8* src = b.blocks[i % BLOCKS]; \
+		[[maybe_unused]] u8* dst = b.linear[i % BLOCKS]; \
+		[[maybe_unused]] u8* bdst = b.blocks[i % BLOCKS]; \
+		[[maybe_unused]] const u8* lsrc = b.linear[i % BLOCKS]; \
+		__VA_ARGS__; \
+	}))
+
+#define BENCH_COLUMN(kernel, format, colh, ...) \
+	Report("GSBlock", #kernel, format, "column", 64, Measure(64, [&](u32 i) { \
+		[[maybe_unused]] const int y = (i & 3) * colh; \
+		[[maybe_unused]] const u8* src = b.blocks[(i >> 2) % BLOCKS]; \
+		[[maybe_unused]] u8* dst = b.linear[(i >> 2) % BLOCKS]; \
+		[[maybe_unused]] u8* bdst = b.blocks[(i >> 2) % BLOCKS]; \
+		[[maybe_unused]] const u8* lsrc = b.linear[(i >> 2) % BLOCKS]; \
+		__VA_ARGS__; \
+	}))
+
+MULTI_ISA_TEST(SwizzleBenchmark, DISABLED_GSBlock)
+{
+	SKIP_IF_UNSUPPORTED();
+
+	const std::unique_ptr<BenchmarkBuffers> buffers = std::make_unique<BenchmarkBuffers>();
+	BenchmarkBuffers& b = *buffers;
+	GIFRegTEXA TEXA = {};
+	TEXA.TA0 = 0x40;
+	TEXA.TA1 = 0x80;
+
+	BENCH_COLUMN(ReadColumn32, "PSMCT32", 2, GSBlock::ReadColumn32(y, src, dst, 32));
+	BENCH_COLUMN(ReadColumn16, "PSMCT16", 2, GSBlock::ReadColumn16(y, src, dst, 32));
+	BENCH_COLUMN(ReadColumn8, "PSMT8", 4, GSBlock::ReadColumn8(y, src, dst, 16));
+	BENCH_COLUMN(ReadColumn4, "PSMT4", 4, GSBlock::ReadColumn4(y, src, dst, 16));
+	BENCH_COLUMN(WriteColumn32, "PSMCT32", 2, GSBlock::WriteColumn32<32, 0xffffffff>(y, bdst, lsrc, 32));
+	BENCH_COLUMN(WriteColumn16, "PSMCT16", 2, GSBlock::WriteColumn16<32>(y, bdst, lsrc, 32));
+	BENCH_COLUMN(WriteColumn8, "PSMT8", 4, GSBlock::WriteColumn8<32>(y, bdst, lsrc, 16));
+	BENCH_COLUMN(WriteColumn4, "PSMT4", 4, GSBlock::WriteColumn4<32>(y, bdst, lsrc, 16));
+
+	BENCH_BLOCK(ReadBlock32, "PSMCT32", GSBlock::ReadBlock32(src, dst, 32));
+	BENCH_BLOCK(ReadBlock16, "PSMCT16", GSBlock::ReadBlock16(src, dst, 32));
+	BENCH_BLOCK(ReadBlock8, "PSMT8", GSBlock::ReadBlock8(src, dst, 16));
+	BENCH_BLOCK(ReadBlock4, "PSMT4", GSBlock::ReadBlock4(src, dst, 16));
+	BENCH_BLOCK(ReadBlock4P, "PSMT4", GSBlock::ReadBlock4P(src, dst, 32));
+	BENCH_BLOCK(ReadBlock8HP, "PSMT8H", GSBlock::ReadBlock8HP(src, dst, 8));
+	BENCH_BLOCK(ReadBlock4HLP, "PSMT4HL", GSBlock::ReadBlock4HLP(src, dst, 8));
+	BENCH_BLOCK(ReadBlock4HHP, "PSMT4HH", GSBlock::ReadBlock4HHP(src, dst, 8));
+
+	BENCH_BLOCK(WriteBlock32, "PSMCT32", GSBlock::WriteBlock32<32, 0xffffffff>(bdst, lsrc, 32));
+	BENCH_BLOCK(WriteBlock16, "PSMCT16", GSBlock::WriteBlock16<32>(bdst, lsrc, 32));
+	BENCH_BLOCK(WriteBlock8, "PSMT8", GSBlock::WriteBlock8<32>(bdst, lsrc, 16));
+	BENCH_BLOCK(WriteBlock4, "PSMT4", GSBlock::WriteBlock4<32>(bdst, lsrc, 16));
+	BENCH_BLOCK(UnpackAndWriteBlock24, "PSMCT24", GSBlock::UnpackAndWriteBlock24(lsrc, 24, bdst));
+	BENCH_BLOCK(UnpackAndWriteBlock8H, "PSMT8H", GSBlock::UnpackAndWriteBlock8H(lsrc, 8, bdst));
+	BENCH_BLOCK(UnpackAndWriteBlock4HL, "PSMT4HL", GSBlock::UnpackAndWriteBlock4HL(lsrc, 4, bdst));
+	BENCH_BLOCK(UnpackAndWriteBlock4HH, "PSMT4HH", GSBlock::UnpackAndWriteBlock4HH(lsrc, 4, bdst));
+
+	BENCH_BLOCK(ReadAndExpandBlock24, "PSMCT24", GSBlock::ReadAndExpandBlock24<false>(src, dst, 32, TEXA));
+	BENCH_BLOCK(ReadAndExpandBlock16, "PSMCT16", GSBlock::ReadAndExpandBlock16<false>(src, dst, 64, TEXA));
+	BENCH_BLOCK(ReadAndExpandBlock8_32, "PSMT8", GSBlock::ReadAndExpandBlock8_32(src, dst, 64, b.clut32));
+	BENCH_BLOCK(ReadAndExpandBlock4_32, "PSMT4", GSBlock::ReadAndExpandBlock4_32(src, dst, 128, b.clut32));
+	BENCH_BLOCK(ReadAndExpandBlock8H_32, "PSMT8H", GSBlock::ReadAndExpandBlock8H_32(src, dst, 32, b.clut32));
+	BENCH_BLOCK(ReadAndExpandBlock4HL_32, "PSMT4HL", GSBlock::ReadAndExpandBlock4HL_32(src, dst, 32, b.clut32));
+	BENCH_BLOCK(ReadAndExpandBlock4HH_32, "PSMT4HH", GSBlock::ReadAndExpandBlock4HH_32(src, dst, 32, b.clut32));
+}
+
+#undef BENCH_COLUMN
+#undef BENCH_BLOCK
+
+MULTI_ISA_TEST(SwizzleBenchmark, DISABLED_GSLocalMemory)
+{
+	SKIP_IF_UNSUPPORTED();
+
+	// Image transfers and texture reads of one 256x256 area, through the function tables of this ISA
+	static constexpr int SIZE = 256;
+
+	const std::unique_ptr<GSLocalMemory> mem = std::make_unique<GSLocalMemory>();
+	GSLocalMemoryPopulateFunctions(*mem);
+
+	std::vector<u8> image(SIZE * SIZE * 4);
+	for (size_t i = 0; i < image.size(); i++)
+		image[i] = static_cast<u8>(i * 7 + (i >> 8));
+	std::vector<u8> output(SIZE * SIZE * 4);
+
+	GIFRegTEXA TEXA = {};
+	TEXA.TA0 = 0x40;
+	TEXA.TA1 = 0x80;
+
+	for (const PSMInfo& fmt : s_formats)
+	{
+		const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[fmt.psm];
+		const u32 bytes = SIZE * SIZE * psm.bpp / 8;
+		const int len = SIZE * SIZE * psm.trbpp / 8;
+
+		GIFRegBITBLTBUF BITBLTBUF = {};
+		BITBLTBUF.SBW = SIZE / 64;
+		BITBLTBUF.SPSM = fmt.psm;
+		BITBLTBUF.DBW = SIZE / 64;
+		BITBLTBUF.DPSM = fmt.psm;
+		GIFRegTRXPOS TRXPOS = {};
+		GIFRegTRXREG TRXREG = {};
+		TRXREG.RRW = SIZE;
+		TRXREG.RRH = SIZE;
+
+		Report("GSLocalMemory", "WriteImage", fmt.name, "image", bytes, Measure(bytes, [&](u32) {
+			int tx = 0, ty = 0;
+			psm.wi(*mem, tx, ty, image.data(), len, BITBLTBUF, TRXPOS, TRXREG);
+		}));
+
+		Report("GSLocalMemory", "ReadImage", fmt.name, "image", bytes, Measure(bytes, [&](u32) {
+			int tx = 0, ty = 0;
+			psm.ri(*mem, tx, ty, output.data(), len, BITBLTBUF, TRXPOS, TRXREG);
+		}));
+
+		const GSOffset off = mem->GetOffset(0, SIZE / 64, fmt.psm);
+		const GSVector4i rect(0, 0, SIZE, SIZE);
+
+		Report("GSLocalMemory", "ReadTexture", fmt.name, "image", bytes, Measure(bytes, [&](u32) {
+			psm.rtx(*mem, off, rect, output.data(), SIZE * 4, TEXA);
+		}));
+
+		if (psm.pal > 0)
+		{
+			Report("GSLocalMemory", "ReadTextureP", fmt.name, "image", bytes, Measure(bytes, [&](u32) {
+				psm.rtxP(*mem, off, rect, output.data(), SIZE, TEXA);
+			}));
+		}
+	}
+}
+
+MULTI_ISA_UNSHARED_END
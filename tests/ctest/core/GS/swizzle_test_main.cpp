@@ -1,54 +1,11 @@
 // SPDX-FileCopyrightText: 2002-2024 PCSX2 Dev Team
 // SPDX-License-Identifier: GPL-3.0+
 
+#include "multi_isa_test.h"
 #include "pcsx2/GS/GSBlock.h"
 #include "pcsx2/GS/GSClut.h"
-#include "pcsx2/GS/MultiISA.h"
-#include <gtest/gtest.h>
 #include <string.h>
 
-#include "cpuinfo.h"
-
-#ifdef MULTI_ISA_UNSHARED_COMPILATION
-
-enum class TestISA
-{
-	isa_sse4,
-	isa_avx,
-	isa_avx2,
-	isa_native,
-};
-
-static bool CheckCapabilities(TestISA required_caps)
-{
-	cpuinfo_initialize();
-	if (required_caps == TestISA::isa_avx && !cpuinfo_has_x86_avx())
-		return false;
-	if (required_caps == TestISA::isa_avx2 && !cpuinfo_has_x86_avx2())
-		return false;
-
-	return true;
-}
-
-#define MULTI_ISA_STRINGIZE_(x) #x
-#define MULTI_ISA_STRINGIZE(x) MULTI_ISA_STRINGIZE_(x)
-
-#define MULTI_ISA_CONCAT_(a, b) a##b
-#define MULTI_ISA_CONCAT(a, b) MULTI_ISA_CONCAT_(a, b)
-
-#define MULTI_ISA_TEST(group, name) TEST(MULTI_ISA_CONCAT(MULTI_ISA_CONCAT(MULTI_ISA_UNSHARED_COMPILATION, _), group), name)
-#define SKIP_IF_UNSUPPORTED() \
-	if (!CheckCapabilities(TestISA::MULTI_ISA_UNSHARED_COMPILATION)) { \
-		GTEST_SKIP() << "Host CPU does not support " MULTI_ISA_STRINGIZE(MULTI_ISA_UNSHARED_COMPILATION); \
-	}
-
-#else
-
-#define MULTI_ISA_TEST(group, name) TEST(group, name)
-#define SKIP_IF_UNSUPPORTED()
-
-#endif
-
 MULTI_ISA_UNSHARED_START
 
 static void swizzle(const u8* table, u8* dst, const u8* src, int bpp, bool deswizzle)
@@ -189,6 +146,13 @@ static std::string image2hex(const u8* bin, int rows, int columns, int bpp)
 	return out;
 }
 
+static void ExpandCLUT64(const u32* src, u64* dst)
+{
+	GSClutKernels kernels;
+	GSClutPopulateKernels(kernels);
+	kernels.ExpandCLUT64_T32_I8(src, dst);
+}
+
 struct TestData
 {
 	alignas(64) u8 block[256];
@@ -206,7 +170,7 @@ struct TestData
 			output.block[i] = i;
 			output.clut32[i] = i | (i << 16);
 		}
-		GSClut::ExpandCLUT64_T32_I8(output.clut32, output.clut64);
+		ExpandCLUT64(output.clut32, output.clut64);
 		return output;
 	}
 
@@ -221,7 +185,7 @@ struct TestData
 			output.block[i] = rand();
 			output.clut32[i] = rand();
 		}
-		GSClut::ExpandCLUT64_T32_I8(output.clut32, output.clut64);
+		ExpandCLUT64(output.clut32, output.clut64);
 		return output;
 	}
 
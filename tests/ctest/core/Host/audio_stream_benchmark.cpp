@@ -0,0 +1,265 @@
+// SPDX-FileCopyrightText: 2002-2024 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#include "benchmark_utils.h"
+#include "pcsx2/Host/AudioStream.h"
+#include "pcsx2/Host/AudioStretcher.h"
+#include "common/Timer.h"
+
+#include "SoundTouch.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// Throughput of the audio output path: the sample readers for each expansion mode, the time stretchers, and the
+// whole stream from WriteChunk() to the reader, and the time the SPU2's thread spends handing a frame of output
+// over with and without the stream write thread. Disabled by default, run it through the audio_stream_benchmark target.
+
+/// Minimum time spent on each measurement
+static constexpr double MIN_SECONDS = 0.05;
+
+static constexpr u32 SAMPLE_RATE = 48000;
+
+/// Frames read from the stream per callback, a typical 1-2ms backend period
+static constexpr u32 READ_FRAMES = 64;
+
+namespace
+{
+	class BenchmarkAudioStream final : public AudioStream
+	{
+	public:
+		// Same channel layouts as SDLAudioStream.
+		static constexpr std::array<SampleReader, static_cast<size_t>(AudioExpansionMode::Count)> s_sample_readers = {
+			&StereoSampleReaderImpl,
+			&SampleReaderImpl<AudioExpansionMode::StereoLFE, READ_CHANNEL_FRONT_LEFT, READ_CHANNEL_FRONT_RIGHT,
+				READ_CHANNEL_LFE>,
+			&SampleReaderImpl<AudioExpansionMode::Quadraphonic, READ_CHANNEL_FRONT_LEFT, READ_CHANNEL_FRONT_RIGHT,
+				READ_CHANNEL_REAR_LEFT, READ_CHANNEL_REAR_RIGHT>,
+			&SampleReaderImpl<AudioExpansionMode::QuadraphonicLFE, READ_CHANNEL_FRONT_LEFT, READ_CHANNEL_FRONT_RIGHT,
+				READ_CHANNEL_LFE, READ_CHANNEL_REAR_LEFT, READ_CHANNEL_REAR_RIGHT>,
+			&SampleReaderImpl<AudioExpansionMode::Surround51, READ_CHANNEL_FRONT_LEFT, READ_CHANNEL_FRONT_RIGHT,
+				READ_CHANNEL_FRONT_CENTER, READ_CHANNEL_LFE, READ_CHANNEL_REAR_LEFT, READ_CHANNEL_REAR_RIGHT>,
+			&SampleReaderImpl<AudioExpansionMode::Surround71, READ_CHANNEL_FRONT_LEFT, READ_CHANNEL_FRONT_RIGHT,
+				READ_CHANNEL_FRONT_CENTER, READ_CHANNEL_LFE, READ_CHANNEL_SIDE_LEFT, READ_CHANNEL_SIDE_RIGHT,
+				READ_CHANNEL_REAR_LEFT, READ_CHANNEL_REAR_RIGHT>,
+		};
+
+		BenchmarkAudioStream(const AudioStreamParameters& parameters, bool stretch_enabled)
+			: AudioStream(SAMPLE_RATE, parameters)
+		{
+			BaseInitialize(s_sample_readers[static_cast<size_t>(parameters.expansion_mode)], stretch_enabled);
+		}
+
+		void Read(SampleType* samples, u32 num_frames) { ReadFrames(samples, num_frames); }
+	};
+} // namespace
+
+/// Runs fn until MIN_SECONDS have passed, returns how many times faster than real time it processed the audio
+template <typename Fn>
+static double Measure(u32 frames_per_call, Fn&& fn)
+{
+	return BenchmarkUtils::CallsPerSecond(MIN_SECONDS, 64, [&fn](u32) { fn(); }) * frames_per_call / SAMPLE_RATE;
+}
+
+static void Report(const char* group, const char* kernel, const char* variant, double realtime)
+{
+	BenchmarkUtils::Result().Add("group", group).Add("kernel", kernel).Add("variant", variant).Add("realtime", realtime).Print();
+}
+
+/// Something that sounds vaguely like music, so the stretchers have a period to find
+static std::vector<float> MakeTone(u32 frames, u32 channels)
+{
+	std::vector<float> ret(frames * channels);
+	for (u32 i = 0; i < frames; i++)
+	{
+		const float t = static_cast<float>(i) / SAMPLE_RATE;
+		const float value = 0.3f * std::sin(2.0f * 3.14159265f * 220.0f * t) + 0.2f * std::sin(2.0f * 3.14159265f * 331.0f * t) +
+							0.1f * std::sin(2.0f * 3.14159265f * 1250.0f * t);
+		for (u32 c = 0; c < channels; c++)
+			ret[i * channels + c] = value * (1.0f - 0.1f * c);
+	}
+	return ret;
+}
+
+TEST(AudioStreamBenchmark, DISABLED_SampleReader)
+{
+	static constexpr u32 FRAMES = 4096;
+
+	std::vector<s16> src(FRAMES * AudioStream::MAX_OUTPUT_CHANNELS);
+	for (size_t i = 0; i < src.size(); i++)
+		src[i] = static_cast<s16>(i * 37);
+	std::vector<s16> dest(FRAMES * AudioStream::MAX_OUTPUT_CHANNELS);
+
+	for (u32 i = 0; i < static_cast<u32>(AudioExpansionMode::Count); i++)
+	{
+		const AudioExpansionMode mode = static_cast<AudioExpansionMode>(i);
+		const auto reader = BenchmarkAudioStream::s_sample_readers[i];
+		Report("SampleReader", "Read", AudioStream::GetExpansionModeName(mode), Measure(FRAMES, [&]() {
+			reader(dest.data(), src.data(), FRAMES);
+		}));
+	}
+}
+
+TEST(AudioStreamBenchmark, DISABLED_Stretcher)
+{
+	static constexpr u32 BLOCK_FRAMES = AudioStream::CHUNK_SIZE;
+	static constexpr u32 TONE_FRAMES = SAMPLE_RATE;
+
+	for (const u32 channels : {2u, 6u, 8u})
+	{
+		const std::vector<float> tone = MakeTone(TONE_FRAMES, channels);
+		std::vector<float> output(BLOCK_FRAMES * channels);
+
+		for (const float tempo : {1.0f, 1.5f, 2.0f})
+		{
+			for (const bool quickseek : {false, true})
+			{
+				char variant[64];
+				std::snprintf(variant, sizeof(variant), "%uch tempo %.1f%s", channels, tempo, quickseek ? " quickseek" : "");
+
+				u32 pos = 0;
+				AudioStretcher stretcher(SAMPLE_RATE, channels, AudioStreamParameters::DEFAULT_STRETCH_SEQUENCE_LENGTH,
+					AudioStreamParameters::DEFAULT_STRETCH_SEEKWINDOW, AudioStreamParameters::DEFAULT_STRETCH_OVERLAP,
+					quickseek);
+				stretcher.SetTempo(tempo);
+				Report("Stretcher", "AudioStretcher", variant, Measure(BLOCK_FRAMES, [&]() {
+					stretcher.PutFrames(&tone[pos * channels], BLOCK_FRAMES);
+					pos = (pos + BLOCK_FRAMES) % TONE_FRAMES;
+					while (stretcher.ReceiveFrames(output.data(), BLOCK_FRAMES) != 0)
+						;
+				}));
+
+				pos = 0;
+				soundtouch::SoundTouch soundtouch;
+				soundtouch.setSampleRate(SAMPLE_RATE);
+				soundtouch.setChannels(channels);
+				soundtouch.setSetting(SETTING_USE_QUICKSEEK, quickseek);
+				soundtouch.setSetting(SETTING_USE_AA_FILTER, AudioStreamParameters::DEFAULT_STRETCH_USE_AA_FILTER);
+				soundtouch.setSetting(SETTING_SEQUENCE_MS, AudioStreamParameters::DEFAULT_STRETCH_SEQUENCE_LENGTH);
+				soundtouch.setSetting(SETTING_SEEKWINDOW_MS, AudioStreamParameters::DEFAULT_STRETCH_SEEKWINDOW);
+				soundtouch.setSetting(SETTING_OVERLAP_MS, AudioStreamParameters::DEFAULT_STRETCH_OVERLAP);
+				soundtouch.setTempo(tempo);
+				Report("Stretcher", "SoundTouch", variant, Measure(BLOCK_FRAMES, [&]() {
+					soundtouch.putSamples(&tone[pos * channels], BLOCK_FRAMES);
+					pos = (pos + BLOCK_FRAMES) % TONE_FRAMES;
+					while (soundtouch.receiveSamples(output.data(), BLOCK_FRAMES) != 0)
+						;
+				}));
+			}
+		}
+	}
+}
+
+TEST(AudioStreamBenchmark, DISABLED_Stream)
+{
+	static constexpr u32 TONE_FRAMES = SAMPLE_RATE;
+
+	std::vector<s16> tone(TONE_FRAMES * AudioStream::NUM_INPUT_CHANNELS);
+	const std::vector<float> ftone = MakeTone(TONE_FRAMES, AudioStream::NUM_INPUT_CHANNELS);
+	for (size_t i = 0; i < tone.size(); i++)
+		tone[i] = static_cast<s16>(ftone[i] * 32767.0f);
+
+	std::vector<s16> output(READ_FRAMES * AudioStream::MAX_OUTPUT_CHANNELS);
+
+	// Everything from the SPU2 writing a chunk to the backend reading it, with a read for every write,
+	// so the stretcher sits close to 1:1 like it does when the game runs at full speed.
+	for (const AudioExpansionMode mode : {AudioExpansionMode::Disabled, AudioExpansionMode::Surround51, AudioExpansionMode::Surround71})
+	{
+		for (const int stretch : {0, 1, 2})
+		{
+			AudioStreamParameters parameters;
+			parameters.expansion_mode = mode;
+			parameters.stretch_use_soundtouch = (stretch == 2);
+
+			char variant[64];
+			std::snprintf(variant, sizeof(variant), "%s %s", AudioStream::GetExpansionModeName(mode),
+				(stretch == 0) ? "no stretch" : ((stretch == 1) ? "AudioStretcher" : "SoundTouch"));
+
+			u32 pos = 0;
+			BenchmarkAudioStream stream(parameters, stretch != 0);
+			Report("Stream", "WriteChunk+Read", variant, Measure(AudioStream::CHUNK_SIZE, [&]() {
+				stream.WriteChunk(&tone[pos * AudioStream::NUM_INPUT_CHANNELS]);
+				pos = (pos + AudioStream::CHUNK_SIZE) % TONE_FRAMES;
+				stream.Read(output.data(), READ_FRAMES);
+			}));
+		}
+	}
+}
+
+TEST(AudioStreamBenchmark, DISABLED_WriteThread)
+{
+	// Two 60Hz frames of output, a whole number of chunks
+	static constexpr u32 FRAMES = 2;
+	static constexpr u32 FRAME_CHUNKS = (SAMPLE_RATE * FRAMES / 60) / AudioStream::CHUNK_SIZE;
+	static constexpr u32 TONE_CHUNKS = SAMPLE_RATE / AudioStream::CHUNK_SIZE;
+
+	std::vector<AudioStreamWriteThread::Chunk> tone(TONE_CHUNKS);
+	const std::vector<float> ftone = MakeTone(TONE_CHUNKS * AudioStream::CHUNK_SIZE, AudioStream::NUM_INPUT_CHANNELS);
+	for (size_t i = 0; i < ftone.size(); i++)
+		tone[i / tone[0].size()][i % tone[0].size()] = static_cast<s16>(ftone[i] * 32767.0f);
+
+	std::vector<s16> output(READ_FRAMES * AudioStream::MAX_OUTPUT_CHANNELS);
+
+	// Time spent on the producing thread per 60Hz frame. The backend's reads happen between frames, once the
+	// write thread has caught up, so both ways see the same stream state.
+	const auto measure = [&](const AudioStreamParameters& parameters, bool stretch, bool threaded) {
+		BenchmarkAudioStream stream(parameters, stretch);
+		AudioStreamWriteThread writer;
+		if (threaded)
+			writer.Start(&stream);
+
+		u32 pos = 0;
+		u32 frames = 0;
+		double busy = 0.0;
+		Common::Timer total;
+		do
+		{
+			Common::Timer timer;
+			for (u32 i = 0; i < FRAME_CHUNKS; i++)
+			{
+				if (threaded)
+					writer.Write(tone[pos]);
+				else
+					stream.WriteChunk(tone[pos].data());
+				pos = (pos + 1) % TONE_CHUNKS;
+			}
+			busy += timer.GetTimeSeconds();
+
+			writer.Sync();
+			for (u32 i = 0; i < FRAME_CHUNKS * AudioStream::CHUNK_SIZE / READ_FRAMES; i++)
+				stream.Read(output.data(), READ_FRAMES);
+			frames += FRAMES;
+		} while (total.GetTimeSeconds() < MIN_SECONDS * 4);
+
+		writer.Stop();
+		return busy * 1e6 / frames;
+	};
+
+	for (const AudioExpansionMode mode : {AudioExpansionMode::Disabled, AudioExpansionMode::Surround51})
+	{
+		for (const int stretch : {0, 1, 2})
+		{
+			AudioStreamParameters parameters;
+			parameters.expansion_mode = mode;
+			parameters.stretch_use_soundtouch = (stretch == 2);
+
+			char variant[64];
+			std::snprintf(variant, sizeof(variant), "%s %s", AudioStream::GetExpansionModeName(mode),
+				(stretch == 0) ? "no stretch" : ((stretch == 1) ? "AudioStretcher" : "SoundTouch"));
+
+			const double direct_us = measure(parameters, stretch != 0, false);
+			const double threaded_us = measure(parameters, stretch != 0, true);
+			BenchmarkUtils::Result()
+				.Add("group", "Stream")
+				.Add("kernel", "WriteThread")
+				.Add("variant", variant)
+				.Add("direct_us_per_frame", direct_us, 2)
+				.Add("threaded_us_per_frame", threaded_us, 2)
+				.Print();
+		}
+	}
+}
@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: 2002-2024 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#include "pcsx2/Host/AudioStream.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <vector>
+
+static constexpr u32 SAMPLE_RATE = 48000;
+
+namespace
+{
+	class TestAudioStream final : public AudioStream
+	{
+	public:
+		TestAudioStream()
+			: AudioStream(SAMPLE_RATE, AudioStreamParameters())
+		{
+			BaseInitialize(&StereoSampleReaderImpl, false);
+		}
+
+		void Read(SampleType* samples, u32 num_frames) { ReadFrames(samples, num_frames); }
+	};
+} // namespace
+
+TEST(AudioStream, UnderrunStretchesBufferedFrames)
+{
+	static constexpr s16 LEFT = 1000;
+	static constexpr s16 RIGHT = -2000;
+	static constexpr u32 READ_FRAMES = AudioStream::CHUNK_SIZE * 4;
+
+	TestAudioStream stream;
+
+	std::vector<s16> chunk(AudioStream::CHUNK_SIZE * 2);
+	for (u32 i = 0; i < AudioStream::CHUNK_SIZE; i++)
+	{
+		chunk[i * 2] = LEFT;
+		chunk[i * 2 + 1] = RIGHT;
+	}
+	stream.WriteChunk(chunk.data());
+
+	// Only a quarter of the request is buffered, it should be spread over the whole read rather than padded with
+	// silence. The filter has unity gain, so a constant signal comes out unchanged apart from rounding.
+	std::vector<s16> output(READ_FRAMES * 2);
+	stream.Read(output.data(), READ_FRAMES);
+	for (u32 i = 0; i < READ_FRAMES; i++)
+	{
+		ASSERT_LE(std::abs(output[i * 2] - LEFT), 1) << "frame " << i;
+		ASSERT_LE(std::abs(output[i * 2 + 1] - RIGHT), 1) << "frame " << i;
+	}
+
+	// With nothing left, the stream falls back to silence.
+	stream.Read(output.data(), READ_FRAMES);
+	for (const s16 sample : output)
+		ASSERT_EQ(sample, 0);
+}
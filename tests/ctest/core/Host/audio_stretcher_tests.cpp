@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: 2002-2024 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#include "pcsx2/Host/AudioStretcher.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+static constexpr u32 SAMPLE_RATE = 48000;
+static constexpr u32 BLOCK_FRAMES = 64;
+static constexpr float TONE_FREQUENCY = 440.0f;
+static constexpr float TONE_AMPLITUDE = 0.5f;
+
+/// Runs seconds of a sine tone through the stretcher in blocks, like AudioStream does
+static std::vector<float> StretchTone(AudioStretcher& stretcher, u32 seconds)
+{
+	const u32 channels = stretcher.GetChannels();
+	std::vector<float> block(BLOCK_FRAMES * channels);
+	std::vector<float> received(BLOCK_FRAMES * channels);
+	std::vector<float> output;
+
+	u32 frame = 0;
+	for (u32 i = 0; i < (SAMPLE_RATE * seconds) / BLOCK_FRAMES; i++)
+	{
+		for (u32 j = 0; j < BLOCK_FRAMES; j++, frame++)
+		{
+			const float value = TONE_AMPLITUDE * std::sin(2.0f * 3.14159265f * TONE_FREQUENCY * frame / SAMPLE_RATE);
+			for (u32 c = 0; c < channels; c++)
+				block[j * channels + c] = (c & 1) ? -value : value;
+		}
+
+		stretcher.PutFrames(block.data(), BLOCK_FRAMES);
+
+		u32 count;
+		while ((count = stretcher.ReceiveFrames(received.data(), BLOCK_FRAMES)) != 0)
+			output.insert(output.end(), received.begin(), received.begin() + count * channels);
+	}
+
+	return output;
+}
+
+TEST(AudioStretcher, FollowsTempo)
+{
+	for (const float tempo : {0.5f, 1.0f, 1.5f, 2.0f})
+	{
+		AudioStretcher stretcher(SAMPLE_RATE, 2, 30, 20, 10, false);
+		stretcher.SetTempo(tempo);
+
+		const std::vector<float> output = StretchTone(stretcher, 4);
+		const float expected = (SAMPLE_RATE * 4) / tempo;
+		const float frames = static_cast<float>(output.size() / 2);
+
+		// Input that hasn't made a whole sequence yet is still buffered.
+		EXPECT_LE(frames, expected) << "tempo " << tempo;
+		EXPECT_GE(frames, expected * 0.97f) << "tempo " << tempo;
+	}
+}
+
+TEST(AudioStretcher, KeepsPitch)
+{
+	// Largest difference between consecutive samples of the tone, anything much bigger is a click.
+	const float max_step = TONE_AMPLITUDE * 2.0f * 3.14159265f * TONE_FREQUENCY / SAMPLE_RATE;
+
+	for (const u32 channels : {2u, 6u, 8u})
+	{
+		for (const bool quickseek : {false, true})
+		{
+			for (const float tempo : {0.75f, 1.25f, 2.0f})
+			{
+				AudioStretcher stretcher(SAMPLE_RATE, channels, 30, 20, 10, quickseek);
+				stretcher.SetTempo(tempo);
+
+				const std::vector<float> output = StretchTone(stretcher, 2);
+				const size_t frames = output.size() / channels;
+				ASSERT_GT(frames, SAMPLE_RATE / 2);
+
+				u32 crossings = 0;
+				float largest_step = 0.0f;
+				for (size_t i = 1; i < frames; i++)
+				{
+					const float prev = output[(i - 1) * channels];
+					const float cur = output[i * channels];
+					crossings += (prev < 0.0f) != (cur < 0.0f);
+					largest_step = std::max(largest_step, std::abs(cur - prev));
+
+					// Channels are stretched together, so they stay in phase.
+					ASSERT_EQ(output[i * channels + 1], -cur) << "frame " << i;
+				}
+
+				const float frequency = (crossings / 2.0f) / (static_cast<float>(frames) / SAMPLE_RATE);
+				EXPECT_NEAR(frequency, TONE_FREQUENCY, TONE_FREQUENCY * 0.01f)
+					<< "channels " << channels << " quickseek " << quickseek << " tempo " << tempo;
+				EXPECT_LE(largest_step, max_step * 1.25f)
+					<< "channels " << channels << " quickseek " << quickseek << " tempo " << tempo;
+			}
+		}
+	}
+}
+
+TEST(AudioStretcher, ClearDropsBufferedAudio)
+{
+	AudioStretcher stretcher(SAMPLE_RATE, 2, 30, 20, 10, false);
+	stretcher.SetTempo(1.5f);
+
+	std::vector<float> block(BLOCK_FRAMES * 2, 0.25f);
+	for (u32 i = 0; i < SAMPLE_RATE / BLOCK_FRAMES; i++)
+		stretcher.PutFrames(block.data(), BLOCK_FRAMES);
+	ASSERT_GT(stretcher.ReceiveFrames(block.data(), BLOCK_FRAMES), 0u);
+
+	stretcher.Clear();
+	EXPECT_EQ(stretcher.ReceiveFrames(block.data(), BLOCK_FRAMES), 0u);
+	stretcher.PutFrames(block.data(), BLOCK_FRAMES);
+	EXPECT_EQ(stretcher.ReceiveFrames(block.data(), BLOCK_FRAMES), 0u);
+}
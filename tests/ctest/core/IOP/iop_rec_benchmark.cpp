@@ -0,0 +1,157 @@
+// SPDX-FileCopyrightText: 2002-2024 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#include "benchmark_utils.h"
+#include "pcsx2/IopMem.h"
+#include "pcsx2/Config.h"
+#include "pcsx2/Memory.h"
+#include "pcsx2/R3000A.h"
+#include "common/Timer.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <initializer_list>
+
+// A ring of small IOP blocks, each jumping to the next through a register holding a known constant. The same
+// ring is compiled once with block linking, where every exit jumps straight into the next block, and once
+// without, where every exit goes back through the dispatcher.
+
+static constexpr u32 RING_BLOCKS = 64;
+static constexpr u32 BLOCK_STRIDE = 0x40;
+static constexpr u32 RING = 0x10000;
+
+// Only the IOP's time runs out, events are pushed far enough out to never fire.
+static constexpr s32 SLICE_EE_CYCLES = 1 << 22;
+
+namespace MIPS
+{
+	static constexpr u32 T0 = 8;
+	static constexpr u32 S1 = 17;
+
+	static constexpr u32 NOP = 0;
+	static constexpr u32 ADDIU(u32 rt, u32 rs, u16 imm) { return (011u << 26) | (rs << 21) | (rt << 16) | imm; }
+	static constexpr u32 LUI(u32 rt, u16 imm) { return (017u << 26) | (rt << 16) | imm; }
+	static constexpr u32 ORI(u32 rt, u32 rs, u16 imm) { return (015u << 26) | (rs << 21) | (rt << 16) | imm; }
+	static constexpr u32 LW(u32 rt, u32 base, u16 offset) { return (043u << 26) | (base << 21) | (rt << 16) | offset; }
+	static constexpr u32 JR(u32 rs) { return (rs << 21) | 010u; }
+} // namespace MIPS
+
+static u32 RingBlock(u32 ring, u32 index)
+{
+	return ring + (index % RING_BLOCKS) * BLOCK_STRIDE;
+}
+
+static void WriteCode(u32 addr, std::initializer_list<u32> code)
+{
+	for (const u32 op : code)
+	{
+		iopMemWrite32(addr, op);
+		addr += 4;
+	}
+}
+
+static void WriteRing()
+{
+	using namespace MIPS;
+
+	for (u32 i = 0; i < RING_BLOCKS; i++)
+	{
+		const u32 next = RingBlock(RING, i + 1);
+		WriteCode(RingBlock(RING, i), {
+			ADDIU(S1, S1, 1),
+			LUI(T0, static_cast<u16>(next >> 16)),
+			ORI(T0, T0, static_cast<u16>(next)),
+			JR(T0),
+			NOP,
+		});
+	}
+}
+
+class IOPRecBenchmark : public ::testing::Test
+{
+protected:
+	static void SetUpTestSuite()
+	{
+		ASSERT_TRUE(SysMemory::Allocate());
+		s_allocated = true;
+
+		s_saved_options = EmuConfig.Cpu.Recompiler;
+		psxRec.Reserve();
+		SysMemory::Reset();
+		WriteRing();
+	}
+
+	static void TearDownTestSuite()
+	{
+		if (!s_allocated)
+			return;
+
+		psxRec.Shutdown();
+		SysMemory::Release();
+		EmuConfig.Cpu.Recompiler = s_saved_options;
+		s_allocated = false;
+	}
+
+	/// Recompiles the ring with or without block linking and runs it for min_seconds, returns nanoseconds per block.
+	static double TimeRing(bool linking, double min_seconds)
+	{
+		EmuConfig.Cpu.Recompiler.EnableIOPBlockLinking = linking;
+		psxRec.Reset();
+
+		std::memset(&psxRegs, 0, sizeof(psxRegs));
+		psxRegs.pc = RING;
+		psxRegs.CP0.n.Status = 0x00400000;
+
+		u64 slices = 0;
+		const auto run_slice = []() {
+			psxRegs.iopNextEventCycle = psxRegs.cycle + 0x40000000;
+			psxRec.ExecuteBlock(SLICE_EE_CYCLES);
+		};
+
+		// Compiles every block on the first slice, which is the warm up.
+		run_slice();
+		const u32 start_blocks = psxRegs.GPR.r[MIPS::S1];
+
+		Common::Timer timer;
+		double seconds;
+		do
+		{
+			run_slice();
+			slices++;
+			seconds = timer.GetTimeSeconds();
+		} while (seconds < min_seconds);
+
+		const u32 blocks = psxRegs.GPR.r[MIPS::S1] - start_blocks;
+		EXPECT_GT(blocks, slices) << "ring didn't run, linking " << linking;
+		EXPECT_EQ(psxRegs.pc & ~(RING_BLOCKS * BLOCK_STRIDE - 1), RING) << "left the ring, linking " << linking;
+		return (blocks != 0) ? (seconds * 1e9 / blocks) : 0.0;
+	}
+
+	static bool s_allocated;
+	static Pcsx2Config::RecompilerOptions s_saved_options;
+};
+
+bool IOPRecBenchmark::s_allocated = false;
+Pcsx2Config::RecompilerOptions IOPRecBenchmark::s_saved_options;
+
+/// The same block exits through linked jumps and through the dispatcher.
+/// Disabled by default, run it through the iop_rec_benchmark target.
+TEST_F(IOPRecBenchmark, DISABLED_LinkedExits)
+{
+	static constexpr double MIN_SECONDS = 0.5;
+
+	const double linked = TimeRing(true, MIN_SECONDS);
+	const double dispatched = TimeRing(false, MIN_SECONDS);
+	ASSERT_GT(linked, 0.0);
+	ASSERT_GT(dispatched, 0.0);
+
+	BenchmarkUtils::Result()
+		.Add("group", "iR3000A")
+		.Add("kernel", "RingOfBlocks")
+		.Add("blocks", static_cast<u64>(RING_BLOCKS))
+		.Add("linked_ns_per_block", linked, 2)
+		.Add("dispatched_ns_per_block", dispatched, 2)
+		.Add("speedup", dispatched / linked, 2)
+		.Print();
+}
@@ -0,0 +1,512 @@
+// SPDX-FileCopyrightText: 2002-2024 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#include "benchmark_utils.h"
+#include "pcsx2/Common.h"
+#include "pcsx2/IPU/IPU.h"
+#include "pcsx2/IPU/IPU_MultiISA.h"
+#include "common/BitUtils.h"
+#include "common/FileSystem.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Runs IDEC over the I-picture slices of an MPEG-2 elementary stream, through the same command/FIFO interface
+// the EE uses, with and without the IPU thread. The stream is synthetic unless IPU_BENCHMARK_STREAM points at a
+// captured one, e.g. the video of a game's .pss demuxed with "ffmpeg -i movie.pss -c:v copy -f mpeg2video out.m2v".
+// The benchmark is disabled by default, run it through the ipu_decode_benchmark target.
+
+/// Minimum time spent on each measurement
+static constexpr double MIN_SECONDS = 0.2;
+
+namespace
+{
+	class BitWriter
+	{
+	public:
+		void Put(u32 value, u32 bits)
+		{
+			for (u32 i = bits; i > 0; i--)
+			{
+				if ((m_bit & 7) == 0)
+					m_data.push_back(0);
+				m_data.back() |= ((value >> (i - 1)) & 1) << (7 - (m_bit & 7));
+				m_bit++;
+			}
+		}
+
+		void StartCode(u8 code)
+		{
+			m_bit = static_cast<u32>(Common::AlignUpPow2(m_bit, 8));
+			Put(0x000001, 24);
+			Put(code, 8);
+		}
+
+		std::vector<u8>& GetData() { return m_data; }
+
+	private:
+		std::vector<u8> m_data;
+		u32 m_bit = 0;
+	};
+
+	class BitReader
+	{
+	public:
+		BitReader(const u8* data, size_t size)
+			: m_data(data)
+			, m_size(size)
+		{
+		}
+
+		u32 Get(u32 bits)
+		{
+			u32 value = 0;
+			for (u32 i = 0; i < bits; i++, m_bit++)
+			{
+				const size_t byte = m_bit / 8;
+				value = (value << 1) | ((byte < m_size) ? ((m_data[byte] >> (7 - (m_bit & 7))) & 1) : 0);
+			}
+			return value;
+		}
+
+	private:
+		const u8* m_data;
+		size_t m_size;
+		size_t m_bit = 0;
+	};
+
+	/// Everything IDEC needs to decode one slice
+	struct Slice
+	{
+		size_t offset; // of the slice start code
+		u32 qsc;
+		bool dtd;
+		bool intra_vlc_format;
+		bool alternate_scan;
+		u32 intra_dc_precision;
+		bool q_scale_type;
+	};
+
+	struct Stream
+	{
+		std::vector<u8> data;
+		std::vector<Slice> slices;
+		u8 iq[64];
+	};
+} // namespace
+
+/// A 720x480 I-picture with a spread of coefficients per block, roughly what a DVD quality FMV has
+static std::vector<u8> MakeStream()
+{
+	static constexpr u32 MB_WIDTH = 720 / 16;
+	static constexpr u32 MB_HEIGHT = 480 / 16;
+
+	BitWriter bw;
+	BenchmarkUtils::Random rng;
+	const auto random = [&rng](u32 max) { return rng.NextBelow(max); };
+
+	// picture_header: temporal_reference, picture_coding_type I, vbv_delay, extra_bit_picture
+	bw.StartCode(0x00);
+	bw.Put(0, 10);
+	bw.Put(I_TYPE, 3);
+	bw.Put(0xFFFF, 16);
+	bw.Put(0, 1);
+
+	// picture_coding_extension: f_codes, intra_dc_precision 8 bits, frame picture, frame_pred_frame_dct
+	bw.StartCode(0xB5);
+	bw.Put(8, 4);
+	bw.Put(0xFFFF, 16);
+	bw.Put(0, 2);
+	bw.Put(FRAME_PICTURE, 2);
+	bw.Put(0b0100000, 7);
+	bw.Put(0, 8);
+
+	for (u32 row = 0; row < MB_HEIGHT; row++)
+	{
+		// quantiser_scale_code, extra_bit_slice
+		bw.StartCode(static_cast<u8>(row + 1));
+		bw.Put(8, 5);
+		bw.Put(0, 1);
+
+		for (u32 col = 0; col < MB_WIDTH; col++)
+		{
+			// macroblock_address_increment 1, macroblock_type intra
+			bw.Put(1, 1);
+			bw.Put(1, 1);
+
+			for (u32 block = 0; block < 6; block++)
+			{
+				// Small DC differences which cancel out, so the prediction stays in range.
+				if (block < 4)
+					bw.Put(0b01, 2), bw.Put((block & 1) ? 0b01 : 0b10, 2);
+				else
+					bw.Put(0b01, 2), bw.Put(block & 1, 1);
+
+				// Table B-14: 11s run 0 level 1, 011s run 1 level 1, 0100s run 0 level 2, 0101s run 2 level 1.
+				const u32 coefs = random((block < 4) ? 16 : 8);
+				for (u32 i = 0; i < coefs; i++)
+				{
+					switch (random(4))
+					{
+						case 0: bw.Put(0b11, 2); break;
+						case 1: bw.Put(0b011, 3); break;
+						case 2: bw.Put(0b0100, 4); break;
+						default: bw.Put(0b0101, 4); break;
+					}
+					bw.Put(random(2), 1);
+				}
+
+				// end_of_block
+				bw.Put(0b10, 2);
+			}
+		}
+	}
+
+	bw.StartCode(0xB7);
+	return std::move(bw.GetData());
+}
+
+/// Finds the slices of intra pictures which start at the left edge, and the intra quantiser matrix
+static Stream ParseStream(std::vector<u8> data)
+{
+	Stream stream = {};
+	std::memset(stream.iq, 16, sizeof(stream.iq));
+
+	Slice state = {};
+	bool intra_picture = false;
+	for (size_t i = 0; (i + 4) <= data.size(); i++)
+	{
+		if (data[i] != 0 || data[i + 1] != 0 || data[i + 2] != 1)
+			continue;
+
+		const u8 code = data[i + 3];
+		BitReader br(&data[i + 4], data.size() - (i + 4));
+		if (code == 0xB3)
+		{
+			// sequence_header: size, aspect, frame rate, bit rate, marker, vbv buffer size, constrained flag
+			br.Get(62);
+			if (br.Get(1))
+			{
+				for (u8& value : stream.iq)
+					value = static_cast<u8>(br.Get(8));
+			}
+		}
+		else if (code == 0x00)
+		{
+			br.Get(10);
+			intra_picture = (br.Get(3) == I_TYPE);
+		}
+		else if (code == 0xB5 && br.Get(4) == 8)
+		{
+			// picture_coding_extension
+			br.Get(16);
+			state.intra_dc_precision = br.Get(2);
+			br.Get(3);
+			state.dtd = !br.Get(1);
+			br.Get(1);
+			state.q_scale_type = br.Get(1);
+			state.intra_vlc_format = br.Get(1);
+			state.alternate_scan = br.Get(1);
+		}
+		else if (code >= 0x01 && code <= 0xAF && intra_picture)
+		{
+			// No extra slice information, and a macroblock_address_increment of 1 for the first macroblock,
+			// which the IDEC command skips along with the slice header.
+			Slice slice = state;
+			slice.offset = i;
+			slice.qsc = br.Get(5);
+			if (br.Get(1) == 0 && br.Get(1) == 1)
+				stream.slices.push_back(slice);
+		}
+	}
+
+	// Make sure the last slice ends with a start code, and there's enough data after it for IDEC to read it.
+	static constexpr u8 sequence_end[] = {0x00, 0x00, 0x01, 0xB7};
+	data.insert(data.end(), std::begin(sequence_end), std::end(sequence_end));
+	data.resize(Common::AlignUpPow2(data.size(), 16) + 32);
+	stream.data = std::move(data);
+	return stream;
+}
+
+static Stream LoadStream()
+{
+	if (const char* path = std::getenv("IPU_BENCHMARK_STREAM"))
+	{
+		std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(path);
+		if (data.has_value())
+			return ParseStream(std::move(data.value()));
+
+		std::fprintf(stderr, "Failed to read %s, using a synthetic stream\n", path);
+	}
+
+	return ParseStream(MakeStream());
+}
+
+static volatile u32 s_ee_sink;
+
+static void SpinEE(u32 iterations)
+{
+	for (u32 i = 0; i < iterations; i++)
+		s_ee_sink = i;
+}
+
+/// Decodes every slice of the stream, returning the number of macroblocks. ee_spin is busy work done whenever the
+/// IPU schedules itself for later, standing in for the EE code which would run before the event fires.
+static u32 DecodeStream(const Stream& stream, bool rgb16, u32 ee_spin, std::vector<u128>* output)
+{
+	const u32 mb_qwc = rgb16 ? (sizeof(macroblock_rgb16) / 16) : (sizeof(macroblock_rgb32) / 16);
+	u32 total_qwc = 0;
+
+	for (const Slice& slice : stream.slices)
+	{
+		ipuRegs.ctrl.IVF = slice.intra_vlc_format;
+		ipuRegs.ctrl.AS = slice.alternate_scan;
+		ipuRegs.ctrl.QST = slice.q_scale_type;
+		ipuRegs.ctrl.IDP = slice.intra_dc_precision;
+		ipuRegs.ctrl.MP1 = 0;
+
+		// BCLR with the bit offset of the start code in its quadword.
+		size_t pos = slice.offset / 16;
+		IPUCMD_WRITE((SCE_IPU_BCLR << 28) | static_cast<u32>((slice.offset & 15) * 8));
+
+		const auto feed = [&stream, &pos]() {
+			const size_t available = (stream.data.size() / 16) - pos;
+			if (available > 0)
+				pos += ipu_fifo.in.write(reinterpret_cast<const u32*>(&stream.data[pos * 16]), static_cast<int>(std::min<size_t>(available, 8)));
+		};
+		const auto drain = [&total_qwc, output]() {
+			while (ipuRegs.ctrl.OFC > 0)
+			{
+				u128 qw;
+				ipu_fifo.out.read(&qw, 1);
+				if (output)
+					output->push_back(qw);
+				total_qwc++;
+			}
+		};
+
+		feed();
+
+		// Skip the slice start code, quantiser_scale_code, extra_bit_slice and the first macroblock_address_increment.
+		IPUCMD_WRITE((SCE_IPU_IDEC << 28) | (rgb16 << 27) | (rgb16 << 26) | (slice.dtd << 24) | (slice.qsc << 16) | 39);
+
+		while (ipuRegs.ctrl.BUSY)
+		{
+			feed();
+			IPUProcessInterrupt();
+			drain();
+			if (ee_spin > 0 && ipuRegs.ctrl.BUSY)
+				SpinEE(ee_spin);
+		}
+	}
+
+	return total_qwc / mb_qwc;
+}
+
+static Stream SetupIPU(bool ipu_thread)
+{
+	Stream stream = LoadStream();
+
+	ipuReset();
+	std::memcpy(decoder.iq, stream.iq, sizeof(decoder.iq));
+
+	// The output DMA is always ready for more.
+	ipu0ch.chcr.STR = 1;
+	ipu0ch.qwc = 0xFFFF;
+
+	EmuConfig.Speedhacks.ipuThread = ipu_thread;
+	IPUThreadSetForced(ipu_thread);
+	return stream;
+}
+
+static void ShutdownIPU()
+{
+	ipuShutdown();
+	EmuConfig.Speedhacks.ipuThread = false;
+	IPUThreadSetForced(false);
+}
+
+/// Macroblocks for BDEC, laid out back to back like a game's own MPEG decoder sends them after parsing everything
+/// up to the blocks itself. Intra ones are reconstructed into mb8 then converted, non-intra ones are added into mb16.
+static std::vector<u8> MakeBDECStream(bool intra, u32 macroblocks)
+{
+	BitWriter bw;
+	BenchmarkUtils::Random rng;
+
+	// Table B-14: 11s run 0 level 1, 011s run 1 level 1, 0100s run 0 level 2, 0101s run 2 level 1.
+	const auto put_coefs = [&bw, &rng](u32 count) {
+		for (u32 i = 0; i < count; i++)
+		{
+			switch (rng.NextBelow(4))
+			{
+				case 0: bw.Put(0b11, 2); break;
+				case 1: bw.Put(0b011, 3); break;
+				case 2: bw.Put(0b0100, 4); break;
+				default: bw.Put(0b0101, 4); break;
+			}
+			bw.Put(rng.NextBelow(2), 1);
+		}
+	};
+
+	for (u32 mb = 0; mb < macroblocks; mb++)
+	{
+		// Table B-9: 001100 all six blocks, 111 luma only.
+		const bool chroma = intra || rng.NextBelow(2);
+		if (!intra)
+			bw.Put(chroma ? 0b001100 : 0b111, chroma ? 6 : 3);
+
+		for (u32 block = 0; block < (chroma ? 6u : 4u); block++)
+		{
+			if (intra)
+			{
+				// Same DC differences as the IDEC stream, they cancel out over a macroblock.
+				if (block < 4)
+					bw.Put(0b01, 2), bw.Put((block & 1) ? 0b01 : 0b10, 2);
+				else
+					bw.Put(0b01, 2), bw.Put(block & 1, 1);
+			}
+			else
+			{
+				// The first coefficient of a non-intra block has the short 1s code for run 0 level 1.
+				bw.Put(0b1, 1);
+				bw.Put(rng.NextBelow(2), 1);
+			}
+
+			put_coefs(rng.NextBelow((block < 4) ? 16 : 8));
+
+			// end_of_block
+			bw.Put(0b10, 2);
+		}
+	}
+
+	bw.StartCode(0xB7);
+	std::vector<u8> data = std::move(bw.GetData());
+	data.resize(Common::AlignUpPow2(data.size(), 16) + 32);
+	return data;
+}
+
+/// Runs BDEC for each macroblock of the stream, collecting the mb16 output.
+static void DecodeBDEC(const std::vector<u8>& data, bool intra, u32 macroblocks, std::vector<u128>* output)
+{
+	ipuRegs.ctrl.IVF = 0;
+	ipuRegs.ctrl.AS = 0;
+	ipuRegs.ctrl.QST = 0;
+	ipuRegs.ctrl.IDP = 0;
+	ipuRegs.ctrl.MP1 = 0;
+
+	size_t pos = 0;
+	IPUCMD_WRITE(SCE_IPU_BCLR << 28);
+
+	const auto feed = [&data, &pos]() {
+		const size_t available = (data.size() / 16) - pos;
+		if (available > 0)
+			pos += ipu_fifo.in.write(reinterpret_cast<const u32*>(&data[pos * 16]), static_cast<int>(std::min<size_t>(available, 8)));
+	};
+
+	for (u32 mb = 0; mb < macroblocks; mb++)
+	{
+		feed();
+
+		// MBI, DCR for the first macroblock only so the DC predictors carry over, QSC 8.
+		IPUCMD_WRITE((SCE_IPU_BDEC << 28) | (intra << 27) | ((mb == 0) << 26) | (8 << 16));
+
+		while (ipuRegs.ctrl.BUSY)
+		{
+			feed();
+			IPUProcessInterrupt();
+			while (ipuRegs.ctrl.OFC > 0)
+			{
+				u128 qw;
+				ipu_fifo.out.read(&qw, 1);
+				output->push_back(qw);
+			}
+		}
+	}
+}
+
+TEST(IPUDecode, ThreadMatchesInline)
+{
+	for (const bool rgb16 : {false, true})
+	{
+		std::vector<u128> inline_output;
+		Stream stream = SetupIPU(false);
+		const u32 inline_mbs = DecodeStream(stream, rgb16, 0, &inline_output);
+		ShutdownIPU();
+
+		std::vector<u128> thread_output;
+		stream = SetupIPU(true);
+		ASSERT_TRUE(IPUThreadEnabled());
+		const u32 thread_mbs = DecodeStream(stream, rgb16, 0, &thread_output);
+		ShutdownIPU();
+
+		ASSERT_GT(inline_mbs, 0u);
+		EXPECT_EQ(inline_mbs, thread_mbs);
+		ASSERT_EQ(inline_output.size(), thread_output.size());
+		EXPECT_EQ(std::memcmp(inline_output.data(), thread_output.data(), inline_output.size() * sizeof(u128)), 0)
+			<< (rgb16 ? "rgb16" : "rgb32");
+	}
+}
+
+TEST(IPUDecode, BDECThreadMatchesInline)
+{
+	static constexpr u32 MACROBLOCKS = 64;
+	static constexpr u32 MB16_QWC = sizeof(macroblock_16) / 16;
+
+	for (const bool intra : {true, false})
+	{
+		const std::vector<u8> data = MakeBDECStream(intra, MACROBLOCKS);
+
+		std::vector<u128> inline_output;
+		SetupIPU(false);
+		std::memset(decoder.niq, 16, sizeof(decoder.niq));
+		DecodeBDEC(data, intra, MACROBLOCKS, &inline_output);
+		ShutdownIPU();
+
+		std::vector<u128> thread_output;
+		SetupIPU(true);
+		ASSERT_TRUE(IPUThreadEnabled());
+		std::memset(decoder.niq, 16, sizeof(decoder.niq));
+		DecodeBDEC(data, intra, MACROBLOCKS, &thread_output);
+		ShutdownIPU();
+
+		ASSERT_EQ(inline_output.size(), MACROBLOCKS * MB16_QWC) << (intra ? "intra" : "non-intra");
+		ASSERT_EQ(thread_output.size(), inline_output.size()) << (intra ? "intra" : "non-intra");
+		EXPECT_EQ(std::memcmp(inline_output.data(), thread_output.data(), inline_output.size() * sizeof(u128)), 0)
+			<< (intra ? "intra" : "non-intra");
+	}
+}
+
+TEST(IPUDecodeBenchmark, DISABLED_Decode)
+{
+	for (const bool rgb16 : {false, true})
+	{
+		for (const u32 ee_spin : {0u, 2000u})
+		{
+			for (const bool ipu_thread : {false, true})
+			{
+				const Stream stream = SetupIPU(ipu_thread);
+
+				const u32 macroblocks = DecodeStream(stream, rgb16, ee_spin, nullptr);
+				const double streams_per_second = BenchmarkUtils::CallsPerSecond(MIN_SECONDS, 1, [&](u32) {
+					DecodeStream(stream, rgb16, ee_spin, nullptr);
+				});
+
+				ShutdownIPU();
+
+				char variant[64];
+				std::snprintf(variant, sizeof(variant), "%s ee_spin %u %s", rgb16 ? "rgb16" : "rgb32", ee_spin,
+					ipu_thread ? "thread" : "inline");
+				BenchmarkUtils::Result()
+					.Add("group", "IPU")
+					.Add("kernel", "IDEC")
+					.Add("variant", variant)
+					.Add("macroblocks_per_second", streams_per_second * macroblocks, 0)
+					.Print();
+			}
+		}
+	}
+}
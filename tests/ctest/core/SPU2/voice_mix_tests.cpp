@@ -0,0 +1,205 @@
+// SPDX-FileCopyrightText: 2002-2024 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#include "pcsx2/SPU2/defs.h"
+#include "pcsx2/SPU2/regs.h"
+#include "pcsx2/SPU2/spu2.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+static constexpr u32 TICKS = 48000;
+static constexpr u32 SOUND_START = 0x2800;
+static constexpr u32 SOUND_END = 0x40000;
+
+struct RegWrite
+{
+	u32 tick;
+	u32 mem;
+	u16 value;
+};
+
+struct VoiceState
+{
+	s32 OutX;
+	s32 Env;
+	u32 NextA;
+	s32 SP;
+	s32 SCurrent;
+	u8 Phase;
+
+	bool operator==(const VoiceState& rhs) const
+	{
+		return OutX == rhs.OutX && Env == rhs.Env && NextA == rhs.NextA && SP == rhs.SP && SCurrent == rhs.SCurrent && Phase == rhs.Phase;
+	}
+};
+
+struct MixRun
+{
+	std::vector<VoiceMixSet> mix;
+	std::vector<VoiceState> voices;
+	std::vector<u32> endx;
+	std::vector<s16> dynmem;
+};
+
+/// Fill sound memory with ADPCM blocks using every filter, and some loop points
+static void FillSoundMemory(std::mt19937& rng)
+{
+	for (u32 addr = SOUND_START; addr < SOUND_END; addr += pcm_WordsPerBlock)
+	{
+		const u32 r = rng();
+		u16 flags = 0;
+		if ((r & 0xff) < 6)
+			flags = 4; // loop start
+		else if ((r & 0xff) < 10)
+			flags = 3; // loop end, repeat
+		else if ((r & 0xff) < 12)
+			flags = 1; // loop end, mute
+
+		_spu2mem[addr] = static_cast<s16>((flags << 8) | (((r >> 8) % 5) << 4) | ((r >> 16) % 13));
+		for (u32 i = 1; i < pcm_WordsPerBlock; i++)
+			_spu2mem[addr + i] = static_cast<s16>(rng());
+	}
+}
+
+/// Register writes a game might do: voice parameters and key on/off, with pitch modulation and noise
+static std::vector<RegWrite> MakeRegisterStream(u32 seed)
+{
+	std::mt19937 rng(seed);
+	std::vector<RegWrite> stream;
+
+	for (u32 tick = 0; tick < TICKS; tick++)
+	{
+		if ((rng() % 64) != 0)
+			continue;
+
+		const u32 core = (rng() & 1) ? SPU2_CORE1 : SPU2_CORE0;
+		const u32 voice = rng() % V_Core::NumVoices;
+		const u32 start = SOUND_START + (rng() % (SOUND_END - SOUND_START));
+
+		switch (rng() % 10)
+		{
+			case 0:
+				stream.push_back({tick, core | REG_S_PMON, static_cast<u16>(rng() & 0xfffe)});
+				stream.push_back({tick, core | (REG_S_NON + 2), static_cast<u16>(rng() & 0x1)});
+				break;
+
+			case 1:
+				stream.push_back({tick, core | (REG_S_VMIXL + (rng() % 6) * 2), static_cast<u16>(rng())});
+				break;
+
+			case 2:
+				// Volume slides, along with fixed volumes
+				stream.push_back({tick, core | SPU2_VP(voice) | REG_VP_VOLL, static_cast<u16>(rng())});
+				stream.push_back({tick, core | SPU2_VP(voice) | REG_VP_VOLR, static_cast<u16>(rng() & 0x7fff)});
+				break;
+
+			case 3:
+				stream.push_back({tick, core | REG_S_KOFF, static_cast<u16>(rng())});
+				break;
+
+			case 4:
+				stream.push_back({tick, core | SPU2_VP(voice) | REG_VP_ENVX, static_cast<u16>(rng() & 0x7fff)});
+				break;
+
+			default:
+				stream.push_back({tick, core | SPU2_VP(voice) | REG_VP_VOLL, static_cast<u16>(rng() & 0x3fff)});
+				stream.push_back({tick, core | SPU2_VP(voice) | REG_VP_VOLR, static_cast<u16>(rng() & 0x3fff)});
+				stream.push_back({tick, core | SPU2_VP(voice) | REG_VP_PITCH, static_cast<u16>(rng() & 0x3fff)});
+				stream.push_back({tick, core | SPU2_VP(voice) | REG_VP_ADSR1, static_cast<u16>(rng())});
+				stream.push_back({tick, core | SPU2_VP(voice) | REG_VP_ADSR2, static_cast<u16>(rng())});
+				stream.push_back({tick, core | (REG_VA_SSA + SPU2_VA(voice)), static_cast<u16>(start >> 16)});
+				stream.push_back({tick, core | (REG_VA_SSA + SPU2_VA(voice) + 2), static_cast<u16>(start)});
+				stream.push_back({tick, core | (REG_S_KON + ((voice >= 16) ? 2 : 0)), static_cast<u16>(1u << (voice & 15))});
+				break;
+		}
+	}
+
+	return stream;
+}
+
+static MixRun RunMixer(u32 seed, const std::vector<RegWrite>& stream, bool batched)
+{
+	std::mt19937 rng(seed);
+
+	std::memset(spu2regs, 0, sizeof(spu2regs));
+	std::memset(_spu2mem, 0, sizeof(_spu2mem));
+	std::memset(pcm_cache_data, 0, sizeof(pcm_cache_data));
+	FillSoundMemory(rng);
+
+	Cycles = 0;
+	OutPos = 0;
+	Cores[0].Init(0);
+	Cores[1].Init(1);
+
+	MixRun run;
+	run.mix.reserve(TICKS * 2);
+
+	auto it = stream.begin();
+	for (u32 tick = 0; tick < TICKS; tick++)
+	{
+		for (; it != stream.end() && it->tick == tick; ++it)
+			SPU2_FastWrite(it->mem, it->value);
+
+		Cycles++;
+		StartQueuedVoices();
+
+		for (uint core = 0; core < 2; core++)
+		{
+			// The noise generator is stepped by V_Core::Mix, which isn't run here.
+			Cores[core].NoiseOut = rng();
+
+			VoiceMixSet mix = VoiceMixSet::Empty;
+			if (batched)
+				MixCoreVoices(mix, core);
+			else
+				MixCoreVoicesScalar(mix, core);
+			run.mix.push_back(mix);
+		}
+
+		OutPos = (OutPos + 1) & 0x1ff;
+	}
+
+	for (uint core = 0; core < 2; core++)
+	{
+		for (const V_Voice& vc : Cores[core].Voices)
+			run.voices.push_back({vc.OutX, vc.ADSR.Value, vc.NextA, vc.SP, vc.SCurrent, vc.ADSR.Phase});
+		run.endx.push_back(Cores[core].Regs.ENDX);
+	}
+	run.dynmem.assign(_spu2mem, _spu2mem + SPU2_DYN_MEMLINE);
+
+	return run;
+}
+
+TEST(SPU2VoiceMix, BatchedMatchesScalar)
+{
+	for (u32 seed = 1; seed <= 4; seed++)
+	{
+		const std::vector<RegWrite> stream = MakeRegisterStream(seed);
+		const MixRun scalar = RunMixer(seed, stream, false);
+		const MixRun batched = RunMixer(seed, stream, true);
+
+		u32 audible = 0;
+		for (size_t i = 0; i < scalar.mix.size(); i++)
+		{
+			const VoiceMixSet& a = scalar.mix[i];
+			const VoiceMixSet& b = batched.mix[i];
+			audible += (a.Dry.Left | a.Dry.Right | a.Wet.Left | a.Wet.Right) != 0;
+			ASSERT_EQ(a.Dry.Left, b.Dry.Left) << "seed " << seed << " tick " << i / 2 << " core " << i % 2;
+			ASSERT_EQ(a.Dry.Right, b.Dry.Right) << "seed " << seed << " tick " << i / 2 << " core " << i % 2;
+			ASSERT_EQ(a.Wet.Left, b.Wet.Left) << "seed " << seed << " tick " << i / 2 << " core " << i % 2;
+			ASSERT_EQ(a.Wet.Right, b.Wet.Right) << "seed " << seed << " tick " << i / 2 << " core " << i % 2;
+		}
+
+		// Make sure the stream actually made some sound.
+		EXPECT_GT(audible, TICKS / 16) << "seed " << seed;
+
+		for (size_t i = 0; i < scalar.voices.size(); i++)
+			EXPECT_TRUE(scalar.voices[i] == batched.voices[i]) << "seed " << seed << " core " << i / V_Core::NumVoices << " voice " << i % V_Core::NumVoices;
+		EXPECT_EQ(scalar.endx, batched.endx) << "seed " << seed;
+		EXPECT_TRUE(scalar.dynmem == batched.dynmem) << "seed " << seed;
+	}
+}
@@ -0,0 +1,169 @@
+// SPDX-FileCopyrightText: 2002-2024 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#include "benchmark_utils.h"
+#include "pcsx2/Config.h"
+#include "pcsx2/MTVU.h"
+#include "pcsx2/Memory.h"
+#include "pcsx2/VUmicro.h"
+#include "common/Timer.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+
+// Frames of VU1 work: every frame starts each of a handful of microprograms once, and every few frames the
+// programs are replaced, the way a game uploads new ones on a scene change. Without background compilation,
+// the first frame of every scene compiles all of them on the EE thread; with it, they run on the interpreter
+// until the compile thread is done with them.
+
+static constexpr u32 PROGRAMS = 8;
+static constexpr u32 PROGRAM_PAIRS = 192;
+static constexpr u32 PROGRAM_BYTES = PROGRAM_PAIRS * 8;
+static constexpr u32 SCENES = 8;
+static constexpr u32 FRAMES_PER_SCENE = 30;
+
+static_assert(PROGRAMS * PROGRAM_BYTES <= VU1_PROGSIZE);
+
+namespace VUCode
+{
+	static constexpr u32 LOWER_NOP = 0x8000033c;
+	static constexpr u32 UPPER_NOP = 0x000002ff;
+	static constexpr u32 E_BIT = 1u << 30;
+	static constexpr u32 ADD(u32 fd, u32 fs, u32 ft) { return (0xfu << 21) | (ft << 16) | (fs << 11) | (fd << 6) | 0x28u; }
+} // namespace VUCode
+
+/// Writes the programs for a scene, each one a run of vector adds ending on an E-bit.
+static void WritePrograms(u32 scene)
+{
+	using namespace VUCode;
+
+	CpuVU1->Clear(0, PROGRAMS * PROGRAM_BYTES);
+
+	for (u32 program = 0; program < PROGRAMS; program++)
+	{
+		u32* code = reinterpret_cast<u32*>(VU1.Micro + program * PROGRAM_BYTES);
+		for (u32 pair = 0; pair < PROGRAM_PAIRS - 2; pair++)
+		{
+			const u32 fd = 1 + (pair + scene) % 31;
+			const u32 fs = 1 + (pair + program) % 31;
+			const u32 ft = 1 + (pair * 7 + scene + program) % 31;
+			code[pair * 2] = LOWER_NOP;
+			code[pair * 2 + 1] = ADD(fd, fs, ft);
+		}
+
+		code[(PROGRAM_PAIRS - 2) * 2] = LOWER_NOP;
+		code[(PROGRAM_PAIRS - 2) * 2 + 1] = UPPER_NOP | E_BIT;
+		code[(PROGRAM_PAIRS - 1) * 2] = LOWER_NOP;
+		code[(PROGRAM_PAIRS - 1) * 2 + 1] = UPPER_NOP;
+	}
+}
+
+class VU1RecBenchmark : public ::testing::Test
+{
+protected:
+	static void SetUpTestSuite()
+	{
+		ASSERT_TRUE(SysMemory::Allocate());
+		s_allocated = true;
+
+		s_saved_options = EmuConfig.Cpu.Recompiler;
+		s_saved_speedhacks = EmuConfig.Speedhacks;
+		s_saved_vu1 = CpuVU1;
+		EmuConfig.Cpu.Recompiler.EnableVU1 = true;
+		EmuConfig.Speedhacks.vuThread = false;
+		EmuConfig.Speedhacks.vu1Instant = true;
+		CpuVU1 = &CpuMicroVU1;
+
+		CpuMicroVU1.Reserve();
+		SysMemory::Reset();
+	}
+
+	static void TearDownTestSuite()
+	{
+		if (!s_allocated)
+			return;
+
+		CpuMicroVU1.Shutdown();
+		vu1Thread.Close();
+		SysMemory::Release();
+		EmuConfig.Cpu.Recompiler = s_saved_options;
+		EmuConfig.Speedhacks = s_saved_speedhacks;
+		CpuVU1 = s_saved_vu1;
+		s_allocated = false;
+	}
+
+	struct FrameTimes
+	{
+		double mean_ms;
+		double worst_ms;
+		double first_frame_ms; // mean over the first frame of each scene
+	};
+
+	/// Runs every scene with or without background compilation, timing each frame.
+	static FrameTimes TimeFrames(bool async)
+	{
+		EmuConfig.Cpu.Recompiler.EnableVU1AsyncCompile = async;
+		CpuMicroVU1.Reset();
+
+		FrameTimes times = {};
+		for (u32 scene = 0; scene < SCENES; scene++)
+		{
+			WritePrograms(scene);
+
+			for (u32 frame = 0; frame < FRAMES_PER_SCENE; frame++)
+			{
+				Common::Timer timer;
+				for (u32 program = 0; program < PROGRAMS; program++)
+				{
+					vu1ExecMicro((program * PROGRAM_BYTES) >> 3);
+					vu1Finish(false);
+				}
+
+				const double ms = timer.GetTimeMilliseconds();
+				times.mean_ms += ms;
+				times.worst_ms = std::max(times.worst_ms, ms);
+				if (frame == 0)
+					times.first_frame_ms += ms;
+
+				EXPECT_FALSE(VU0.VI[REG_VPU_STAT].UL & 0x100) << "VU1 still running, async " << async;
+			}
+		}
+
+		times.mean_ms /= SCENES * FRAMES_PER_SCENE;
+		times.first_frame_ms /= SCENES;
+		return times;
+	}
+
+	static bool s_allocated;
+	static Pcsx2Config::RecompilerOptions s_saved_options;
+	static Pcsx2Config::SpeedhackOptions s_saved_speedhacks;
+	static BaseVUmicroCPU* s_saved_vu1;
+};
+
+bool VU1RecBenchmark::s_allocated = false;
+Pcsx2Config::RecompilerOptions VU1RecBenchmark::s_saved_options;
+Pcsx2Config::SpeedhackOptions VU1RecBenchmark::s_saved_speedhacks;
+BaseVUmicroCPU* VU1RecBenchmark::s_saved_vu1 = nullptr;
+
+/// Frame times of VU1 heavy frames with programs compiled on the EE thread and in the background.
+/// Disabled by default, run it through the vu1_rec_benchmark target.
+TEST_F(VU1RecBenchmark, DISABLED_FrameTimes)
+{
+	const FrameTimes sync = TimeFrames(false);
+	const FrameTimes async = TimeFrames(true);
+
+	BenchmarkUtils::Result()
+		.Add("group", "microVU1")
+		.Add("kernel", "SceneChanges")
+		.Add("programs", static_cast<u64>(PROGRAMS))
+		.Add("frames", static_cast<u64>(SCENES * FRAMES_PER_SCENE))
+		.Add("sync_mean_ms", sync.mean_ms, 3)
+		.Add("sync_first_frame_ms", sync.first_frame_ms, 3)
+		.Add("sync_worst_ms", sync.worst_ms, 3)
+		.Add("async_mean_ms", async.mean_ms, 3)
+		.Add("async_first_frame_ms", async.first_frame_ms, 3)
+		.Add("async_worst_ms", async.worst_ms, 3)
+		.Print();
+}
@@ -0,0 +1,189 @@
+// SPDX-FileCopyrightText: 2002-2024 PCSX2 Dev Team
+// SPDX-License-Identifier: GPL-3.0+
+
+#pragma once
+
+#include "common/FileSystem.h"
+#include "common/Path.h"
+#include "common/Pcsx2Defs.h"
+#include "common/Timer.h"
+
+#include "fmt/format.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// Shared pieces of the core_test benchmarks. They're disabled tests, run through the targets made by
+// add_core_benchmark(), and print each result as a single line JSON object so runs can be collected with grep.
+// The temporary directory fixture is shared with the tests that need input files written to disk.
+
+namespace BenchmarkUtils
+{
+	/// Deterministic filler data, the same sequence on every platform and standard library.
+	class Random
+	{
+	public:
+		explicit Random(u32 seed = 0x12345678)
+			: m_state(seed)
+		{
+		}
+
+		u32 Next()
+		{
+			m_state = m_state * 1103515245u + 12345u;
+			return m_state;
+		}
+
+		/// The low bits of the LCG are poor, so small values come from the top.
+		u8 NextU8() { return static_cast<u8>(Next() >> 24); }
+		u16 NextU16() { return static_cast<u16>(Next() >> 16); }
+		u32 NextBelow(u32 max) { return (Next() >> 8) % max; }
+
+	private:
+		u32 m_state;
+	};
+
+	/// Calls fn with an increasing counter in batches until min_seconds have passed, after one batch to warm up.
+	/// Returns the number of calls per second.
+	template <typename Fn>
+	double CallsPerSecond(double min_seconds, u32 batch, Fn&& fn)
+	{
+		for (u32 i = 0; i < batch; i++)
+			fn(i);
+
+		u64 calls = 0;
+		Common::Timer timer;
+		double seconds;
+		do
+		{
+			for (u32 i = 0; i < batch; i++)
+				fn(static_cast<u32>(calls + i));
+			calls += batch;
+			seconds = timer.GetTimeSeconds();
+		} while (seconds < min_seconds);
+
+		return static_cast<double>(calls) / seconds;
+	}
+
+	/// One line of benchmark output, fields are printed in the order they're added.
+	class Result
+	{
+	public:
+		Result& Add(const char* key, const char* value)
+		{
+			AddKey(key);
+			m_json += '"';
+			for (const char* p = value; *p; p++)
+			{
+				if (*p == '"' || *p == '\\')
+					m_json += '\\';
+				m_json += *p;
+			}
+			m_json += '"';
+			return *this;
+		}
+
+		Result& Add(const char* key, u64 value)
+		{
+			AddKey(key);
+			m_json += std::to_string(value);
+			return *this;
+		}
+
+		Result& Add(const char* key, double value, int decimals = 1)
+		{
+			char buf[64];
+			std::snprintf(buf, sizeof(buf), "%.*f", decimals, value);
+			AddKey(key);
+			m_json += buf;
+			return *this;
+		}
+
+		void Print() const { std::printf("{%s}\n", m_json.c_str()); }
+
+	private:
+		void AddKey(const char* key)
+		{
+			if (!m_json.empty())
+				m_json += ", ";
+			m_json += '"';
+			m_json += key;
+			m_json += "\": ";
+		}
+
+		std::string m_json;
+	};
+
+	/// A directory of its own under the system temporary directory, deleted along with its contents when destroyed.
+	class TempDirectory
+	{
+	public:
+		explicit TempDirectory(std::string_view prefix)
+		{
+			std::error_code ec;
+			const std::string temp = std::filesystem::temp_directory_path(ec).string();
+			if (ec)
+				return;
+
+			std::string path = Path::Combine(temp, fmt::format("{}_{}", prefix, Common::Timer::GetCurrentValue()));
+			if (FileSystem::CreateDirectoryPath(path.c_str(), false))
+				m_path = std::move(path);
+		}
+
+		~TempDirectory()
+		{
+			if (!m_path.empty())
+				FileSystem::RecursiveDeleteDirectory(m_path.c_str());
+		}
+
+		TempDirectory(const TempDirectory&) = delete;
+		TempDirectory& operator=(const TempDirectory&) = delete;
+
+		bool IsValid() const { return !m_path.empty(); }
+		const std::string& GetPath() const { return m_path; }
+		std::string Combine(std::string_view name) const { return Path::Combine(m_path, name); }
+
+	private:
+		std::string m_path;
+	};
+
+	/// Suites whose input files are written once, to a temporary directory that lives as long as the suite.
+	/// Derived supplies TEMP_PREFIX, WriteFiles(const TempDirectory&) returning false on failure, and ReleaseFiles()
+	/// for anything it keeps in memory. Tests are skipped when the files couldn't be written.
+	template <typename Derived>
+	class TempDirectoryTest : public ::testing::Test
+	{
+	protected:
+		static void SetUpTestSuite()
+		{
+			s_directory = std::make_unique<TempDirectory>(Derived::TEMP_PREFIX);
+			ASSERT_TRUE(s_directory->IsValid()) << "Failed to create a temporary directory";
+			s_files_written = Derived::WriteFiles(*s_directory);
+			ASSERT_TRUE(s_files_written) << "Failed to write the test files to " << s_directory->GetPath();
+		}
+
+		static void TearDownTestSuite()
+		{
+			Derived::ReleaseFiles();
+			s_directory.reset();
+			s_files_written = false;
+		}
+
+		void SetUp() override
+		{
+			if (!s_files_written)
+				GTEST_SKIP() << "Failed to create the test files";
+		}
+
+		static const TempDirectory& GetTempDirectory() { return *s_directory; }
+
+	private:
+		static inline std::unique_ptr<TempDirectory> s_directory;
+		static inline bool s_files_written = false;
+	};
+} // namespace BenchmarkUtils